@@ -21,25 +21,40 @@
 
 #include "ODApplication.h"
 
+#include "creatureeffect/CreatureEffectSlap.h"
+#include "entities/ChickenEntity.h"
+#include "entities/Creature.h"
+#include "entities/CreatureDefinition.h"
+#include "entities/MissileOneHit.h"
+#include "entities/SmallSpiderEntity.h"
+#include "entities/Tile.h"
+#include "entities/TreasuryObject.h"
+#include "gamemap/GameMap.h"
+#include "gamemap/MapHandler.h"
 #include "network/ODServer.h"
 #include "network/ODClient.h"
 #include "network/ServerMode.h"
+#include "network/ServerNotification.h"
 #include "sound/MusicPlayer.h"
 #include "sound/SoundEffectsManager.h"
 #include "render/Gui.h"
 #include "render/ODFrameListener.h"
 #include "render/TextRenderer.h"
+#include "utils/AllocationCounter.h"
 #include "utils/ConfigManager.h"
+#include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/LogSinkConsole.h"
 #include "utils/LogSinkFile.h"
 #include "utils/LogSinkOgre.h"
+#include "utils/ObjectPool.h"
 #include "utils/Random.h"
 #include "utils/ResourceManager.h"
 
 #include <OgreErrorDialog.h>
 #include <OgreRenderWindow.h>
 #include <OgreRoot.h>
+#include <OgreTimer.h>
 #include <Overlay/OgreOverlaySystem.h>
 #include <RTShaderSystem/OgreShaderGenerator.h>
 
@@ -58,9 +73,157 @@
 
 #include <boost/program_options.hpp>
 
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <utility>
+#include <vector>
+
+namespace
+{
+//! \brief Object created by ODApplication::benchmarkObjectPools
+struct BenchmarkObject
+{
+    void* mPtr;
+    void (*mDelete)(void* ptr, bool useHeap);
+    uint32_t mTurnRelease;
+};
+
+//! \brief Creates a T from its pool (class operator new) or from the global heap
+template<typename T, typename... Args>
+void* createBenchmarkObject(bool useHeap, Args&&... args)
+{
+    if(!useHeap)
+        return new T(std::forward<Args>(args)...);
+
+    void* mem = ::operator new(sizeof(T));
+    return ::new(mem) T(std::forward<Args>(args)...);
+}
+
+template<typename T>
+void deleteBenchmarkObject(void* ptr, bool useHeap)
+{
+    T* obj = static_cast<T*>(ptr);
+    if(!useHeap)
+    {
+        delete obj;
+        return;
+    }
+
+    obj->~T();
+    ::operator delete(ptr);
+}
+
+template<typename T>
+uint64_t getPoolHeldBytes()
+{
+    ObjectPool& pool = PooledObject<T>::getPool();
+    return static_cast<uint64_t>(pool.getNbChunks()) * pool.getNbBlocksPerChunk() * pool.getBlockSize();
+}
+
+//! \brief Free memory kept by the heap (not given back to the system). Returns false if it cannot be
+//! measured on this platform
+bool getHeapFreeBytes(uint64_t& freeBytes)
+{
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+    freeBytes = mallinfo2().fordblks;
+    return true;
+#elif defined(__GLIBC__)
+    freeBytes = static_cast<uint64_t>(mallinfo().fordblks);
+    return true;
+#else
+    freeBytes = 0;
+    return false;
+#endif
+}
+
+//! \brief Runs the fight turns of benchmarkObjectPools. Returns the peak of live objects and their size
+void runBenchmarkObjectTurns(GameMap& gameMap, bool useHeap, uint32_t nbTurns, uint32_t& peakObjects,
+    uint64_t& peakBytes)
+{
+    // Both runs create the same objects in the same order
+    Random::initialize(42);
+    peakObjects = 0;
+    peakBytes = 0;
+    uint64_t liveBytes = 0;
+    std::vector<BenchmarkObject> live;
+    std::vector<std::size_t> liveSizes;
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        uint32_t nbNew = Random::Uint(0, 39);
+        for(uint32_t i = 0; i < nbNew; ++i)
+        {
+            BenchmarkObject obj;
+            std::size_t size;
+            switch(Random::Uint(0, 5))
+            {
+                case 0:
+                    obj.mPtr = createBenchmarkObject<MissileOneHit>(useHeap, &gameMap);
+                    obj.mDelete = &deleteBenchmarkObject<MissileOneHit>;
+                    size = sizeof(MissileOneHit);
+                    break;
+                case 1:
+                    obj.mPtr = createBenchmarkObject<ChickenEntity>(useHeap, &gameMap);
+                    obj.mDelete = &deleteBenchmarkObject<ChickenEntity>;
+                    size = sizeof(ChickenEntity);
+                    break;
+                case 2:
+                    obj.mPtr = createBenchmarkObject<SmallSpiderEntity>(useHeap, &gameMap);
+                    obj.mDelete = &deleteBenchmarkObject<SmallSpiderEntity>;
+                    size = sizeof(SmallSpiderEntity);
+                    break;
+                case 3:
+                    obj.mPtr = createBenchmarkObject<TreasuryObject>(useHeap, &gameMap);
+                    obj.mDelete = &deleteBenchmarkObject<TreasuryObject>;
+                    size = sizeof(TreasuryObject);
+                    break;
+                case 4:
+                    obj.mPtr = createBenchmarkObject<CreatureEffectSlap>(useHeap);
+                    obj.mDelete = &deleteBenchmarkObject<CreatureEffectSlap>;
+                    size = sizeof(CreatureEffectSlap);
+                    break;
+                default:
+                    obj.mPtr = createBenchmarkObject<ServerNotification>(useHeap,
+                        ServerNotificationType::chatServer, nullptr);
+                    obj.mDelete = &deleteBenchmarkObject<ServerNotification>;
+                    size = sizeof(ServerNotification);
+                    break;
+            }
+            obj.mTurnRelease = turn + 1 + Random::Uint(0, 19);
+            live.push_back(obj);
+            liveSizes.push_back(size);
+            liveBytes += size;
+        }
+        if(live.size() > peakObjects)
+        {
+            peakObjects = static_cast<uint32_t>(live.size());
+            peakBytes = liveBytes;
+        }
+
+        for(uint32_t i = 0; i < live.size();)
+        {
+            if(live[i].mTurnRelease > turn)
+            {
+                ++i;
+                continue;
+            }
+            live[i].mDelete(live[i].mPtr, useHeap);
+            liveBytes -= liveSizes[i];
+            live[i] = live.back();
+            live.pop_back();
+            liveSizes[i] = liveSizes.back();
+            liveSizes.pop_back();
+        }
+    }
+
+    for(BenchmarkObject& obj : live)
+        obj.mDelete(obj.mPtr, useHeap);
+}
+}
 
 void ODApplication::startGame(boost::program_options::variables_map& options)
 {
@@ -72,7 +235,9 @@ void ODApplication::startGame(boost::program_options::variables_map& options)
     logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkConsole()));
     logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkFile(resMgr.getLogFile())));
 
-    if(resMgr.isServerMode())
+    if(resMgr.getBenchmarkLevelsNbLoads() > 0)
+        benchmarkLevels();
+    else if(resMgr.isServerMode())
         startServer();
     else
         startClient();
@@ -85,7 +250,8 @@ void ODApplication::startServer()
     OD_LOG_INF("Initializing");
 
     Random::initialize();
-    ConfigManager configManager(resMgr.getConfigPath(), "", resMgr.getSoundPath());
+    ConfigManager configManager(resMgr.getConfigPath(), "", resMgr.getSoundPath(),
+        resMgr.getConfigCacheFile(), resMgr.getRebuildConfigCache());
     OD_LOG_INF("Launching server");
 
     const std::string& creator = resMgr.getServerModeCreator();
@@ -107,6 +273,177 @@ void ODApplication::startServer()
     server.stopServer();
 }
 
+void ODApplication::benchmarkLevels()
+{
+    ResourceManager& resMgr = ResourceManager::getSingleton();
+
+    Random::initialize();
+    ConfigManager configManager(resMgr.getConfigPath(), "", resMgr.getSoundPath(),
+        resMgr.getConfigCacheFile(), resMgr.getRebuildConfigCache());
+
+    // The server is not started but server game maps need it while loading entities
+    ODServer server;
+
+    std::vector<std::string> levels;
+    Helper::fillFilesList(resMgr.getGameLevelPathSkirmish(), levels, MapHandler::LEVEL_EXTENSION);
+    Helper::fillFilesList(resMgr.getGameLevelPathMultiplayer(), levels, MapHandler::LEVEL_EXTENSION);
+
+    int32_t nbLoads = resMgr.getBenchmarkLevelsNbLoads();
+    for(const std::string& level : levels)
+    {
+        LevelLoadingTimes totalTimes;
+        int32_t nbLoaded = 0;
+        for(int32_t i = 0; i < nbLoads; ++i)
+        {
+            GameMap gameMap(true);
+            LevelLoadingTimes times;
+            if(!gameMap.loadLevel(level, &times))
+            {
+                OD_LOG_ERR("Couldn't load level " + level);
+                break;
+            }
+
+            totalTimes.mReadFile += times.mReadFile;
+            totalTimes.mParseTiles += times.mParseTiles;
+            totalTimes.mBuildTiles += times.mBuildTiles;
+            totalTimes.mEntities += times.mEntities;
+            ++nbLoaded;
+
+            if(i == 0)
+                benchmarkTileQueries(gameMap, level);
+        }
+
+        if(nbLoaded == 0)
+            continue;
+
+        double nb = static_cast<double>(nbLoaded);
+        OD_LOG_INF("Benchmark level " + level + " loaded " + Helper::toString(nbLoaded) + " times, average readFile="
+            + Helper::toString(totalTimes.mReadFile / nb)
+            + " ms, parseTiles=" + Helper::toString(totalTimes.mParseTiles / nb)
+            + " ms, buildTiles=" + Helper::toString(totalTimes.mBuildTiles / nb)
+            + " ms, entities=" + Helper::toString(totalTimes.mEntities / nb) + " ms");
+    }
+
+    // The pooled entities do not depend on the level
+    GameMap gameMap(true);
+    benchmarkObjectPools(gameMap);
+}
+
+void ODApplication::benchmarkTileQueries(GameMap& gameMap, const std::string& level)
+{
+    // We simulate the tile queries each creature runs during a server turn when it updates its sight
+    // (see Creature::updateTilesInSight). The old way returned new vectors assigned to the creature. The
+    // new way fills vectors kept by the creature
+    std::vector<std::pair<Tile*, int>> creatureQueries;
+    for(Creature* creature : gameMap.getCreatures())
+    {
+        Tile* posTile = creature->getPositionTile();
+        if(posTile == nullptr)
+            continue;
+
+        creatureQueries.push_back(std::make_pair(posTile, creature->getDefinition()->getSightRadius()));
+    }
+
+    if(creatureQueries.empty())
+    {
+        OD_LOG_INF("Benchmark level " + level + " has no creature, tile queries not benchmarked");
+        return;
+    }
+
+    const uint32_t nbTurns = 100;
+    std::vector<std::vector<Tile*>> tilesInSight(creatureQueries.size());
+    std::vector<std::vector<Tile*>> visibleTiles(creatureQueries.size());
+
+    uint64_t nbAllocs = AllocationCounter::getNbAllocations();
+    Ogre::Timer timer;
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        for(uint32_t i = 0; i < creatureQueries.size(); ++i)
+        {
+            const std::pair<Tile*, int>& query = creatureQueries[i];
+            tilesInSight[i] = gameMap.circularRegion(query.first->getX(), query.first->getY(), query.second);
+            visibleTiles[i] = gameMap.visibleTiles(query.first->getX(), query.first->getY(), query.second);
+        }
+    }
+    uint64_t timeReturned = timer.getMilliseconds();
+    uint64_t nbAllocsReturned = AllocationCounter::getNbAllocations() - nbAllocs;
+
+    for(std::vector<Tile*>& tiles : tilesInSight)
+        std::vector<Tile*>().swap(tiles);
+    for(std::vector<Tile*>& tiles : visibleTiles)
+        std::vector<Tile*>().swap(tiles);
+
+    // The first turn allocates the creature vectors. That is counted since it happens for each new creature
+    nbAllocs = AllocationCounter::getNbAllocations();
+    timer.reset();
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        for(uint32_t i = 0; i < creatureQueries.size(); ++i)
+        {
+            const std::pair<Tile*, int>& query = creatureQueries[i];
+            gameMap.circularRegion(query.first->getX(), query.first->getY(), query.second, tilesInSight[i]);
+            gameMap.visibleTiles(query.first->getX(), query.first->getY(), query.second, visibleTiles[i]);
+        }
+    }
+    uint64_t timeReused = timer.getMilliseconds();
+    uint64_t nbAllocsReused = AllocationCounter::getNbAllocations() - nbAllocs;
+
+    std::string allocsReturned = "not counted";
+    std::string allocsReused = "not counted";
+    if(AllocationCounter::isEnabled())
+    {
+        allocsReturned = Helper::toString(static_cast<double>(nbAllocsReturned) / nbTurns);
+        allocsReused = Helper::toString(static_cast<double>(nbAllocsReused) / nbTurns);
+    }
+
+    OD_LOG_INF("Benchmark level " + level + " sight queries of " + Helper::toString(creatureQueries.size())
+        + " creatures over " + Helper::toString(nbTurns) + " simulated turns, returned vectors: "
+        + Helper::toString(timeReturned) + " ms, heap allocations per turn=" + allocsReturned
+        + ", reused vectors: " + Helper::toString(timeReused) + " ms, heap allocations per turn=" + allocsReused);
+}
+
+void ODApplication::benchmarkObjectPools(GameMap& gameMap)
+{
+    const uint32_t nbTurns = 10000;
+    uint64_t heapFreeBefore = 0;
+    uint64_t heapFreeAfter = 0;
+    bool isHeapMeasured = getHeapFreeBytes(heapFreeBefore);
+
+    uint32_t peakObjects;
+    uint64_t peakBytes;
+    Ogre::Timer timer;
+    runBenchmarkObjectTurns(gameMap, false, nbTurns, peakObjects, peakBytes);
+    uint64_t timePools = timer.getMilliseconds();
+    getHeapFreeBytes(heapFreeAfter);
+    int64_t heapFreePools = static_cast<int64_t>(heapFreeAfter) - static_cast<int64_t>(heapFreeBefore);
+
+    // The pools keep their chunks. This is all the memory they hold, including what the level uses
+    uint64_t poolHeldBytes = getPoolHeldBytes<MissileOneHit>() + getPoolHeldBytes<ChickenEntity>()
+        + getPoolHeldBytes<SmallSpiderEntity>() + getPoolHeldBytes<TreasuryObject>()
+        + getPoolHeldBytes<CreatureEffectSlap>() + getPoolHeldBytes<ServerNotification>();
+
+    getHeapFreeBytes(heapFreeBefore);
+    timer.reset();
+    runBenchmarkObjectTurns(gameMap, true, nbTurns, peakObjects, peakBytes);
+    uint64_t timeHeap = timer.getMilliseconds();
+    getHeapFreeBytes(heapFreeAfter);
+    int64_t heapFreeHeap = static_cast<int64_t>(heapFreeAfter) - static_cast<int64_t>(heapFreeBefore);
+
+    std::string fragmentationPools = "not measured";
+    std::string fragmentationHeap = "not measured";
+    if(isHeapMeasured)
+    {
+        fragmentationPools = Helper::toString(heapFreePools) + " bytes";
+        fragmentationHeap = Helper::toString(heapFreeHeap) + " bytes";
+    }
+
+    OD_LOG_INF("Benchmark object pools over " + Helper::toString(nbTurns) + " simulated turns, peak of "
+        + Helper::toString(peakObjects) + " live objects (" + Helper::toString(peakBytes) + " bytes)"
+        + ", pools: " + Helper::toString(timePools) + " ms, pool memory held="
+        + Helper::toString(poolHeldBytes) + " bytes, heap free memory change=" + fragmentationPools
+        + ", global heap: " + Helper::toString(timeHeap) + " ms, heap free memory change=" + fragmentationHeap);
+}
+
 void ODApplication::startClient()
 {
     ResourceManager& resMgr = ResourceManager::getSingleton();
@@ -127,7 +464,7 @@ void ODApplication::startClient()
     Ogre::Root ogreRoot(resMgr.getPluginsPath(), "");
 
     ConfigManager configManager(resMgr.getConfigPath(), resMgr.getUserCfgFile(),
-        resMgr.getSoundPath());
+        resMgr.getSoundPath(), resMgr.getConfigCacheFile(), resMgr.getRebuildConfigCache());
 
     if (!configManager.initVideoConfig(ogreRoot))
         return;
@@ -36,6 +36,7 @@ namespace Ogre {
 class Root;
 }
 
+class GameMap;
 class LogManager;
 
 //! \brief Base class which manages the startup of OpenDungeons.
@@ -64,6 +65,20 @@ private:
     void startClient();
     //! \brief Server mode. Creates only the needed to launch a level. Note that this is to be used without gui
     void startServer();
+    //! \brief Loads every official level several times and logs the average time spent in each loading
+    //! stage. Like server mode, it is used without gui
+    void benchmarkLevels();
+    //! \brief Called by benchmarkLevels for each level. Runs the sight queries (circularRegion and visibleTiles)
+    //! of every creature of the level over simulated turns, returning new vectors and then reusing the
+    //! creature vectors, and logs the time and the heap allocations per turn of each way. The allocations
+    //! are only counted when built with OD_COUNT_ALLOCATIONS
+    void benchmarkTileQueries(GameMap& gameMap, const std::string& level);
+    //! \brief Called by benchmarkLevels once the levels are benchmarked. Simulates fight turns creating and deleting the pooled entity types
+    //! (missiles, chickens, spiders, treasuries, creature effects, server notifications) with random life
+    //! times, once with their object pools and once with the global heap. Logs the time of each run, the
+    //! memory held by the pools compared to the peak of live objects and, with glibc, the free memory the heap
+    //! keeps after each run (fragmentation)
+    void benchmarkObjectPools(GameMap& gameMap);
 };
 
 #endif // ODAPPLICATION_H
@@ -44,7 +44,7 @@ BaseAI::BaseAI(GameMap& gameMap, Player& player):
 
 Room* BaseAI::getDungeonTemple()
 {
-    std::vector<Room*> dt = mGameMap.getRoomsByTypeAndSeat(RoomType::dungeonTemple, mPlayer.getSeat());
+    const std::vector<Room*>& dt = mGameMap.getRoomsByTypeAndSeat(RoomType::dungeonTemple, mPlayer.getSeat());
     if(!dt.empty())
         return dt.front();
     else
@@ -424,46 +424,40 @@ bool BaseAI::digWayToTile(Tile* tileStart, Tile* tileEnd)
     if (worker == nullptr)
         return false;
 
-    std::list<Tile*> pathToDig = mGameMap.path(tileEnd, tileStart, worker, seat, true);
+    TilePath pathToDig = mGameMap.path(tileEnd, tileStart, worker, seat, true);
     if (pathToDig.empty())
         return false;
 
-    // We search for the first reachable tile in the list
-    bool isPathFound = false;
-    for(std::list<Tile*>::iterator it = pathToDig.begin(); it != pathToDig.end();)
+    // We search for the first reachable tile in the path. We only keep the tiles before it
+    uint32_t nbTilesToDig = 0;
+    for(Tile* tile : pathToDig)
     {
-        Tile* tile = *it;
-        if(!isPathFound &&
-           (tile->getFullness() == 0.0) &&
+        if((tile->getFullness() == 0.0) &&
            (mGameMap.pathExists(worker, tileStart, tile)))
         {
-            isPathFound = true;
+            break;
         }
 
-        if(isPathFound)
-        {
-            it = pathToDig.erase(it);
-            continue;
-        }
+        ++nbTilesToDig;
 
         // If the tile should be dug, we check if one of its neighboors can be reached.
         // If yes, we will stop after digging it to avoid digging through a wall as much as
         // possible
+        bool isPathFound = false;
         for(Tile* t : tile->getAllNeighbors())
         {
-            if(!isPathFound &&
-               (t->getFullness() == 0.0) &&
+            if((t->getFullness() == 0.0) &&
                (mGameMap.pathExists(worker, tileStart, t)))
             {
-                // we let the iterator increment because we want to dig the currently
-                // tested tile
                 isPathFound = true;
                 break;
             }
         }
 
-        ++it;
+        if(isPathFound)
+            break;
     }
+    pathToDig.truncate(nbTilesToDig);
 
     for(Tile* tile : pathToDig)
     {
@@ -386,81 +386,84 @@ bool KeeperAI::lookForGold()
     int widerSide = mGameMap.getMapSizeX() > mGameMap.getMapSizeY() ?
         mGameMap.getMapSizeX() : mGameMap.getMapSizeY();
 
+    // The gold tiles are searched in the snapshot published at the end of the last turn. The scan
+    // only needs the tiles type and fullness and does not touch the live tiles
+    std::shared_ptr<const GameMapSnapshot> snapshot = mGameMap.getSnapshot();
+    if(snapshot == nullptr)
+        return false;
+
+    auto isGoldTile = [&snapshot](int x, int y)
+    {
+        const TileSnapshot* tile = snapshot->getTile(x, y);
+        return (tile != nullptr) && (tile->mType == TileType::gold) && (tile->mFullness > 0.0);
+    };
+
     // We search for the closest gold tile
     Tile* firstGoldTile = nullptr;
     for(int32_t distance = 1; distance < widerSide; ++distance)
     {
         for(int k = 0; k <= distance; ++k)
         {
-            Tile* t;
             // North-East
-            t = mGameMap.getTile(central->getX() + k, central->getY() + distance);
-            if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
+            if(isGoldTile(central->getX() + k, central->getY() + distance))
             {
                 // If we already have a tile at same distance, we randomly change to
                 // try to not be too predictable
                 if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                    firstGoldTile = t;
+                    firstGoldTile = mGameMap.getTile(central->getX() + k, central->getY() + distance);
             }
             // North-West
             if(k > 0)
             {
-                t = mGameMap.getTile(central->getX() - k, central->getY() + distance);
-                if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
+                if(isGoldTile(central->getX() - k, central->getY() + distance))
                 {
                     if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                        firstGoldTile = t;
+                        firstGoldTile = mGameMap.getTile(central->getX() - k, central->getY() + distance);
                 }
             }
             // South-East
-            t = mGameMap.getTile(central->getX() + k, central->getY() - distance);
-            if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
+            if(isGoldTile(central->getX() + k, central->getY() - distance))
             {
                 if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                    firstGoldTile = t;
+                    firstGoldTile = mGameMap.getTile(central->getX() + k, central->getY() - distance);
             }
             // South-West
             if(k > 0)
             {
-                t = mGameMap.getTile(central->getX() - k, central->getY() - distance);
-                if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
+                if(isGoldTile(central->getX() - k, central->getY() - distance))
                 {
                     if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                        firstGoldTile = t;
+                        firstGoldTile = mGameMap.getTile(central->getX() - k, central->getY() - distance);
                 }
             }
             // East-North
-            t = mGameMap.getTile(central->getX() + distance, central->getY() + k);
-            if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
+            if(isGoldTile(central->getX() + distance, central->getY() + k))
             {
                 if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                    firstGoldTile = t;
+                    firstGoldTile = mGameMap.getTile(central->getX() + distance, central->getY() + k);
             }
             // East-South
             if(k > 0)
             {
-                t = mGameMap.getTile(central->getX() + distance, central->getY() - k);
-                if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
+                if(isGoldTile(central->getX() + distance, central->getY() - k))
                 {
                     if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                        firstGoldTile = t;
+                        firstGoldTile = mGameMap.getTile(central->getX() + distance, central->getY() - k);
                 }
             }
             // West-North
-            t = mGameMap.getTile(central->getX() - distance, central->getY() + k);
-            if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
+            if(isGoldTile(central->getX() - distance, central->getY() + k))
             {
                 if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                    firstGoldTile = t;
+                    firstGoldTile = mGameMap.getTile(central->getX() - distance, central->getY() + k);
             }
             // West-South
             if(k > 0)
             {
-                t = mGameMap.getTile(central->getX() - distance, central->getY() - k);
-                if(t != nullptr && t->getType() == TileType::gold && t->getFullness() > 0.0)
+                if(isGoldTile(central->getX() - distance, central->getY() - k))
                 {
                     if((firstGoldTile == nullptr) || (Random::Uint(1,2) == 1))
-                        firstGoldTile = t;
+                        firstGoldTile = mGameMap.getTile(central->getX() - distance, central->getY() - k);
                 }
             }
 
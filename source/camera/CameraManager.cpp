@@ -27,6 +27,8 @@
 #include "utils/LogManager.h"
 #include "gamemap/GameMap.h"
 #include <OgreCamera.h>
+#include <OgrePlane.h>
+#include <OgreRay.h>
 #include <OgreSceneNode.h>
 #include <OgreSceneManager.h>
 #include <OgreViewport.h>
@@ -34,6 +36,7 @@
 
 
 #include <algorithm>
+#include <cmath>
 
 //! The camera base moving speed.
 const Ogre::Real MOVE_SPEED = 2.0;
@@ -427,6 +430,29 @@ Ogre::Vector3 CameraManager::getCameraViewTarget() const
     return target;
 }
 
+Ogre::Real CameraManager::getCameraViewRadius(const Ogre::Vector3& viewTarget) const
+{
+    Ogre::Plane floorPlane(Ogre::Vector3::UNIT_Z, 0.0);
+    const Ogre::Real screenBorders[] = {0.0, 1.0};
+    Ogre::Real radius = 0.0;
+    for(Ogre::Real screenX : screenBorders)
+    {
+        for(Ogre::Real screenY : screenBorders)
+        {
+            Ogre::Ray ray = mActiveCamera->getCameraToViewportRay(screenX, screenY);
+            std::pair<bool, Ogre::Real> p = ray.intersects(floorPlane);
+            if(!p.first)
+                return Ogre::Math::POS_INFINITY;
+
+            Ogre::Vector3 corner = ray.getPoint(p.second);
+            radius = std::max(radius, std::abs(corner.x - viewTarget.x));
+            radius = std::max(radius, std::abs(corner.y - viewTarget.y));
+        }
+    }
+
+    return radius;
+}
+
 void CameraManager::resetCamera(const Ogre::Vector3& position, const Ogre::Vector3& rotation)
 {
     Ogre::Node* nodeRotation = getActiveCameraNode()->getChild(0);
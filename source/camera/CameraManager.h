@@ -102,6 +102,12 @@ public:
     */
     Ogre::Vector3 getCameraViewTarget() const;
 
+    /*! \brief Computes the half size of the square centered on viewTarget containing the part of the floor
+    * seen by the camera (the corners of the viewport projected on the floor). If a corner of the viewport
+    * does not see the floor (the camera looks at the horizon), Ogre::Math::POS_INFINITY is returned.
+    */
+    Ogre::Real getCameraViewRadius(const Ogre::Vector3& viewTarget) const;
+
     void onMiniMapClick(Ogre::Vector2 cc);
 
     /** \brief Starts the camera moving towards a destination position,
@@ -83,7 +83,7 @@ bool CreatureActionEatChicken::handleEatChicken(Creature& creature, ChickenEntit
     if(dist > 1)
     {
         // We walk to the chicken
-        std::list<Tile*> pathToChicken = creature.getGameMap()->path(&creature, chickenTile);
+        TilePath pathToChicken = creature.getGameMap()->path(&creature, chickenTile);
         if(pathToChicken.empty())
         {
             OD_LOG_ERR("creature=" + creature.getName() + " posTile=" + Tile::displayAsString(myTile) + " empty path to chicken tile=" + Tile::displayAsString(chickenTile));
@@ -96,22 +96,20 @@ bool CreatureActionEatChicken::handleEatChicken(Creature& creature, ChickenEntit
         {
             // We only keep 80% of the path
             int nbTiles = 8 * pathToChicken.size() / 10;
-            pathToChicken.resize(nbTiles);
+            pathToChicken.truncate(nbTiles);
         }
 
-        std::vector<Ogre::Vector3> path;
-        creature.tileToVector3(pathToChicken, path, true, 0.0);
-        creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, path);
+        creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, pathToChicken);
         creature.pushAction(Utils::make_unique<CreatureActionWalkToTile>(creature));
         return false;
     }
 
     // We can eat the chicken
     chicken->eatChicken(&creature);
-    creature.foodEaten(ConfigManager::getSingleton().getRoomConfigDouble("HatcheryHungerPerChicken"));
-    creature.setJobCooldown(Random::Int(ConfigManager::getSingleton().getRoomConfigUInt32("HatcheryCooldownChickenMin"),
-        ConfigManager::getSingleton().getRoomConfigUInt32("HatcheryCooldownChickenMax")));
-    creature.setHP(creature.getHP() + ConfigManager::getSingleton().getRoomConfigDouble("HatcheryHpRecoveredPerChicken"));
+    creature.foodEaten(ConfigManager::getSingleton().getRoomConfigDouble(RoomConfig::HatcheryHungerPerChicken));
+    creature.setJobCooldown(Random::Int(ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfig::HatcheryCooldownChickenMin),
+        ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfig::HatcheryCooldownChickenMax)));
+    creature.setHP(creature.getHP() + ConfigManager::getSingleton().getRoomConfigDouble(RoomConfig::HatcheryHpRecoveredPerChicken));
     creature.computeCreatureOverlayHealthValue();
     Ogre::Vector3 walkDirection = Ogre::Vector3(chickenTile->getX(), chickenTile->getY(), 0) - creature.getPosition();
     walkDirection.normalise();
@@ -144,7 +144,7 @@ bool CreatureActionFight::handleFight(Creature& creature, GameEntity* entityAtta
             }
 
             // We need to move
-            std::list<Tile*> result = creature.getGameMap()->path(&creature, tilePosition);
+            TilePath result = creature.getGameMap()->path(&creature, tilePosition);
             if(result.empty())
             {
                 OD_LOG_ERR("name=" + creature.getName() + ", myTile=" + Tile::displayAsString(myTile) + ", dest=" + Tile::displayAsString(tilePosition));
@@ -152,11 +152,9 @@ bool CreatureActionFight::handleFight(Creature& creature, GameEntity* entityAtta
             }
 
             if(result.size() > 3)
-                result.resize(3);
+                result.truncate(3);
 
-            std::vector<Ogre::Vector3> path;
-            creature.tileToVector3(result, path, true, 0.0);
-            creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, path);
+            creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, result);
             creature.pushAction(Utils::make_unique<CreatureActionWalkToTile>(creature));
             return false;
         }
@@ -181,7 +179,7 @@ bool CreatureActionFight::handleFight(Creature& creature, GameEntity* entityAtta
             }
 
             // We need to move to the entity
-            std::list<Tile*> result = creature.getGameMap()->path(&creature, tilePosition);
+            TilePath result = creature.getGameMap()->path(&creature, tilePosition);
             if(result.empty())
             {
                 OD_LOG_ERR("name" + creature.getName() + ", myTile=" + Tile::displayAsString(myTile) + ", dest=" + Tile::displayAsString(tilePosition));
@@ -189,11 +187,9 @@ bool CreatureActionFight::handleFight(Creature& creature, GameEntity* entityAtta
             }
 
             if(result.size() > 3)
-                result.resize(3);
+                result.truncate(3);
 
-            std::vector<Ogre::Vector3> path;
-            creature.tileToVector3(result, path, true, 0.0);
-            creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, path);
+            creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, result);
             creature.pushAction(Utils::make_unique<CreatureActionWalkToTile>(creature));
             return false;
         }
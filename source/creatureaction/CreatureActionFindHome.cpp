@@ -99,7 +99,7 @@ bool CreatureActionFindHome::handleFindHome(Creature& creature, bool forced)
     }
 
     // Check to see if we can walk to a dormitory that does have an open tile.
-    std::vector<Room*> tempRooms = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::dormitory, creature.getSeat());
+    const std::vector<Room*>& tempRooms = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::dormitory, creature.getSeat());
     std::vector<Tile*> availableDormitories;
     for (Room* room : tempRooms)
     {
@@ -136,10 +136,8 @@ bool CreatureActionFindHome::handleFindHome(Creature& creature, bool forced)
     }
 
     Tile* choosenTile = nullptr;
-    std::list<Tile*> tempPath = creature.getGameMap()->findBestPath(&creature, myTile, availableDormitories, choosenTile);
-    std::vector<Ogre::Vector3> path;
-    creature.tileToVector3(tempPath, path, true, 0.0);
-    creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, path);
+    TilePath tempPath = creature.getGameMap()->findBestPath(&creature, myTile, availableDormitories, choosenTile);
+    creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, tempPath);
     creature.pushAction(Utils::make_unique<CreatureActionWalkToTile>(creature));
     return false;
 }
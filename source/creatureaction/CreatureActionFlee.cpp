@@ -54,21 +54,19 @@ bool CreatureActionFlee::handleFlee(Creature& creature, int32_t nbTurns)
     }
 
     // We try to go closer to the dungeon temple. If we are too near or if we cannot go there, we will flee randomly
-    std::vector<Room*> tempRooms = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::dungeonTemple, creature.getSeat());
-    tempRooms = creature.getGameMap()->getReachableRooms(tempRooms, myTile, &creature);
+    const std::vector<Room*>& tempRooms = creature.getGameMap()->getReachableRoomsByTypeAndSeat(RoomType::dungeonTemple,
+        creature.getSeat(), myTile, &creature);
     if(!tempRooms.empty())
     {
         // We can go to one dungeon temple
         Room* room = tempRooms[Random::Int(0, tempRooms.size() - 1)];
         Tile* tile = room->getCoveredTile(0);
-        std::list<Tile*> result = creature.getGameMap()->path(&creature, tile);
+        TilePath result = creature.getGameMap()->path(&creature, tile);
         // If we are not too near from the dungeon temple, we go there
         if(result.size() > 5)
         {
-            result.resize(5);
-            std::vector<Ogre::Vector3> path;
-            creature.tileToVector3(result, path, true, 0.0);
-            creature.setWalkPath(EntityAnimation::flee_anim, EntityAnimation::idle_anim, true, true, path);
+            result.truncate(5);
+            creature.setWalkPath(EntityAnimation::flee_anim, EntityAnimation::idle_anim, true, true, result);
             creature.pushAction(Utils::make_unique<CreatureActionWalkToTile>(creature));
             return false;
         }
@@ -102,7 +102,7 @@ bool CreatureActionGetFee::handleGetFee(Creature& creature)
     }
 
     Tile* chosenTile = nullptr;
-    std::list<Tile*> tilePath = creature.getGameMap()->findBestPath(&creature, myTile,
+    TilePath tilePath = creature.getGameMap()->findBestPath(&creature, myTile,
         availableTreasuries, chosenTile);
 
     if(tilePath.empty() || (chosenTile == nullptr))
@@ -112,9 +112,7 @@ bool CreatureActionGetFee::handleGetFee(Creature& creature)
         return true;
     }
 
-    std::vector<Ogre::Vector3> vectorPath;
-    creature.tileToVector3(tilePath, vectorPath, true, 0.0);
-    creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, vectorPath);
+    creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, tilePath);
     creature.pushAction(Utils::make_unique<CreatureActionWalkToTile>(creature));
     return false;
 }
@@ -84,7 +84,7 @@ bool CreatureActionGrabEntity::handleGrabEntity(Creature& creature, GameEntity*
     }
 
     // We try to find a building that wants the entity
-    std::vector<Building*> buildings = creature.getGameMap()->getReachableBuildingsPerSeat(creature.getSeat(), myTile, &creature);
+    const std::vector<Building*>& buildings = creature.getGameMap()->getReachableBuildingsPerSeat(creature.getSeat(), myTile, &creature);
     std::vector<Tile*> tilesDest;
     for(Building* building : buildings)
     {
@@ -69,8 +69,8 @@ bool CreatureActionLeaveDungeon::handleLeaveDungeon(Creature& creature)
     }
 
     // We try to go to the portal
-    std::vector<Room*> tempRooms = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::portal, creature.getSeat());
-    tempRooms = creature.getGameMap()->getReachableRooms(tempRooms, myTile, &creature);
+    const std::vector<Room*>& tempRooms = creature.getGameMap()->getReachableRoomsByTypeAndSeat(RoomType::portal,
+        creature.getSeat(), myTile, &creature);
     if(tempRooms.empty())
     {
         creature.popAction();
@@ -95,7 +95,7 @@ bool CreatureActionSearchFood::handleSearchFood(Creature& creature, bool forced)
 
     // We couldn't find a wandering chicken. We look for a room where we can eat
     // Get the list of hatchery controlled by our seat and make sure there is at least one.
-    std::vector<Room*> hatcheries = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::hatchery, creature.getSeat());
+    const std::vector<Room*>& hatcheries = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::hatchery, creature.getSeat());
     if (hatcheries.empty())
     {
         if((creature.getSeat()->getPlayer() != nullptr) &&
@@ -144,7 +144,7 @@ bool CreatureActionSearchFood::handleSearchFood(Creature& creature, bool forced)
     }
 
     Tile* chosenTile = nullptr;
-    std::list<Tile*> pathToHatchery = creature.getGameMap()->findBestPath(&creature, myTile, hatcheriesTiles, chosenTile);
+    TilePath pathToHatchery = creature.getGameMap()->findBestPath(&creature, myTile, hatcheriesTiles, chosenTile);
     if(chosenTile == nullptr)
     {
         // We couldn't find a path !
@@ -19,6 +19,7 @@
 
 #include "creatureaction/CreatureActionClaimGroundTile.h"
 #include "entities/Creature.h"
+#include "entities/CreatureDefinition.h"
 #include "entities/Tile.h"
 #include "game/Player.h"
 #include "game/Seat.h"
@@ -125,14 +126,15 @@ bool CreatureActionSearchGroundTileToClaim::handleSearchGroundTileToClaim(Creatu
         }
     }
 
-    // If we still haven't found a tile to claim, we try to take the closest one
+    // If we still haven't found a tile to claim, we try to take the closest one. We look in the seat
+    // job board for the claimable tiles within our sight radius
     float distBest = -1;
     Tile* tileToClaim = nullptr;
-    for (Tile* tile : creature.getTilesWithinSightRadius())
+    std::vector<Tile*> claimJobs;
+    creature.getSeat()->fillClaimJobs(*myTile, creature.getDefinition()->getSightRadius(), claimJobs);
+    for (Tile* tile : claimJobs)
     {
         // if this tile is not fully claimed yet or the tile is of another player's color
-        if(tile == nullptr)
-            continue;
         if(tile->isFullTile())
             continue;
         if(!tile->isGroundClaimable(creature.getSeat()))
@@ -194,14 +194,12 @@ bool CreatureActionSearchJob::handleSearchJob(Creature& creature, bool forced)
             continue;
 
         Tile* chosenTile = nullptr;
-        std::list<Tile*> tilePath = creature.getGameMap()->findBestPath(&creature, myTile, rooms, chosenTile);
+        TilePath tilePath = creature.getGameMap()->findBestPath(&creature, myTile, rooms, chosenTile);
 
         if(tilePath.empty() || (chosenTile == nullptr))
             continue;
 
-        std::vector<Ogre::Vector3> vectorPath;
-        creature.tileToVector3(tilePath, vectorPath, true, 0.0);
-        creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, vectorPath);
+        creature.setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, tilePath);
         creature.pushAction(Utils::make_unique<CreatureActionWalkToTile>(creature));
         return false;
     }
@@ -20,6 +20,7 @@
 #include "creatureaction/CreatureActionDigTile.h"
 #include "creatureaction/CreatureActionGrabEntity.h"
 #include "entities/Creature.h"
+#include "entities/CreatureDefinition.h"
 #include "entities/Tile.h"
 #include "entities/TreasuryObject.h"
 #include "game/Player.h"
@@ -75,6 +76,7 @@ bool CreatureActionSearchTileToDig::handleSearchTileToDig(Creature& creature, in
 
     // See if any of the tiles is one of our neighbors
     Player* tempPlayer = creature.getGameMap()->getPlayerBySeat(creature.getSeat());
+    std::vector<Tile*> tiles;
     for (Tile* tempTile : myTile->getAllNeighbors())
     {
         if (tempPlayer == nullptr)
@@ -84,7 +86,7 @@ bool CreatureActionSearchTileToDig::handleSearchTileToDig(Creature& creature, in
             continue;
 
         // Check if there is still empty space for digging the tile
-        std::vector<Tile*> tiles;
+        tiles.clear();
         tempTile->canWorkerDig(creature, tiles);
         if(tiles.empty())
             continue;
@@ -108,18 +110,16 @@ bool CreatureActionSearchTileToDig::handleSearchTileToDig(Creature& creature, in
         return true;
     }
 
-    // Find the closest tile to dig
+    // Find the closest tile to dig. We look in the seat job board for the marked tiles within our sight radius
     float distBest = -1;
     Tile* tileToDig = nullptr;
     Tile* tilePos = nullptr;
-    for (Tile* tile : creature.getTilesWithinSightRadius())
+    std::vector<Tile*> digJobs;
+    creature.getSeat()->fillDigJobs(*myTile, creature.getDefinition()->getSightRadius(), digJobs);
+    for (Tile* tile : digJobs)
     {
-        // Check to see whether the tile is marked for digging
-        if(!tile->getMarkedForDigging(tempPlayer))
-            continue;
-
-        // and there is still room to work on it
-        std::vector<Tile*> tiles;
+        // Check if there is still room to work on it
+        tiles.clear();
         tile->canWorkerDig(creature, tiles);
         if(tiles.empty())
             continue;
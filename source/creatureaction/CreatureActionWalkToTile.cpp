@@ -29,7 +29,8 @@ std::function<bool()> CreatureActionWalkToTile::action()
 
 bool CreatureActionWalkToTile::handleWalkToTile(Creature& creature)
 {
-    if (creature.isMoving())
+    // The path asked by setDestination is set after the creatures upkeep
+    if (creature.isMoving() || creature.isWaitingForPath())
         return false;
 
     creature.popAction();
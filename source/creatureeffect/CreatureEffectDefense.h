@@ -19,8 +19,9 @@
 #define CREATUREEFFECTDEFENSE_H
 
 #include "creatureeffect/CreatureEffect.h"
+#include "utils/ObjectPool.h"
 
-class CreatureEffectDefense : public CreatureEffect
+class CreatureEffectDefense : public CreatureEffect, public PooledObject<CreatureEffectDefense>
 {
 public:
     CreatureEffectDefense(uint32_t nbTurnsEffect, double phy, double mag, double ele, const std::string& particleEffectName) :
@@ -19,8 +19,9 @@
 #define CREATUREEFFECTEXPLOSION_H
 
 #include "creatureeffect/CreatureEffect.h"
+#include "utils/ObjectPool.h"
 
-class CreatureEffectExplosion : public CreatureEffect
+class CreatureEffectExplosion : public CreatureEffect, public PooledObject<CreatureEffectExplosion>
 {
 public:
     CreatureEffectExplosion(uint32_t nbTurnsEffect, double effectValue, const std::string& particleEffectName) :
@@ -19,8 +19,9 @@
 #define CREATUREEFFECTHEAL_H
 
 #include "creatureeffect/CreatureEffect.h"
+#include "utils/ObjectPool.h"
 
-class CreatureEffectHeal : public CreatureEffect
+class CreatureEffectHeal : public CreatureEffect, public PooledObject<CreatureEffectHeal>
 {
 public:
     CreatureEffectHeal(uint32_t nbTurnsEffect, double effectValue, const std::string& particleEffectName) :
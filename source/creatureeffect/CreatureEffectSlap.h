@@ -19,8 +19,9 @@
 #define CREATUREEFFECTSLAP_H
 
 #include "creatureeffect/CreatureEffect.h"
+#include "utils/ObjectPool.h"
 
-class CreatureEffectSlap : public CreatureEffect
+class CreatureEffectSlap : public CreatureEffect, public PooledObject<CreatureEffectSlap>
 {
 public:
     CreatureEffectSlap(uint32_t nbTurnsEffect, const std::string& particleEffectScript) :
@@ -19,8 +19,9 @@
 #define CREATUREEFFECTSPEEDCHANGE_H
 
 #include "creatureeffect/CreatureEffect.h"
+#include "utils/ObjectPool.h"
 
-class CreatureEffectSpeedChange : public CreatureEffect
+class CreatureEffectSpeedChange : public CreatureEffect, public PooledObject<CreatureEffectSpeedChange>
 {
 public:
     CreatureEffectSpeedChange(uint32_t nbTurnsEffect, double effectValue, const std::string& particleEffectName) :
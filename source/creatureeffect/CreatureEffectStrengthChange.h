@@ -19,8 +19,9 @@
 #define CREATUREEFFECTSTRENGTHCHANGE_H
 
 #include "creatureeffect/CreatureEffect.h"
+#include "utils/ObjectPool.h"
 
-class CreatureEffectStrengthChange : public CreatureEffect
+class CreatureEffectStrengthChange : public CreatureEffect, public PooledObject<CreatureEffectStrengthChange>
 {
 public:
     CreatureEffectStrengthChange(uint32_t nbTurnsEffect, double effectValue, const std::string& particleEffectName) :
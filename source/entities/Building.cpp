@@ -18,6 +18,7 @@
 #include "entities/Building.h"
 
 #include "entities/BuildingObject.h"
+#include "entities/GameEntityType.h"
 #include "entities/RenderedMovableEntity.h"
 #include "entities/Tile.h"
 #include "game/Player.h"
@@ -25,11 +26,62 @@
 #include "gamemap/GameMap.h"
 #include "network/ODServer.h"
 #include "render/RenderManager.h"
+#include "rooms/Room.h"
+#include "rooms/RoomType.h"
+#include "traps/Trap.h"
+#include "traps/TrapType.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
+#include <sstream>
+
 const double Building::DEFAULT_TILE_HP = 10.0;
 
+BuildingTileSaveRecord::BuildingTileSaveRecord() :
+    mX(-1),
+    mY(-1),
+    mHP(0.0),
+    mIsActivated(false),
+    mReloadTime(0),
+    mNbShootsBeforeDeactivation(0),
+    mClaimedValue(0.0)
+{
+}
+
+BuildingSaveRecord::BuildingSaveRecord() :
+    mObjectType(GameEntityType::room),
+    mRoomType(RoomType::nullRoomType),
+    mTrapType(TrapType::nullTrapType),
+    mSeatId(-1),
+    mIsEditorMode(false)
+{
+}
+
+void BuildingSaveRecord::exportHeadersToStream(std::ostream& os) const
+{
+    if(mObjectType == GameEntityType::trap)
+        os << mTrapType << "\t";
+    else
+        os << mRoomType << "\t";
+}
+
+void BuildingSaveRecord::exportToStream(std::ostream& os) const
+{
+    uint32_t nbTiles = mTiles.size();
+    os << mName << "\t" << mSeatId << "\t" << nbTiles << "\n";
+    for(const BuildingTileSaveRecord& tile : mTiles)
+    {
+        os << tile.mX << "\t" << tile.mY;
+        if(mObjectType == GameEntityType::trap)
+            Trap::exportTileSaveRecordToStream(os, tile, mIsEditorMode);
+        else
+            Room::exportTileSaveRecordToStream(os, tile, mIsEditorMode);
+        os << "\n";
+    }
+
+    os << mSpecificData;
+}
+
 Building::~Building()
 {
     for(std::pair<Tile* const, TileData*>& p : mTileData)
@@ -209,6 +261,7 @@ bool Building::removeCoveredTile(Tile* t)
     mCoveredTilesDestroyed.push_back(t);
     mTileData[t]->mHP = 0.0;
     t->setCoveringBuilding(nullptr);
+    getGameMap()->notifyBuildingsChanged();
 
     return true;
 }
@@ -238,7 +291,7 @@ double Building::getHP(Tile *tile) const
 {
     if (tile != nullptr)
     {
-        std::map<Tile*, TileData*>::const_iterator tileSearched = mTileData.find(tile);
+        TileDataMap::const_iterator tileSearched = mTileData.find(tile);
         if(tileSearched == mTileData.end())
         {
             OD_LOG_ERR("couldn't find requested tile=" + Tile::displayAsString(tile));
@@ -295,7 +348,10 @@ double Building::takeDamage(GameEntity* attacker, double absoluteDamage, double
     }
 
     if(!isAlive)
+    {
+        getGameMap()->notifyBuildingsChanged();
         fireEntityDead();
+    }
 
     Player* player = getSeat()->getPlayer();
     if (player == nullptr)
@@ -331,16 +387,20 @@ bool Building::canSeatSellBuilding(Seat* seat) const
 
 void Building::exportToStream(std::ostream& os) const
 {
-    const std::string& name = getName();
-    int seatId = getSeat()->getId();
-    bool isEditorMode = getGameMap()->isInEditorMode();
-    uint32_t nbTiles;
-    if(isEditorMode)
-        nbTiles = mCoveredTiles.size();
-    else
-        nbTiles = mCoveredTiles.size() + mCoveredTilesDestroyed.size();
+    BuildingSaveRecord record;
+    fillSaveRecord(record);
+    record.exportToStream(os);
+}
 
-    os << name << "\t" << seatId << "\t" << nbTiles << "\n";
+void Building::fillSaveRecord(BuildingSaveRecord& record) const
+{
+    record.mObjectType = getObjectType();
+    record.mName = getName();
+    record.mSeatId = getSeat()->getId();
+    record.mIsEditorMode = getGameMap()->isInEditorMode();
+
+    record.mTiles.clear();
+    record.mTiles.reserve(mCoveredTiles.size() + mCoveredTilesDestroyed.size());
     for(Tile* tile : mCoveredTiles)
     {
         auto it = mTileData.find(tile);
@@ -349,29 +409,35 @@ void Building::exportToStream(std::ostream& os) const
             OD_LOG_ERR("building=" + getName() + ", tile=" + Tile::displayAsString(tile));
             continue;
         }
-        TileData* tileData = it->second;
-        os << tile->getX() << "\t" << tile->getY();
-        exportTileDataToStream(os, tile, tileData);
-        os << "\n";
+        record.mTiles.push_back(BuildingTileSaveRecord());
+        BuildingTileSaveRecord& tileRecord = record.mTiles.back();
+        tileRecord.mX = tile->getX();
+        tileRecord.mY = tile->getY();
+        fillTileSaveRecord(tile, it->second, tileRecord);
     }
 
     // In editor mode, we don't export destroyed tiles (there might be some if buildings have been deleted)
-    if(isEditorMode)
-        return;
-
-    for(Tile* tile : mCoveredTilesDestroyed)
+    if(!record.mIsEditorMode)
     {
-        auto it = mTileData.find(tile);
-        if(it == mTileData.end())
+        for(Tile* tile : mCoveredTilesDestroyed)
         {
-            OD_LOG_ERR("building=" + getName() + ", tile=" + Tile::displayAsString(tile));
-            continue;
+            auto it = mTileData.find(tile);
+            if(it == mTileData.end())
+            {
+                OD_LOG_ERR("building=" + getName() + ", tile=" + Tile::displayAsString(tile));
+                continue;
+            }
+            record.mTiles.push_back(BuildingTileSaveRecord());
+            BuildingTileSaveRecord& tileRecord = record.mTiles.back();
+            tileRecord.mX = tile->getX();
+            tileRecord.mY = tile->getY();
+            fillTileSaveRecord(tile, it->second, tileRecord);
         }
-        TileData* tileData = it->second;
-        os << tile->getX() << "\t" << tile->getY();
-        exportTileDataToStream(os, tile, tileData);
-        os << "\n";
     }
+
+    std::ostringstream specificData;
+    exportSpecificDataToStream(specificData);
+    record.mSpecificData = specificData.str();
 }
 
 bool Building::importFromStream(std::istream& is)
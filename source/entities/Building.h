@@ -24,6 +24,8 @@
 #define BUILDING_H_
 
 #include "entities/GameEntity.h"
+#include "entities/TileDataMap.h"
+#include "utils/ObjectPool.h"
 
 class BuildingObject;
 class GameMap;
@@ -32,7 +34,13 @@ class Room;
 class Seat;
 class Trap;
 
-class TileData
+enum class RoomType;
+enum class TrapType;
+
+//! \brief Data kept by a building for each of its tiles. TileData and its subclasses are allocated from
+//! object pools so that the data of the tiles of a building are close to each other in memory. Subclasses
+//! should derive from PooledObject too and bring its operators into scope (see TrapTileData)
+class TileData : public PooledObject<TileData>
 {
 public:
     TileData() :
@@ -55,6 +63,51 @@ public:
     std::vector<Seat*> mSeatsVision;
 };
 
+//! \brief Plain copy of the data of a building tile written in level files (see BuildingSaveRecord)
+class BuildingTileSaveRecord
+{
+public:
+    BuildingTileSaveRecord();
+
+    int mX;
+    int mY;
+    double mHP;
+    //! \brief Ids of the enemy seats with vision on the tile
+    std::vector<int> mSeatsVision;
+    //! \brief Trap tiles only
+    bool mIsActivated;
+    uint32_t mReloadTime;
+    int32_t mNbShootsBeforeDeactivation;
+    double mClaimedValue;
+};
+
+//! \brief Plain copy of the room or trap data written in level files. It is filled by the thread owning the
+//! game map and can then be written by any thread (see MapFileWriter)
+class BuildingSaveRecord
+{
+public:
+    BuildingSaveRecord();
+
+    //! \brief Writes the record like Room::exportHeadersToStream or Trap::exportHeadersToStream
+    void exportHeadersToStream(std::ostream& os) const;
+    //! \brief Writes the record like Building::exportToStream
+    void exportToStream(std::ostream& os) const;
+
+    //! \brief GameEntityType::room or GameEntityType::trap. Only the matching type is used
+    GameEntityType mObjectType;
+    RoomType mRoomType;
+    TrapType mTrapType;
+    std::string mName;
+    int mSeatId;
+    //! \brief In editor mode, only the tiles coordinates (and activation for traps) are written
+    bool mIsEditorMode;
+    //! \brief Covered tiles followed by the destroyed ones
+    std::vector<BuildingTileSaveRecord> mTiles;
+    //! \brief Data specific to the building type, already written with exportSpecificDataToStream. It is
+    //! small and not plain data for some types (creatures in a prison, waves of a portal, ...)
+    std::string mSpecificData;
+};
+
 /*! \class Building
  *  \brief This class holds elements that are common to Building like Rooms or Traps
  *
@@ -170,12 +223,20 @@ public:
     virtual void exportToStream(std::ostream& os) const override;
     virtual bool importFromStream(std::istream& is) override;
 
+    //! \brief Copies the data written by exportToStream (see BuildingSaveRecord). Subclasses should
+    //! set the building type
+    virtual void fillSaveRecord(BuildingSaveRecord& record) const;
+
 protected:
-    //! \brief Allows to export/import specific data for child classes. Note that every tile
-    //! should be exported on 1 line (thus, no line ending should be added here). Moreover
-    //! the building will only export the tile coords. Exporting other relevant data is
-    //! up to the subclass
-    virtual void exportTileDataToStream(std::ostream& os, Tile* tile, TileData* tileData) const
+    //! \brief Allows child classes to copy the data of each tile. The building only copies the tile
+    //! coords. Copying other relevant data is up to the subclass. The tile data is written from the
+    //! record (see BuildingSaveRecord::exportToStream)
+    virtual void fillTileSaveRecord(Tile* tile, TileData* tileData, BuildingTileSaveRecord& record) const
+    {}
+
+    //! \brief Allows child classes to export specific data after the tiles. It is written when the
+    //! record is filled (see BuildingSaveRecord::mSpecificData)
+    virtual void exportSpecificDataToStream(std::ostream& os) const
     {}
 
     //! \brief importTileDataFromStream should add the tile to covered or destroyed tiles vector and,
@@ -201,7 +262,7 @@ protected:
     std::map<Tile*, BuildingObject*> mBuildingObjects;
     std::vector<Tile*> mCoveredTiles;
     std::vector<Tile*> mCoveredTilesDestroyed;
-    std::map<Tile*, TileData*> mTileData;
+    TileDataMap mTileData;
 };
 
 #endif // BUILDING_H_
@@ -21,11 +21,7 @@
 #include "entities/GameEntityType.h"
 #include "entities/Tile.h"
 #include "network/ODPacket.h"
-#include "game/Player.h"
-#include "game/Seat.h"
 #include "gamemap/GameMap.h"
-#include "network/ODServer.h"
-#include "network/ServerNotification.h"
 #include "traps/TrapBoulder.h"
 #include "traps/TrapCannon.h"
 #include "traps/TrapSpike.h"
@@ -114,25 +110,3 @@ void BuildingObject::addParticleEffect(const std::string& effectScript, uint32_t
     EntityParticleEffect* effect = new EntityParticleEffect(nextParticleSystemsName(), effectScript, nbTurns);
     mEntityParticleEffects.push_back(effect);
 }
-
-void BuildingObject::fireRefresh()
-{
-    for(Seat* seat : mSeatsWithVisionNotified)
-    {
-        if(seat->getPlayer() == nullptr)
-            continue;
-        if(!seat->getPlayer()->getIsHuman())
-            continue;
-
-        const std::string& name = getName();
-        ServerNotification *serverNotification = new ServerNotification(
-            ServerNotificationType::entitiesRefresh, seat->getPlayer());
-        uint32_t nb = 1;
-        GameEntityType entityType = getObjectType();
-        serverNotification->mPacket << nb;
-        serverNotification->mPacket << entityType;
-        serverNotification->mPacket << name;
-        exportToPacketForUpdate(serverNotification->mPacket, seat);
-        ODServer::getSingleton().queueServerNotification(serverNotification);
-    }
-}
@@ -19,6 +19,7 @@
 #define CHICKENENTITY_H
 
 #include "entities/RenderedMovableEntity.h"
+#include "utils/ObjectPool.h"
 
 #include <string>
 #include <iosfwd>
@@ -29,7 +30,7 @@ class GameMap;
 class Tile;
 class ODPacket;
 
-class ChickenEntity: public RenderedMovableEntity
+class ChickenEntity: public RenderedMovableEntity, public PooledObject<ChickenEntity>
 {
 public:
     ChickenEntity(GameMap* gameMap, const std::string& hatcheryName);
@@ -88,6 +88,7 @@
 
 #include <cmath>
 #include <algorithm>
+#include <sstream>
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
 #define snprintf_is_banned_in_OD_code _snprintf
@@ -117,6 +118,41 @@ enum CreatureMoodEnum
     MoodPrisonFiltersPrisonAllies = KoTemp | InJail
 };
 
+CreatureSaveRecord::CreatureSaveRecord() :
+    mSeatId(-1),
+    mPosition(Ogre::Vector3::ZERO),
+    mLevel(0),
+    mExp(0.0),
+    mHp(0.0),
+    mMaxHP(0.0),
+    mWakefulness(0.0),
+    mHunger(0.0),
+    mGoldCarried(0),
+    mSkillTypeDropDeath(SkillType::nullSkillType),
+    mNbEffects(0)
+{
+}
+
+void CreatureSaveRecord::exportToStream(std::ostream& os) const
+{
+    GameEntity::exportToStream(mSeatId, mName, mMeshName, mPosition, os);
+    os << mClassName << "\t";
+    os << mLevel << "\t" << mExp << "\t";
+    if(mHp < mMaxHP)
+        os << mHp;
+    else
+        os << "max";
+    os << "\t" << mWakefulness << "\t" << mHunger << "\t" << mGoldCarried;
+    os << "\t" << mWeaponL;
+    os << "\t" << mWeaponR;
+    os << "\t" << Skills::toString(mSkillTypeDropDeath);
+    os << "\t" << mWeaponDropDeath;
+
+    os << "\t" << mNbEffects;
+    for(const std::string& effect : mEffects)
+        os << "\t" << effect;
+}
+
 CreatureParticuleEffect::CreatureParticuleEffect(Creature& creature, const std::string& name, const std::string& script, uint32_t nbTurnsEffect,
         CreatureEffect* effect) :
     EntityParticleEffect(name, script, nbTurnsEffect),
@@ -153,6 +189,9 @@ Creature::Creature(GameMap* gameMap, const CreatureDefinition* definition, Seat*
     mWeaponR                 (nullptr),
     mHomeTile                (nullptr),
     mDefinition              (definition),
+    mDefinitionNetworkId     (NetworkIdTable::NoName),
+    mWeaponLNetworkId        (NetworkIdTable::NoName),
+    mWeaponRNetworkId        (NetworkIdTable::NoName),
     mHasVisualDebuggingEntities (false),
     mWakefulness             (100.0),
     mHunger                  (0.0),
@@ -181,14 +220,14 @@ Creature::Creature(GameMap* gameMap, const CreatureDefinition* definition, Seat*
     mOverlayHealthValue      (0),
     mOverlayMoodValue        (0),
     mOverlayStatus           (nullptr),
-    mNeedFireRefresh         (false),
     mDropCooldown            (0),
     mSpeedModifier           (1.0),
     mKoTurnCounter           (0),
     mSeatPrison              (nullptr),
     mNbTurnsTorture          (0),
     mNbTurnsPrison           (0),
-    mActiveSlapsCount        (0)
+    mActiveSlapsCount        (0),
+    mSeatCounted             (nullptr)
 
 {
     //TODO: This should be set in initialiser list in parent classes
@@ -231,6 +270,9 @@ Creature::Creature(GameMap* gameMap) :
     mWeaponR                 (nullptr),
     mHomeTile                (nullptr),
     mDefinition              (nullptr),
+    mDefinitionNetworkId     (NetworkIdTable::NoName),
+    mWeaponLNetworkId        (NetworkIdTable::NoName),
+    mWeaponRNetworkId        (NetworkIdTable::NoName),
     mHasVisualDebuggingEntities (false),
     mWakefulness             (100.0),
     mHunger                  (0.0),
@@ -259,14 +301,14 @@ Creature::Creature(GameMap* gameMap) :
     mOverlayHealthValue      (0),
     mOverlayMoodValue        (0),
     mOverlayStatus           (nullptr),
-    mNeedFireRefresh         (false),
     mDropCooldown            (0),
     mSpeedModifier           (1.0),
     mKoTurnCounter           (0),
     mSeatPrison              (nullptr),
     mNbTurnsTorture          (0),
     mNbTurnsPrison           (0),
-    mActiveSlapsCount        (0)
+    mActiveSlapsCount        (0),
+    mSeatCounted             (nullptr)
 {
 }
 
@@ -338,6 +380,9 @@ void Creature::addToGameMap()
         return;
 
     getGameMap()->addActiveObject(this);
+
+    if(isAlive())
+        setSeatCounted(getSeat());
 }
 
 void Creature::removeFromGameMap()
@@ -351,6 +396,8 @@ void Creature::removeFromGameMap()
     if(!getIsOnServerMap())
         return;
 
+    setSeatCounted(nullptr);
+
     // If the creature has a homeTile where it sleeps, its bed needs to be destroyed.
     if (getHomeTile() != nullptr)
     {
@@ -377,32 +424,46 @@ std::string Creature::getCreatureStreamFormat()
 
 void Creature::exportToStream(std::ostream& os) const
 {
-    MovableGameEntity::exportToStream(os);
-    os << mDefinition->getClassName() << "\t";
-    os << getLevel() << "\t" << mExp << "\t";
-    if(getHP() < mMaxHP)
-        os << getHP();
-    else
-        os << "max";
-    os << "\t" << mWakefulness << "\t" << mHunger << "\t" << mGoldCarried;
+    // The data is the one of MovableGameEntity::exportToStream followed by the creature data
+    CreatureSaveRecord record;
+    fillSaveRecord(record);
+    record.exportToStream(os);
+}
+
+void Creature::fillSaveRecord(CreatureSaveRecord& record) const
+{
+    record.mSeatId = -1;
+    if(getSeat() != nullptr)
+        record.mSeatId = getSeat()->getId();
+
+    record.mName = getName();
+    record.mMeshName = getMeshName();
+    record.mPosition = getPosition();
+    record.mClassName = mDefinition->getClassName();
+    record.mLevel = getLevel();
+    record.mExp = mExp;
+    record.mHp = getHP();
+    record.mMaxHP = mMaxHP;
+    record.mWakefulness = mWakefulness;
+    record.mHunger = mHunger;
+    record.mGoldCarried = mGoldCarried;
 
     // Check creature weapons
     if(mWeaponL != nullptr)
-        os << "\t" << mWeaponL->getName();
+        record.mWeaponL = mWeaponL->getName();
     else
-        os << "\tnone";
+        record.mWeaponL = "none";
 
     if(mWeaponR != nullptr)
-        os << "\t" << mWeaponR->getName();
+        record.mWeaponR = mWeaponR->getName();
     else
-        os << "\tnone";
+        record.mWeaponR = "none";
 
-    os << "\t" << Skills::toString(mSkillTypeDropDeath);
-
-    os << "\t" << mWeaponDropDeath;
+    record.mSkillTypeDropDeath = mSkillTypeDropDeath;
+    record.mWeaponDropDeath = mWeaponDropDeath;
 
-    uint32_t nbEffects = mEntityParticleEffects.size();
-    os << "\t" << nbEffects;
+    record.mNbEffects = mEntityParticleEffects.size();
+    record.mEffects.clear();
     for(EntityParticleEffect* effect : mEntityParticleEffects)
     {
         // We only save creature particle effects. The other are expected to be re-created
@@ -411,8 +472,9 @@ void Creature::exportToStream(std::ostream& os) const
             continue;
 
         CreatureParticuleEffect* creatureParticuleEffect = static_cast<CreatureParticuleEffect*>(effect);
-        os << "\t";
-        CreatureEffectManager::write(*creatureParticuleEffect->mEffect, os);
+        std::ostringstream effectStream;
+        CreatureEffectManager::write(*creatureParticuleEffect->mEffect, effectStream);
+        record.mEffects.push_back(effectStream.str());
     }
 }
 
@@ -538,8 +600,7 @@ Creature* Creature::getCreatureFromPacket(GameMap* gameMap, ODPacket& is)
 void Creature::exportToPacket(ODPacket& os, const Seat* seat) const
 {
     MovableGameEntity::exportToPacket(os, seat);
-    const std::string& className = mDefinition->getClassName();
-    os << className;
+    os << mDefinitionNetworkId;
     os << mLevel;
     os << mExp;
 
@@ -575,23 +636,23 @@ void Creature::exportToPacket(ODPacket& os, const Seat* seat) const
     os << moodValue;
     os << mSpeedModifier;
 
-    if(mWeaponL != nullptr)
-        os << mWeaponL->getName();
-    else
-        os << "none";
-
-    if(mWeaponR != nullptr)
-        os << mWeaponR->getName();
-    else
-        os << "none";
+    os << mWeaponLNetworkId;
+    os << mWeaponRNetworkId;
 }
 
 void Creature::importFromPacket(ODPacket& is)
 {
     MovableGameEntity::importFromPacket(is);
-    std::string tempString;
 
-    OD_ASSERT_TRUE(is >> mDefinitionString);
+    // The definition is set here from its id. For the default worker, setupDefinition will pick the seat worker
+    uint32_t definitionId;
+    OD_ASSERT_TRUE(is >> definitionId);
+    if(definitionId == NetworkIdTable::DefaultWorkerClassId)
+        mDefinitionString = ConfigManager::DefaultWorkerCreatureDefinition;
+    else if(definitionId < getGameMap()->numClassDescriptions())
+        mDefinition = getGameMap()->getClassDescription(static_cast<int>(definitionId));
+    else
+        OD_LOG_ERR("Unknown creature class id=" + Helper::toString(definitionId));
 
     OD_ASSERT_TRUE(is >> mLevel);
     OD_ASSERT_TRUE(is >> mExp);
@@ -616,24 +677,23 @@ void Creature::importFromPacket(ODPacket& is)
     OD_ASSERT_TRUE(is >> mOverlayMoodValue);
     OD_ASSERT_TRUE(is >> mSpeedModifier);
 
-    OD_ASSERT_TRUE(is >> tempString);
-    if(tempString != "none")
+    uint32_t weaponId;
+    OD_ASSERT_TRUE(is >> weaponId);
+    if(weaponId != NetworkIdTable::NoName)
     {
-        mWeaponL = getGameMap()->getWeapon(tempString);
-        if(mWeaponL == nullptr)
-        {
-            OD_LOG_ERR("Unknown weapon name=" + tempString);
-        }
+        if(weaponId < getGameMap()->numWeapons())
+            mWeaponL = getGameMap()->getWeapon(static_cast<int>(weaponId));
+        else
+            OD_LOG_ERR("Unknown weapon id=" + Helper::toString(weaponId));
     }
 
-    OD_ASSERT_TRUE(is >> tempString);
-    if(tempString != "none")
+    OD_ASSERT_TRUE(is >> weaponId);
+    if(weaponId != NetworkIdTable::NoName)
     {
-        mWeaponR = getGameMap()->getWeapon(tempString);
-        if(mWeaponR == nullptr)
-        {
-            OD_LOG_ERR("Unknown weapon name=" + tempString);
-        }
+        if(weaponId < getGameMap()->numWeapons())
+            mWeaponR = getGameMap()->getWeapon(static_cast<int>(weaponId));
+        else
+            OD_LOG_ERR("Unknown weapon id=" + Helper::toString(weaponId));
     }
 
     setupDefinition(*getGameMap(), *ConfigManager::getSingleton().getCreatureDefinitionDefaultWorker());
@@ -653,6 +713,7 @@ void Creature::setHP(double nHP)
     else
         mHp = nHP;
 
+    uncountIfDead();
     computeCreatureOverlayHealthValue();
 }
 
@@ -723,7 +784,7 @@ void Creature::setLevel(unsigned int level)
 
     buildStats();
 
-    mNeedFireRefresh = true;
+    setNeedFireRefresh();
 }
 
 void Creature::dropCarriedEquipment()
@@ -787,7 +848,7 @@ void Creature::doUpkeep()
         {
             // it is not standing on a jail. It is free
             mSeatPrison = nullptr;
-            mNeedFireRefresh = true;
+            setNeedFireRefresh();
         }
     }
 
@@ -843,6 +904,7 @@ void Creature::doUpkeep()
             return;
 
         mHp = 0;
+        uncountIfDead();
         computeCreatureOverlayHealthValue();
         computeCreatureOverlayMoodValue();
     }
@@ -1101,13 +1163,11 @@ bool Creature::handleIdleAction()
             uint32_t index = Random::Uint(0,reachableCallToWars.size()-1);
             Spell* callToWar = reachableCallToWars[index];
             Tile* callToWarTile = callToWar->getPositionTile();
-            std::list<Tile*> tempPath = getGameMap()->path(this, callToWarTile);
+            TilePath tempPath = getGameMap()->path(this, callToWarTile);
             // If we are 5 tiles from the call to war, we don't go there
             if(tempPath.size() >= 5)
             {
-                std::vector<Ogre::Vector3> path;
-                tileToVector3(tempPath, path, true, 0.0);
-                setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, path);
+                setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, tempPath);
                 pushAction(Utils::make_unique<CreatureActionWalkToTile>(*this));
                 return false;
             }
@@ -1350,7 +1410,7 @@ bool Creature::searchBestTargetInList(const std::vector<GameEntity*>& listObject
         int bestScoreAttack = -1;
         std::vector<Tile*> tiles;
         if(tilesFilter.empty())
-            tiles = getGameMap()->visibleTiles(tileAttackCheck->getX(), tileAttackCheck->getY(), skillRangeMaxInt);
+            getGameMap()->visibleTiles(tileAttackCheck->getX(), tileAttackCheck->getY(), skillRangeMaxInt, tiles);
         else
         {
             float radiusSquared = skillRangeMaxInt * skillRangeMaxInt;
@@ -1406,7 +1466,7 @@ bool Creature::searchBestTargetInList(const std::vector<GameEntity*>& listObject
         Tile* fleeTile = nullptr;
         std::vector<Tile*> tiles;
         if(tilesFilter.empty())
-            tiles = getGameMap()->visibleTiles(tileEntityFlee->getX(), tileEntityFlee->getY(), fightIdleDist);
+            getGameMap()->visibleTiles(tileEntityFlee->getX(), tileEntityFlee->getY(), fightIdleDist, tiles);
         else
         {
             float radiusSquared = fightIdleDist * fightIdleDist;
@@ -1652,11 +1712,11 @@ void Creature::updateTilesInSight()
     if (posTile == nullptr)
         return;
 
-    // The tiles with sight radius without constraints
-    mTilesWithinSightRadius = getGameMap()->circularRegion(posTile->getX(), posTile->getY(), mDefinition->getSightRadius());
+    // The tiles with sight radius without constraints. The vectors are reused to avoid allocating each turn
+    getGameMap()->circularRegion(posTile->getX(), posTile->getY(), mDefinition->getSightRadius(), mTilesWithinSightRadius);
 
     // Only the tiles the creature can "see".
-    mVisibleTiles = getGameMap()->visibleTiles(posTile->getX(), posTile->getY(), mDefinition->getSightRadius());
+    getGameMap()->visibleTiles(posTile->getX(), posTile->getY(), mDefinition->getSightRadius(), mVisibleTiles);
 }
 
 std::vector<GameEntity*> Creature::getVisibleEnemyObjects()
@@ -1993,6 +2053,7 @@ double Creature::takeDamage(GameEntity* attacker, double absoluteDamage, double
     computeCreatureOverlayHealthValue();
     computeCreatureOverlayMoodValue();
 
+    uncountIfDead();
     if(!isAlive())
         fireEntityDead();
 
@@ -2350,11 +2411,8 @@ bool Creature::setDestination(Tile* tile)
     if(posTile == nullptr)
         return false;
 
-    std::list<Tile*> result = getGameMap()->path(this, tile);
-
-    std::vector<Ogre::Vector3> path;
-    tileToVector3(result, path, true, 0.0);
-    setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, path);
+    // The path is computed with the other paths asked during the turn. It will be set before the creature moves
+    getGameMap()->requestPath(this, tile);
     pushAction(Utils::make_unique<CreatureActionWalkToTile>(*this));
     return true;
 }
@@ -2525,6 +2583,8 @@ void Creature::slap()
         ConfigManager::getSingleton().getSlapEffectDuration(), "");
     addCreatureEffect(effect);
     mHp -= mMaxHP * ConfigManager::getSingleton().getSlapDamagePercent() / 100.0;
+    uncountIfDead();
+
     computeCreatureOverlayHealthValue();
 }
 
@@ -2587,31 +2647,6 @@ void Creature::fireRemoveEntity(Seat* seat)
     ODServer::getSingleton().queueServerNotification(serverNotification);
 }
 
-void Creature::fireCreatureRefreshIfNeeded()
-{
-    if(!mNeedFireRefresh)
-        return;
-
-    mNeedFireRefresh = false;
-    for(Seat* seat : mSeatsWithVisionNotified)
-    {
-        if(seat->getPlayer() == nullptr)
-            continue;
-        if(!seat->getPlayer()->getIsHuman())
-            continue;
-
-        const std::string& name = getName();
-        ServerNotification *serverNotification = new ServerNotification(
-            ServerNotificationType::entitiesRefresh, seat->getPlayer());
-        uint32_t nbCreature = 1;
-        serverNotification->mPacket << nbCreature;
-        serverNotification->mPacket << GameEntityType::creature;
-        serverNotification->mPacket << name;
-        exportToPacketForUpdate(serverNotification->mPacket, seat);
-        ODServer::getSingleton().queueServerNotification(serverNotification);
-    }
-}
-
 void Creature::fireChatMsgTookFee(int goldTaken)
 {
     if(getSeat()->getPlayer() == nullptr)
@@ -2761,6 +2796,18 @@ void Creature::setupDefinition(GameMap& gameMap, const CreatureDefinition& defau
             CreatureSkillData skillData(skill, skill->getCooldownNbTurns(), 0);
             mSkillData.push_back(skillData);
         }
+
+        // The default worker definition is not in the game map definitions. It has a reserved id
+        const NetworkIdTable& networkIdTable = gameMap.getNetworkIdTable();
+        if(mDefinition == &defaultWorkerCreatureDefinition)
+            mDefinitionNetworkId = NetworkIdTable::DefaultWorkerClassId;
+        else
+            mDefinitionNetworkId = networkIdTable.getId(NetworkIdCategory::creatureClass, mDefinition->getClassName());
+
+        if(mWeaponL != nullptr)
+            mWeaponLNetworkId = networkIdTable.getId(NetworkIdCategory::weapon, mWeaponL->getName());
+        if(mWeaponR != nullptr)
+            mWeaponRNetworkId = networkIdTable.getId(NetworkIdCategory::weapon, mWeaponR->getName());
     }
 
     buildStats();
@@ -2901,7 +2948,7 @@ void Creature::computeCreatureOverlayHealthValue()
     if(mOverlayHealthValue != value)
     {
         mOverlayHealthValue = value;
-        mNeedFireRefresh = true;
+        setNeedFireRefresh();
     }
 }
 
@@ -2943,7 +2990,7 @@ void Creature::computeCreatureOverlayMoodValue()
     if(mOverlayMoodValue != value)
     {
         mOverlayMoodValue = value;
-        mNeedFireRefresh = true;
+        setNeedFireRefresh();
     }
 }
 
@@ -2957,7 +3004,7 @@ void Creature::addCreatureEffect(CreatureEffect* effect)
         effect->getNbTurnsEffect(), effect);
     mEntityParticleEffects.push_back(particleEffect);
 
-    mNeedFireRefresh = true;
+    setNeedFireRefresh();
 }
 
 bool Creature::isHurt() const
@@ -3069,7 +3116,7 @@ bool Creature::isHungry() const
 void Creature::resetKoTurns()
 {
     mKoTurnCounter = 0;
-    mNeedFireRefresh = true;
+    setNeedFireRefresh();
 }
 
 void Creature::setInJail(Room* prison)
@@ -3080,7 +3127,7 @@ void Creature::setInJail(Room* prison)
             return;
 
         mSeatPrison = nullptr;
-        mNeedFireRefresh = true;
+        setNeedFireRefresh();
         return;
     }
 
@@ -3089,7 +3136,7 @@ void Creature::setInJail(Room* prison)
         return;
 
     mSeatPrison = prison->getSeat();
-    mNeedFireRefresh = true;
+    setNeedFireRefresh();
 }
 
 bool Creature::isDangerous(const Creature* creature, int distance) const
@@ -3126,7 +3173,7 @@ void Creature::setMoveSpeedModifier(double modifier)
     mGroundSpeed *= mSpeedModifier;
     mWaterSpeed *= mSpeedModifier;
     mLavaSpeed *= mSpeedModifier;
-    mNeedFireRefresh = true;
+    setNeedFireRefresh();
 }
 
 void Creature::clearMoveSpeedModifier()
@@ -3153,7 +3200,7 @@ void Creature::setDefenseModifier(double phy, double mag, double ele)
     mMagicalDefense += mDefinition->getMagicalDefPerLevel() * multiplier;
     mElementDefense += mDefinition->getElementDefPerLevel() * multiplier;
 
-    mNeedFireRefresh = true;
+    setNeedFireRefresh();
 }
 
 void Creature::clearDefenseModifier()
@@ -3224,6 +3271,8 @@ void Creature::changeSeat(Seat* newSeat)
     OD_LOG_INF("creature=" + getName() + " changes side from seatId=" + Helper::toString(getSeat()->getId()) + " to seatId=" + Helper::toString(newSeat->getId()));
     OD_ASSERT_TRUE_MSG(getSeat() != newSeat, "creature=" + getName() + ", seatId=" + Helper::toString(newSeat->getId()));
     setSeat(newSeat);
+    if(mSeatCounted != nullptr)
+        setSeatCounted(newSeat);
     mMoodValue = CreatureMoodLevel::Neutral;
     mMoodPoints = 0;
     mWakefulness = 100;
@@ -3233,10 +3282,43 @@ void Creature::changeSeat(Seat* newSeat)
     mActiveSlapsCount = 0;
     clearDestinations(EntityAnimation::idle_anim, true, true);
     clearActionQueue();
-    mNeedFireRefresh = true;
+    setNeedFireRefresh();
     if (getHomeTile() != nullptr)
     {
         RoomDormitory* home = static_cast<RoomDormitory*>(getHomeTile()->getCoveringBuilding());
         home->releaseTileForSleeping(getHomeTile(), this);
     }
 }
+
+void Creature::setSeatCounted(Seat* seat)
+{
+    if(mSeatCounted == seat)
+        return;
+
+    // The tile the creature is on also counts the alive creatures by seat
+    if(getIsOnMap())
+    {
+        Tile* tile = getPositionTile();
+        if(tile != nullptr)
+            tile->notifyCreatureSeatCountedChanged(mSeatCounted, seat);
+    }
+
+    if(mSeatCounted != nullptr)
+        mSeatCounted->notifyCreatureCounted(*this, false);
+
+    mSeatCounted = seat;
+
+    if(mSeatCounted != nullptr)
+        mSeatCounted->notifyCreatureCounted(*this, true);
+}
+
+void Creature::uncountIfDead()
+{
+    if(!getIsOnServerMap())
+        return;
+
+    if(isAlive())
+        return;
+
+    setSeatCounted(nullptr);
+}
@@ -81,6 +81,39 @@ public:
     uint32_t mWarmup;
 };
 
+//! \brief Plain copy of the creature data written in level files. It is filled by the thread owning the
+//! game map and can then be written by any thread (see MapFileWriter)
+class CreatureSaveRecord
+{
+public:
+    CreatureSaveRecord();
+
+    //! \brief Writes the record like Creature::exportToStream
+    void exportToStream(std::ostream& os) const;
+
+    int mSeatId;
+    std::string mName;
+    std::string mMeshName;
+    Ogre::Vector3 mPosition;
+    std::string mClassName;
+    unsigned int mLevel;
+    double mExp;
+    double mHp;
+    double mMaxHP;
+    double mWakefulness;
+    double mHunger;
+    int32_t mGoldCarried;
+    //! \brief Weapon names. "none" if no weapon
+    std::string mWeaponL;
+    std::string mWeaponR;
+    SkillType mSkillTypeDropDeath;
+    std::string mWeaponDropDeath;
+    uint32_t mNbEffects;
+    //! \brief Creature effects already written with CreatureEffectManager::write. They are few and
+    //! not plain data
+    std::vector<std::string> mEffects;
+};
+
 //! Class used on server side to link creature effects (spells, slap, ...) with particle effects
 class CreatureParticuleEffect : public EntityParticleEffect
 {
@@ -141,6 +174,10 @@ public:
 
     bool isAlive() const;
 
+    //! \brief Seat whose creature counters account for this creature (see mSeatCounted). Used on server side only
+    inline Seat* getSeatCounted() const
+    { return mSeatCounted; }
+
     //! \brief Gets the maximum HP the creature can have currently
     inline double getMaxHp() const
     { return mMaxHP; }
@@ -471,8 +508,6 @@ public:
     void pushAction(std::unique_ptr<CreatureAction>&& action);
     void popAction();
 
-    void fireCreatureRefreshIfNeeded();
-
     void fireChatMsgTookFee(int goldTaken);
     void fireChatMsgLeftDungeon();
     void fireChatMsgLeavingDungeon();
@@ -588,6 +623,9 @@ public:
     //! \brief Called when the creature changes seat (for example when it becomes rogue or after torture)
     void changeSeat(Seat* newSeat);
 
+    //! \brief Copies the data exported to level files in the given record
+    void fillSaveRecord(CreatureSaveRecord& record) const;
+
 protected:
     virtual void exportToPacket(ODPacket& os, const Seat* seat) const override;
     virtual void importFromPacket(ODPacket& is) override;
@@ -639,6 +677,12 @@ private:
     //! \brief Pointer to the struct holding the general type of the creature with its values
     const CreatureDefinition* mDefinition;
 
+    //! \brief Server side. Network ids (see NetworkIdTable) of mDefinition, mWeaponL and mWeaponR. Set by
+    //! setupDefinition so that the names are not looked up each time the creature is sent
+    uint32_t mDefinitionNetworkId;
+    uint32_t mWeaponLNetworkId;
+    uint32_t mWeaponRNetworkId;
+
     bool            mHasVisualDebuggingEntities;
     double          mWakefulness;
     double          mHunger;
@@ -720,10 +764,6 @@ private:
     //! to allocate/delete this pointer
     CreatureOverlayStatus*          mOverlayStatus;
 
-    //! Used on server side to indicate if a change that needs to be notified to the clients happened (like changing
-    //! level or HP)
-    bool                            mNeedFireRefresh;
-
     //! \brief Used on client side. When a creature is dropped, this cooldown will be set to a value > 0
     //! and decreased at each turn. Until it is > 0, the creature cannot be slapped. That's to avoid
     //! slapping creatures to death when dropping many.
@@ -758,6 +798,10 @@ private:
     //! \brief Counts the number of active slaps affecting the creature
     uint32_t                        mActiveSlapsCount;
 
+    //! \brief Seat whose creature counters currently account for this creature. nullptr if the
+    //! creature is not counted (not in the gamemap or dead). Used on server side only
+    Seat*                           mSeatCounted;
+
     //! \brief Skills the creature can use
     std::vector<CreatureSkillData> mSkillData;
 
@@ -779,6 +823,14 @@ private:
     void computeMood();
 
     void computeCreatureOverlayMoodValue();
+
+    //! \brief Moves this creature from the counters of mSeatCounted to the ones of the given seat
+    //! (nullptr if it should not be counted anymore)
+    void setSeatCounted(Seat* seat);
+
+    //! \brief Removes this creature from the seat counters if its HP dropped to 0. Every path
+    //! changing mHp on server side should call this so that dead creatures are not counted anymore
+    void uncountIfDead();
 };
 
 #endif // CREATURE_H
@@ -34,6 +34,7 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
+#include <algorithm>
 #include <cassert>
 
 void EntityParticleEffect::exportParticleEffectToPacket(const EntityParticleEffect& effect, ODPacket& os)
@@ -98,11 +99,18 @@ GameEntity::GameEntity(
     mIsOnMap           (false),
     mParticleSystemsNumber   (0),
     mCarryLock         (false),
+    mNeedFireRefresh   (false),
     mEntityParentNodeAttach     (EntityParentNodeAttach::ATTACHED)
 {
     assert(mGameMap != nullptr);
 }
 
+GameEntity::~GameEntity()
+{
+    if(mNeedFireRefresh || !mSeatsRefreshDeferred.empty())
+        mGameMap->removeEntityToRefresh(this);
+}
+
 void GameEntity::deleteYourself()
 {
     destroyMesh();
@@ -344,6 +352,54 @@ void GameEntity::fireRemoveEntityToSeatsWithVision()
     mSeatsWithVisionNotified.clear();
 }
 
+void GameEntity::setNeedFireRefresh()
+{
+    if(mNeedFireRefresh)
+        return;
+
+    // Refreshes are only sent by the server
+    if(!getIsOnServerMap())
+        return;
+
+    mNeedFireRefresh = true;
+    // If some seats are waiting for a deferred refresh, the entity is already in the list
+    if(mSeatsRefreshDeferred.empty())
+        getGameMap()->addEntityToRefresh(this);
+}
+
+bool GameEntity::isRefreshPendingForSeat(Seat* seat) const
+{
+    if(mNeedFireRefresh)
+        return true;
+
+    return std::find(mSeatsRefreshDeferred.begin(), mSeatsRefreshDeferred.end(), seat) != mSeatsRefreshDeferred.end();
+}
+
+void GameEntity::notifyRefreshForSeat(Seat* seat, bool sent)
+{
+    std::vector<Seat*>::iterator it = std::find(mSeatsRefreshDeferred.begin(), mSeatsRefreshDeferred.end(), seat);
+    if(sent)
+    {
+        if(it != mSeatsRefreshDeferred.end())
+            mSeatsRefreshDeferred.erase(it);
+        return;
+    }
+
+    if(it == mSeatsRefreshDeferred.end())
+        mSeatsRefreshDeferred.push_back(seat);
+}
+
+bool GameEntity::notifyRefreshFired()
+{
+    mNeedFireRefresh = false;
+    return !mSeatsRefreshDeferred.empty();
+}
+
+bool GameEntity::hasSeatWithVisionNotified(Seat* seat) const
+{
+    return std::find(mSeatsWithVisionNotified.begin(), mSeatsWithVisionNotified.end(), seat) != mSeatsWithVisionNotified.end();
+}
+
 std::string GameEntity::getGameEntityStreamFormat()
 {
     return "SeatId\tName\tMeshName\tPosX\tPosY\tPosZ";
@@ -369,7 +425,7 @@ void GameEntity::exportToPacket(ODPacket& os, const Seat* seat) const
 
     os << seatId;
     os << mName;
-    os << mMeshName;
+    mGameMap->getNetworkIdTable().writeName(os, NetworkIdCategory::mesh, mMeshName);
     os << mPosition;
 
     uint32_t nbEffects = mEntityParticleEffects.size();
@@ -386,7 +442,7 @@ void GameEntity::importFromPacket(ODPacket& is)
         mSeat = mGameMap->getSeatById(seatId);
 
     OD_ASSERT_TRUE(is >> mName);
-    OD_ASSERT_TRUE(is >> mMeshName);
+    OD_ASSERT_TRUE(mGameMap->getNetworkIdTable().readName(is, NetworkIdCategory::mesh, mMeshName));
     OD_ASSERT_TRUE(is >> mPosition);
 
     uint32_t nbEffects;
@@ -410,10 +466,7 @@ void GameEntity::exportToStream(std::ostream& os) const
     if(mSeat != nullptr)
         seatId = mSeat->getId();
 
-    os << seatId << "\t";
-    os << mName << "\t";
-    os << mMeshName << "\t";
-    os << mPosition.x << "\t" << mPosition.y << "\t" << mPosition.z << "\t";
+    exportToStream(seatId, mName, mMeshName, mPosition, os);
 
     // We do not export to stream the particle effects. It is the entity work to know if
     // they should be exported or not
@@ -559,6 +612,15 @@ void GameEntity::exportToStream(GameEntity* entity, std::ostream& os)
     entity->exportToStream(os);
 }
 
+void GameEntity::exportToStream(int seatId, const std::string& name, const std::string& meshName,
+    const Ogre::Vector3& position, std::ostream& os)
+{
+    os << seatId << "\t";
+    os << name << "\t";
+    os << meshName << "\t";
+    os << position.x << "\t" << position.y << "\t" << position.z << "\t";
+}
+
 std::string GameEntity::getOgreNamePrefix() const
 {
     return Helper::toString(static_cast<int32_t>(getObjectType())) + "-";
@@ -160,7 +160,7 @@ class GameEntity
           Seat*           seat        = nullptr
           );
 
-    virtual ~GameEntity() {}
+    virtual ~GameEntity();
 
     std::string getOgreNamePrefix() const;
 
@@ -333,6 +333,24 @@ class GameEntity
     //! \brief Fires remove event to every seat with vision
     virtual void fireRemoveEntityToSeatsWithVision();
 
+    //! \brief Server side only. Asks for the entity state (see exportToPacketForUpdate) to be sent to the seats
+    //! with vision at the end of the turn. The GameMap sends all the refreshed entities in one message per seat
+    void setNeedFireRefresh();
+
+    //! \brief Returns true if the last refresh has not been sent to the given seat yet
+    bool isRefreshPendingForSeat(Seat* seat) const;
+
+    //! \brief Called by the GameMap when the last refresh has been sent to the given seat (sent is true) or when
+    //! it has been deferred because the entity is far from the seat camera (see Seat::isChangeSentThisTurn)
+    void notifyRefreshForSeat(Seat* seat, bool sent);
+
+    //! \brief Called by the GameMap once the refreshes have been processed for every seat. Returns true
+    //! if some seats are still waiting for the refresh
+    bool notifyRefreshFired();
+
+    //! \brief Returns true if the given seat has been notified that it sees this entity
+    bool hasSeatWithVisionNotified(Seat* seat) const;
+
     //! \brief Returns true if the entity can be carried by a worker. False otherwise.
     virtual EntityCarryType getEntityCarryType(Creature* carrier)
     { return EntityCarryType::notCarryable; }
@@ -393,6 +411,11 @@ class GameEntity
 
     static void exportToStream(GameEntity* entity, std::ostream& os);
 
+    //! \brief Writes the GameEntity data from the given values. Used by the entities that can be
+    //! exported from a plain copy of their data (see CreatureSaveRecord)
+    static void exportToStream(int seatId, const std::string& name, const std::string& meshName,
+        const Ogre::Vector3& position, std::ostream& os);
+
   protected:
     /*! \brief Exports the headers needed to recreate the entity. For example, for missile objects
      * type cannon, it exports GameEntityType::missileObject and MissileType::oneHit. The content of the
@@ -480,6 +503,13 @@ class GameEntity
     //! know that they should not consider taking it
     bool mCarryLock;
 
+    //! \brief true if the entity state changed since the last time the GameMap processed the refreshes
+    bool mNeedFireRefresh;
+
+    //! \brief Seats that still wait for the last refresh because the entity was far from their camera. The entity
+    //! stays in the GameMap list of entities to refresh while mNeedFireRefresh is true or this is not empty
+    std::vector<Seat*> mSeatsRefreshDeferred;
+
     //! \brief Client side only. byte array used to know if the entity is currently attached to
     //! its rendering parent node or not
     uint32_t mEntityParentNodeAttach;
@@ -35,6 +35,24 @@
 
 const std::string MapLight::MAPLIGHT_NAME_PREFIX = "Map_light_";
 
+MapLightSaveRecord::MapLightSaveRecord() :
+    mPosition(Ogre::Vector3::ZERO),
+    mAttenuationRange(0.0),
+    mAttenuationConstant(0.0),
+    mAttenuationLinear(0.0),
+    mAttenuationQuadratic(0.0)
+{
+}
+
+void MapLightSaveRecord::exportToStream(std::ostream& os) const
+{
+    os << mPosition.x << "\t" << mPosition.y << "\t" << mPosition.z;
+    os << "\t" << mDiffuseColor.r << "\t" << mDiffuseColor.g << "\t" << mDiffuseColor.b;
+    os << "\t" << mSpecularColor.r << "\t" << mSpecularColor.g << "\t" << mSpecularColor.b;
+    os << "\t" << mAttenuationRange << "\t" << mAttenuationConstant;
+    os << "\t" << mAttenuationLinear << "\t" << mAttenuationQuadratic;
+}
+
 MapLight::MapLight(GameMap* gameMap, Ogre::Real diffRed, Ogre::Real diffGreen, Ogre::Real diffBlue,
         Ogre::Real specRed, Ogre::Real specGreen, Ogre::Real specBlue,
         Ogre::Real attenRange, Ogre::Real attenConst, Ogre::Real attenLin, Ogre::Real attenQuad) :
@@ -285,11 +303,20 @@ MapLight* MapLight::getMapLightFromPacket(GameMap* gameMap, ODPacket& is)
 
 void MapLight::exportToStream(std::ostream& os) const
 {
-    os << mPosition.x << "\t" << mPosition.y << "\t" << mPosition.z;
-    os << "\t" << mDiffuseColor.r << "\t" << mDiffuseColor.g << "\t" << mDiffuseColor.b;
-    os << "\t" << mSpecularColor.r << "\t" << mSpecularColor.g << "\t" << mSpecularColor.b;
-    os << "\t" << mAttenuationRange << "\t" << mAttenuationConstant;
-    os << "\t" << mAttenuationLinear << "\t" << mAttenuationQuadratic;
+    MapLightSaveRecord record;
+    fillSaveRecord(record);
+    record.exportToStream(os);
+}
+
+void MapLight::fillSaveRecord(MapLightSaveRecord& record) const
+{
+    record.mPosition = mPosition;
+    record.mDiffuseColor = mDiffuseColor;
+    record.mSpecularColor = mSpecularColor;
+    record.mAttenuationRange = mAttenuationRange;
+    record.mAttenuationConstant = mAttenuationConstant;
+    record.mAttenuationLinear = mAttenuationLinear;
+    record.mAttenuationQuadratic = mAttenuationQuadratic;
 }
 
 bool MapLight::importFromStream(std::istream& is)
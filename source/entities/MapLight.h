@@ -30,6 +30,25 @@
 class GameMap;
 class ODPacket;
 
+//! \brief Plain copy of the map light data written in level files. It is filled by the thread owning the
+//! game map and can then be written by any thread (see MapFileWriter)
+class MapLightSaveRecord
+{
+public:
+    MapLightSaveRecord();
+
+    //! \brief Writes the record like MapLight::exportToStream
+    void exportToStream(std::ostream& os) const;
+
+    Ogre::Vector3 mPosition;
+    Ogre::ColourValue mDiffuseColor;
+    Ogre::ColourValue mSpecularColor;
+    Ogre::Real mAttenuationRange;
+    Ogre::Real mAttenuationConstant;
+    Ogre::Real mAttenuationLinear;
+    Ogre::Real mAttenuationQuadratic;
+};
+
 class MapLight: public MovableGameEntity
 {
 public:
@@ -119,6 +138,9 @@ public:
 
     static std::string getMapLightStreamFormat();
 
+    //! \brief Copies the data written by exportToStream
+    void fillSaveRecord(MapLightSaveRecord& record) const;
+
 protected:
     virtual void exportToStream(std::ostream& os) const override;
     virtual bool importFromStream(std::istream& is) override;
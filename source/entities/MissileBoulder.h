@@ -19,6 +19,7 @@
 #define MISSILEBOULDER_H
 
 #include "entities/MissileObject.h"
+#include "utils/ObjectPool.h"
 
 #include <string>
 #include <iosfwd>
@@ -29,7 +30,7 @@ class GameMap;
 class Tile;
 class ODPacket;
 
-class MissileBoulder: public MissileObject
+class MissileBoulder: public MissileObject, public PooledObject<MissileBoulder>
 {
 public:
     MissileBoulder(GameMap* gameMap, Seat* seat, const std::string& senderName, const std::string& meshName,
@@ -96,15 +96,16 @@ void MissileObject::doUpkeep()
     Ogre::Vector3 position = getPosition();
     double moveDist = getMoveSpeed();
     Ogre::Vector3 destination;
-    std::list<Tile*> tiles;
+    std::vector<Tile*> tiles;
     mIsMissileAlive = computeDestination(position, moveDist, mDirection, destination, tiles);
 
     std::vector<Ogre::Vector3> path;
     Tile* lastTile = nullptr;
-    while(!tiles.empty() && mIsMissileAlive)
+    uint32_t indexTile = 0;
+    while((indexTile < tiles.size()) && mIsMissileAlive)
     {
-        Tile* tmpTile = tiles.front();
-        tiles.pop_front();
+        Tile* tmpTile = tiles[indexTile];
+        ++indexTile;
 
         if(tmpTile == nullptr)
         {
@@ -131,6 +132,7 @@ void MissileObject::doUpkeep()
                 // We compute next position
                 mDirection = nextDirection;
                 mIsMissileAlive = computeDestination(position, moveDist, mDirection, destination, tiles);
+                indexTile = 0;
                 continue;
             }
         }
@@ -202,11 +204,11 @@ void MissileObject::doUpkeep()
 }
 
 bool MissileObject::computeDestination(const Ogre::Vector3& position, double moveDist, const Ogre::Vector3& direction,
-        Ogre::Vector3& destination, std::list<Tile*>& tiles)
+        Ogre::Vector3& destination, std::vector<Tile*>& tiles)
 {
     destination = position + (moveDist * direction);
-    tiles = getGameMap()->tilesBetween(Helper::round(position.x),
-        Helper::round(position.y), Helper::round(destination.x), Helper::round(destination.y));
+    getGameMap()->tilesBetween(Helper::round(position.x),
+        Helper::round(position.y), Helper::round(destination.x), Helper::round(destination.y), tiles);
     if(tiles.empty())
     {
         OD_LOG_ERR("missile=" + getName() + " has unexpected empty tiles destination");
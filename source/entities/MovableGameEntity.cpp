@@ -17,6 +17,7 @@
 
 #include "entities/MovableGameEntity.h"
 
+#include "entities/GameEntityType.h"
 #include "entities/Tile.h"
 #include "game/Player.h"
 #include "game/Seat.h"
@@ -31,6 +32,26 @@
 
 #include <OgreAnimationState.h>
 
+#include <algorithm>
+
+namespace
+{
+//! \brief Client drifts smaller than this distance (in tiles) are ignored. Destinations are randomly
+//! moved on client side (see correctEntityMovePosition) so the positions never match exactly
+const Ogre::Real DRIFT_IGNORED_DISTANCE = 0.5;
+
+//! \brief Client drifts bigger than this distance (in tiles) are corrected at once
+const Ogre::Real DRIFT_MAX_SMOOTHED_DISTANCE = 3.0;
+
+//! \brief Part of the drift corrected each second
+const Ogre::Real DRIFT_CORRECTION_RATE = 4.0;
+
+//! \brief Maximum distance (in tiles) between an entity on the server and the first destination of a path it
+//! gets. Paths start on a tile next to the one the entity is on (a diagonal step is ~1.41) and the entity may
+//! be anywhere on its tile
+const Ogre::Real FIRST_DESTINATION_MAX_DISTANCE = 2.0;
+}
+
 MovableGameEntity::MovableGameEntity(GameMap* gameMap) :
     GameEntity(gameMap),
     mAnimationState(nullptr),
@@ -39,7 +60,10 @@ MovableGameEntity::MovableGameEntity(GameMap* gameMap) :
     mDestinationPlayIdleWhenAnimationEnds(false),
     mDestinationAnimationDirection(Ogre::Vector3::ZERO),
     mWalkDirection(Ogre::Vector3::ZERO),
-    mAnimationTime(0.0)
+    mAnimationTime(0.0),
+    mPositionCorrection(Ogre::Vector3::ZERO),
+    mIsUpdatingPosition(false),
+    mPathRequestId(0)
 {
 }
 
@@ -48,7 +72,7 @@ bool MovableGameEntity::isMoving()
     return !mWalkQueue.empty();
 }
 
-void MovableGameEntity::tileToVector3(const std::list<Tile*>& tiles, std::vector<Ogre::Vector3>& path,
+void MovableGameEntity::tileToVector3(const TilePath& tiles, std::vector<Ogre::Vector3>& path,
     bool skipFirst, Ogre::Real z)
 {
     for(Tile* tile : tiles)
@@ -67,6 +91,7 @@ void MovableGameEntity::tileToVector3(const std::list<Tile*>& tiles, std::vector
 void MovableGameEntity::setWalkPath(const std::string& walkAnim, const std::string& endAnim, bool loopEndAnim,
         bool playIdleWhenAnimationEnds, const std::vector<Ogre::Vector3>& path)
 {
+    mPathRequestId = 0;
     mWalkQueue.clear();
     // We set the animation after clearing mWalkQueue and before filling it to be
     // sure it is empty when we set it
@@ -76,7 +101,93 @@ void MovableGameEntity::setWalkPath(const std::string& walkAnim, const std::stri
     for(const Ogre::Vector3& dest : path)
         mWalkQueue.push_back(dest);
 
-    if(path.empty())
+    walkPathChanged(walkAnim, endAnim, loopEndAnim, playIdleWhenAnimationEnds);
+}
+
+void MovableGameEntity::setWalkPath(const std::string& walkAnim, const std::string& endAnim, bool loopEndAnim,
+        bool playIdleWhenAnimationEnds, const TilePath& path)
+{
+    mPathRequestId = 0;
+    mWalkQueue.clear();
+    // We set the animation after clearing mWalkQueue and before filling it to be
+    // sure it is empty when we set it. The first tile is the one we are on
+    if(path.size() > 1)
+        setAnimationState(walkAnim);
+
+    bool skipFirst = true;
+    for(Tile* tile : path)
+    {
+        if(skipFirst)
+        {
+            skipFirst = false;
+            continue;
+        }
+
+        mWalkQueue.push_back(Ogre::Vector3(static_cast<Ogre::Real>(tile->getX()), static_cast<Ogre::Real>(tile->getY()), 0.0));
+    }
+
+    walkPathChanged(walkAnim, endAnim, loopEndAnim, playIdleWhenAnimationEnds);
+}
+
+void MovableGameEntity::setWalkPathFromServer(const std::string& walkAnim, const std::string& endAnim, bool loopEndAnim,
+        bool playIdleWhenAnimationEnds, const std::vector<Ogre::Vector3>& path)
+{
+    setWalkPath(walkAnim, endAnim, loopEndAnim, playIdleWhenAnimationEnds, path);
+
+    // Entities in hand are not on the map. They will be moved where they are dropped
+    if(!getIsOnMap())
+        return;
+
+    // The server position is not sent. We estimate it from the first destination which is next to it. Missiles
+    // fly in a straight line so their first destination can be far away
+    if(path.empty() || (getObjectType() == GameEntityType::missileObject))
+        return;
+
+    // The height is not synchronized as some entities (like flying creatures) change it on client side
+    Ogre::Vector3 firstDestToEntity = getPosition() + mPositionCorrection - path.front();
+    firstDestToEntity.z = 0;
+    Ogre::Real firstDestDistance = firstDestToEntity.length();
+    Ogre::Real driftDistance = firstDestDistance - FIRST_DESTINATION_MAX_DISTANCE;
+    if(driftDistance <= DRIFT_IGNORED_DISTANCE)
+        return;
+
+    // We correct towards the nearest position the server entity could be at
+    Ogre::Vector3 drift = firstDestToEntity * (-driftDistance / firstDestDistance);
+    Ogre::Vector3 serverPosition = getPosition() + mPositionCorrection + drift;
+
+    // The correction is applied in a straight line. If it would go through a wall, we move
+    // the entity at once
+    std::vector<Tile*> tiles;
+    getGameMap()->tilesBetween(Helper::round(getPosition().x), Helper::round(getPosition().y),
+        Helper::round(serverPosition.x), Helper::round(serverPosition.y), tiles);
+    bool isThroughWall = false;
+    for(Tile* tile : tiles)
+    {
+        if(!tile->isFullTile())
+            continue;
+
+        isThroughWall = true;
+        break;
+    }
+
+    if(isThroughWall || (driftDistance > DRIFT_MAX_SMOOTHED_DISTANCE))
+    {
+        Ogre::Vector3 position = getPosition();
+        position.x = serverPosition.x;
+        position.y = serverPosition.y;
+        // setPosition clears the pending correction
+        setPosition(position);
+        return;
+    }
+
+    // We only correct what exceeds the ignored distance
+    mPositionCorrection += drift * ((driftDistance - DRIFT_IGNORED_DISTANCE) / driftDistance);
+}
+
+void MovableGameEntity::walkPathChanged(const std::string& walkAnim, const std::string& endAnim, bool loopEndAnim,
+        bool playIdleWhenAnimationEnds)
+{
+    if(mWalkQueue.empty())
     {
         setAnimationState(endAnim, loopEndAnim, Ogre::Vector3::ZERO, playIdleWhenAnimationEnds);
     }
@@ -91,6 +202,9 @@ void MovableGameEntity::setWalkPath(const std::string& walkAnim, const std::stri
     if(!getIsOnServerMap())
         return;
 
+    const NetworkIdTable& networkIdTable = getGameMap()->getNetworkIdTable();
+    uint32_t walkAnimId = networkIdTable.getId(NetworkIdCategory::animation, walkAnim);
+    uint32_t endAnimId = networkIdTable.getId(NetworkIdCategory::animation, endAnim);
     for(Seat* seat : mSeatsWithVisionNotified)
     {
         if(seat->getPlayer() == nullptr)
@@ -102,7 +216,11 @@ void MovableGameEntity::setWalkPath(const std::string& walkAnim, const std::stri
         uint32_t nbDest = mWalkQueue.size();
         ServerNotification *serverNotification = new ServerNotification(
             ServerNotificationType::animatedObjectSetWalkPath, seat->getPlayer());
-        serverNotification->mPacket << name << walkAnim << endAnim << loopEndAnim << playIdleWhenAnimationEnds << nbDest;
+        serverNotification->mPacket << name;
+        NetworkIdTable::writeId(serverNotification->mPacket, walkAnimId, walkAnim);
+        NetworkIdTable::writeId(serverNotification->mPacket, endAnimId, endAnim);
+        serverNotification->mPacket << loopEndAnim << playIdleWhenAnimationEnds;
+        serverNotification->mPacket << nbDest;
         for(const Ogre::Vector3& v : mWalkQueue)
             serverNotification->mPacket << v;
 
@@ -112,9 +230,12 @@ void MovableGameEntity::setWalkPath(const std::string& walkAnim, const std::stri
 
 void MovableGameEntity::clearDestinations(const std::string& animation, bool loopAnim, bool playIdleWhenAnimationEnds)
 {
+    mPathRequestId = 0;
     mWalkQueue.clear();
+    mPositionCorrection = Ogre::Vector3::ZERO;
     stopWalking();
 
+    uint32_t animationId = getGameMap()->getNetworkIdTable().getId(NetworkIdCategory::animation, animation);
     for(Seat* seat : mSeatsWithVisionNotified)
     {
         if(seat->getPlayer() == nullptr)
@@ -123,12 +244,13 @@ void MovableGameEntity::clearDestinations(const std::string& animation, bool loo
             continue;
 
         const std::string& name = getName();
-        const std::string emptyString;
         uint32_t nbDest = 0;
         ServerNotification *serverNotification = new ServerNotification(
             ServerNotificationType::animatedObjectSetWalkPath, seat->getPlayer());
-        serverNotification->mPacket << name << emptyString << animation
-            << loopAnim << playIdleWhenAnimationEnds << nbDest;
+        serverNotification->mPacket << name << NetworkIdTable::NoName;
+        NetworkIdTable::writeId(serverNotification->mPacket, animationId, animation);
+        serverNotification->mPacket << loopAnim << playIdleWhenAnimationEnds;
+        serverNotification->mPacket << nbDest;
         ODServer::getSingleton().queueServerNotification(serverNotification);
     }
 }
@@ -222,17 +344,35 @@ void MovableGameEntity::update(Ogre::Real timeSinceLastFrame)
             getAnimationState()->addTime(static_cast<Ogre::Real>(addedTime));
     }
 
+    // On client side, we apply the drift correction progressively (see setWalkPathFromServer)
+    Ogre::Vector3 newPosition = getPosition();
+    bool positionCorrected = false;
+    if(mPositionCorrection != Ogre::Vector3::ZERO)
+    {
+        Ogre::Real ratio = std::min(static_cast<Ogre::Real>(1.0), DRIFT_CORRECTION_RATE * timeSinceLastFrame);
+        Ogre::Vector3 correction = mPositionCorrection * ratio;
+        if(mPositionCorrection.squaredLength() < 0.0001)
+            correction = mPositionCorrection;
+
+        mPositionCorrection -= correction;
+        newPosition += correction;
+        positionCorrected = true;
+    }
+
     if (mWalkQueue.empty())
+    {
+        if(positionCorrected)
+            updatePosition(newPosition);
         return;
+    }
 
     // Move the entity
 
-    // Note: When the client and the server are using different frame rates, the entities walk at different speeds
-    // If this happens to become a problem, resyncing mechanisms will be needed.
+    // Note: When the client and the server are using different frame rates, the entities walk at different speeds.
+    // The client corrects the drift each time it receives a walk path (see setWalkPathFromServer)
     double moveDist = ODApplication::turnsPerSecond
                       * getMoveSpeed()
                       * timeSinceLastFrame;
-    Ogre::Vector3 newPosition = getPosition();
     Ogre::Vector3 nextDest = mWalkQueue.front();
     Ogre::Vector3 walkDirection = nextDest - newPosition;
     walkDirection.normalise();
@@ -265,7 +405,14 @@ void MovableGameEntity::update(Ogre::Real timeSinceLastFrame)
     }
 
     setWalkDirection(walkDirection);
-    setPosition(newPosition);
+    updatePosition(newPosition);
+}
+
+void MovableGameEntity::updatePosition(const Ogre::Vector3& v)
+{
+    mIsUpdatingPosition = true;
+    setPosition(v);
+    mIsUpdatingPosition = false;
 }
 
 void MovableGameEntity::setPosition(const Ogre::Vector3& v)
@@ -289,6 +436,11 @@ void MovableGameEntity::setPosition(const Ogre::Vector3& v)
     if((oldTile != newTile) && (oldTile != nullptr))
         removeEntityFromPositionTile();
 
+    // The drift correction only applies to the moves done by update(). Other moves (teleport,
+    // drop, ...) put the entity where it should be
+    if(!mIsUpdatingPosition)
+        mPositionCorrection = Ogre::Vector3::ZERO;
+
     mPosition = v;
 
     if(!getIsOnServerMap())
@@ -300,6 +452,7 @@ void MovableGameEntity::setPosition(const Ogre::Vector3& v)
 
 void MovableGameEntity::fireObjectAnimationState(const std::string& state, bool loop, const Ogre::Vector3& direction, bool playIdleWhenAnimationEnds)
 {
+    uint32_t stateId = getGameMap()->getNetworkIdTable().getId(NetworkIdCategory::animation, state);
     for(Seat* seat : mSeatsWithVisionNotified)
     {
         if(seat->getPlayer() == nullptr)
@@ -310,7 +463,9 @@ void MovableGameEntity::fireObjectAnimationState(const std::string& state, bool
         ServerNotification* serverNotification = new ServerNotification(
             ServerNotificationType::setObjectAnimationState, seat->getPlayer());
         const std::string& name = getName();
-        serverNotification->mPacket << name << state << loop << playIdleWhenAnimationEnds;
+        serverNotification->mPacket << name;
+        NetworkIdTable::writeId(serverNotification->mPacket, stateId, state);
+        serverNotification->mPacket << loop << playIdleWhenAnimationEnds;
         if(direction != Ogre::Vector3::ZERO)
             serverNotification->mPacket << true << direction;
         else if(mWalkDirection != Ogre::Vector3::ZERO)
@@ -343,7 +498,7 @@ std::string MovableGameEntity::getMovableGameEntityStreamFormat()
 void MovableGameEntity::exportToPacket(ODPacket& os, const Seat* seat) const
 {
     GameEntity::exportToPacket(os, seat);
-    os << mPrevAnimationState;
+    getGameMap()->getNetworkIdTable().writeName(os, NetworkIdCategory::animation, mPrevAnimationState);
     os << mPrevAnimationStateLoop;
     os << mWalkDirection;
     os << mAnimationTime;
@@ -359,7 +514,7 @@ void MovableGameEntity::exportToPacket(ODPacket& os, const Seat* seat) const
 void MovableGameEntity::importFromPacket(ODPacket& is)
 {
     GameEntity::importFromPacket(is);
-    OD_ASSERT_TRUE(is >> mPrevAnimationState);
+    OD_ASSERT_TRUE(getGameMap()->getNetworkIdTable().readName(is, NetworkIdCategory::animation, mPrevAnimationState));
     OD_ASSERT_TRUE(is >> mPrevAnimationStateLoop);
     OD_ASSERT_TRUE(is >> mWalkDirection);
     OD_ASSERT_TRUE(is >> mAnimationTime);
@@ -23,9 +23,9 @@
 #include <OgreVector3.h>
 
 #include <deque>
-#include <list>
 
 class Tile;
+class TilePath;
 
 namespace EntityAnimation
 {
@@ -50,6 +50,17 @@ public:
     //! \brief Checks if the destination queue is empty
     bool isMoving();
 
+    //! \brief Server side. Id of the path asked with GameMap::requestPath that the entity has not received yet
+    //! (0 if none). Setting or clearing the walk path cancels the request
+    inline uint32_t getPathRequestId() const
+    { return mPathRequestId; }
+
+    inline void setPathRequestId(uint32_t pathRequestId)
+    { mPathRequestId = pathRequestId; }
+
+    inline bool isWaitingForPath() const
+    { return mPathRequestId != 0; }
+
 
     /*! \brief Replaces an object's current walk queue with a new path. During the
      * walk, the entity will play walkAnim (looped). When it gets to the wanted position,
@@ -58,11 +69,25 @@ public:
     void setWalkPath(const std::string& walkAnim, const std::string& endAnim, bool loopEndAnim,
         bool playIdleWhenAnimationEnds, const std::vector<Ogre::Vector3>& path);
 
-    /*! \brief Converts a tile list to a vector of Ogre::Vector3
+    //! \brief Same as above but the entity walks through the tiles of the given path. The first tile of
+    //! the path is skipped as it is the one the entity is on
+    void setWalkPath(const std::string& walkAnim, const std::string& endAnim, bool loopEndAnim,
+        bool playIdleWhenAnimationEnds, const TilePath& path);
+
+    /*! \brief Client side. Same as setWalkPath for a path received from the server. Client and server move
+     * entities with their own frame rates so the client position drifts from the server one. The server position
+     * is not sent: as the first destination of a path is next to the entity on the server, an entity too far from
+     * it has drifted. Small drifts are corrected smoothly during the next frames while big ones (like after a lag
+     * spike) or ones going through walls are corrected at once. Drifts shorter than a tile or two are not detected.
+     */
+    void setWalkPathFromServer(const std::string& walkAnim, const std::string& endAnim, bool loopEndAnim,
+        bool playIdleWhenAnimationEnds, const std::vector<Ogre::Vector3>& path);
+
+    /*! \brief Converts a tile path to a vector of Ogre::Vector3
      *
-     * If skipFirst is true, the first tile in the list will be skipped
+     * If skipFirst is true, the first tile in the path will be skipped
      */
-    static void tileToVector3(const std::list<Tile*>& tiles, std::vector<Ogre::Vector3>& path, bool skipFirst, Ogre::Real z);
+    static void tileToVector3(const TilePath& tiles, std::vector<Ogre::Vector3>& path, bool skipFirst, Ogre::Real z);
 
     //! \brief Clears all future destinations from the walk queue, stops the object where it is, and sets its animation state.
     //! This is a server side function
@@ -108,6 +133,10 @@ public:
     static std::string getMovableGameEntityStreamFormat();
 
 protected:
+    //! \brief Called once mWalkQueue has been filled by setWalkPath. Sets the animations and notifies the clients
+    void walkPathChanged(const std::string& walkAnim, const std::string& endAnim, bool loopEndAnim,
+        bool playIdleWhenAnimationEnds);
+
     virtual void exportToStream(std::ostream& os) const override;
     virtual bool importFromStream(std::istream& is) override;
     virtual void exportToPacket(ODPacket& os, const Seat* seat) const override;
@@ -119,6 +148,10 @@ protected:
 
 private:
     void fireObjectAnimationState(const std::string& state, bool loop, const Ogre::Vector3& direction, bool playIdleWhenAnimationEnds);
+
+    //! \brief Moves the entity from update() without clearing mPositionCorrection
+    void updatePosition(const Ogre::Vector3& v);
+
     Ogre::AnimationState* mAnimationState;
     std::string mDestinationAnimationState;
     bool mDestinationAnimationLoop;
@@ -126,6 +159,17 @@ private:
     Ogre::Vector3 mDestinationAnimationDirection;
     Ogre::Vector3 mWalkDirection;
     double mAnimationTime;
+
+    //! \brief Client side only. Offset between the server and the client position that is
+    //! progressively applied to the entity position (see setWalkPathFromServer). It is cleared when
+    //! the entity is moved by anything else than update()
+    Ogre::Vector3 mPositionCorrection;
+
+    //! \brief True while update() moves the entity
+    bool mIsUpdatingPosition;
+
+    //! \brief See getPathRequestId
+    uint32_t mPathRequestId;
 };
 
 
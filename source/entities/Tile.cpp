@@ -60,6 +60,7 @@ Tile::Tile(GameMap* gameMap, int x, int y, TileType type, double fullness) :
     mRefundPriceTrap    (0),
     mCoveringBuilding   (nullptr),
     mClaimedPercentage  (0.0),
+    mSeatClaimedCounted (nullptr),
     mIsRoom             (false),
     mIsTrap             (false),
     mDisplayTileMesh    (true),
@@ -67,6 +68,7 @@ Tile::Tile(GameMap* gameMap, int x, int y, TileType type, double fullness) :
     mHasBridge          (false),
     mLocalPlayerHasVision   (false),
     mTileCulling        (CullingType::HIDE),
+    mIsListedWithEntities(false),
     mNbWorkersClaiming(0)
 {
     computeTileVisual();
@@ -210,12 +212,11 @@ std::string Tile::getFormat()
 
 void Tile::exportToStream(std::ostream& os) const
 {
-    os << getX() << "\t" << getY() << "\t";
-    os << getType() << "\t" << getFullness();
-    if(getSeat() == nullptr)
-        return;
+    int seatId = -1;
+    if(getSeat() != nullptr)
+        seatId = getSeat()->getId();
 
-    os << "\t" << getSeat()->getId();
+    exportToStream(getX(), getY(), getType(), getFullness(), seatId, os);
 }
 
 ODPacket& operator<<(ODPacket& os, const TileType& type)
@@ -396,9 +397,22 @@ void Tile::setMarkedForDigging(bool ss, const Player *pp)
         return;
 
     if (ss)
+    {
         addPlayerMarkingTile(pp);
+        if(getIsOnServerMap())
+        {
+            for(Seat* seat : getGameMap()->getSeats())
+            {
+                if(seat->getPlayer() == pp)
+                    seat->addTileToDigJobs(this);
+            }
+        }
+    }
     else
         removePlayerMarkingTile(pp);
+
+    // The minimap displays the tiles marked for digging
+    fireTileStateChanged();
 }
 
 bool Tile::getMarkedForDigging(const Player *p) const
@@ -560,6 +574,7 @@ void Tile::resetFloodFill()
             floodFillValue = NO_FLOODFILL;
         }
     }
+    getGameMap()->notifyFloodFillChanged();
 }
 
 bool Tile::updateFloodFillFromTile(Seat* seat, FloodFillType type, Tile* tile)
@@ -600,6 +615,7 @@ bool Tile::updateFloodFillFromTile(Seat* seat, FloodFillType type, Tile* tile)
     }
 
     values[intType] = tile->getFloodFillValue(seat, type);
+    getGameMap()->notifyFloodFillChanged(NO_FLOODFILL, values[intType]);
     return true;
 }
 
@@ -633,7 +649,12 @@ void Tile::replaceFloodFill(Seat* seat, FloodFillType type, uint32_t newValue)
         return;
     }
 
+    uint32_t oldValue = values[intType];
+    if(oldValue == newValue)
+        return;
+
     values[intType] = newValue;
+    getGameMap()->notifyFloodFillChanged(oldValue, newValue);
 }
 
 void Tile::copyFloodFillToOtherSeats(Seat* seatToCopy)
@@ -662,6 +683,7 @@ void Tile::copyFloodFillToOtherSeats(Seat* seatToCopy)
             values[intType] = valuesToCopy[intType];
 
     }
+    getGameMap()->notifyFloodFillChanged();
 }
 
 void Tile::logFloodFill() const
@@ -726,15 +748,24 @@ void Tile::clearVision()
 
 void Tile::notifyVision(Seat* seat)
 {
+    // Allied seats see what their allies see. We notify them at once so that they get the vision
+    // during the same turn, whenever it is notified
+    seat->notifyVisionOnTile(this);
+    for(Seat* alliedSeat : seat->getAlliedSeats())
+        alliedSeat->notifyVisionOnTile(this);
+
     if(std::find(mSeatsWithVision.begin(), mSeatsWithVision.end(), seat) != mSeatsWithVision.end())
         return;
 
-    seat->notifyVisionOnTile(this);
     mSeatsWithVision.push_back(seat);
 
-    // We also notify vision for allied seats
     for(Seat* alliedSeat : seat->getAlliedSeats())
-        notifyVision(alliedSeat);
+    {
+        if(std::find(mSeatsWithVision.begin(), mSeatsWithVision.end(), alliedSeat) != mSeatsWithVision.end())
+            continue;
+
+        mSeatsWithVision.push_back(alliedSeat);
+    }
 }
 
 void Tile::setSeats(const std::vector<Seat*>& seats)
@@ -745,6 +776,7 @@ void Tile::setSeats(const std::vector<Seat*>& seats)
         // Every tile should be notified by default
         std::pair<Seat*, bool> p(seat, true);
         mTileChangedForSeats.push_back(p);
+        seat->notifyTileChanged(this);
     }
 }
 
@@ -775,6 +807,8 @@ void Tile::changeNotifiedForSeat(Seat* seat)
 
 void Tile::computeTileVisual()
 {
+    notifySnapshotChanged();
+
     switch(getType())
     {
         case TileType::dirt:
@@ -897,11 +931,26 @@ void Tile::exportToStream(Tile* tile, std::ostream& os)
     tile->exportToStream(os);
 }
 
+void Tile::exportToStream(int x, int y, TileType type, double fullness, int seatId, std::ostream& os)
+{
+    os << x << "\t" << y << "\t";
+    os << type << "\t" << fullness;
+    if(seatId == -1)
+        return;
+
+    os << "\t" << seatId;
+}
+
 void Tile::setFullness(double f)
 {
     double oldFullness = getFullness();
 
     mFullness = f;
+    notifySnapshotChanged();
+
+    // Full tiles block vision
+    if((oldFullness > 0.0) != (mFullness > 0.0))
+        getGameMap()->notifyTileVisionChanged(this);
 
     // If the tile was marked for digging and has been dug out, unmark it and set its fullness to 0.
     if (mFullness == 0.0 && isMarkedForDiggingByAnySeat())
@@ -919,6 +968,10 @@ void Tile::setFullness(double f)
             for(Seat* seat : getGameMap()->getSeats())
                 getGameMap()->refreshFloodFill(seat, this);
         }
+
+        // The dug tile may be claimed now
+        if(getIsOnServerMap())
+            notifyClaimJobsChanged();
     }
 }
 
@@ -959,6 +1012,8 @@ void Tile::setCoveringBuilding(Building *building)
     if(mCoveringBuilding == building)
         return;
 
+    notifySnapshotChanged();
+
     // We set the tile as dirty for all seats if needed (we have to check because we
     // don't want to refresh tiles for traps for enemy players)
     if(mCoveringBuilding != nullptr)
@@ -968,10 +1023,12 @@ void Tile::setCoveringBuilding(Building *building)
             if(!mCoveringBuilding->shouldSetCoveringTileDirty(seatChanged.first, this))
                 continue;
 
-            seatChanged.second = true;
+            setChangedForSeat(seatChanged);
         }
     }
     mCoveringBuilding = building;
+    // Some buildings (doors) may block vision
+    getGameMap()->notifyTileVisionChanged(this);
     mIsRoom = false;
     if(getCoveringRoom() != nullptr)
     {
@@ -993,12 +1050,13 @@ void Tile::setCoveringBuilding(Building *building)
             if(!mCoveringBuilding->shouldSetCoveringTileDirty(seatChanged.first, this))
                 continue;
 
-            seatChanged.second = true;
+            setChangedForSeat(seatChanged);
         }
 
         // Set the tile as claimed and of the team color of the building
         setSeat(mCoveringBuilding->getSeat());
         mClaimedPercentage = 1.0;
+        refreshClaimedTilesCounter();
     }
 }
 
@@ -1092,67 +1150,74 @@ void Tile::updateFromPacket(ODPacket& is)
 
 void Tile::loadFromLine(const std::string& line, Tile *t)
 {
-    std::vector<std::string> elems = Helper::split(line, '\t');
-
-    int xLocation = Helper::toInt(elems[0]);
-    int yLocation = Helper::toInt(elems[1]);
-
-    std::stringstream tileName("");
-    tileName << TILE_PREFIX;
-    tileName << xLocation;
-    tileName << "_";
-    tileName << yLocation;
+    TileLevelData data;
+    parseLine(line, data);
+    loadFromData(data, t);
+}
 
-    t->setName(tileName.str());
-    t->mX = xLocation;
-    t->mY = yLocation;
-    t->mPosition = Ogre::Vector3(static_cast<Ogre::Real>(t->mX), static_cast<Ogre::Real>(t->mY), 0.0f);
+void Tile::parseLine(const std::string& line, TileLevelData& data)
+{
+    std::vector<std::string> elems = Helper::split(line, '\t');
 
-    TileType tileType = static_cast<TileType>(Helper::toInt(elems[2]));
-    t->setType(tileType);
+    data.mX = Helper::toInt(elems[0]);
+    data.mY = Helper::toInt(elems[1]);
+    data.mType = static_cast<TileType>(Helper::toInt(elems[2]));
 
     // If the tile type is lava or water, we ignore fullness
-    double fullness;
-    switch(tileType)
+    switch(data.mType)
     {
         case TileType::water:
         case TileType::lava:
-            fullness = 0.0;
+            data.mFullness = 0.0;
             break;
 
         default:
-            fullness = Helper::toDouble(elems[3]);
+            data.mFullness = Helper::toDouble(elems[3]);
             break;
     }
-    t->setFullnessValue(fullness);
 
     bool shouldSetSeat = false;
     // We allow to set seat if the tile is dirt (full or not) or if it is gold (ground only)
     if(elems.size() >= 5)
     {
-        if(tileType == TileType::dirt)
+        if(data.mType == TileType::dirt)
         {
             shouldSetSeat = true;
         }
-        else if((tileType == TileType::gold) &&
-            (fullness == 0.0))
+        else if((data.mType == TileType::gold) &&
+            (data.mFullness == 0.0))
         {
             shouldSetSeat = true;
         }
     }
 
-    if(!shouldSetSeat)
+    data.mSeatId = -1;
+    if(shouldSetSeat)
+        data.mSeatId = Helper::toInt(elems[4]);
+}
+
+void Tile::loadFromData(const TileLevelData& data, Tile* t)
+{
+    t->setName(buildName(data.mX, data.mY));
+    t->mX = data.mX;
+    t->mY = data.mY;
+    t->mPosition = Ogre::Vector3(static_cast<Ogre::Real>(t->mX), static_cast<Ogre::Real>(t->mY), 0.0f);
+
+    t->setType(data.mType);
+    t->setFullnessValue(data.mFullness);
+
+    if(data.mSeatId == -1)
     {
         t->setSeat(nullptr);
         return;
     }
 
-    int seatId = Helper::toInt(elems[4]);
-    Seat* seat = t->getGameMap()->getSeatById(seatId);
+    Seat* seat = t->getGameMap()->getSeatById(data.mSeatId);
     if(seat == nullptr)
         return;
     t->setSeat(seat);
     t->mClaimedPercentage = 1.0;
+    t->refreshClaimedTilesCounter();
 }
 
 void Tile::refreshMesh()
@@ -1195,7 +1260,23 @@ bool Tile::addEntity(GameEntity *entity)
     }
 
     mEntitiesInTile.push_back(entity);
-    if(!getGameMap()->isServerGameMap())
+    uint32_t typeIndex = static_cast<uint32_t>(entity->getObjectType());
+    if(typeIndex >= mNbEntitiesByType.size())
+        mNbEntitiesByType.resize(typeIndex + 1, 0);
+    ++mNbEntitiesByType[typeIndex];
+
+    if(getGameMap()->isServerGameMap())
+    {
+        if(entity->getObjectType() == GameEntityType::creature)
+            addCreaturesAliveForSeat(static_cast<Creature*>(entity)->getSeatCounted(), 1);
+
+        if(!mIsListedWithEntities)
+        {
+            mIsListedWithEntities = true;
+            getGameMap()->addTileWithEntities(this);
+        }
+    }
+    else
     {
         // On client side, we cull any movable entity that walks over a
         // culled tile (or show it if it was previously culled and walks
@@ -1217,6 +1298,13 @@ void Tile::removeEntity(GameEntity *entity)
     }
 
     mEntitiesInTile.erase(it);
+    uint32_t typeIndex = static_cast<uint32_t>(entity->getObjectType());
+    if(typeIndex < mNbEntitiesByType.size())
+        --mNbEntitiesByType[typeIndex];
+
+    if(getGameMap()->isServerGameMap() && (entity->getObjectType() == GameEntityType::creature))
+        addCreaturesAliveForSeat(static_cast<Creature*>(entity)->getSeatCounted(), -1);
+
     fireTileStateChanged();
 }
 
@@ -1261,7 +1349,11 @@ void Tile::claimForSeat(Seat* seat, double nDanceRate)
         (getSeat()->isAlliedSeat(seat)))
     {
         claimTile(seat);
+        return;
     }
+
+    // The tile may not be fully claimed anymore by its previous owner
+    refreshClaimedTilesCounter();
 }
 
 void Tile::claimTile(Seat* seat)
@@ -1273,6 +1365,7 @@ void Tile::claimTile(Seat* seat)
     // We need this because if we are a client, the tile may be from a non allied seat
     setSeat(seat);
     mClaimedPercentage = 1.0;
+    refreshClaimedTilesCounter();
 
     if(isFullTile())
         fireTileSound(TileSound::ClaimWall);
@@ -1308,6 +1401,7 @@ void Tile::unclaimTile()
 
     setSeat(nullptr);
     mClaimedPercentage = 0.0;
+    refreshClaimedTilesCounter();
 
     computeTileVisual();
     setDirtyForAllSeats();
@@ -1428,6 +1522,10 @@ bool Tile::isEntityOnTile(GameEntity* entity) const
         default:
             break;
     }
+
+    if(countEntitiesOnTile(entity->getObjectType()) == 0)
+        return false;
+
     for(GameEntity* tmpEntity : mEntitiesInTile)
     {
         if(tmpEntity == entity)
@@ -1438,26 +1536,103 @@ bool Tile::isEntityOnTile(GameEntity* entity) const
 
 uint32_t Tile::countEntitiesOnTile(GameEntityType entityType) const
 {
-    uint32_t nbItems = 0;
-    for(GameEntity* entity : mEntitiesInTile)
+    uint32_t typeIndex = static_cast<uint32_t>(entityType);
+    if(typeIndex >= mNbEntitiesByType.size())
+        return 0;
+
+    return mNbEntitiesByType[typeIndex];
+}
+
+bool Tile::hasCreatureAlive(const Seat* seat, bool allied) const
+{
+    for(const std::pair<Seat*, uint32_t>& p : mNbCreaturesAliveBySeat)
     {
-        if(entity == nullptr)
-        {
-            OD_LOG_ERR("unexpected null entity in tile=" + Tile::displayAsString(this));
+        if(p.first->isAlliedSeat(seat) == allied)
+            return true;
+    }
+
+    return false;
+}
+
+void Tile::notifyCreatureSeatCountedChanged(Seat* oldSeat, Seat* newSeat)
+{
+    addCreaturesAliveForSeat(oldSeat, -1);
+    addCreaturesAliveForSeat(newSeat, 1);
+}
+
+void Tile::addCreaturesAliveForSeat(Seat* seat, int delta)
+{
+    if(seat == nullptr)
+        return;
+
+    for(std::vector<std::pair<Seat*, uint32_t>>::iterator it = mNbCreaturesAliveBySeat.begin(); it != mNbCreaturesAliveBySeat.end(); ++it)
+    {
+        if(it->first != seat)
             continue;
+
+        if(delta > 0)
+        {
+            it->second += static_cast<uint32_t>(delta);
+            return;
         }
 
-        if(entity->getObjectType() != entityType)
-            continue;
+        if(it->second <= static_cast<uint32_t>(-delta))
+        {
+            mNbCreaturesAliveBySeat.erase(it);
+            return;
+        }
 
-        ++nbItems;
+        it->second -= static_cast<uint32_t>(-delta);
+        return;
     }
 
-    return nbItems;
+    if(delta <= 0)
+    {
+        OD_LOG_ERR("tile=" + Tile::displayAsString(this) + ", no creature to remove for seatId=" + Helper::toString(seat->getId()));
+        return;
+    }
+
+    mNbCreaturesAliveBySeat.push_back(std::pair<Seat*, uint32_t>(seat, static_cast<uint32_t>(delta)));
 }
 
 void Tile::fillWithEntities(std::vector<GameEntity*>& entities, SelectionEntityWanted entityWanted, Player* player)
 {
+    // The entities counters tell if an entity can match. If not, there is no need to go through the entities
+    switch(entityWanted)
+    {
+        case SelectionEntityWanted::chicken:
+            if(countEntitiesOnTile(GameEntityType::chickenEntity) == 0)
+                return;
+            break;
+        case SelectionEntityWanted::treasuryObjects:
+            if(countEntitiesOnTile(GameEntityType::treasuryObject) == 0)
+                return;
+            break;
+        case SelectionEntityWanted::creatureAlive:
+        case SelectionEntityWanted::creatureAliveOrDead:
+        case SelectionEntityWanted::creatureAliveInOwnedPrisonHurt:
+            if(countEntitiesOnTile(GameEntityType::creature) == 0)
+                return;
+            break;
+        case SelectionEntityWanted::creatureAliveOwned:
+        case SelectionEntityWanted::creatureAliveOwnedHurt:
+        case SelectionEntityWanted::creatureAliveAllied:
+            if(countEntitiesOnTile(GameEntityType::creature) == 0)
+                return;
+            if(getIsOnServerMap() && !hasCreatureAlive(player->getSeat(), true))
+                return;
+            break;
+        case SelectionEntityWanted::creatureAliveEnemy:
+        case SelectionEntityWanted::creatureAliveEnemyAttackable:
+            if(countEntitiesOnTile(GameEntityType::creature) == 0)
+                return;
+            if(getIsOnServerMap() && !hasCreatureAlive(player->getSeat(), false))
+                return;
+            break;
+        default:
+            break;
+    }
+
     for(GameEntity* entity : mEntitiesInTile)
     {
         if(entity == nullptr)
@@ -1734,7 +1909,85 @@ void Tile::setDirtyForAllSeats()
         return;
 
     for(std::pair<Seat*, bool>& seatChanged : mTileChangedForSeats)
-        seatChanged.second = true;
+        setChangedForSeat(seatChanged);
+}
+
+void Tile::notifySnapshotChanged()
+{
+    if(!getIsOnServerMap())
+        return;
+
+    getGameMap()->notifyTileSnapshotChanged(this);
+}
+
+void Tile::setChangedForSeat(std::pair<Seat*, bool>& seatChanged)
+{
+    if(seatChanged.second)
+        return;
+
+    seatChanged.second = true;
+    seatChanged.first->notifyTileChanged(this);
+}
+
+void Tile::refreshClaimedTilesCounter()
+{
+    if(!getIsOnServerMap())
+        return;
+
+    // The claimed state may have changed even if the counted seat did not
+    notifySnapshotChanged();
+
+    Seat* seat = isClaimed() ? getSeat() : nullptr;
+    if(seat == mSeatClaimedCounted)
+        return;
+
+    if(mSeatClaimedCounted != nullptr)
+        mSeatClaimedCounted->notifyClaimedTileCounted(false);
+
+    mSeatClaimedCounted = seat;
+
+    if(mSeatClaimedCounted != nullptr)
+        mSeatClaimedCounted->notifyClaimedTileCounted(true);
+
+    notifyClaimJobsChanged();
+}
+
+void Tile::notifyClaimJobsChanged()
+{
+    // Only ground tiles can be claimed
+    if(isFullTile())
+        return;
+
+    // The jobs can only change for the seats this tile is claimed for (its neighbors may be claimable now)
+    // and for the seats a ground neighbor is claimed for (this tile may be claimable now). If no tile around
+    // is claimed, no seat can claim anything new here
+    bool isClaimedAround = isClaimed();
+    for(Tile* neigh : mNeighbors)
+    {
+        if(isClaimedAround)
+            break;
+
+        if(neigh->isFullTile())
+            continue;
+
+        isClaimedAround = neigh->isClaimed();
+    }
+
+    if(!isClaimedAround)
+        return;
+
+    for(Seat* seat : getGameMap()->getSeats())
+    {
+        if(isClaimedForSeat(seat))
+        {
+            for(Tile* neigh : mNeighbors)
+                seat->addTileToClaimJobs(neigh);
+
+            continue;
+        }
+
+        seat->addTileToClaimJobs(this);
+    }
 }
 
 void Tile::notifyEntitiesSeatsWithVision()
@@ -108,6 +108,27 @@ enum class FloodFillType
     nbValues
 };
 
+/*! \brief Tile data read from a level file line (see Tile::parseLine). Parsing a line does not use the game map
+ * so it can be done from any thread
+ */
+struct TileLevelData
+{
+    TileLevelData() :
+        mX(-1),
+        mY(-1),
+        mType(TileType::nullTileType),
+        mFullness(0.0),
+        mSeatId(-1)
+    {}
+
+    int mX;
+    int mY;
+    TileType mType;
+    double mFullness;
+    //! \brief Seat claiming the tile. -1 if the tile is not claimed
+    int mSeatId;
+};
+
 /*! \brief Tile for listening for tile state events (like claiming or entity added/removed)
  */
 class TileStateListener
@@ -173,7 +194,10 @@ public:
      * for the tile.
      */
     inline void setType(TileType t)
-    { mType = t; }
+    {
+        mType = t;
+        notifySnapshotChanged();
+    }
 
     //! \brief Returns the tile type (rock, claimed, etc.).
     inline TileType getType() const
@@ -330,6 +354,12 @@ public:
     //! \brief Loads the tile data from a level line.
     static void loadFromLine(const std::string& line, Tile *t);
 
+    //! \brief Reads the tile data from a level line without changing any tile. Thread safe
+    static void parseLine(const std::string& line, TileLevelData& data);
+
+    //! \brief Sets the tile data read by parseLine
+    static void loadFromData(const TileLevelData& data, Tile* t);
+
     /*! \brief This is a helper function which just converts the tile type enum into a string.
      *
      * This function is used primarily in forming the mesh names to load from disk
@@ -358,8 +388,19 @@ public:
 
     //! \brief fills the given vector with the carryable entities on this tile
     void fillWithCarryableEntities(Creature* carrier, std::vector<GameEntity*>& entities);
+
+    //! \brief Returns the number of entities of the given type on this tile. The entities are counted
+    //! when they are added/removed so this does not go through the entities list
     uint32_t countEntitiesOnTile(GameEntityType entityType) const;
 
+    //! \brief Server side. Returns true if an alive creature allied with the given seat (if allied is true) or
+    //! an enemy one (if allied is false) is on this tile
+    bool hasCreatureAlive(const Seat* seat, bool allied) const;
+
+    //! \brief Server side. Called when the seat counting an alive creature on this tile changes (see
+    //! Creature::setSeatCounted). Seats can be nullptr
+    void notifyCreatureSeatCountedChanged(Seat* oldSeat, Seat* newSeat);
+
     //! \brief Returns true if the given entity is on the tile and false otherwise
     bool isEntityOnTile(GameEntity* entity) const;
 
@@ -377,6 +418,10 @@ public:
 
     void notifyEntitiesSeatsWithVision();
 
+    //! \brief Server side. Called by the gamemap when it removes this tile from its list of tiles with entities
+    inline void notifyUnlistedWithEntities()
+    { mIsListedWithEntities = false; }
+
     const std::vector<Seat*>& getSeatsWithVision()
     { return mSeatsWithVision; }
 
@@ -458,6 +503,10 @@ public:
 
     static void exportToStream(Tile* tile, std::ostream& os);
 
+    //! \brief Writes a tile line of the level file from the given tile data. seatId is -1 if the
+    //! tile has no seat. Used to write levels from a GameMapSnapshot (see MapHandler::writeLevelSaveToStream)
+    static void exportToStream(int x, int y, TileType type, double fullness, int seatId, std::ostream& os);
+
     virtual void exportToPacketForUpdate(ODPacket& os, const Seat* seat) const override;
     virtual void updateFromPacket(ODPacket& is) override;
     void exportToPacketForUpdate(ODPacket& os, const Seat* seat, bool hideSeatId) const;
@@ -513,6 +562,14 @@ private:
     //! \brief List of the entities actually on this tile. Most of the creatures actions will rely on this list
     std::vector<GameEntity*> mEntitiesInTile;
 
+    //! \brief Number of entities in mEntitiesInTile by GameEntityType. The vector is only as long as the highest
+    //! type added to the tile
+    std::vector<uint32_t> mNbEntitiesByType;
+
+    //! \brief Number of alive creatures on this tile by seat counting them (see Creature::getSeatCounted). Seats
+    //! without creature are removed. Used on server side only
+    std::vector<std::pair<Seat*, uint32_t>> mNbCreaturesAliveBySeat;
+
     Building* mCoveringBuilding;
     //! Floodfill values per seat and per floodfill type
     std::vector<std::vector<uint32_t>> mFloodFillColor;
@@ -520,6 +577,10 @@ private:
     //! \brief The tile claiming. Used on server side only
     double mClaimedPercentage;
 
+    //! \brief Seat whose claimed tiles counter currently accounts for this tile (nullptr if none).
+    //! Used on server side only
+    Seat* mSeatClaimedCounted;
+
     //! \brief True if a building is on this tile. False otherwise. It is used on client side because the clients do not know about
     //! buildings. However, it needs to know the tiles where a building is to display the room/trap costs.
     bool mIsRoom;
@@ -536,6 +597,10 @@ private:
 
     uint32_t mTileCulling;
 
+    //! \brief Server side. true if this tile is in the gamemap list of tiles with entities
+    //! (see GameMap::updateVisibleEntities)
+    bool mIsListedWithEntities;
+
     /*! \brief Set the fullness value for the tile.
      *  This only sets the fullness variable. This function is here to change the value
      *  before a map object has been set. setFullness is called once a map is assigned.
@@ -545,6 +610,25 @@ private:
 
     void setDirtyForAllSeats();
 
+    //! \brief Server side. Notifies the gamemap that the state stored in the snapshot has changed
+    //! (see GameMap::publishSnapshot)
+    void notifySnapshotChanged();
+
+    //! \brief Sets the tile as changed for the seat in the given entry of mTileChangedForSeats. If it was not,
+    //! the seat is notified so that it sends the tile at the end of the turn (see Seat::notifyTileChanged)
+    void setChangedForSeat(std::pair<Seat*, bool>& seatChanged);
+
+    //! \brief Adds delta to the alive creatures counter of the given seat (see mNbCreaturesAliveBySeat)
+    void addCreaturesAliveForSeat(Seat* seat, int delta);
+
+    //! \brief Updates the seats claimed tiles counters if the claimed state of this tile has changed.
+    //! Should be called each time the tile seat or claimed percentage is changed
+    void refreshClaimedTilesCounter();
+
+    //! \brief Adds this tile and its neighbors to the seats claim job boards if they can be claimed. Should be
+    //! called when the tile claimed state or fullness changes
+    void notifyClaimJobsChanged();
+
     //! \brief Vector with the number of workers digging the tile. The index corresponds
     //! to the index in mNeighbors
     std::vector<uint32_t> mNbWorkersDigging;
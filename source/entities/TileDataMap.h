@@ -0,0 +1,140 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEDATAMAP_H
+#define TILEDATAMAP_H
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+class Tile;
+class TileData;
+
+//! \brief Associates the tiles of a building with their TileData. The slots are stored densely in a contiguous
+//! array, in the order the tiles were added to the building, so iterating goes through the array. Tiles are only
+//! added to buildings (destroyed tiles keep their data), so a slot never moves to another index. The tile of a
+//! slot cannot be changed. Lookups use a separate tile to slot index sorted by tile.
+//! The TileData are owned by the building, not by this container.
+class TileDataMap
+{
+public:
+    typedef std::pair<Tile* const, TileData*> value_type;
+    typedef std::vector<value_type>::iterator iterator;
+    typedef std::vector<value_type>::const_iterator const_iterator;
+
+    inline iterator begin()
+    { return mSlots.begin(); }
+    inline iterator end()
+    { return mSlots.end(); }
+    inline const_iterator begin() const
+    { return mSlots.begin(); }
+    inline const_iterator end() const
+    { return mSlots.end(); }
+
+    inline uint32_t size() const
+    { return mSlots.size(); }
+    inline bool empty() const
+    { return mSlots.empty(); }
+    inline void clear()
+    {
+        mSlots.clear();
+        mIndex.clear();
+    }
+
+    inline iterator find(const Tile* tile)
+    {
+        uint32_t slot = findSlot(tile);
+        if(slot == NO_SLOT)
+            return mSlots.end();
+
+        return mSlots.begin() + slot;
+    }
+
+    inline const_iterator find(const Tile* tile) const
+    {
+        uint32_t slot = findSlot(tile);
+        if(slot == NO_SLOT)
+            return mSlots.end();
+
+        return mSlots.begin() + slot;
+    }
+
+    //! \brief Like std::map::at, throws std::out_of_range if the tile has no data
+    TileData* at(const Tile* tile) const
+    {
+        uint32_t slot = findSlot(tile);
+        if(slot == NO_SLOT)
+            throw std::out_of_range("TileDataMap::at");
+
+        return mSlots[slot].second;
+    }
+
+    //! \brief Like std::map::operator[], adds an empty slot at the end for the tile if it has no data
+    TileData*& operator[](Tile* tile)
+    {
+        std::vector<IndexEntry>::iterator it = mIndex.begin() + lowerBound(tile);
+        if((it != mIndex.end()) && (it->first == tile))
+            return mSlots[it->second].second;
+
+        uint32_t slot = mSlots.size();
+        mIndex.insert(it, IndexEntry(tile, slot));
+        mSlots.push_back(value_type(tile, nullptr));
+        return mSlots.back().second;
+    }
+
+private:
+    typedef std::pair<const Tile*, uint32_t> IndexEntry;
+
+    static const uint32_t NO_SLOT = 0xFFFFFFFF;
+
+    //! \brief Returns the slot of the given tile or NO_SLOT if it has no data
+    uint32_t findSlot(const Tile* tile) const
+    {
+        uint32_t index = lowerBound(tile);
+        if((index == mIndex.size()) || (mIndex[index].first != tile))
+            return NO_SLOT;
+
+        return mIndex[index].second;
+    }
+
+    //! \brief Returns the position in mIndex of the first entry whose tile is not lower than the given one. The
+    //! search is written without unpredictable branches as the tiles looked for are random from the search point of view
+    uint32_t lowerBound(const Tile* tile) const
+    {
+        uint32_t first = 0;
+        uint32_t count = mIndex.size();
+        while(count > 0)
+        {
+            uint32_t half = count / 2;
+            uint32_t next = first + half + 1;
+            bool lower = (mIndex[first + half].first < tile);
+            first = lower ? next : first;
+            count = lower ? count - half - 1 : half;
+        }
+        return first;
+    }
+
+    //! \brief Tiles and their data, in the order they were added
+    std::vector<value_type> mSlots;
+    //! \brief Slot of each tile, sorted by tile
+    std::vector<IndexEntry> mIndex;
+};
+
+#endif // TILEDATAMAP_H
@@ -162,7 +162,7 @@ bool Weapon::update(Weapon* weapon, std::stringstream& defFile)
     return true;
 }
 
-void Weapon::writeWeaponDiff(const Weapon* def1, const Weapon* def2, std::ofstream& file)
+void Weapon::writeWeaponDiff(const Weapon* def1, const Weapon* def2, std::ostream& file)
 {
     file << "[Equipment]" << std::endl;
     file << "    Name\t" << def2->mName << std::endl;
@@ -19,6 +19,7 @@
 
 #include "ai/KeeperAIType.h"
 #include "entities/Building.h"
+#include "entities/Creature.h"
 #include "entities/CreatureDefinition.h"
 #include "entities/GameEntityType.h"
 #include "entities/Tile.h"
@@ -27,6 +28,7 @@
 #include "game/SkillManager.h"
 #include "game/SkillType.h"
 #include "gamemap/GameMap.h"
+#include "gamemap/Pathfinding.h"
 #include "goals/Goal.h"
 #include "network/ODServer.h"
 #include "network/ServerNotification.h"
@@ -43,8 +45,23 @@
 #include "utils/LogManager.h"
 #include "utils/Random.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <istream>
 #include <ostream>
+#include <sstream>
+
+//! \brief Flags used in Seat::mJobTileFlags
+const uint8_t JOB_TILE_DIG = 0x01;
+const uint8_t JOB_TILE_CLAIM = 0x02;
+
+//! \brief Size in tiles of the square cells the job board is split in (see Seat::mDigJobs)
+const int JOB_CELL_SIZE = 8;
+
+//! \brief Tiles added around the camera view reported by the client (see Seat::isChangeSentThisTurn)
+const int CAMERA_VIEW_MARGIN = 4;
+
+const int64_t Seat::FAR_CHANGES_TURNS = 4;
 
 const std::string Seat::PLAYER_TYPE_HUMAN = "Human";
 const std::string Seat::PLAYER_TYPE_AI = "AI";
@@ -60,12 +77,79 @@ TileStateNotified::TileStateNotified():
     mTileVisual(TileVisual::nullTileVisual),
     mSeatIdOwner(-1),
     mMarkedForDigging(false),
-    mVisionTurnLast(false),
-    mVisionTurnCurrent(false),
     mBuilding(nullptr)
 {
 }
 
+//! exports the tiles of the corresponding TileVisual the seat have seen
+static void exportTilesVisualInitialStates(const std::vector<std::vector<TileStateNotified>>& tilesStates,
+    TileVisual tileVisual, std::ostream& os)
+{
+    os << "[" + Tile::tileVisualToString(tileVisual) + "]" << std::endl;
+
+    for(uint32_t xxx = 0; xxx < tilesStates.size(); ++xxx)
+    {
+        for(uint32_t yyy = 0; yyy < tilesStates[xxx].size(); ++yyy)
+        {
+            const TileStateNotified& tileState = tilesStates[xxx][yyy];
+            if(tileState.mTileVisual != tileVisual)
+                continue;
+
+            os << xxx << "\t" << yyy << "\t" << tileState.mSeatIdOwner << std::endl;
+        }
+    }
+
+    os << "[/" + Tile::tileVisualToString(tileVisual) + "]" << std::endl;
+}
+
+SeatSaveRecord::SeatSaveRecord() :
+    mHasTileStates(false)
+{
+}
+
+void SeatSaveRecord::exportToStream(std::ostream& os) const
+{
+    os << mData;
+
+    if(!mHasTileStates)
+        return;
+
+    // We save the visible tiles last state
+    uint32_t nb = static_cast<uint32_t>(TileVisual::countTileVisual);
+    for(uint32_t k = 0; k < nb; ++k)
+    {
+        TileVisual tileVisual = static_cast<TileVisual>(k);
+        // Full dirt tiles, full gold tiles and full rock tiles are automatically
+        // set so we don't have to bother about them
+        switch(tileVisual)
+        {
+            case TileVisual::nullTileVisual:
+            case TileVisual::goldFull:
+            case TileVisual::dirtFull:
+            case TileVisual::rockFull:
+                continue;
+
+            default:
+                break;
+        }
+        exportTilesVisualInitialStates(mTilesStates, tileVisual, os);
+    }
+
+    os << "[markedTiles]" << std::endl;
+    for(uint32_t xxx = 0; xxx < mTilesStates.size(); ++xxx)
+    {
+        for(uint32_t yyy = 0; yyy < mTilesStates[xxx].size(); ++yyy)
+        {
+            const TileStateNotified& tileState = mTilesStates[xxx][yyy];
+            if(!tileState.mMarkedForDigging)
+                continue;
+
+            os << xxx << "\t" << yyy << std::endl;
+        }
+    }
+    os << "[/markedTiles]" << std::endl;
+}
+
 
 Seat::Seat(GameMap* gameMap) :
     mGameMap(gameMap),
@@ -80,13 +164,23 @@ Seat::Seat(GameMap* gameMap) :
     mConfigPlayerId(-1),
     mConfigTeamId(-1),
     mConfigFactionIndex(-1),
-    mKoCreatures(false)
+    mKoCreatures(false),
+    mJobCellsX(0),
+    mJobBoardDirty(true),
+    mCameraViewX(0),
+    mCameraViewY(0),
+    mCameraViewRadius(-1),
+    mGoalDependenciesChanged(Goal::DEPENDENCY_ALL),
+    mGoalsDependencies(0)
 {
 }
 
 void Seat::addGoal(Goal* g)
 {
     mUncompleteGoals.push_back(g);
+    mGoalsDependencies |= g->getDependencies();
+    // The new goal has never been checked
+    mGoalDependenciesChanged = Goal::DEPENDENCY_ALL;
 }
 
 unsigned int Seat::numUncompleteGoals()
@@ -142,10 +236,18 @@ Goal* Seat::getFailedGoal(unsigned int index)
 
 unsigned int Seat::checkAllCompletedGoals()
 {
+    notifyGoalDependencyChanged(Goal::DEPENDENCY_TURN);
+
     // Loop over the goals vector and move any goals that have been met to the completed goals vector.
     std::vector<Goal*>::iterator currentGoal = mCompletedGoals.begin();
     while (currentGoal != mCompletedGoals.end())
     {
+        if(!isGoalToCheck(*currentGoal))
+        {
+            ++currentGoal;
+            continue;
+        }
+
         // Start by checking if this previously met goal has now been unmet.
         if ((*currentGoal)->isUnmet(*this, *mGameMap))
         {
@@ -227,41 +329,33 @@ void Seat::addAlliedSeat(Seat* seat)
 
 void Seat::clearTilesWithVision()
 {
-    if(mPlayer == nullptr)
-        return;
-    if(!mPlayer->getIsHuman())
-        return;
-
-    for(std::vector<TileStateNotified>& vec : mTilesStates)
-    {
-        for(TileStateNotified& p : vec)
-        {
-            p.mVisionTurnLast = p.mVisionTurnCurrent;
-            p.mVisionTurnCurrent = false;
-        }
-    }
+    resizeVisionPlanesIfNeeded();
+    mVisionTurnLast.swap(mVisionTurnCurrent);
+    mVisionTurnCurrent.clear();
 }
 
 void Seat::notifyVisionOnTile(Tile* tile)
 {
-    if(mPlayer == nullptr)
-        return;
-    if(!mPlayer->getIsHuman())
-        return;
-
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
+    resizeVisionPlanesIfNeeded();
+    if(!mVisionTurnCurrent.isInside(tile->getX(), tile->getY()))
     {
         OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
         return;
     }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
+
+    mVisionTurnCurrent.set(tile->getX(), tile->getY());
+}
+
+void Seat::resizeVisionPlanesIfNeeded()
+{
+    if((mVisionTurnCurrent.getMapSizeX() == mGameMap->getMapSizeX()) &&
+       (mVisionTurnCurrent.getMapSizeY() == mGameMap->getMapSizeY()))
     {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
         return;
     }
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
-    tileState.mVisionTurnCurrent = true;
+    mVisionTurnCurrent.resize(mGameMap->getMapSizeX(), mGameMap->getMapSizeY());
+    mVisionTurnLast.resize(mGameMap->getMapSizeX(), mGameMap->getMapSizeY());
 }
 
 void Seat::notifyTileClaimedByEnemy(Tile* tile)
@@ -287,7 +381,7 @@ void Seat::notifyTileClaimedByEnemy(Tile* tile)
     // By default, we set the tile like if it was not claimed anymore
     tileState.mSeatIdOwner = -1;
     tileState.mTileVisual = TileVisual::dirtGround;
-    tileState.mVisionTurnCurrent = true;
+    notifyVisionOnTile(tile);
 }
 
 const std::string Seat::getFactionFromLine(const std::string& line)
@@ -310,6 +404,12 @@ bool Seat::takeMana(double mana)
     return true;
 }
 
+void Seat::addGoldMined(int quantity)
+{
+    mGoldMined += quantity;
+    notifyGoalDependencyChanged(Goal::DEPENDENCY_GOLD_MINED);
+}
+
 bool Seat::sortForMapSave(Seat* s1, Seat* s2)
 {
     return s1->mId < s2->mId;
@@ -325,6 +425,8 @@ void Seat::setPlayer(Player* player)
 
     mPlayer = player;
     player->mSeat = this;
+    // The tiles marked for digging depend on the player
+    mJobBoardDirty = true;
 }
 
 bool Seat::hasVisionOnTile(Tile* tile)
@@ -344,20 +446,7 @@ bool Seat::hasVisionOnTile(Tile* tile)
     if(!mPlayer->getIsHuman())
         return true;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return false;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return false;
-    }
-
-    TileStateNotified& stateTile = mTilesStates[tile->getX()][tile->getY()];
-
-    return stateTile.mVisionTurnCurrent;
+    return mVisionTurnCurrent.test(tile->getX(), tile->getY());
 }
 
 void Seat::initSeat()
@@ -517,6 +606,12 @@ unsigned int Seat::checkAllGoals()
     while (currentGoal != mUncompleteGoals.end())
     {
         Goal* goal = *currentGoal;
+        if(!isGoalToCheck(goal))
+        {
+            ++currentGoal;
+            continue;
+        }
+
         // Start by checking if the goal has been met by this seat.
         if (goal->isMet(*this, *mGameMap))
         {
@@ -586,15 +681,31 @@ unsigned int Seat::checkAllGoals()
         }
     }
 
+    // The goals will be checked again when a state they depend on changes
+    mGoalDependenciesChanged = 0;
     for(std::vector<Goal*>::iterator it = goalsToAdd.begin(); it != goalsToAdd.end(); ++it)
     {
         Goal* goal = *it;
-        mUncompleteGoals.push_back(goal);
+        addGoal(goal);
     }
 
     return numUncompleteGoals();
 }
 
+void Seat::notifyGoalDependencyChanged(uint32_t dependencies)
+{
+    mGoalDependenciesChanged |= dependencies;
+
+    // The goals descriptions may display the changed state
+    if((mGoalsDependencies & dependencies) != 0)
+        mHasGoalsChanged = true;
+}
+
+bool Seat::isGoalToCheck(const Goal* goal) const
+{
+    return (goal->getDependencies() & mGoalDependenciesChanged) != 0;
+}
+
 void Seat::notifyChangedVisibleTiles()
 {
     if(mPlayer == nullptr)
@@ -602,24 +713,32 @@ void Seat::notifyChangedVisibleTiles()
     if(!mPlayer->getIsHuman())
         return;
 
+    // The tiles that are not visible or that are far from the camera stay changed. We keep them
+    // in the list for the next turns
     std::vector<Tile*> tilesToNotify;
-    int xMax = static_cast<int>(mTilesStates.size());
-    for(int xxx = 0; xxx < xMax; ++xxx)
+    std::vector<Tile*>::iterator itKept = mChangedTiles.begin();
+    for(Tile* tile : mChangedTiles)
     {
-        int yMax = static_cast<int>(mTilesStates[xxx].size());
-        for(int yyy = 0; yyy < yMax; ++yyy)
+        // The change may have been notified by other means (for example, when a room is built)
+        if(!tile->hasChangedForSeat(this))
         {
-            if(!mTilesStates[xxx][yyy].mVisionTurnCurrent)
-                continue;
-
-            Tile* tile = mGameMap->getTile(xxx, yyy);
-            if(!tile->hasChangedForSeat(this))
-                continue;
+            mChangedTilesListed[getJobTileIndex(tile)] = false;
+            continue;
+        }
 
-            tilesToNotify.push_back(tile);
-            tile->changeNotifiedForSeat(this);
+        if(!mVisionTurnCurrent.test(tile->getX(), tile->getY()) ||
+           !isChangeSentThisTurn(tile))
+        {
+            *itKept = tile;
+            ++itKept;
+            continue;
         }
+
+        mChangedTilesListed[getJobTileIndex(tile)] = false;
+        tilesToNotify.push_back(tile);
+        tile->changeNotifiedForSeat(this);
     }
+    mChangedTiles.erase(itKept, mChangedTiles.end());
 
     if(tilesToNotify.empty())
         return;
@@ -637,6 +756,42 @@ void Seat::notifyChangedVisibleTiles()
     ODServer::getSingleton().queueServerNotification(serverNotification);
 }
 
+void Seat::notifyTileChanged(Tile* tile)
+{
+    if(mChangedTilesListed.empty())
+        mChangedTilesListed.assign(mGameMap->getMapSizeX() * mGameMap->getMapSizeY(), false);
+
+    uint32_t index = getJobTileIndex(tile);
+    if(mChangedTilesListed[index])
+        return;
+
+    mChangedTilesListed[index] = true;
+    mChangedTiles.push_back(tile);
+}
+
+void Seat::setCameraView(int x, int y, int radius)
+{
+    mCameraViewX = x;
+    mCameraViewY = y;
+    mCameraViewRadius = radius;
+}
+
+bool Seat::isChangeSentThisTurn(const Tile* tile) const
+{
+    if(mCameraViewRadius < 0)
+        return true;
+    if(tile == nullptr)
+        return true;
+    if((mGameMap->getTurnNumber() % FAR_CHANGES_TURNS) == 0)
+        return true;
+
+    // We add a margin to the view so that changes close to the screen borders are up to date when the
+    // camera moves a bit
+    int radius = mCameraViewRadius + CAMERA_VIEW_MARGIN;
+    return (std::abs(tile->getX() - mCameraViewX) <= radius) &&
+        (std::abs(tile->getY() - mCameraViewY) <= radius);
+}
+
 void Seat::stopVisualDebugEntities()
 {
     if(mGameMap->isServerGameMap())
@@ -709,19 +864,10 @@ void Seat::refreshSeatVisualDebug()
     if(mIsDebuggingVision)
     {
         std::vector<Tile*> tiles;
-        int xMax = static_cast<int>(mTilesStates.size());
-        for(int xxx = 0; xxx < xMax; ++xxx)
-        {
-            int yMax = static_cast<int>(mTilesStates[xxx].size());
-            for(int yyy = 0; yyy < yMax; ++yyy)
+        mVisionTurnCurrent.forEachTile([this, &tiles](int x, int y)
             {
-                if(!mTilesStates[xxx][yyy].mVisionTurnCurrent)
-                    continue;
-
-                Tile* tile = mGameMap->getTile(xxx, yyy);
-                tiles.push_back(tile);
-            }
-        }
+                tiles.push_back(mGameMap->getTile(x, y));
+            });
         uint32_t nbTiles = tiles.size();
         ServerNotification *serverNotification = new ServerNotification(
             ServerNotificationType::refreshSeatVisDebug, nullptr);
@@ -760,18 +906,11 @@ void Seat::sendVisibleTiles()
         ServerNotificationType::refreshVisibleTiles, getPlayer());
     std::vector<Tile*> tilesVisionGained;
     std::vector<Tile*> tilesVisionLost;
-    // Tiles we gained vision
-    int xMax = static_cast<int>(mTilesStates.size());
-    for(int xxx = 0; xxx < xMax; ++xxx)
-    {
-        int yMax = static_cast<int>(mTilesStates[xxx].size());
-        for(int yyy = 0; yyy < yMax; ++yyy)
+    // Tiles where the vision changed since last turn
+    mVisionTurnCurrent.forEachDifference(mVisionTurnLast, [this, &tilesVisionGained, &tilesVisionLost](int x, int y)
         {
-            if(mTilesStates[xxx][yyy].mVisionTurnCurrent == mTilesStates[xxx][yyy].mVisionTurnLast)
-                continue;
-
-            Tile* tile = mGameMap->getTile(xxx, yyy);
-            if(mTilesStates[xxx][yyy].mVisionTurnCurrent)
+            Tile* tile = mGameMap->getTile(x, y);
+            if(mVisionTurnCurrent.test(x, y))
             {
                 // Vision gained
                 tilesVisionGained.push_back(tile);
@@ -781,8 +920,7 @@ void Seat::sendVisibleTiles()
                 // Vision lost
                 tilesVisionLost.push_back(tile);
             }
-        }
-    }
+        });
 
     // Notify tiles we gained vision
     nbTiles = tilesVisionGained.size();
@@ -802,31 +940,221 @@ void Seat::sendVisibleTiles()
     ODServer::getSingleton().queueServerNotification(serverNotification);
 }
 
-void Seat::computeSeatBeginTurn()
+void Seat::notifyClaimedTileCounted(bool counted)
 {
-    if(mPlayer != nullptr)
+    notifyGoalDependencyChanged(Goal::DEPENDENCY_CLAIMED_TILES);
+    if(counted)
     {
-        std::fill(mNbRooms.begin(), mNbRooms.end(), 0);
-        for(Room* room : mGameMap->getRooms())
+        ++mNumClaimedTiles;
+        return;
+    }
+
+    if(mNumClaimedTiles <= 0)
+    {
+        OD_LOG_ERR("seatId=" + Helper::toString(getId()) + ", no claimed tile to remove");
+        return;
+    }
+    --mNumClaimedTiles;
+}
+
+void Seat::notifyCreatureCounted(const Creature& creature, bool counted)
+{
+    // Goals may depend on the creatures of the other seats
+    mGameMap->notifyGoalDependencyChanged(Goal::DEPENDENCY_CREATURES);
+    int delta = counted ? 1 : -1;
+    if(creature.getDefinition()->isWorker())
+        mNumCreaturesWorkers += delta;
+    else
+        mNumCreaturesFighters += delta;
+}
+
+void Seat::notifyRoomCounted(RoomType type, bool counted)
+{
+    mGameMap->notifyGoalDependencyChanged(Goal::DEPENDENCY_ROOMS);
+    uint32_t index = static_cast<uint32_t>(type);
+    if(index >= mNbRooms.size())
+    {
+        OD_LOG_ERR("wrong index=" + Helper::toString(index) + ", size=" + Helper::toString(mNbRooms.size()));
+        return;
+    }
+
+    if(counted)
+    {
+        ++mNbRooms[index];
+        return;
+    }
+
+    if(mNbRooms[index] <= 0)
+    {
+        OD_LOG_ERR("seatId=" + Helper::toString(getId()) + ", no room to remove for index=" + Helper::toString(index));
+        return;
+    }
+    --mNbRooms[index];
+}
+
+void Seat::notifyGoldChanged(int goldDelta, int goldMaxDelta)
+{
+    mGold += goldDelta;
+    mGoldMax += goldMaxDelta;
+}
+
+void Seat::fillStartingGold()
+{
+    // The gold read from the level file is not stored in any treasury yet. The treasuries
+    // will update the gold counter when the gold is deposited
+    int startingGold = mGold;
+    mGold = 0;
+    if(startingGold <= 0)
+        return;
+
+    mGameMap->addGoldToSeat(startingGold, getId());
+}
+
+uint32_t Seat::getJobTileIndex(Tile* tile) const
+{
+    return static_cast<uint32_t>(tile->getX() + tile->getY() * mGameMap->getMapSizeX());
+}
+
+uint32_t Seat::getJobCellIndex(Tile* tile) const
+{
+    return static_cast<uint32_t>((tile->getX() / JOB_CELL_SIZE) + (tile->getY() / JOB_CELL_SIZE) * mJobCellsX);
+}
+
+bool Seat::isClaimJob(Tile* tile) const
+{
+    if(tile->isFullTile())
+        return false;
+
+    if(tile->isClaimedForSeat(this))
+        return false;
+
+    for(Tile* neigh : tile->getAllNeighbors())
+    {
+        if(neigh->isFullTile())
+            continue;
+
+        if(!neigh->isClaimedForSeat(this))
+            continue;
+
+        return true;
+    }
+
+    return false;
+}
+
+bool Seat::isJob(Tile* tile, uint8_t jobType) const
+{
+    if(jobType == JOB_TILE_DIG)
+        return (mPlayer != nullptr) && tile->getMarkedForDigging(mPlayer);
+
+    return isClaimJob(tile);
+}
+
+void Seat::rebuildJobBoard()
+{
+    mJobBoardDirty = false;
+    mJobCellsX = (mGameMap->getMapSizeX() + JOB_CELL_SIZE - 1) / JOB_CELL_SIZE;
+    int nbCellsY = (mGameMap->getMapSizeY() + JOB_CELL_SIZE - 1) / JOB_CELL_SIZE;
+    mDigJobs.assign(mJobCellsX * nbCellsY, std::vector<Tile*>());
+    mClaimJobs.assign(mJobCellsX * nbCellsY, std::vector<Tile*>());
+    mJobTileFlags.assign(mGameMap->getMapSizeX() * mGameMap->getMapSizeY(), 0);
+    for(int yy = 0; yy < mGameMap->getMapSizeY(); ++yy)
+    {
+        for(int xx = 0; xx < mGameMap->getMapSizeX(); ++xx)
         {
-            if(room->getSeat() != this)
-                continue;
+            Tile* tile = mGameMap->getTile(xx, yy);
+            addTileToDigJobs(tile);
+            addTileToClaimJobs(tile);
+        }
+    }
+}
 
-            if(room->getHP(nullptr) <= 0.0)
-                continue;
+void Seat::addTileToDigJobs(Tile* tile)
+{
+    // If the board is dirty, the tile will be added when it is rebuilt
+    if(mJobBoardDirty)
+        return;
+
+    if(!isJob(tile, JOB_TILE_DIG))
+        return;
+
+    uint8_t& flags = mJobTileFlags[getJobTileIndex(tile)];
+    if((flags & JOB_TILE_DIG) != 0)
+        return;
+
+    flags |= JOB_TILE_DIG;
+    mDigJobs[getJobCellIndex(tile)].push_back(tile);
+}
+
+void Seat::addTileToClaimJobs(Tile* tile)
+{
+    if(mJobBoardDirty)
+        return;
+
+    if(!isJob(tile, JOB_TILE_CLAIM))
+        return;
+
+    uint8_t& flags = mJobTileFlags[getJobTileIndex(tile)];
+    if((flags & JOB_TILE_CLAIM) != 0)
+        return;
+
+    flags |= JOB_TILE_CLAIM;
+    mClaimJobs[getJobCellIndex(tile)].push_back(tile);
+}
+
+void Seat::fillDigJobs(const Tile& center, int radius, std::vector<Tile*>& jobs)
+{
+    if(mJobBoardDirty)
+        rebuildJobBoard();
+
+    fillJobs(mDigJobs, JOB_TILE_DIG, center, radius, jobs);
+}
+
+void Seat::fillClaimJobs(const Tile& center, int radius, std::vector<Tile*>& jobs)
+{
+    if(mJobBoardDirty)
+        rebuildJobBoard();
+
+    // Note that tiles that are temporarily not claimable (covered by a building, too many workers
+    // claiming, ...) are kept in the board
+    fillJobs(mClaimJobs, JOB_TILE_CLAIM, center, radius, jobs);
+}
+
+void Seat::fillJobs(std::vector<std::vector<Tile*>>& jobsByCell, uint8_t jobType, const Tile& center,
+        int radius, std::vector<Tile*>& jobs)
+{
+    jobs.clear();
+    int cellXMin = std::max(center.getX() - radius, 0) / JOB_CELL_SIZE;
+    int cellXMax = std::min(center.getX() + radius, mGameMap->getMapSizeX() - 1) / JOB_CELL_SIZE;
+    int cellYMin = std::max(center.getY() - radius, 0) / JOB_CELL_SIZE;
+    int cellYMax = std::min(center.getY() + radius, mGameMap->getMapSizeY() - 1) / JOB_CELL_SIZE;
+    int radiusSquared = radius * radius;
+    for(int cellY = cellYMin; cellY <= cellYMax; ++cellY)
+    {
+        for(int cellX = cellXMin; cellX <= cellXMax; ++cellX)
+        {
+            std::vector<Tile*>& cellJobs = jobsByCell[cellX + cellY * mJobCellsX];
+            // We remove the tiles that are not jobs anymore
+            cellJobs.erase(std::remove_if(cellJobs.begin(), cellJobs.end(), [this, jobType](Tile* tile)
+                {
+                    if(isJob(tile, jobType))
+                        return false;
+
+                    mJobTileFlags[getJobTileIndex(tile)] &= ~jobType;
+                    return true;
+                }), cellJobs.end());
 
-            uint32_t index = static_cast<uint32_t>(room->getType());
-            if(index >= mNbRooms.size())
+            for(Tile* tile : cellJobs)
             {
-                OD_LOG_ERR("wrong index=" + Helper::toString(index) + ", size=" + Helper::toString(mNbRooms.size()));
-                return;
+                if(Pathfinding::squaredDistanceTile(center, *tile) > radiusSquared)
+                    continue;
+
+                jobs.push_back(tile);
             }
-            ++mNbRooms[index];
         }
     }
 }
 
-
 Seat* Seat::createRogueSeat(GameMap* gameMap)
 {
     Seat* seat = new Seat(gameMap);
@@ -1121,6 +1449,15 @@ bool Seat::importSeatFromStream(std::istream& is)
 
 bool Seat::exportSeatToStream(std::ostream& os) const
 {
+    SeatSaveRecord record;
+    fillSaveRecord(record);
+    record.exportToStream(os);
+    return true;
+}
+
+void Seat::fillSaveRecord(SeatSaveRecord& record) const
+{
+    std::ostringstream os;
     os << "seatId\t";
     os << mId;
     os << std::endl;
@@ -1213,72 +1550,23 @@ bool Seat::exportSeatToStream(std::ostream& os) const
     }
     os << "[/SkillPending]" << std::endl;
 
+    record.mData = os.str();
+    record.mHasTileStates = false;
+    record.mTilesStates.clear();
+
     // In editor mode, we don't save tile states
     if(mGameMap->isInEditorMode())
-        return true;
+        return;
 
     // Tile states are only saved for human players
     if((getPlayer() == nullptr) ||
         (!getPlayer()->getIsHuman()))
     {
-        return true;
-    }
-
-    // We save the visible tiles last state
-    uint32_t nb = static_cast<uint32_t>(TileVisual::countTileVisual);
-    for(uint32_t k = 0; k < nb; ++k)
-    {
-        TileVisual tileVisual = static_cast<TileVisual>(k);
-        // Full dirt tiles, full gold tiles and full rock tiles are automatically
-        // set so we don't have to bother about them
-        switch(tileVisual)
-        {
-            case TileVisual::nullTileVisual:
-            case TileVisual::goldFull:
-            case TileVisual::dirtFull:
-            case TileVisual::rockFull:
-                continue;
-
-            default:
-                break;
-        }
-        exportTilesVisualInitialStates(tileVisual, os);
-    }
-
-    os << "[markedTiles]" << std::endl;
-    for(uint32_t xxx = 0; xxx < mTilesStates.size(); ++xxx)
-    {
-        for(uint32_t yyy = 0; yyy < mTilesStates[xxx].size(); ++yyy)
-        {
-            const TileStateNotified& tileState = mTilesStates[xxx][yyy];
-            if(!tileState.mMarkedForDigging)
-                continue;
-
-            os << xxx << "\t" << yyy << std::endl;
-        }
-    }
-    os << "[/markedTiles]" << std::endl;
-
-    return true;
-}
-
-void Seat::exportTilesVisualInitialStates(TileVisual tileVisual, std::ostream& os) const
-{
-    os << "[" + Tile::tileVisualToString(tileVisual) + "]" << std::endl;
-
-    for(uint32_t xxx = 0; xxx < mTilesStates.size(); ++xxx)
-    {
-        for(uint32_t yyy = 0; yyy < mTilesStates[xxx].size(); ++yyy)
-        {
-            const TileStateNotified& tileState = mTilesStates[xxx][yyy];
-            if(tileState.mTileVisual != tileVisual)
-                continue;
-
-            os << xxx << "\t" << yyy << "\t" << tileState.mSeatIdOwner << std::endl;
-        }
+        return;
     }
 
-    os << "[/" + Tile::tileVisualToString(tileVisual) + "]" << std::endl;
+    record.mHasTileStates = true;
+    record.mTilesStates = mTilesStates;
 }
 
 bool Seat::addSkill(SkillType type)
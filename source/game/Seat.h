@@ -19,6 +19,7 @@
 #define SEAT_H
 
 #include "game/SeatData.h"
+#include "gamemap/VisionPlane.h"
 
 #include <OgreVector3.h>
 #include <OgreColourValue.h>
@@ -29,6 +30,7 @@
 
 class Building;
 class ConfigManager;
+class Creature;
 class Goal;
 class ODPacket;
 class GameMap;
@@ -54,11 +56,26 @@ public:
     TileVisual mTileVisual;
     int mSeatIdOwner;
     bool mMarkedForDigging;
-    bool mVisionTurnLast;
-    bool mVisionTurnCurrent;
     Building* mBuilding;
 };
 
+//! \brief Plain copy of the seat data written in level files. It is filled by the thread owning the
+//! game map and can then be written by any thread (see MapFileWriter)
+class SeatSaveRecord
+{
+public:
+    SeatSaveRecord();
+
+    //! \brief Writes the record like Seat::exportSeatToStream
+    void exportToStream(std::ostream& os) const;
+
+    //! \brief Seat parameters and skills, already written. They are small compared to the tile states
+    std::string mData;
+    //! \brief Tile states are only saved in game for human players
+    bool mHasTileStates;
+    std::vector<std::vector<TileStateNotified>> mTilesStates;
+};
+
 class Seat : public SeatData
 {
 public:
@@ -90,15 +107,21 @@ public:
     void clearCompletedGoals();
 
     /** \brief Loop over the vector of unmet goals and call the isMet() and isFailed() functions on
-     * each one, if it is met move it to the completedGoals vector.
+     * each one, if it is met move it to the completedGoals vector. Only the goals depending on a game
+     * state that changed since the last call are checked (see notifyGoalDependencyChanged).
      */
     unsigned int checkAllGoals();
 
     /** \brief Loop over the vector of met goals and call the isUnmet() function on each one,
-     * if any of them are no longer satisfied move them back to the goals vector.
+     * if any of them are no longer satisfied move them back to the goals vector. Should be called
+     * before checkAllGoals.
      */
     unsigned int checkAllCompletedGoals();
 
+    //! \brief Server side. Called when a game state goals may depend on has changed. dependencies
+    //! are Goal::DEPENDENCY_* flags
+    void notifyGoalDependencyChanged(uint32_t dependencies);
+
     //! \brief A simple accessor function to return the number of goals completed by this seat.
     unsigned int numCompletedGoals();
 
@@ -120,6 +143,13 @@ public:
     inline void resetGoalsChanged()
     { mHasGoalsChanged = false; }
 
+    //! \brief Server side. Last goals string sent to the player on this seat (see GameMap::getGoalsStringForPlayer)
+    inline const std::string& getGoalsStringSent() const
+    { return mGoalsStringSent; }
+
+    inline void setGoalsStringSent(const std::string& goals)
+    { mGoalsStringSent = goals; }
+
     inline bool isRogueSeat() const
     { return mId == 0; }
 
@@ -164,8 +194,7 @@ public:
     inline Ogre::Vector3 getStartingPosition() const
     { return Ogre::Vector3(static_cast<Ogre::Real>(mStartingX), static_cast<Ogre::Real>(mStartingY), 0); }
 
-    inline void addGoldMined(int quantity)
-    { mGoldMined += quantity; }
+    void addGoldMined(int quantity);
 
     inline bool getIsDebuggingVision()
     { return mIsDebuggingVision; }
@@ -200,6 +229,8 @@ public:
     bool canOwnedCreatureUseRoomFrom(const Seat* seat) const;
     bool canBuildingBeDestroyedBy(const Seat* seat) const;
 
+    //! \brief Called at the beginning of the vision computation. The current vision becomes the last
+    //! turn vision (see sendVisibleTiles)
     void clearTilesWithVision();
     void notifyVisionOnTile(Tile* tile);
     void notifyTileClaimedByEnemy(Tile* tile);
@@ -208,9 +239,25 @@ public:
     bool hasVisionOnTile(Tile* tile);
 
     //! \brief Checks if the visible tiles seen by this seat have changed and notify
-    //! the players if yes
+    //! the players if yes. Only the tiles in the changed tiles list are processed (see notifyTileChanged)
     void notifyChangedVisibleTiles();
 
+    //! \brief Server side. Called by the tiles when they become changed for this seat. The tile
+    //! is added to the changed tiles list if it is not already in it
+    void notifyTileChanged(Tile* tile);
+
+    //! \brief Server side. Sets the region the player on this seat is looking at, as reported by its client
+    void setCameraView(int x, int y, int radius);
+
+    //! \brief Server side. Interest management: changes happening far from the camera of the player are only
+    //! sent every FAR_CHANGES_TURNS turns. Until then, the tile/entity stays dirty so that only its latest
+    //! state is sent. Returns true if a change on the given tile should be sent this turn. If the client
+    //! has not reported its camera, every change is sent
+    bool isChangeSentThisTurn(const Tile* tile) const;
+
+    //! \brief Number of turns between 2 refreshes of the changes far from the camera
+    static const int64_t FAR_CHANGES_TURNS;
+
     //! \brief Server side to toggle the tiles this seat has vision on
     void toggleSeatVisualDebug();
     void refreshSeatVisualDebug();
@@ -225,7 +272,28 @@ public:
     inline const std::vector<Seat*>& getAlliedSeats()
     { return mAlliedSeats; }
 
-    void computeSeatBeginTurn();
+    //! \brief Running counters notifications. They are called by the tiles, rooms and creatures when their
+    //! state changes so that the seat totals (claimed tiles, creatures, rooms and gold) do not have to be
+    //! recomputed every turn. Used on server side only
+    void notifyClaimedTileCounted(bool counted);
+    void notifyCreatureCounted(const Creature& creature, bool counted);
+    void notifyRoomCounted(RoomType type, bool counted);
+    void notifyGoldChanged(int goldDelta, int goldMaxDelta);
+
+    //! \brief Called when the game starts to put the gold the seat starts with in its treasuries.
+    void fillStartingGold();
+
+    //! \brief Worker job board. Lists the tiles marked for digging by the seat player and the ground tiles
+    //! next to the seat claimed tiles so that workers do not have to scan every tile they see when looking
+    //! for work. The tiles are added when their state changes (marked for digging, claimed, dug, ...) and the
+    //! entries no longer valid are removed when the lists are read. Used on server side only
+    void addTileToDigJobs(Tile* tile);
+    void addTileToClaimJobs(Tile* tile);
+
+    //! \brief Fills jobs with the tiles of the job board within radius of center. jobs is cleared first.
+    //! Only the board cells around center are read
+    void fillDigJobs(const Tile& center, int radius, std::vector<Tile*>& jobs);
+    void fillClaimJobs(const Tile& center, int radius, std::vector<Tile*>& jobs);
 
     //! \brief Gets whether a skill is being done
     bool isSkilling() const
@@ -306,6 +374,8 @@ public:
 
     bool importSeatFromStream(std::istream& is);
     bool exportSeatToStream(std::ostream& os) const;
+    //! \brief Copies the data exported to level files in the given record
+    void fillSaveRecord(SeatSaveRecord& record) const;
     static void loadFromLine(const std::string& line, Seat *s);
     static const std::string getFactionFromLine(const std::string& line);
 
@@ -363,6 +433,11 @@ private:
 
     std::map<std::pair<int, int>, TileStateNotified> mTilesStateLoaded;
 
+    //! \brief Tiles this seat has vision on for the current and the previous turn. They are used for every
+    //! seat (including AI ones) because allied seats share their vision
+    VisionPlane mVisionTurnCurrent;
+    VisionPlane mVisionTurnLast;
+
     std::vector<Tile*> mVisualDebugEntityTiles;
 
     //! \brief Index of the team in the gamemap (from 0 to N). Must be set when the seat is added to the gamemap
@@ -395,6 +470,59 @@ private:
     //! \brief Should the creatures fight to death or ko enemy creatures
     bool mKoCreatures;
 
+    //! \brief Worker job board (see fillDigJobs and fillClaimJobs). The tiles are bucketed by square cells of
+    //! the map (see getJobCellIndex) so that workers only read the cells around them. mJobTileFlags is indexed by
+    //! x + y * mapSizeX and tells in which lists a tile is to avoid duplicates
+    std::vector<std::vector<Tile*>> mDigJobs;
+    std::vector<std::vector<Tile*>> mClaimJobs;
+    std::vector<uint8_t> mJobTileFlags;
+    int mJobCellsX;
+    //! \brief true until the job board has been built from the gamemap tiles
+    bool mJobBoardDirty;
+
+    //! \brief Tiles that may have changed for this seat and have not been sent yet (see notifyChangedVisibleTiles).
+    //! mChangedTilesListed is indexed like mJobTileFlags and tells if a tile is in the list to avoid duplicates
+    std::vector<Tile*> mChangedTiles;
+    std::vector<bool> mChangedTilesListed;
+
+    //! \brief Center and half size (in tiles) of the region the player is looking at (see setCameraView).
+    //! mCameraViewRadius is negative until the client reports its camera
+    int mCameraViewX;
+    int mCameraViewY;
+    int mCameraViewRadius;
+
+    //! \brief Goal::DEPENDENCY_* flags of the game states that changed since the goals were last checked
+    uint32_t mGoalDependenciesChanged;
+
+    //! \brief Goal::DEPENDENCY_* flags the goals of this seat depend on
+    uint32_t mGoalsDependencies;
+
+    std::string mGoalsStringSent;
+
+    //! \brief Returns true if the given goal depends on a game state that changed since the goals were last checked
+    bool isGoalToCheck(const Goal* goal) const;
+
+    //! \brief Builds the job board from the gamemap tiles
+    void rebuildJobBoard();
+
+    //! \brief Fills jobs with the tiles within radius of center in the given job board cells. The tiles that are
+    //! not a job of the given type (JOB_TILE_DIG or JOB_TILE_CLAIM) anymore are removed from the cells
+    void fillJobs(std::vector<std::vector<Tile*>>& jobsByCell, uint8_t jobType, const Tile& center,
+        int radius, std::vector<Tile*>& jobs);
+
+    //! \brief Returns true if the given tile is still a job of the given type (JOB_TILE_DIG or JOB_TILE_CLAIM)
+    bool isJob(Tile* tile, uint8_t jobType) const;
+
+    //! \brief Sets the vision planes to the gamemap size if they are not already
+    void resizeVisionPlanesIfNeeded();
+
+    //! \brief Returns true if the given tile is a ground tile, not claimed by this seat, next to
+    //! a tile claimed by this seat
+    bool isClaimJob(Tile* tile) const;
+
+    uint32_t getJobTileIndex(Tile* tile) const;
+    uint32_t getJobCellIndex(Tile* tile) const;
+
     //! \brief Server side function. Sets mCurrentSkill to the first entry in mSkillPending. If the pending
     //! list in empty, mCurrentSkill will be set to null
     //! researchedType is the currently researched type if any (nullSkillType if none)
@@ -403,9 +531,6 @@ private:
     //! Fills mTilesStateLoaded with the tiles of the given tileVisual is the given istream.
     //! Returns 0 if the seat end tile has been reached, 1 if the read success and -1 if there is an error
     int readTilesVisualInitialStates(TileVisual tileVisual, std::istream& is);
-
-    //! exports the tiles of the corresponding TileVisual this seat have seen
-    void exportTilesVisualInitialStates(TileVisual tileVisual, std::ostream& os) const;
 };
 
 #endif // SEAT_H
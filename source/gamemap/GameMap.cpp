@@ -55,6 +55,7 @@
 #include "spells/Spell.h"
 #include "sound/SoundEffectsManager.h"
 #include "traps/Trap.h"
+#include "traps/TrapDoor.h"
 #include "traps/TrapManager.h"
 #include "utils/ConfigManager.h"
 #include "utils/Helper.h"
@@ -63,16 +64,53 @@
 
 #include <OgreTimer.h>
 
+#include <SFML/System/Thread.hpp>
+
 #include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
+#include <thread>
 
 const std::string DEFAULT_NICK = "You";
 
+//! \brief Number of paths kept in the path cache
+const uint32_t PATH_CACHE_SIZE = 512;
+
+//! \brief Minimum number of paths to solve for each thread when the path requests are processed
+const uint32_t MIN_PATHS_PER_THREAD = 4;
+
+//! \brief Returned by the building queries when nothing matches
+static const std::vector<Room*> EMPTY_ROOMS;
+static const std::vector<Building*> EMPTY_BUILDINGS;
+
+//! \brief Returns the floodfill type that should be used to check if the given creature can go somewhere
+static FloodFillType getFloodFillTypeForCreature(const Creature* creature)
+{
+    FloodFillType floodFill = FloodFillType::ground;
+    if((creature->getMoveSpeedGround() > 0.0) &&
+        (creature->getMoveSpeedWater() > 0.0) &&
+        (creature->getMoveSpeedLava() > 0.0))
+    {
+        floodFill = FloodFillType::groundWaterLava;
+    }
+    if((creature->getMoveSpeedGround() > 0.0) &&
+        (creature->getMoveSpeedWater() > 0.0))
+    {
+        floodFill = FloodFillType::groundWater;
+    }
+    if((creature->getMoveSpeedGround() > 0.0) &&
+        (creature->getMoveSpeedLava() > 0.0))
+    {
+        floodFill = FloodFillType::groundLava;
+    }
+    return floodFill;
+}
+
 using namespace std;
 
 /*! \brief A helper class for the A* search in the GameMap::path function.
@@ -161,6 +199,13 @@ GameMap::GameMap(bool isServerGameMap) :
         mFloodFillEnabled(false),
         mIsFOWActivated(true),
         mNumCallsTo_path(0),
+        mPathCache(PATH_CACHE_SIZE),
+        mLastPathRequestId(0),
+        mNbPathRequests(0),
+        mNbPathRequestsMerged(0),
+        mNbPathRequestsSolved(0),
+        mSeatBuildingsDirty(true),
+        mReachableBuildingsDirty(true),
         mAiManager(*this),
         mTileSet(nullptr)
 {
@@ -188,7 +233,7 @@ bool GameMap::isInEditorMode() const
     return (ODFrameListener::getSingleton().getModeManager()->getCurrentModeType() == ModeManager::EDITOR);
 }
 
-bool GameMap::loadLevel(const std::string& levelFilepath)
+bool GameMap::loadLevel(const std::string& levelFilepath, LevelLoadingTimes* loadingTimes)
 {
     // We reset the creature definitions
     clearClasses();
@@ -213,11 +258,12 @@ bool GameMap::loadLevel(const std::string& levelFilepath)
         delete rogueSeat;
     }
 
-    if (MapHandler::readGameMapFromFile(levelFilepath, *this))
+    if (MapHandler::readGameMapFromFile(levelFilepath, *this, loadingTimes))
         setLevelFileName(levelFilepath);
     else
         return false;
 
+    buildNetworkIdTable();
     return true;
 }
 
@@ -260,6 +306,7 @@ void GameMap::clearAll()
     clearCreatures();
     clearClasses();
     clearWeapons();
+    mNetworkIdTable.clear();
     clearTraps();
 
     clearMapLights();
@@ -272,6 +319,12 @@ void GameMap::clearAll()
 
     clearTiles();
     processDeletionQueues();
+    mTilesWithEntities.clear();
+    mPathCache.clear();
+    mPathRequests.clear();
+    mSnapshotBuilder.resize(0, 0);
+    mSnapshotChangedTiles.clear();
+    mSnapshotTilesListed.clear();
 
     clearGoalsForAllSeats();
     clearSeats();
@@ -355,6 +408,7 @@ void GameMap::clearClasses()
             delete def.first;
     }
     mClassDescriptions.clear();
+    mNetworkIdTable.clear(NetworkIdCategory::creatureClass);
 }
 
 void GameMap::clearWeapons()
@@ -369,6 +423,7 @@ void GameMap::clearWeapons()
             delete def.first;
     }
     mWeapons.clear();
+    mNetworkIdTable.clear(NetworkIdCategory::weapon);
 }
 
 void GameMap::clearRenderedMovableEntities()
@@ -405,11 +460,14 @@ void GameMap::resetUniqueNumbers()
 
 void GameMap::addClassDescription(const CreatureDefinition *c)
 {
+    // If several definitions have the same name, the first one is used (like when the names were compared)
+    mNetworkIdTable.addName(NetworkIdCategory::creatureClass, c->getClassName());
     mClassDescriptions.push_back(std::pair<const CreatureDefinition*,CreatureDefinition*>(c, nullptr));
 }
 
 void GameMap::addWeapon(const Weapon* weapon)
 {
+    mNetworkIdTable.addName(NetworkIdCategory::weapon, weapon->getName());
     mWeapons.push_back(std::pair<const Weapon*,Weapon*>(weapon, nullptr));
 }
 
@@ -430,40 +488,31 @@ const Weapon* GameMap::getWeapon(int index)
 
 const Weapon* GameMap::getWeapon(const std::string& name)
 {
-    for (std::pair<const Weapon*,Weapon*>& def : mWeapons)
-    {
-        if(def.second != nullptr)
-        {
-            if (def.second->getName().compare(name) == 0)
-                return def.second;
-        }
-        else if(def.first->getName().compare(name) == 0)
-            return def.first;
-    }
+    uint32_t id = mNetworkIdTable.getId(NetworkIdCategory::weapon, name);
+    if(id >= mWeapons.size())
+        return nullptr;
 
-    return nullptr;
+    return getWeapon(static_cast<int>(id));
 }
 
 Weapon* GameMap::getWeaponForTuning(const std::string& name)
 {
-    for (std::pair<const Weapon*,Weapon*>& def : mWeapons)
+    uint32_t id = mNetworkIdTable.getId(NetworkIdCategory::weapon, name);
+    if(id < mWeapons.size())
     {
+        std::pair<const Weapon*,Weapon*>& def = mWeapons[id];
         if(def.second != nullptr)
-        {
-            if (def.second->getName().compare(name) == 0)
-                return def.second;
-        }
-        else if(def.first->getName().compare(name) == 0)
-        {
-            // If the definition is not a copy, we make one because we want to keep the original so we are able
-            // to save the changes if the map is saved
-            def.second = new Weapon(*def.first);
             return def.second;
-        }
+
+        // If the definition is not a copy, we make one because we want to keep the original so we are able
+        // to save the changes if the map is saved
+        def.second = new Weapon(*def.first);
+        return def.second;
     }
 
     // It is a new definition
     Weapon* def = new Weapon(name);
+    mNetworkIdTable.addName(NetworkIdCategory::weapon, name);
     mWeapons.push_back(std::pair<const Weapon*,Weapon*>(nullptr, def));
     return def;
 }
@@ -473,14 +522,15 @@ uint32_t GameMap::numWeapons()
     return mWeapons.size();
 }
 
-void GameMap::saveLevelEquipments(std::ofstream& levelFile)
+void GameMap::getLevelEquipments(std::vector<std::pair<const Weapon*, const Weapon*>>& weapons) const
 {
-    for (std::pair<const Weapon*,Weapon*>& def : mWeapons)
+    weapons.clear();
+    for (const std::pair<const Weapon*,Weapon*>& def : mWeapons)
     {
         if(def.second == nullptr)
             continue;
 
-        Weapon::writeWeaponDiff(def.first, def.second, levelFile);
+        weapons.push_back(std::pair<const Weapon*, const Weapon*>(def.first, def.second));
     }
 }
 
@@ -490,6 +540,7 @@ void GameMap::addCreature(Creature *cc)
         + ", seatId=" + (cc->getSeat() != nullptr ? Helper::toString(cc->getSeat()->getId()) : std::string("null")));
 
     mCreatures.push_back(cc);
+    notifyGoalDependencyChanged(Goal::DEPENDENCY_CREATURES);
 }
 
 void GameMap::removeCreature(Creature *c)
@@ -504,6 +555,41 @@ void GameMap::removeCreature(Creature *c)
     }
 
     mCreatures.erase(it);
+    notifyGoalDependencyChanged(Goal::DEPENDENCY_CREATURES);
+
+    // The creature will not be there to get its path
+    mPathRequests.erase(std::remove_if(mPathRequests.begin(), mPathRequests.end(),
+        [c](const PathRequest& request) { return request.mCreature == c; }), mPathRequests.end());
+    c->setPathRequestId(0);
+}
+
+void GameMap::buildNetworkIdTable()
+{
+    mNetworkIdTable.clear(NetworkIdCategory::mesh);
+    mNetworkIdTable.clear(NetworkIdCategory::animation);
+
+    // Meshes of the creatures that can spawn and of the entities created by the level. The meshes
+    // of the objects created later by rooms and traps are sent by name
+    for(const std::pair<const CreatureDefinition*,CreatureDefinition*>& def : mClassDescriptions)
+    {
+        const CreatureDefinition* creatureDefinition = (def.second != nullptr) ? def.second : def.first;
+        mNetworkIdTable.addNameIfMissing(NetworkIdCategory::mesh, creatureDefinition->getMeshName());
+        mNetworkIdTable.addNameIfMissing(NetworkIdCategory::mesh, creatureDefinition->getBedMeshName());
+    }
+    for(MovableGameEntity* entity : mAnimatedObjects)
+        mNetworkIdTable.addNameIfMissing(NetworkIdCategory::mesh, entity->getMeshName());
+    for(RenderedMovableEntity* entity : mRenderedMovableEntities)
+        mNetworkIdTable.addNameIfMissing(NetworkIdCategory::mesh, entity->getMeshName());
+
+    // Animations played by the creatures and by the room and trap objects
+    const std::vector<std::string> animations = {
+        EntityAnimation::idle_anim, EntityAnimation::flee_anim, EntityAnimation::die_anim,
+        EntityAnimation::dig_anim, EntityAnimation::attack_anim, EntityAnimation::claim_anim,
+        EntityAnimation::walk_anim, EntityAnimation::sleep_anim, TrapDoor::ANIMATION_OPEN,
+        TrapDoor::ANIMATION_CLOSE, "Triggered", "Pick"
+    };
+    for(const std::string& animation : animations)
+        mNetworkIdTable.addNameIfMissing(NetworkIdCategory::animation, animation);
 }
 
 void GameMap::queueEntityForDeletion(GameEntity *ge)
@@ -513,38 +599,29 @@ void GameMap::queueEntityForDeletion(GameEntity *ge)
 
 const CreatureDefinition* GameMap::getClassDescription(const string &className)
 {
-    for (std::pair<const CreatureDefinition*,CreatureDefinition*>& def : mClassDescriptions)
-    {
-        if (def.second != nullptr)
-        {
-            if(def.second->getClassName().compare(className) == 0)
-                return def.second;
-        }
-        else if(def.first->getClassName().compare(className) == 0)
-            return def.first;
-    }
+    uint32_t id = mNetworkIdTable.getId(NetworkIdCategory::creatureClass, className);
+    if(id >= mClassDescriptions.size())
+        return nullptr;
 
-    return nullptr;
+    return getClassDescription(static_cast<int>(id));
 }
 
 CreatureDefinition* GameMap::getClassDescriptionForTuning(const std::string& name)
 {
-    for (std::pair<const CreatureDefinition*,CreatureDefinition*>& def : mClassDescriptions)
+    uint32_t id = mNetworkIdTable.getId(NetworkIdCategory::creatureClass, name);
+    if(id < mClassDescriptions.size())
     {
+        std::pair<const CreatureDefinition*,CreatureDefinition*>& def = mClassDescriptions[id];
         if(def.second != nullptr)
-        {
-            if (def.second->getClassName().compare(name) == 0)
-                return def.second;
-        }
-        else if(def.first->getClassName().compare(name) == 0)
-        {
-            def.second = new CreatureDefinition(*def.first);
             return def.second;
-        }
+
+        def.second = new CreatureDefinition(*def.first);
+        return def.second;
     }
 
     // It is a new definition
     CreatureDefinition* def = new CreatureDefinition(name);
+    mNetworkIdTable.addName(NetworkIdCategory::creatureClass, name);
     mClassDescriptions.push_back(std::pair<const CreatureDefinition*,CreatureDefinition*>(nullptr, def));
     return def;
 }
@@ -889,14 +966,15 @@ unsigned int GameMap::numClassDescriptions()
     return mClassDescriptions.size();
 }
 
-void GameMap::saveLevelClassDescriptions(std::ofstream& levelFile)
+void GameMap::getLevelClassDescriptions(std::vector<std::pair<const CreatureDefinition*, const CreatureDefinition*>>& defs) const
 {
-    for (std::pair<const CreatureDefinition*,CreatureDefinition*>& def : mClassDescriptions)
+    defs.clear();
+    for (const std::pair<const CreatureDefinition*,CreatureDefinition*>& def : mClassDescriptions)
     {
         if(def.second == nullptr)
             continue;
 
-        CreatureDefinition::writeCreatureDefinitionDiff(def.first, def.second, levelFile, ConfigManager::getSingleton().getCreatureDefinitions());
+        defs.push_back(std::pair<const CreatureDefinition*, const CreatureDefinition*>(def.first, def.second));
     }
 }
 
@@ -1087,10 +1165,83 @@ void GameMap::doTurn(double timeSinceLastTurn)
         seat->getPlayer()->upkeepPlayer(timeSinceLastTurn);
     }
 
+    processPathRequests();
+
+    publishSnapshot();
+
     OD_LOG_INF("During this turn there were " + Helper::toString(mNumCallsTo_path - numCallsTo_path_atStart)
         + " calls to GameMap::path(), miscUpkeepTime=" + Helper::toString(miscUpkeepTime));
 }
 
+void GameMap::publishSnapshot()
+{
+    if((mSnapshotBuilder.getMapSizeX() != getMapSizeX()) ||
+       (mSnapshotBuilder.getMapSizeY() != getMapSizeY()))
+    {
+        // First snapshot for this map. Every tile is copied
+        mSnapshotBuilder.resize(getMapSizeX(), getMapSizeY());
+        mSnapshotTilesListed.assign(getMapSizeX() * getMapSizeY(), true);
+        mSnapshotChangedTiles.clear();
+        for(int xx = 0; xx < getMapSizeX(); ++xx)
+        {
+            for(int yy = 0; yy < getMapSizeY(); ++yy)
+                mSnapshotChangedTiles.push_back(getTile(xx, yy));
+        }
+    }
+
+    // Only the tiles changed since the last snapshot are copied. The pages containing them are
+    // copied if they are shared with the published snapshot
+    for(Tile* tile : mSnapshotChangedTiles)
+    {
+        TileSnapshot tileSnapshot;
+        tileSnapshot.mType = tile->getType();
+        tileSnapshot.mTileVisual = tile->getTileVisual();
+        tileSnapshot.mFullness = tile->getFullness();
+        if(tile->getSeat() != nullptr)
+            tileSnapshot.mSeatId = tile->getSeat()->getId();
+        tileSnapshot.mIsClaimed = tile->isClaimed();
+        tileSnapshot.mIsBuilding = (tile->getCoveringBuilding() != nullptr);
+        mSnapshotBuilder.setTile(tile->getX(), tile->getY(), tileSnapshot);
+        mSnapshotTilesListed[tile->getX() + tile->getY() * getMapSizeX()] = false;
+    }
+    mSnapshotChangedTiles.clear();
+
+    mSnapshotBuilder.clearCreatures();
+    for(Creature* creature : mCreatures)
+    {
+        CreatureSnapshot creatureSnapshot;
+        creatureSnapshot.mName = creature->getName();
+        creatureSnapshot.mClassName = creature->getDefinition()->getClassName();
+        if(creature->getSeat() != nullptr)
+            creatureSnapshot.mSeatId = creature->getSeat()->getId();
+        Tile* posTile = creature->getPositionTile();
+        if(posTile != nullptr)
+        {
+            creatureSnapshot.mTileX = posTile->getX();
+            creatureSnapshot.mTileY = posTile->getY();
+        }
+        creatureSnapshot.mHP = creature->getHP();
+        creatureSnapshot.mLevel = creature->getLevel();
+        mSnapshotBuilder.addCreature(creatureSnapshot);
+    }
+
+    mSnapshotBuilder.publish(mTurnNumber);
+}
+
+void GameMap::notifyTileSnapshotChanged(Tile* tile)
+{
+    // Before the first snapshot, there is nothing to track: every tile will be copied
+    if(mSnapshotTilesListed.empty())
+        return;
+
+    uint32_t index = static_cast<uint32_t>(tile->getX() + tile->getY() * getMapSizeX());
+    if(mSnapshotTilesListed[index])
+        return;
+
+    mSnapshotTilesListed[index] = true;
+    mSnapshotChangedTiles.push_back(tile);
+}
+
 void GameMap::doPlayerAITurn(double timeSinceLastTurn)
 {
     mAiManager.doTurn(timeSinceLastTurn);
@@ -1098,10 +1249,15 @@ void GameMap::doPlayerAITurn(double timeSinceLastTurn)
 
 unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
 {
-    Tile *tempTile;
     Ogre::Timer stopwatch;
     unsigned long int timeTaken;
 
+#ifdef OD_DEBUG
+    // The seat counters are updated when the entities change. In debug, we check
+    // that they are consistent with a full recompute
+    checkSeatCounters();
+#endif
+
     // We check if it is pay day
     mTimePayDay += timeSinceLastTurn;
     if((mTimePayDay >= ConfigManager::getSingleton().getTimePayDay()))
@@ -1160,28 +1316,6 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
             addWinningSeat(seat);
 
         seat->mNumCreaturesFightersMax = getMaxNumberCreatures(seat);
-
-        // Set the creatures count to 0. It will be reset by the next count in doTurn()
-        seat->mNumCreaturesFighters = 0;
-        seat->mNumCreaturesWorkers = 0;
-    }
-
-    // Count how many creatures the player controls
-    for(Creature* creature : mCreatures)
-    {
-        // Check to see if the creature has died.
-        if (!creature->isAlive())
-            continue;
-
-        Seat *tempSeat = creature->getSeat();
-        if(tempSeat == nullptr)
-            continue;
-
-        // We only count fighters
-        if (creature->getDefinition()->isWorker())
-            ++(tempSeat->mNumCreaturesWorkers);
-        else
-            ++(tempSeat->mNumCreaturesFighters);
     }
 
     // At each upkeep, we re-compute tiles with vision
@@ -1235,15 +1369,17 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
     for(GameEntity* ge : activeObjects)
         ge->doUpkeep();
 
-    // Carry out the upkeep round for each seat. This means recomputing how much gold is
-    // available in their treasuries, how much mana they gain/lose during this turn, etc.
+    // The paths asked by the creatures during their upkeep are given before they move
+    processPathRequests();
+
+    // Carry out the upkeep round for each seat. This means computing how much mana they
+    // gain/lose during this turn. Gold, rooms and claimed tiles counters are kept up to date
+    // by the entities themselves
     for (Seat* seat : mSeats)
     {
         if(seat->getPlayer() == nullptr)
             continue;
 
-        seat->computeSeatBeginTurn();
-
         // Add the amount of mana this seat accrued this turn if the player has a dungeon temple
         if(seat->getNbRooms(RoomType::dungeonTemple) == 0)
         {
@@ -1258,43 +1394,86 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
             if (seat->mMana > maxMana)
                 seat->mMana = maxMana;
         }
+    }
+
+    timeTaken = stopwatch.getMicroseconds();
+    return timeTaken;
+}
 
-        // Update the count on how much gold is available in all of the treasuries claimed by the given seat.
-        seat->mGold = 0;
-        seat->mGoldMax = 0;
-        for (Room* room : getRooms())
+void GameMap::checkSeatCounters() const
+{
+    for(Seat* seat : mSeats)
+    {
+        if(seat->getPlayer() == nullptr)
+            continue;
+
+        int gold = 0;
+        int goldMax = 0;
+        std::vector<uint32_t> nbRooms(static_cast<uint32_t>(RoomType::nbRooms), 0);
+        for(Room* room : mRooms)
         {
             if(room->getSeat() != seat)
                 continue;
 
-            seat->mGold += room->getTotalGoldStored();
-            seat->mGoldMax += room->getTotalGoldStorage();
-        }
-    }
+            gold += room->getTotalGoldStored();
+            goldMax += room->getTotalGoldStorage();
+            if(room->getHP(nullptr) <= 0.0)
+                continue;
 
-    // Determine the number of tiles claimed by each seat.
-    // Begin by setting the number of claimed tiles for each seat to 0.
-    for (Seat* seat : mSeats)
-        seat->setNumClaimedTiles(0);
+            ++nbRooms[static_cast<uint32_t>(room->getType())];
+        }
 
-    // Now loop over all of the tiles, if the tile is claimed increment the given seats count.
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
+        int nbWorkers = 0;
+        int nbFighters = 0;
+        for(Creature* creature : mCreatures)
         {
-            tempTile = getTile(ii,jj);
+            if(creature->getSeat() != seat)
+                continue;
+            if(!creature->isAlive())
+                continue;
 
-            // Check to see if the current tile is claimed by anyone.
-            if (tempTile->isClaimed())
+            if(creature->getDefinition()->isWorker())
+                ++nbWorkers;
+            else
+                ++nbFighters;
+        }
+
+        unsigned int nbClaimedTiles = 0;
+        for(int jj = 0; jj < getMapSizeY(); ++jj)
+        {
+            for(int ii = 0; ii < getMapSizeX(); ++ii)
             {
-                // Increment the count of the seat who owns the tile.
-                tempTile->getSeat()->incrementNumClaimedTiles();
+                Tile* tile = getTile(ii, jj);
+                if(tile->isClaimed() && (tile->getSeat() == seat))
+                    ++nbClaimedTiles;
             }
         }
-    }
 
-    timeTaken = stopwatch.getMicroseconds();
-    return timeTaken;
+        const std::string seatStr = "seatId=" + Helper::toString(seat->getId());
+        if((seat->mGold != gold) || (seat->mGoldMax != goldMax))
+        {
+            OD_LOG_ERR(seatStr + ", gold=" + Helper::toString(seat->mGold) + "/" + Helper::toString(seat->mGoldMax)
+                + ", expected=" + Helper::toString(gold) + "/" + Helper::toString(goldMax));
+        }
+        if((seat->mNumCreaturesWorkers != nbWorkers) || (seat->mNumCreaturesFighters != nbFighters))
+        {
+            OD_LOG_ERR(seatStr + ", workers=" + Helper::toString(seat->mNumCreaturesWorkers) + ", fighters=" + Helper::toString(seat->mNumCreaturesFighters)
+                + ", expected=" + Helper::toString(nbWorkers) + "/" + Helper::toString(nbFighters));
+        }
+        if(seat->getNumClaimedTiles() != nbClaimedTiles)
+        {
+            OD_LOG_ERR(seatStr + ", claimedTiles=" + Helper::toString(seat->getNumClaimedTiles())
+                + ", expected=" + Helper::toString(nbClaimedTiles));
+        }
+        for(uint32_t index = 0; index < nbRooms.size(); ++index)
+        {
+            if(seat->getNbRooms(static_cast<RoomType>(index)) == nbRooms[index])
+                continue;
+
+            OD_LOG_ERR(seatStr + ", roomIndex=" + Helper::toString(index) + ", nbRooms=" + Helper::toString(seat->getNbRooms(static_cast<RoomType>(index)))
+                + ", expected=" + Helper::toString(nbRooms[index]));
+        }
+    }
 }
 
 void GameMap::updateAnimations(Ogre::Real timeSinceLastFrame)
@@ -1305,6 +1484,9 @@ void GameMap::updateAnimations(Ogre::Real timeSinceLastFrame)
     if(getTurnNumber() <= 0)
         return;
 
+    // Paths may have been asked since the last turn (AI, console commands, ...)
+    processPathRequests();
+
     // Update the animations on all AnimatedObjects
     for(MovableGameEntity* mge : mAnimatedObjects)
         mge->update(timeSinceLastFrame);
@@ -1334,11 +1516,11 @@ void GameMap::playerIsFighting(Player* player, Tile* tile)
     }
 }
 
-std::list<Tile*> GameMap::findBestPath(const Creature* creature, Tile* tileStart, const std::vector<Tile*> possibleDests,
+TilePath GameMap::findBestPath(const Creature* creature, Tile* tileStart, const std::vector<Tile*> possibleDests,
     Tile*& chosenTile)
 {
     chosenTile = nullptr;
-    std::list<Tile*> returnList;
+    TilePath returnList;
     if(possibleDests.empty())
         return returnList;
 
@@ -1370,12 +1552,12 @@ std::list<Tile*> GameMap::findBestPath(const Creature* creature, Tile* tileStart
         if(walkableDist < (dist * magic))
             continue;
 
-        std::list<Tile*> pathTmp = path(tileStart, tile, creature, creature->getSeat(), false);
+        TilePath pathTmp = path(tileStart, tile, creature, creature->getSeat(), false);
         if(pathTmp.size() < returnList.size())
         {
             // The path is shorter
             chosenTile = tile;
-            returnList = pathTmp;
+            returnList = std::move(pathTmp);
         }
     }
     return returnList;
@@ -1392,23 +1574,7 @@ bool GameMap::pathExists(const Creature* creature, Tile* tileStart, Tile* tileEn
     if(creature == nullptr)
         return false;
 
-    FloodFillType floodFill = FloodFillType::ground;
-    if((creature->getMoveSpeedGround() > 0.0) &&
-        (creature->getMoveSpeedWater() > 0.0) &&
-        (creature->getMoveSpeedLava() > 0.0))
-    {
-        floodFill = FloodFillType::groundWaterLava;
-    }
-    if((creature->getMoveSpeedGround() > 0.0) &&
-        (creature->getMoveSpeedWater() > 0.0))
-    {
-        floodFill = FloodFillType::groundWater;
-    }
-    if((creature->getMoveSpeedGround() > 0.0) &&
-        (creature->getMoveSpeedLava() > 0.0))
-    {
-        floodFill = FloodFillType::groundLava;
-    }
+    FloodFillType floodFill = getFloodFillTypeForCreature(creature);
 
     if(creature->getDefinition()->isWorker())
     {
@@ -1432,10 +1598,10 @@ bool GameMap::pathExists(const Creature* creature, Tile* tileStart, Tile* tileEn
     }
 }
 
-std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* creature, Seat* seat, bool throughDiggableTiles)
+TilePath GameMap::path(int x1, int y1, int x2, int y2, const Creature* creature, Seat* seat, bool throughDiggableTiles)
 {
     ++mNumCallsTo_path;
-    std::list<Tile*> returnList;
+    TilePath returnList;
 
     // If the start tile was not found return an empty path
     Tile* start = getTile(x1, y1);
@@ -1450,6 +1616,176 @@ std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* c
     if (creature == nullptr)
         return returnList;
 
+    // Paths through diggable tiles depend on the tiles marked for digging which do not invalidate the cache. And
+    // if the floodfill is not enabled (editor or client), the cache would not be invalidated when tiles change
+    if(throughDiggableTiles || !mFloodFillEnabled)
+        return computePath(start, destination, creature, seat, throughDiggableTiles);
+
+    // The cached paths are invalidated by floodfill component. If the start tile has no floodfill value, we
+    // would not know when to invalidate the path
+    uint32_t component = start->getFloodFillValue(creature->getSeat(), getFloodFillTypeForCreature(creature));
+    if(component == Tile::NO_FLOODFILL)
+        return computePath(start, destination, creature, seat, throughDiggableTiles);
+
+    PathCache::Key key(start, destination, *creature);
+    const TilePath* cachedPath = mPathCache.find(key);
+    if(cachedPath != nullptr)
+        return cachedPath->share();
+
+    returnList = computePath(start, destination, creature, seat, throughDiggableTiles);
+    mPathCache.insert(key, component, returnList);
+    return returnList;
+}
+
+void GameMap::requestPath(Creature* creature, Tile* destination)
+{
+    ++mLastPathRequestId;
+    // 0 means no request
+    if(mLastPathRequestId == 0)
+        ++mLastPathRequestId;
+
+    ++mNbPathRequests;
+    creature->setPathRequestId(mLastPathRequestId);
+    mPathRequests.push_back(PathRequest(creature, destination, mLastPathRequestId));
+}
+
+void GameMap::processPathRequests()
+{
+    if(mPathRequests.empty())
+        return;
+
+    // The requests made while the paths are given will be processed by the next call
+    mPathRequestsProcessing.swap(mPathRequests);
+
+    //! \brief A path solved for one or more requests
+    struct PathJob
+    {
+        PathJob(const PathCache::Key& key, const Creature* creature, uint32_t component) :
+            mKey(key),
+            mCreature(creature),
+            mComponent(component)
+        {}
+
+        PathCache::Key mKey;
+        const Creature* mCreature;
+        uint32_t mComponent;
+        TilePath mPath;
+    };
+
+    const uint32_t NO_JOB = static_cast<uint32_t>(-1);
+    const uint32_t CACHED_JOB = static_cast<uint32_t>(-2);
+    std::vector<PathJob> jobs;
+    std::map<PathCache::Key, uint32_t> jobIndexes;
+    for(PathRequest& request : mPathRequestsProcessing)
+    {
+        Creature* creature = request.mCreature;
+        request.mJob = NO_JOB;
+        // If the walk path was set or cleared since the request, it is cancelled
+        if(creature->getPathRequestId() != request.mId)
+            continue;
+
+        Tile* start = creature->getPositionTile();
+        if(start == nullptr)
+        {
+            creature->setPathRequestId(0);
+            continue;
+        }
+
+        ++mNumCallsTo_path;
+        PathCache::Key key(start, request.mDestination, *creature);
+        uint32_t component = Tile::NO_FLOODFILL;
+        if(mFloodFillEnabled)
+            component = start->getFloodFillValue(creature->getSeat(), getFloodFillTypeForCreature(creature));
+
+        // Like in path(), paths are only cached when we know when to invalidate them
+        if(component != Tile::NO_FLOODFILL)
+        {
+            const TilePath* cachedPath = mPathCache.find(key);
+            if(cachedPath != nullptr)
+            {
+                request.mJob = CACHED_JOB;
+                request.mPath = cachedPath->share();
+                continue;
+            }
+        }
+
+        auto it = jobIndexes.find(key);
+        if(it != jobIndexes.end())
+        {
+            ++mNbPathRequestsMerged;
+            request.mJob = it->second;
+            continue;
+        }
+
+        request.mJob = static_cast<uint32_t>(jobs.size());
+        jobIndexes[key] = request.mJob;
+        jobs.push_back(PathJob(key, creature, component));
+    }
+
+    // Solving a path only reads the game map. Nothing changes it while the threads are running
+    // since this thread waits for them
+    uint32_t nbJobs = static_cast<uint32_t>(jobs.size());
+    mNbPathRequestsSolved += nbJobs;
+    auto solveJobs = [this, &jobs](uint32_t indexBegin, uint32_t indexEnd)
+    {
+        for(uint32_t i = indexBegin; i < indexEnd; ++i)
+        {
+            PathJob& job = jobs[i];
+            job.mPath = computePath(job.mKey.mStart, job.mKey.mDest, job.mCreature, job.mCreature->getSeat(), false);
+        }
+    };
+
+    uint32_t nbThreads = std::max(1u, std::thread::hardware_concurrency());
+    nbThreads = std::min(nbThreads, nbJobs / MIN_PATHS_PER_THREAD);
+    if(nbThreads <= 1)
+        solveJobs(0, nbJobs);
+    else
+    {
+        // This thread solves the last part
+        uint32_t nbJobsPerThread = (nbJobs + nbThreads - 1) / nbThreads;
+        std::vector<std::unique_ptr<sf::Thread>> threads;
+        for(uint32_t i = 0; i < nbThreads - 1; ++i)
+        {
+            uint32_t indexBegin = i * nbJobsPerThread;
+            uint32_t indexEnd = indexBegin + nbJobsPerThread;
+            threads.emplace_back(new sf::Thread([&solveJobs, indexBegin, indexEnd]()
+            {
+                solveJobs(indexBegin, indexEnd);
+            }));
+            threads.back()->launch();
+        }
+        solveJobs((nbThreads - 1) * nbJobsPerThread, nbJobs);
+
+        for(std::unique_ptr<sf::Thread>& thread : threads)
+            thread->wait();
+    }
+
+    for(PathJob& job : jobs)
+    {
+        if(job.mComponent != Tile::NO_FLOODFILL)
+            mPathCache.insert(job.mKey, job.mComponent, job.mPath);
+    }
+
+    for(PathRequest& request : mPathRequestsProcessing)
+    {
+        if(request.mJob == NO_JOB)
+            continue;
+
+        const TilePath& path = (request.mJob == CACHED_JOB) ? request.mPath : jobs[request.mJob].mPath;
+        request.mCreature->setWalkPath(EntityAnimation::walk_anim, EntityAnimation::idle_anim, true, true, path);
+    }
+
+    mPathRequestsProcessing.clear();
+}
+
+TilePath GameMap::computePath(Tile* start, Tile* destination, const Creature* creature, Seat* seat, bool throughDiggableTiles)
+{
+    TilePath returnList;
+    int x1 = start->getX();
+    int y1 = start->getY();
+    int x2 = destination->getX();
+    int y2 = destination->getY();
+
     // If flood filling is enabled, we can possibly eliminate this path by checking to see if they two tiles are floodfilled differently.
     if (!throughDiggableTiles && !pathExists(creature, start, destination))
         return returnList;
@@ -1631,11 +1967,14 @@ std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* c
         {
             if (curEntry->getTile() != nullptr)
             {
-                returnList.push_front(curEntry->getTile());
+                returnList.pushBack(curEntry->getTile());
                 curEntry = curEntry->getParent();
             }
 
         } while (curEntry != nullptr);
+
+        // The path has been filled from the destination
+        returnList.reverse();
     }
 
     // Clean up the memory we allocated by deleting the astarEntries.  Note that
@@ -1812,6 +2151,8 @@ void GameMap::addRoom(Room *r)
     }
 
     mRooms.push_back(r);
+    notifyBuildingsChanged();
+    notifyGoalDependencyChanged(Goal::DEPENDENCY_ROOMS);
 }
 
 void GameMap::removeRoom(Room *r)
@@ -1827,6 +2168,8 @@ void GameMap::removeRoom(Room *r)
     }
 
     mRooms.erase(it);
+    notifyBuildingsChanged();
+    notifyGoalDependencyChanged(Goal::DEPENDENCY_ROOMS);
 }
 
 std::vector<Room*> GameMap::getRoomsByType(RoomType type) const
@@ -1841,93 +2184,187 @@ std::vector<Room*> GameMap::getRoomsByType(RoomType type) const
     return returnList;
 }
 
-std::vector<Room*> GameMap::getRoomsByTypeAndSeat(RoomType type, const Seat* seat)
+const std::vector<Room*>& GameMap::getRoomsByTypeAndSeat(RoomType type, const Seat* seat) const
 {
-    std::vector<Room*> returnList;
-    for (Room* room : mRooms)
+    SeatBuildings* seatBuildings = getSeatBuildings(seat);
+    if(seatBuildings == nullptr)
+        return EMPTY_ROOMS;
+
+    uint32_t index = static_cast<uint32_t>(type);
+    if(index >= seatBuildings->mRoomsByType.size())
     {
-        if (room->getType() == type && room->getSeat() == seat && room->getHP(nullptr) > 0.0)
-            returnList.push_back(room);
+        OD_LOG_ERR("wrong index=" + Helper::toString(index) + ", size=" + Helper::toString(seatBuildings->mRoomsByType.size()));
+        return EMPTY_ROOMS;
     }
 
-    return returnList;
+    return seatBuildings->mRoomsByType[index];
 }
 
-std::vector<const Room*> GameMap::getRoomsByTypeAndSeat(RoomType type, const Seat* seat) const
+unsigned int GameMap::numRoomsByTypeAndSeat(RoomType type, const Seat* seat) const
 {
-    std::vector<const Room*> returnList;
-    for (const Room* room : mRooms)
+    SeatBuildings* seatBuildings = getSeatBuildings(seat);
+    if(seatBuildings == nullptr)
+        return 0;
+
+    uint32_t index = static_cast<uint32_t>(type);
+    if(index >= seatBuildings->mRoomsByType.size())
     {
-        if (room->getType() == type && room->getSeat() == seat && room->getHP(nullptr) > 0.0)
-            returnList.push_back(room);
+        OD_LOG_ERR("wrong index=" + Helper::toString(index) + ", size=" + Helper::toString(seatBuildings->mRoomsByType.size()));
+        return 0;
     }
 
-    return returnList;
+    return seatBuildings->mRoomsByType[index].size();
 }
 
-unsigned int GameMap::numRoomsByTypeAndSeat(RoomType type, const Seat* seat) const
+const std::vector<Room*>& GameMap::getReachableRoomsByTypeAndSeat(RoomType type, const Seat* seat,
+        Tile* startTile, const Creature* creature)
 {
-    int cptRooms = 0;
-    for (Room* room : mRooms)
+    SeatBuildings* seatBuildings = getSeatBuildings(seat);
+    if(seatBuildings == nullptr)
+        return EMPTY_ROOMS;
+
+    uint32_t index = static_cast<uint32_t>(type);
+    if(index >= seatBuildings->mRoomsByType.size())
     {
-        if (room->getType() == type && room->getSeat() == seat && room->getHP(nullptr) > 0.0)
-            ++cptRooms;
+        OD_LOG_ERR("wrong index=" + Helper::toString(index) + ", size=" + Helper::toString(seatBuildings->mRoomsByType.size()));
+        return EMPTY_ROOMS;
     }
-    return cptRooms;
+
+    const std::vector<Room*>& rooms = seatBuildings->mRoomsByType[index];
+    // If floodfill is not enabled, we cannot check if the path exists so we consider every room reachable (like pathExists)
+    if(!mFloodFillEnabled)
+        return rooms;
+
+    if((creature == nullptr) || rooms.empty())
+        return EMPTY_ROOMS;
+
+    FloodFillType floodFillType = getFloodFillTypeForCreature(creature);
+    const Seat* creatureSeat = creature->getDefinition()->isWorker() ? nullptr : creature->getSeat();
+    std::map<std::vector<uint32_t>, std::vector<Room*>>& buckets = seatBuildings->mReachableRooms[
+        std::make_tuple(creatureSeat, static_cast<uint32_t>(floodFillType), static_cast<uint32_t>(type))];
+    if(buckets.empty())
+        fillFloodFillBuckets(creature, floodFillType, rooms, buckets);
+
+    fillFloodFillComponent(creature, floodFillType, startTile, mFloodFillComponent);
+    auto it = buckets.find(mFloodFillComponent);
+    if(it == buckets.end())
+        return EMPTY_ROOMS;
+
+    return it->second;
 }
 
-std::vector<Room*> GameMap::getReachableRooms(const std::vector<Room*>& vec,
-                                              Tile* startTile,
-                                              const Creature* creature)
+const std::vector<Building*>& GameMap::getReachableBuildingsPerSeat(const Seat* seat,
+       Tile *startTile, const Creature* creature)
 {
-    std::vector<Room*> returnVector;
+    SeatBuildings* seatBuildings = getSeatBuildings(seat);
+    if(seatBuildings == nullptr)
+        return EMPTY_BUILDINGS;
 
-    for (unsigned int i = 0; i < vec.size(); ++i)
-    {
-        Room* room = vec[i];
-        Tile* coveredTile = room->getCoveredTile(0);
-        if (pathExists(creature, startTile, coveredTile))
-        {
-            returnVector.push_back(room);
-        }
-    }
+    // If floodfill is not enabled, we cannot check if the path exists so we consider every building reachable (like pathExists)
+    if(!mFloodFillEnabled)
+        return seatBuildings->mBuildings;
+
+    if((creature == nullptr) || seatBuildings->mBuildings.empty())
+        return EMPTY_BUILDINGS;
+
+    FloodFillType floodFillType = getFloodFillTypeForCreature(creature);
+    const Seat* creatureSeat = creature->getDefinition()->isWorker() ? nullptr : creature->getSeat();
+    std::map<std::vector<uint32_t>, std::vector<Building*>>& buckets = seatBuildings->mReachableBuildings[
+        std::make_pair(creatureSeat, static_cast<uint32_t>(floodFillType))];
+    if(buckets.empty())
+        fillFloodFillBuckets(creature, floodFillType, seatBuildings->mBuildings, buckets);
+
+    fillFloodFillComponent(creature, floodFillType, startTile, mFloodFillComponent);
+    auto it = buckets.find(mFloodFillComponent);
+    if(it == buckets.end())
+        return EMPTY_BUILDINGS;
 
-    return returnVector;
+    return it->second;
 }
 
-std::vector<Building*> GameMap::getReachableBuildingsPerSeat(Seat* seat,
-       Tile *startTile, const Creature* creature)
+GameMap::SeatBuildings* GameMap::getSeatBuildings(const Seat* seat) const
 {
-    std::vector<Building*> returnList;
-    for (Room* room : mRooms)
+    if(mSeatBuildingsDirty)
     {
-        if (room->getSeat() != seat)
-            continue;
+        mSeatBuildingsDirty = false;
+        mReachableBuildingsDirty = false;
+        mSeatBuildings.clear();
+        for(Room* room : mRooms)
+        {
+            if(room->getHP(nullptr) <= 0.0)
+                continue;
 
-        if (room->getHP(nullptr) <= 0.0)
-            continue;
+            SeatBuildings& seatBuildings = mSeatBuildings[room->getSeat()];
+            if(seatBuildings.mRoomsByType.empty())
+                seatBuildings.mRoomsByType.resize(static_cast<uint32_t>(RoomType::nbRooms));
 
-        if(!pathExists(creature, startTile, room->getCoveredTile(0)))
-            continue;
+            uint32_t index = static_cast<uint32_t>(room->getType());
+            if(index >= seatBuildings.mRoomsByType.size())
+            {
+                OD_LOG_ERR("room=" + room->getName() + ", wrong index=" + Helper::toString(index));
+                continue;
+            }
+
+            seatBuildings.mRoomsByType[index].push_back(room);
+            seatBuildings.mBuildings.push_back(room);
+        }
+
+        for(Trap* trap : mTraps)
+        {
+            if(trap->getHP(nullptr) <= 0.0)
+                continue;
+
+            SeatBuildings& seatBuildings = mSeatBuildings[trap->getSeat()];
+            if(seatBuildings.mRoomsByType.empty())
+                seatBuildings.mRoomsByType.resize(static_cast<uint32_t>(RoomType::nbRooms));
 
-        returnList.push_back(room);
+            seatBuildings.mBuildings.push_back(trap);
+        }
+    }
+    else if(mReachableBuildingsDirty)
+    {
+        mReachableBuildingsDirty = false;
+        for(std::pair<const Seat* const, SeatBuildings>& p : mSeatBuildings)
+        {
+            p.second.mReachableBuildings.clear();
+            p.second.mReachableRooms.clear();
+        }
     }
 
-    for (Trap* trap : mTraps)
+    auto it = mSeatBuildings.find(seat);
+    if(it == mSeatBuildings.end())
+        return nullptr;
+
+    return &it->second;
+}
+
+void GameMap::fillFloodFillComponent(const Creature* creature, FloodFillType floodFillType, Tile* tile,
+        std::vector<uint32_t>& component) const
+{
+    component.clear();
+    if(!creature->getDefinition()->isWorker())
     {
-        if (trap->getSeat() != seat)
-            continue;
+        component.push_back(tile->getFloodFillValue(creature->getSeat(), floodFillType));
+        return;
+    }
 
-        if (trap->getHP(nullptr) <= 0.0)
-            continue;
+    for(Seat* seat : mSeats)
+        component.push_back(tile->getFloodFillValue(seat, floodFillType));
+}
 
-        if(!pathExists(creature, startTile, trap->getCoveredTile(0)))
+template<typename T>
+void GameMap::fillFloodFillBuckets(const Creature* creature, FloodFillType floodFillType, const std::vector<T*>& buildings,
+        std::map<std::vector<uint32_t>, std::vector<T*>>& buckets) const
+{
+    std::vector<uint32_t> component;
+    for(T* building : buildings)
+    {
+        if(building->numCoveredTiles() <= 0)
             continue;
 
-        returnList.push_back(trap);
+        fillFloodFillComponent(creature, floodFillType, building->getCoveredTile(0), component);
+        buckets[component].push_back(building);
     }
-
-    return returnList;
 }
 
 Room* GameMap::getRoomByName(const std::string& name)
@@ -1972,6 +2409,7 @@ void GameMap::addTrap(Trap *trap)
         + Helper::toString(nbTiles) + ", seatId=" + Helper::toString(trap->getSeat()->getId()));
 
     mTraps.push_back(trap);
+    notifyBuildingsChanged();
 }
 
 void GameMap::removeTrap(Trap *t)
@@ -1985,6 +2423,7 @@ void GameMap::removeTrap(Trap *t)
     }
 
     mTraps.erase(it);
+    notifyBuildingsChanged();
 }
 
 bool GameMap::withdrawFromTreasuries(int gold, Seat* seat)
@@ -2122,6 +2561,14 @@ void GameMap::addWinningSeat(Seat *s)
     fireRelativeSound(seats, SoundRelativeKeeperStatements::Victory);
 
     mWinningSeats.push_back(s);
+    // The goals string shows the victory
+    s->mHasGoalsChanged = true;
+}
+
+void GameMap::notifyGoalDependencyChanged(uint32_t dependencies)
+{
+    for(Seat* seat : mSeats)
+        seat->notifyGoalDependencyChanged(dependencies);
 }
 
 bool GameMap::seatIsAWinner(Seat *s) const
@@ -2441,25 +2888,25 @@ void GameMap::enableFloodFill()
     }
 }
 
-std::list<Tile*> GameMap::path(Creature *c1, Creature *c2, const Creature* creature, Seat* seat, bool throughDiggableTiles)
+TilePath GameMap::path(Creature *c1, Creature *c2, const Creature* creature, Seat* seat, bool throughDiggableTiles)
 {
     return path(c1->getPositionTile()->getX(), c1->getPositionTile()->getY(),
                 c2->getPositionTile()->getX(), c2->getPositionTile()->getY(), creature, seat, throughDiggableTiles);
 }
 
-std::list<Tile*> GameMap::path(Tile *t1, Tile *t2, const Creature* creature, Seat* seat, bool throughDiggableTiles)
+TilePath GameMap::path(Tile *t1, Tile *t2, const Creature* creature, Seat* seat, bool throughDiggableTiles)
 {
     return path(t1->getX(), t1->getY(), t2->getX(), t2->getY(), creature, seat, throughDiggableTiles);
 }
 
-std::list<Tile*> GameMap::path(const Creature* creature, Tile* destination, bool throughDiggableTiles)
+TilePath GameMap::path(const Creature* creature, Tile* destination, bool throughDiggableTiles)
 {
     if (destination == nullptr)
-        return std::list<Tile*>();
+        return TilePath();
 
     Tile* positionTile = creature->getPositionTile();
     if (positionTile == nullptr)
-        return std::list<Tile*>();
+        return TilePath();
 
     return path(positionTile->getX(), positionTile->getY(),
                 destination->getX(), destination->getY(),
@@ -2707,6 +3154,51 @@ GameEntity* GameMap::getEntityFromTypeAndName(GameEntityType entityType,
     return nullptr;
 }
 
+void GameMap::logPathCacheStats()
+{
+    OD_LOG_INF(serverStr() + "Path cache: " + mPathCache.getStatsString());
+    OD_LOG_INF(serverStr() + "Path requests: requests=" + Helper::toString(mNbPathRequests)
+        + ", merged=" + Helper::toString(mNbPathRequestsMerged)
+        + ", solved=" + Helper::toString(mNbPathRequestsSolved));
+}
+
+void GameMap::logMapStats()
+{
+    // The stats are read from the snapshot so that they are consistent with the end of a turn
+    std::shared_ptr<const GameMapSnapshot> snapshot = getSnapshot();
+    if(snapshot == nullptr)
+    {
+        OD_LOG_INF(serverStr() + "Map stats: no snapshot published yet");
+        return;
+    }
+
+    std::map<int, uint32_t> claimedTiles;
+    std::map<int, uint32_t> creatures;
+    uint32_t goldTiles = 0;
+    for(int yy = 0; yy < snapshot->getMapSizeY(); ++yy)
+    {
+        for(int xx = 0; xx < snapshot->getMapSizeX(); ++xx)
+        {
+            const TileSnapshot* tile = snapshot->getTile(xx, yy);
+            if(tile->mIsClaimed)
+                ++claimedTiles[tile->mSeatId];
+            if((tile->mType == TileType::gold) && (tile->mFullness > 0.0))
+                ++goldTiles;
+        }
+    }
+    for(const CreatureSnapshot& creature : snapshot->getCreatures())
+        ++creatures[creature.mSeatId];
+
+    OD_LOG_INF(serverStr() + "Map stats at turn=" + Helper::toString(snapshot->getTurnNumber())
+        + ": goldTiles=" + Helper::toString(goldTiles));
+    for(Seat* seat : mSeats)
+    {
+        OD_LOG_INF(serverStr() + "Map stats seat=" + Helper::toString(seat->getId())
+            + ": claimedTiles=" + Helper::toString(claimedTiles[seat->getId()])
+            + ", creatures=" + Helper::toString(creatures[seat->getId()]));
+    }
+}
+
 void GameMap::logFloodFileTiles()
 {
     for(int yy = 0; yy < getMapSizeY(); ++yy)
@@ -2803,15 +3295,19 @@ Creature* GameMap::getWorkerForPathFinding(Seat* seat)
 
 void GameMap::updateVisibleEntities()
 {
-    // Notify what happened to entities on visible tiles
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
+    // Notify what happened to entities on visible tiles. The tiles without entities have nothing to
+    // notify so we remove them from the list
+    mTilesWithEntities.erase(std::remove_if(mTilesWithEntities.begin(), mTilesWithEntities.end(), [](Tile* tile)
         {
-            Tile* tile = getTile(ii,jj);
-            tile->notifyEntitiesSeatsWithVision();
-        }
-    }
+            if(tile->numEntitiesInTile() > 0)
+            {
+                tile->notifyEntitiesSeatsWithVision();
+                return false;
+            }
+
+            tile->notifyUnlistedWithEntities();
+            return true;
+        }), mTilesWithEntities.end());
 }
 
 void GameMap::fireRefreshEntities()
@@ -2820,10 +3316,72 @@ void GameMap::fireRefreshEntities()
     for(Seat* seat : mSeats)
         seat->notifyChangedVisibleTiles();
 
-    for(Creature* creature : mCreatures)
+    if(mEntitiesToRefresh.empty())
+        return;
+
+    // Each seat gets the entities it has vision on in one message. The entities far from the seat camera
+    // are deferred (see Seat::isChangeSentThisTurn)
+    std::vector<GameEntity*> entities;
+    for(Seat* seat : mSeats)
     {
-        creature->fireCreatureRefreshIfNeeded();
+        if(seat->getPlayer() == nullptr)
+            continue;
+        if(!seat->getPlayer()->getIsHuman())
+            continue;
+
+        entities.clear();
+        for(GameEntity* entity : mEntitiesToRefresh)
+        {
+            if(!entity->isRefreshPendingForSeat(seat))
+                continue;
+
+            // If the seat lost vision, it will get the entity state when it sees it again
+            if(!entity->hasSeatWithVisionNotified(seat))
+            {
+                entity->notifyRefreshForSeat(seat, true);
+                continue;
+            }
+
+            bool sent = seat->isChangeSentThisTurn(entity->getPositionTile());
+            entity->notifyRefreshForSeat(seat, sent);
+            if(sent)
+                entities.push_back(entity);
+        }
+
+        if(entities.empty())
+            continue;
+
+        ServerNotification *serverNotification = new ServerNotification(
+            ServerNotificationType::entitiesRefresh, seat->getPlayer());
+        uint32_t nbEntities = entities.size();
+        serverNotification->mPacket << nbEntities;
+        for(GameEntity* entity : entities)
+        {
+            GameEntityType entityType = entity->getObjectType();
+            serverNotification->mPacket << entityType;
+            serverNotification->mPacket << entity->getName();
+            entity->exportToPacketForUpdate(serverNotification->mPacket, seat);
+        }
+        ODServer::getSingleton().queueServerNotification(serverNotification);
     }
+
+    // We keep the entities some seats are still waiting for
+    mEntitiesToRefresh.erase(std::remove_if(mEntitiesToRefresh.begin(), mEntitiesToRefresh.end(), [](GameEntity* entity)
+        {
+            return !entity->notifyRefreshFired();
+        }), mEntitiesToRefresh.end());
+}
+
+void GameMap::removeEntityToRefresh(GameEntity* entity)
+{
+    std::vector<GameEntity*>::iterator it = std::find(mEntitiesToRefresh.begin(), mEntitiesToRefresh.end(), entity);
+    if(it == mEntitiesToRefresh.end())
+    {
+        OD_LOG_ERR("entity=" + entity->getName());
+        return;
+    }
+
+    mEntitiesToRefresh.erase(it);
 }
 
 void GameMap::addSpell(Spell *spell)
@@ -2935,7 +3493,7 @@ uint32_t GameMap::getMaxNumberCreatures(Seat* seat) const
 {
     uint32_t nbCreatures = ConfigManager::getSingleton().getMaxCreaturesPerSeatDefault();
 
-    std::vector<const Room*> portals = getRoomsByTypeAndSeat(RoomType::portal, seat);
+    const std::vector<Room*>& portals = getRoomsByTypeAndSeat(RoomType::portal, seat);
     for(const Room* room : portals)
     {
         const RoomPortal* roomPortal = static_cast<const RoomPortal*>(room);
@@ -3058,6 +3616,11 @@ void GameMap::clientUpKeep(int64_t turnNumber)
 
 void GameMap::doorLock(Tile* tileDoor, Seat* seat, bool locked)
 {
+    // Closed doors are impassable for some creatures even when the floodfill does not change
+    notifyPathingChanged();
+    // Closed doors also block vision
+    notifyTileVisionChanged(tileDoor);
+
     if(!locked)
     {
         // When a door is unlocked, we check all its neighboors to find a floodfill value for each possible
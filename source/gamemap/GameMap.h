@@ -18,7 +18,12 @@
 #ifndef GAMEMAP_H
 #define GAMEMAP_H
 
+#include "gamemap/GameMapSnapshot.h"
+#include "gamemap/PathCache.h"
 #include "gamemap/TileContainer.h"
+#include "gamemap/TilePath.h"
+
+#include "network/NetworkIdTable.h"
 
 #include "ai/AIManager.h"
 
@@ -32,6 +37,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 
 #include <OgreVector3.h>
 
@@ -54,6 +60,8 @@ class Spell;
 class TileSet;
 class TileSetValue;
 
+struct LevelLoadingTimes;
+
 enum class GameEntityType;
 enum class FloodFillType;
 enum class KeeperAIType;
@@ -114,8 +122,9 @@ public:
     bool isInEditorMode() const;
 
     //! \brief Load a level file (Part of the resource paths)
-    //! \returns whether the file loaded correctly
-    bool loadLevel(const std::string& levelFilepath);
+    //! \returns whether the file loaded correctly. If loadingTimes is not nullptr, it is filled with the time spent
+    //! in each loading stage (see MapHandler::readGameMapFromFile)
+    bool loadLevel(const std::string& levelFilepath, LevelLoadingTimes* loadingTimes = nullptr);
 
     //! \brief Setup the map memory to fit the given size.
     //! This methods also puts default (dirt) tiles on the new map.
@@ -200,17 +209,33 @@ public:
     const CreatureDefinition* getClassDescription(const std::string& className);
     CreatureDefinition* getClassDescriptionForTuning(const std::string& name);
 
+    //! \brief Ids of the creature class, weapon, mesh and animation names used in network packets. Class and
+    //! weapon ids are the indexes given to getClassDescription(int) and getWeapon(int)
+    inline const NetworkIdTable& getNetworkIdTable() const
+    { return mNetworkIdTable; }
+
+    inline NetworkIdTable& getNetworkIdTable()
+    { return mNetworkIdTable; }
+
+    //! \brief Server side. Registers the mesh and animation names known when the level is loaded in the
+    //! network id table. They are sent to the clients when they connect
+    void buildNetworkIdTable();
+
     //! \brief Returns the total number of class descriptions stored in this game map.
     unsigned int numClassDescriptions();
 
-    void saveLevelClassDescriptions(std::ofstream& levelFile);
+    //! \brief Fills defs with the class descriptions changed by the level (global definition, level definition).
+    //! The definitions are not changed once the level is loaded so they can be written from another thread
+    //! while the map is used (see MapHandler::writeLevelSaveToStream)
+    void getLevelClassDescriptions(std::vector<std::pair<const CreatureDefinition*, const CreatureDefinition*>>& defs) const;
 
     void addWeapon(const Weapon* weapon);
     const Weapon* getWeapon(int index);
     const Weapon* getWeapon(const std::string& name);
     Weapon* getWeaponForTuning(const std::string& name);
     uint32_t numWeapons();
-    void saveLevelEquipments(std::ofstream& levelFile);
+    //! \brief Same as getLevelClassDescriptions for the weapons
+    void getLevelEquipments(std::vector<std::pair<const Weapon*, const Weapon*>>& weapons) const;
 
     //! \brief Calls the deleteYourself() method on each of the rooms in the game map as well as clearing the vector of stored rooms.
     void clearRooms();
@@ -227,16 +252,55 @@ public:
     { return mRooms; }
 
     std::vector<Room*> getRoomsByType(RoomType type) const;
-    std::vector<Room*> getRoomsByTypeAndSeat(RoomType type,
-                        const Seat* seat);
-    std::vector<const Room*> getRoomsByTypeAndSeat(RoomType type,
+
+    //! \brief Returns the rooms with the given type owned by the given seat (with HP > 0). The returned
+    //! vector belongs to the gamemap building registries: nothing is allocated. It stays valid until a
+    //! room/trap is added, removed or destroyed (or a floodfill changes) and another building query
+    //! rebuilds the registries. Callers that change buildings while iterating must copy it first
+    const std::vector<Room*>& getRoomsByTypeAndSeat(RoomType type,
                           const Seat* seat) const;
     unsigned int numRoomsByTypeAndSeat(RoomType type,
                       const Seat* seat) const;
-    std::vector<Room*> getReachableRooms(const std::vector<Room*> &vec,
-                       Tile *startTile, const Creature* creature);
-    std::vector<Building*> getReachableBuildingsPerSeat(Seat* seat,
+
+    //! \brief Returns the rooms with the given type owned by the given seat the given creature can
+    //! reach from startTile. The vector is a bucket of the registries, valid as for getRoomsByTypeAndSeat
+    const std::vector<Room*>& getReachableRoomsByTypeAndSeat(RoomType type, const Seat* seat,
+        Tile *startTile, const Creature* creature);
+
+    //! \brief Returns the rooms and traps owned by the given seat the given creature can
+    //! reach from startTile. The vector is a bucket of the registries, valid as for getRoomsByTypeAndSeat
+    const std::vector<Building*>& getReachableBuildingsPerSeat(const Seat* seat,
         Tile *startTile, const Creature* creature);
+
+    //! \brief Invalidates the building registries. Should be called when a room/trap is added, removed
+    //! or destroyed or when its covered tiles change
+    inline void notifyBuildingsChanged()
+    {
+        mSeatBuildingsDirty = true;
+        mPathCache.invalidate();
+    }
+
+    //! \brief Invalidates the reachable buildings buckets and every cached path. Called when the floodfill
+    //! values of a tile change for several seats or floodfill types at once
+    inline void notifyFloodFillChanged()
+    {
+        mReachableBuildingsDirty = true;
+        mPathCache.invalidate();
+    }
+
+    //! \brief Invalidates the reachable buildings buckets and the cached paths starting in the given floodfill
+    //! components. Called when a tile floodfill value changes from oldValue to newValue
+    inline void notifyFloodFillChanged(uint32_t oldValue, uint32_t newValue)
+    {
+        mReachableBuildingsDirty = true;
+        mPathCache.invalidateComponent(oldValue);
+        mPathCache.invalidateComponent(newValue);
+    }
+
+    //! \brief Invalidates the cached paths. Called when the passability of a tile changes without
+    //! changing the floodfill (door locked/unlocked, trap activated, ...)
+    inline void notifyPathingChanged()
+    { mPathCache.invalidate(); }
     Room* getRoomByName(const std::string& name);
     Trap* getTrapByName(const std::string& name);
 
@@ -303,6 +367,9 @@ public:
     { return mGoalsForAllSeats; }
     void clearGoalsForAllSeats();
 
+    //! \brief Notifies every seat that a game state goals may depend on has changed (see Seat::notifyGoalDependencyChanged)
+    void notifyGoalDependencyChanged(uint32_t dependencies);
+
     bool withdrawFromTreasuries(int gold, Seat* seat);
 
     inline const std::string& getLevelFileName() const
@@ -353,7 +420,7 @@ public:
      * Note that this function will use some magic numbers to avoid computing paths that are likely to be
      * further
      */
-    std::list<Tile*> findBestPath(const Creature* creature, Tile* tileStart, const std::vector<Tile*> possibleDests,
+    TilePath findBestPath(const Creature* creature, Tile* tileStart, const std::vector<Tile*> possibleDests,
         Tile*& chosenTile);
 
     /*! \brief Calculates the walkable path between tiles (x1, y1) and (x2, y2).
@@ -367,12 +434,23 @@ public:
      * if the creature can go through the 4 tiles.
      * \param seat The seat is used when searching a diggable path to know
      * what tile actually diggable for the given team.
+     * Walkable paths (throughDiggableTiles = false) are served from the path cache when possible.
      */
-    std::list<Tile*> path(int x1, int y1, int x2, int y2, const Creature* creature, Seat* seat, bool throughDiggableTiles = false);
-    std::list<Tile*> path(Creature *c1, Creature *c2, const Creature* creature, Seat* seat, bool throughDiggableTiles = false);
-    std::list<Tile*> path(Tile *t1, Tile *t2, const Creature* creature, Seat* seat, bool throughDiggableTiles = false);
+    TilePath path(int x1, int y1, int x2, int y2, const Creature* creature, Seat* seat, bool throughDiggableTiles = false);
+    TilePath path(Creature *c1, Creature *c2, const Creature* creature, Seat* seat, bool throughDiggableTiles = false);
+    TilePath path(Tile *t1, Tile *t2, const Creature* creature, Seat* seat, bool throughDiggableTiles = false);
     //! \note Returns a path for the given creature to the given destination.
-    std::list<Tile*> path(const Creature* creature, Tile* destination, bool throughDiggableTiles = false);
+    TilePath path(const Creature* creature, Tile* destination, bool throughDiggableTiles = false);
+
+    //! \brief Asks for a walkable path from the position of the given creature to destination. The requests made
+    //! during a turn are solved together by processPathRequests and each path is then given to its creature with
+    //! setWalkPath. Until then, the creature waits for its path (see MovableGameEntity::isWaitingForPath)
+    void requestPath(Creature* creature, Tile* destination);
+
+    //! \brief Solves the pending path requests and gives the paths to the creatures. Identical requests are solved
+    //! once, the cached paths are reused and the other ones are solved in parallel. Called after the creatures
+    //! upkeep and before the entities move (see updateAnimations)
+    void processPathRequests();
 
     //! \brief Loops over the visibleTiles and returns any creature/room/trap in those tiles allied with the given seat
     //! (or if enemyForce is true, is not allied)
@@ -422,6 +500,20 @@ public:
     inline int64_t getTurnNumber() const
     { return mTurnNumber; }
 
+    //! \brief Publishes a read only snapshot of the current state of the map. It is called at the end of each turn and
+    //! can be called between turns by consumers needing the latest state (like the savegames or the editor). Only the tiles
+    //! notified with notifyTileSnapshotChanged since the previous publish are copied. Server side only
+    void publishSnapshot();
+
+    //! \brief Called by the tiles when a state stored in the snapshot changes. The tile will be copied
+    //! in the next published snapshot
+    void notifyTileSnapshotChanged(Tile* tile);
+
+    //! \brief Returns the last published snapshot (nullptr if none). It can be read from any thread while the next
+    //! turns are computed. Thread safe
+    inline std::shared_ptr<const GameMapSnapshot> getSnapshot() const
+    { return mSnapshotBuilder.getSnapshot(); }
+
     inline void setTurnNumber(int64_t turnNumber)
     { mTurnNumber = turnNumber; }
 
@@ -449,6 +541,9 @@ public:
     uint32_t getMaxNumberCreatures(Seat* seat) const;
 
     void logFloodFileTiles();
+    void logPathCacheStats();
+    //! \brief Logs the claimed tiles, creatures and remaining gold of each seat, read from the last published snapshot
+    void logMapStats();
     void consoleSetCreatureDestination(const std::string& creatureName, int x, int y);
     void consoleToggleCreatureVisualDebug(const std::string& creatureName);
     void consoleToggleSeatVisualDebug(int seatId);
@@ -492,10 +587,24 @@ public:
     //! RenderManager has finished to render every object inside.
     void processDeletionQueues();
 
+    //! \brief Notifies the entities of the seats having vision on them. Only the tiles with entities are
+    //! processed (see addTileWithEntities)
     void updateVisibleEntities();
 
+    //! \brief Called by the tiles when an entity is added while they are not listed. The tiles that have
+    //! no entity anymore are removed from the list by updateVisibleEntities
+    inline void addTileWithEntities(Tile* tile)
+    { mTilesWithEntities.push_back(tile); }
+
+    //! \brief Sends the tiles and the entities that changed during the turn to the seats with vision.
+    //! Each seat gets one entitiesRefresh message with all the entities it sees
     void fireRefreshEntities();
 
+    //! \brief Entities that need to be refreshed at the end of the turn (see GameEntity::setNeedFireRefresh)
+    inline void addEntityToRefresh(GameEntity* entity)
+    { mEntitiesToRefresh.push_back(entity); }
+    void removeEntityToRefresh(GameEntity* entity);
+
     inline const std::vector<RenderedMovableEntity*>& getRenderedMovableEntities() const
     { return mRenderedMovableEntities; }
 
@@ -585,6 +694,9 @@ private:
     std::vector<std::pair<const CreatureDefinition*,CreatureDefinition*> > mClassDescriptions;
     std::vector<std::pair<const Weapon*,Weapon*> > mWeapons;
 
+    //! \brief Ids of the names sent over the network. Also used to find the definitions by name
+    NetworkIdTable mNetworkIdTable;
+
     //Mutable to allow locking in const functions.
     std::vector<MovableGameEntity*> mAnimatedObjects;
 
@@ -615,15 +727,89 @@ private:
     //! \brief Useless entities that need to be deleted. They will be deleted when processDeletionQueues is called
     std::vector<GameEntity*> mEntitiesToDelete;
 
+    //! \brief Entities whose state changed during the turn. They are sent by fireRefreshEntities
+    std::vector<GameEntity*> mEntitiesToRefresh;
+
+    //! \brief Tiles on the server gamemap that may have entities (see updateVisibleEntities)
+    std::vector<Tile*> mTilesWithEntities;
+
     //! \brief Debug member used to know how many call to pathfinding has been made within the same turn.
     unsigned int mNumCallsTo_path;
 
+    //! \brief Walkable paths computed by path(). See PathCache
+    PathCache mPathCache;
+
+    //! \brief A path asked with requestPath
+    struct PathRequest
+    {
+        PathRequest(Creature* creature, Tile* destination, uint32_t id) :
+            mCreature(creature),
+            mDestination(destination),
+            mId(id),
+            mJob(0)
+        {}
+
+        Creature* mCreature;
+        Tile* mDestination;
+        uint32_t mId;
+        //! \brief Set by processPathRequests: index of the path solving this request
+        uint32_t mJob;
+        //! \brief Set by processPathRequests if the path was cached
+        TilePath mPath;
+    };
+
+    //! \brief Pending path requests. They are moved to mPathRequestsProcessing when processed so that
+    //! both vectors keep their capacity between turns
+    std::vector<PathRequest> mPathRequests;
+    std::vector<PathRequest> mPathRequestsProcessing;
+    uint32_t mLastPathRequestId;
+
+    //! \brief Path request stats logged with the path cache stats
+    uint64_t mNbPathRequests;
+    uint64_t mNbPathRequestsMerged;
+    uint64_t mNbPathRequestsSolved;
+
+    //! \brief Builds the snapshots returned by getSnapshot
+    GameMapSnapshotBuilder mSnapshotBuilder;
+
+    //! \brief Tiles changed since the last published snapshot. mSnapshotTilesListed is indexed like the tiles
+    //! and avoids listing a tile twice
+    std::vector<Tile*> mSnapshotChangedTiles;
+    std::vector<bool> mSnapshotTilesListed;
+
     std::vector<RenderedMovableEntity*> mRenderedMovableEntities;
 
     std::vector<Spell*> mSpells;
 
     std::vector<int> mTeamIds;
 
+    //! \brief Buildings owned by a seat, used to avoid going through every room and trap when looking
+    //! for a seat buildings. Only buildings with HP > 0 are registered
+    struct SeatBuildings
+    {
+        //! \brief Rooms indexed by RoomType
+        std::vector<std::vector<Room*>> mRoomsByType;
+
+        //! \brief Rooms and traps
+        std::vector<Building*> mBuildings;
+
+        //! \brief Reachable buildings bucketed by floodfill component. They are computed on demand for each
+        //! (creature seat, floodfill type) and the component key is given by fillFloodFillComponent
+        std::map<std::pair<const Seat*, uint32_t>, std::map<std::vector<uint32_t>, std::vector<Building*>>> mReachableBuildings;
+
+        //! \brief Same as mReachableBuildings for rooms with a given type. The key is (creature seat, floodfill type, room type)
+        std::map<std::tuple<const Seat*, uint32_t, uint32_t>, std::map<std::vector<uint32_t>, std::vector<Room*>>> mReachableRooms;
+    };
+
+    //! \brief Building registries per seat. They are rebuilt on demand when mSeatBuildingsDirty is set. When only
+    //! mReachableBuildingsDirty is set, only the reachable buckets are cleared
+    mutable std::map<const Seat*, SeatBuildings> mSeatBuildings;
+    mutable bool mSeatBuildingsDirty;
+    mutable bool mReachableBuildingsDirty;
+
+    //! \brief Used to compute the floodfill component of the start tile without allocating
+    std::vector<uint32_t> mFloodFillComponent;
+
     //! AI Handling manager
     AIManager mAiManager;
 
@@ -632,11 +818,33 @@ private:
     std::string mTileSetName;
 
     //! \brief Updates different entities states.
-    //! Updates active objects (creatures, rooms, ...), goals, count each team Workers, gold, mana and claimed tiles.
+    //! Updates active objects (creatures, rooms, ...), goals, vision and mana.
     unsigned long int doMiscUpkeep(double timeSinceLastTurn);
 
+
+    //! \brief Recomputes the seat counters (gold, creatures, rooms and claimed tiles) from scratch
+    //! and logs an error for each one that differs from the running counter. Used in debug only
+    void checkSeatCounters() const;
+
     //! \brief Resets the unique numbers
     void resetUniqueNumbers();
+
+    //! \brief Computes the path with the A-star algorithm. Called by path() when the path is not cached
+    TilePath computePath(Tile* start, Tile* destination, const Creature* creature, Seat* seat, bool throughDiggableTiles);
+
+    //! \brief Returns the building registry of the given seat (rebuilding the registries if needed) or
+    //! nullptr if the seat has no building
+    SeatBuildings* getSeatBuildings(const Seat* seat) const;
+
+    //! \brief Fills component with the floodfill values to compare with for the given creature to know if
+    //! tile can be reached. For workers, the values of every seat are used (see pathExists)
+    void fillFloodFillComponent(const Creature* creature, FloodFillType floodFillType, Tile* tile,
+        std::vector<uint32_t>& component) const;
+
+    //! \brief Fills buckets with the given buildings sorted by the floodfill component of their first covered tile
+    template<typename T>
+    void fillFloodFillBuckets(const Creature* creature, FloodFillType floodFillType, const std::vector<T*>& buildings,
+        std::map<std::vector<uint32_t>, std::vector<T*>>& buckets) const;
 };
 
 #endif // GAMEMAP_H
@@ -0,0 +1,161 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/GameMapSnapshot.h"
+
+const int GameMapSnapshot::PAGE_SIZE = 16;
+
+TileSnapshot::TileSnapshot() :
+    mType(static_cast<TileType>(0)),
+    mTileVisual(static_cast<TileVisual>(0)),
+    mFullness(0.0),
+    mSeatId(-1),
+    mIsClaimed(false),
+    mIsBuilding(false)
+{
+}
+
+bool TileSnapshot::operator==(const TileSnapshot& other) const
+{
+    return (mType == other.mType) &&
+        (mTileVisual == other.mTileVisual) &&
+        (mFullness == other.mFullness) &&
+        (mSeatId == other.mSeatId) &&
+        (mIsClaimed == other.mIsClaimed) &&
+        (mIsBuilding == other.mIsBuilding);
+}
+
+CreatureSnapshot::CreatureSnapshot() :
+    mSeatId(-1),
+    mTileX(-1),
+    mTileY(-1),
+    mHP(0.0),
+    mLevel(0)
+{
+}
+
+GameMapSnapshot::GameMapSnapshot(int64_t turnNumber, int mapSizeX, int mapSizeY) :
+    mTurnNumber(turnNumber),
+    mMapSizeX(mapSizeX),
+    mMapSizeY(mapSizeY),
+    mNbPagesX((mapSizeX + PAGE_SIZE - 1) / PAGE_SIZE)
+{
+}
+
+const TileSnapshot* GameMapSnapshot::getTile(int x, int y) const
+{
+    if((x < 0) || (y < 0) || (x >= mMapSizeX) || (y >= mMapSizeY))
+        return nullptr;
+
+    const Page& page = *mPages[(x / PAGE_SIZE) + (y / PAGE_SIZE) * mNbPagesX];
+    return &page[(x % PAGE_SIZE) + (y % PAGE_SIZE) * PAGE_SIZE];
+}
+
+uint32_t GameMapSnapshot::getNbSharedPages(const GameMapSnapshot& other) const
+{
+    if(mPages.size() != other.mPages.size())
+        return 0;
+
+    uint32_t nbShared = 0;
+    for(uint32_t i = 0; i < mPages.size(); ++i)
+    {
+        if(mPages[i] == other.mPages[i])
+            ++nbShared;
+    }
+    return nbShared;
+}
+
+GameMapSnapshotBuilder::GameMapSnapshotBuilder() :
+    mMapSizeX(0),
+    mMapSizeY(0),
+    mNbPagesX(0),
+    mNbPagesCopied(0)
+{
+}
+
+void GameMapSnapshotBuilder::resize(int mapSizeX, int mapSizeY)
+{
+    mMapSizeX = mapSizeX;
+    mMapSizeY = mapSizeY;
+    mNbPagesX = (mapSizeX + GameMapSnapshot::PAGE_SIZE - 1) / GameMapSnapshot::PAGE_SIZE;
+    int nbPagesY = (mapSizeY + GameMapSnapshot::PAGE_SIZE - 1) / GameMapSnapshot::PAGE_SIZE;
+    uint32_t nbPages = static_cast<uint32_t>(mNbPagesX * nbPagesY);
+    mPages.clear();
+    for(uint32_t i = 0; i < nbPages; ++i)
+    {
+        mPages.push_back(std::make_shared<GameMapSnapshot::Page>(GameMapSnapshot::PAGE_SIZE * GameMapSnapshot::PAGE_SIZE));
+    }
+    mPagesShared.assign(nbPages, false);
+    mCreatures.clear();
+    mNbPagesCopied = 0;
+
+    std::lock_guard<std::mutex> lock(mSnapshotMutex);
+    mSnapshot.reset();
+}
+
+void GameMapSnapshotBuilder::setTile(int x, int y, const TileSnapshot& tile)
+{
+    if((x < 0) || (y < 0) || (x >= mMapSizeX) || (y >= mMapSizeY))
+        return;
+
+    uint32_t indexPage = static_cast<uint32_t>((x / GameMapSnapshot::PAGE_SIZE) + (y / GameMapSnapshot::PAGE_SIZE) * mNbPagesX);
+    uint32_t indexTile = static_cast<uint32_t>((x % GameMapSnapshot::PAGE_SIZE) + (y % GameMapSnapshot::PAGE_SIZE) * GameMapSnapshot::PAGE_SIZE);
+    if((*mPages[indexPage])[indexTile] == tile)
+        return;
+
+    // The published snapshot might be read by another thread. We don't modify its pages
+    if(mPagesShared[indexPage])
+    {
+        mPages[indexPage] = std::make_shared<GameMapSnapshot::Page>(*mPages[indexPage]);
+        mPagesShared[indexPage] = false;
+        ++mNbPagesCopied;
+    }
+
+    (*mPages[indexPage])[indexTile] = tile;
+}
+
+void GameMapSnapshotBuilder::clearCreatures()
+{
+    mCreatures.clear();
+}
+
+void GameMapSnapshotBuilder::addCreature(const CreatureSnapshot& creature)
+{
+    mCreatures.push_back(creature);
+}
+
+void GameMapSnapshotBuilder::publish(int64_t turnNumber)
+{
+    GameMapSnapshot* snapshot = new GameMapSnapshot(turnNumber, mMapSizeX, mMapSizeY);
+    snapshot->mPages.reserve(mPages.size());
+    for(const std::shared_ptr<GameMapSnapshot::Page>& page : mPages)
+        snapshot->mPages.push_back(page);
+
+    snapshot->mCreatures = std::make_shared<const std::vector<CreatureSnapshot>>(mCreatures);
+    mPagesShared.assign(mPages.size(), true);
+    mNbPagesCopied = 0;
+
+    std::shared_ptr<const GameMapSnapshot> newSnapshot(snapshot);
+    std::lock_guard<std::mutex> lock(mSnapshotMutex);
+    mSnapshot = newSnapshot;
+}
+
+std::shared_ptr<const GameMapSnapshot> GameMapSnapshotBuilder::getSnapshot() const
+{
+    std::lock_guard<std::mutex> lock(mSnapshotMutex);
+    return mSnapshot;
+}
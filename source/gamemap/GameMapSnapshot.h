@@ -0,0 +1,156 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMEMAPSNAPSHOT_H
+#define GAMEMAPSNAPSHOT_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class TileType;
+enum class TileVisual;
+
+//! \brief State of a tile in a GameMapSnapshot
+struct TileSnapshot
+{
+    TileSnapshot();
+
+    bool operator==(const TileSnapshot& other) const;
+
+    inline bool operator!=(const TileSnapshot& other) const
+    { return !(*this == other); }
+
+    TileType mType;
+    TileVisual mTileVisual;
+    double mFullness;
+    //! \brief Id of the seat of the tile. -1 if none
+    int mSeatId;
+    bool mIsClaimed;
+    bool mIsBuilding;
+};
+
+//! \brief State of a creature in a GameMapSnapshot
+struct CreatureSnapshot
+{
+    CreatureSnapshot();
+
+    std::string mName;
+    std::string mClassName;
+    int mSeatId;
+    //! \brief Position tile. -1 if the creature is not on the map
+    int mTileX;
+    int mTileY;
+    double mHP;
+    unsigned int mLevel;
+};
+
+//! \brief Read only view of the game map state published at the end of each turn (see GameMap::publishSnapshot). Snapshots are immutable so they can
+//! be read from any thread while the next turns are computed. The tiles are stored in pages shared
+//! between consecutive snapshots: a page is only copied when one of its tiles changed (see
+//! GameMapSnapshotBuilder)
+class GameMapSnapshot
+{
+    friend class GameMapSnapshotBuilder;
+public:
+    //! \brief A page stores PAGE_SIZE x PAGE_SIZE tiles
+    static const int PAGE_SIZE;
+
+    inline int64_t getTurnNumber() const
+    { return mTurnNumber; }
+
+    inline int getMapSizeX() const
+    { return mMapSizeX; }
+
+    inline int getMapSizeY() const
+    { return mMapSizeY; }
+
+    //! \brief Returns the tile at the given coordinates or nullptr if out of the map
+    const TileSnapshot* getTile(int x, int y) const;
+
+    inline const std::vector<CreatureSnapshot>& getCreatures() const
+    { return *mCreatures; }
+
+    //! \brief Returns the number of tile pages this snapshot shares with the given one
+    uint32_t getNbSharedPages(const GameMapSnapshot& other) const;
+
+private:
+    typedef std::vector<TileSnapshot> Page;
+
+    GameMapSnapshot(int64_t turnNumber, int mapSizeX, int mapSizeY);
+
+    int64_t mTurnNumber;
+    int mMapSizeX;
+    int mMapSizeY;
+    int mNbPagesX;
+    std::vector<std::shared_ptr<const Page>> mPages;
+    std::shared_ptr<const std::vector<CreatureSnapshot>> mCreatures;
+};
+
+//! \brief Builds GameMapSnapshot from the live game map. It keeps the tile pages of the last published
+//! snapshot and copies a page the first time one of its tiles is changed after publishing (copy on write).
+//! Only publish and getSnapshot can be called from several threads. The other functions should only be called
+//! by the thread computing the turns
+class GameMapSnapshotBuilder
+{
+public:
+    GameMapSnapshotBuilder();
+
+    //! \brief Drops the published snapshot and resets the tiles to the given map size
+    void resize(int mapSizeX, int mapSizeY);
+
+    inline int getMapSizeX() const
+    { return mMapSizeX; }
+
+    inline int getMapSizeY() const
+    { return mMapSizeY; }
+
+    //! \brief Sets the state of the tile. The page containing it is copied if it is shared with the
+    //! published snapshot and the tile changed
+    void setTile(int x, int y, const TileSnapshot& tile);
+
+    void clearCreatures();
+    void addCreature(const CreatureSnapshot& creature);
+
+    //! \brief Makes the current state available through getSnapshot
+    void publish(int64_t turnNumber);
+
+    //! \brief Returns the last published snapshot (nullptr if none). Thread safe
+    std::shared_ptr<const GameMapSnapshot> getSnapshot() const;
+
+    //! \brief Number of pages copied since the last call to publish
+    inline uint32_t getNbPagesCopied() const
+    { return mNbPagesCopied; }
+
+private:
+    int mMapSizeX;
+    int mMapSizeY;
+    int mNbPagesX;
+    std::vector<std::shared_ptr<GameMapSnapshot::Page>> mPages;
+    //! \brief True if the page at the same index is used by the published snapshot and should be copied
+    //! before being modified
+    std::vector<bool> mPagesShared;
+    std::vector<CreatureSnapshot> mCreatures;
+    uint32_t mNbPagesCopied;
+
+    mutable std::mutex mSnapshotMutex;
+    std::shared_ptr<const GameMapSnapshot> mSnapshot;
+};
+
+#endif // GAMEMAPSNAPSHOT_H
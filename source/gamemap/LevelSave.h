@@ -0,0 +1,64 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LEVELSAVE_H
+#define LEVELSAVE_H
+
+#include "entities/Building.h"
+#include "entities/Creature.h"
+#include "entities/MapLight.h"
+#include "game/Seat.h"
+#include "gamemap/GameMapSnapshot.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CreatureDefinition;
+class Weapon;
+
+//! \brief Plain records of a level captured from the game map by MapHandler::captureLevelSave. Capturing
+//! only copies the data so that it can be done during a turn. The level file is then formatted from the
+//! records by MapHandler::writeLevelSaveToStream, which can be called from any thread.
+//! The tiles, seats, rooms, traps, lights and creatures are stored as records. The definitions changed by the
+//! level are not changed once it is loaded, so only pointers to them are kept. The other sections (level info,
+//! goals and the other entities) have only a few items and are written directly when capturing
+class LevelSave
+{
+public:
+    LevelSave()
+    {}
+
+    //! \brief Version and level info
+    std::string mHeader;
+    std::vector<SeatSaveRecord> mSeats;
+    std::string mGoals;
+    //! \brief The tiles are written from a snapshot of the game map
+    std::shared_ptr<const GameMapSnapshot> mTiles;
+    std::vector<BuildingSaveRecord> mRooms;
+    std::vector<BuildingSaveRecord> mTraps;
+    std::vector<MapLightSaveRecord> mMapLights;
+    //! \brief Definitions changed by the level (global definition, level definition)
+    std::vector<std::pair<const CreatureDefinition*, const CreatureDefinition*>> mCreatureDefinitions;
+    std::vector<std::pair<const Weapon*, const Weapon*>> mWeapons;
+    std::vector<CreatureSaveRecord> mCreatures;
+    //! \brief Spells and rendered entities
+    std::string mEntities;
+};
+
+#endif // LEVELSAVE_H
@@ -0,0 +1,169 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/MapFileWriter.h"
+
+#include "gamemap/LevelSave.h"
+#include "gamemap/MapHandler.h"
+#include "utils/Helper.h"
+#include "utils/LogManager.h"
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Lock.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+
+MapFileWriter::MapFileWriter() :
+    mThread(&MapFileWriter::writerThread, this),
+    mCaptureTime(0),
+    mIsWriting(false)
+{
+}
+
+MapFileWriter::~MapFileWriter()
+{
+    waitForWrite();
+}
+
+bool MapFileWriter::writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
+{
+    // We cannot change the level while the previous one is written and we don't want
+    // to wait for it during the turn
+    if(isWriting())
+    {
+        OD_LOG_WRN("Cannot save " + fileName + " while " + mFileName + " is written");
+        return false;
+    }
+
+    // The writer thread is done. We make sure it is finished before changing its data
+    mThread.wait();
+
+    sf::Clock clock;
+    mFileName = fileName;
+    mLevelSave.reset(new LevelSave);
+    MapHandler::captureLevelSave(gameMap, *mLevelSave);
+    mCaptureTime = clock.getElapsedTime().asMilliseconds();
+    OD_LOG_INF("Captured map for " + fileName + " in " + Helper::toString(mCaptureTime) + " ms");
+
+    {
+        sf::Lock lock(mLock);
+        mIsWriting = true;
+    }
+    mThread.launch();
+    return true;
+}
+
+bool MapFileWriter::isWriting()
+{
+    sf::Lock lock(mLock);
+    return mIsWriting;
+}
+
+bool MapFileWriter::popWrittenFile(std::string& fileName, bool& isSuccess)
+{
+    sf::Lock lock(mLock);
+    if(mWrittenFiles.empty())
+        return false;
+
+    fileName = mWrittenFiles.front().first;
+    isSuccess = mWrittenFiles.front().second;
+    mWrittenFiles.pop_front();
+    return true;
+}
+
+void MapFileWriter::waitForWrite()
+{
+    mThread.wait();
+}
+
+void MapFileWriter::clearWrittenFiles()
+{
+    sf::Lock lock(mLock);
+    mWrittenFiles.clear();
+}
+
+void MapFileWriter::writerThread()
+{
+    sf::Clock clock;
+    std::ostringstream levelStream;
+    MapHandler::writeLevelSaveToStream(levelStream, *mLevelSave);
+    std::string content = levelStream.str();
+    int32_t formatTime = clock.restart().asMilliseconds();
+
+    bool isSuccess = writeContentToFile(mFileName, content);
+    int32_t writeTime = clock.getElapsedTime().asMilliseconds();
+    OD_LOG_INF("Wrote map file " + mFileName + " in " + Helper::toString(formatTime) + " ms (format) + "
+        + Helper::toString(writeTime) + " ms (write), size="
+        + Helper::toString(static_cast<uint64_t>(content.size())) + ", success=" + std::string(isSuccess ? "true" : "false"));
+    // Saving from the turn used to capture, format and write the level before the turn could go on
+    OD_LOG_INF("Turn paused " + Helper::toString(mCaptureTime) + " ms to save " + mFileName
+        + " instead of " + Helper::toString(mCaptureTime + formatTime + writeTime) + " ms for a synchronous save");
+
+    // We don't need the captured level anymore
+    mLevelSave.reset();
+
+    sf::Lock lock(mLock);
+    mWrittenFiles.push_back(std::pair<std::string, bool>(mFileName, isSuccess));
+    mIsWriting = false;
+}
+
+bool MapFileWriter::writeContentToFile(const std::string& fileName, const std::string& content)
+{
+    std::string tmpFileName = fileName + ".tmp";
+    std::ofstream levelFile(tmpFileName.c_str(), std::ofstream::out);
+    if(!levelFile.good())
+    {
+        OD_LOG_WRN("Couldn't open file for writing: " + tmpFileName);
+        return false;
+    }
+
+    levelFile.write(content.data(), content.size());
+    levelFile.close();
+    boost::system::error_code ec;
+    if(!levelFile.good())
+    {
+        OD_LOG_WRN("Unexpected failure on file: " + tmpFileName);
+        boost::filesystem::remove(tmpFileName, ec);
+        return false;
+    }
+
+    // If the file exists, we make a backup. It is linked or copied (not renamed) so that the level file
+    // exists until the temporary file replaces it
+    if(boost::filesystem::exists(fileName, ec))
+    {
+        std::string bakFileName = fileName + ".bak";
+        boost::filesystem::remove(bakFileName, ec);
+        boost::filesystem::create_hard_link(fileName, bakFileName, ec);
+        if(ec)
+            boost::filesystem::copy_file(fileName, bakFileName, ec);
+        if(ec)
+            OD_LOG_WRN("Couldn't backup file " + fileName + ": " + ec.message());
+    }
+
+    // The rename replaces the existing file in one step
+    boost::filesystem::rename(tmpFileName, fileName, ec);
+    if(ec)
+    {
+        OD_LOG_WRN("Couldn't rename " + tmpFileName + " to " + fileName + ": " + ec.message());
+        return false;
+    }
+
+    return true;
+}
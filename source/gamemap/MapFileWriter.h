@@ -0,0 +1,86 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAPFILEWRITER_H
+#define MAPFILEWRITER_H
+
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Thread.hpp>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+
+class GameMap;
+class LevelSave;
+
+//! \brief Saves level files without stalling the server. The thread owning the game map only copies the
+//! level data (see MapHandler::captureLevelSave). The level file is formatted from this copy and
+//! written by a background thread. The file is first written with a temporary name then renamed over the
+//! level file so that a crash during the write does not leave a truncated or missing level. If the file already
+//! exists, a copy is kept with the .bak extension. Only one save can be written at a time.
+class MapFileWriter
+{
+public:
+    MapFileWriter();
+    ~MapFileWriter();
+
+    //! \brief Captures the given game map and writes it to fileName in the background. If a previous write
+    //! is still running, the save is rejected and false is returned. Should be called from the thread owning
+    //! the game map
+    bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap);
+
+    //! \brief Returns true if a save is being written
+    bool isWriting();
+
+    //! \brief Returns true if a write finished since the last call. In this case, fileName and isSuccess are
+    //! set to the written file and whether it could be written
+    bool popWrittenFile(std::string& fileName, bool& isSuccess);
+
+    //! \brief Blocks until the current write (if any) is finished. Should not be called while turns are computed
+    void waitForWrite();
+
+    //! \brief Forgets the files written that were not popped
+    void clearWrittenFiles();
+
+private:
+    void writerThread();
+
+    //! \brief Writes the content to a temporary file then renames it over fileName. The previous file is linked
+    //! (or copied) to fileName.bak first so that fileName always exists
+    static bool writeContentToFile(const std::string& fileName, const std::string& content);
+
+    sf::Thread mThread;
+
+    //! \brief File to write and the captured level. Only accessed by the writer thread while it is running
+    std::string mFileName;
+    std::unique_ptr<LevelSave> mLevelSave;
+    //! \brief Time the thread owning the game map was paused to capture the level
+    int32_t mCaptureTime;
+
+    //! \brief Protects mIsWriting and mWrittenFiles
+    sf::Mutex mLock;
+
+    //! \brief True from the launch of the writer thread until it has written the file
+    bool mIsWriting;
+
+    //! \brief Files written by the writer thread and whether the write succeeded
+    std::deque<std::pair<std::string, bool>> mWrittenFiles;
+};
+
+#endif // MAPFILEWRITER_H
@@ -19,6 +19,7 @@
 
 #include "creaturemood/CreatureMoodManager.h"
 #include "gamemap/GameMap.h"
+#include "gamemap/LevelSave.h"
 #include "game/Seat.h"
 #include "goals/Goal.h"
 #include "goals/GoalLoading.h"
@@ -48,13 +49,75 @@
 
 #include "ODApplication.h"
 
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Thread.hpp>
+
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <thread>
+
+namespace
+{
+//! \brief Minimum number of tile lines parsed by a thread. Smaller levels are parsed by the loading thread only
+const uint32_t MIN_TILE_LINES_PER_THREAD = 2048;
+
+void parseTileLines(const std::vector<std::string>& tileLines, std::vector<TileLevelData>& tilesData,
+    uint32_t indexBegin, uint32_t indexEnd)
+{
+    for(uint32_t i = indexBegin; i < indexEnd; ++i)
+        Tile::parseLine(tileLines[i], tilesData[i]);
+}
+
+//! \brief Parses the tile lines. Parsing does not use the game map so big levels are split between
+//! several threads
+void parseTileLinesParallel(const std::vector<std::string>& tileLines, std::vector<TileLevelData>& tilesData)
+{
+    uint32_t nbLines = static_cast<uint32_t>(tileLines.size());
+    tilesData.resize(nbLines);
+    uint32_t nbThreads = std::max(1u, std::thread::hardware_concurrency());
+    nbThreads = std::min(nbThreads, nbLines / MIN_TILE_LINES_PER_THREAD);
+    if(nbThreads <= 1)
+    {
+        parseTileLines(tileLines, tilesData, 0, nbLines);
+        return;
+    }
+
+    // The loading thread parses the last part
+    uint32_t nbLinesPerThread = (nbLines + nbThreads - 1) / nbThreads;
+    std::vector<std::unique_ptr<sf::Thread>> threads;
+    for(uint32_t i = 0; i < nbThreads - 1; ++i)
+    {
+        uint32_t indexBegin = i * nbLinesPerThread;
+        uint32_t indexEnd = indexBegin + nbLinesPerThread;
+        threads.emplace_back(new sf::Thread([&tileLines, &tilesData, indexBegin, indexEnd]()
+        {
+            parseTileLines(tileLines, tilesData, indexBegin, indexEnd);
+        }));
+        threads.back()->launch();
+    }
+    parseTileLines(tileLines, tilesData, (nbThreads - 1) * nbLinesPerThread, nbLines);
+
+    for(std::unique_ptr<sf::Thread>& thread : threads)
+        thread->wait();
+}
+
+double getElapsedMs(sf::Clock& clock)
+{
+    return static_cast<double>(clock.restart().asMicroseconds()) / 1000.0;
+}
+}
 
 namespace MapHandler {
 
-bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
+bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap, LevelLoadingTimes* loadingTimes)
 {
+    // Loading is done in stages: reading the file, parsing the tiles, building the tiles (neighbors, visuals)
+    // and creating the entities. The time spent in each stage is logged
+    LevelLoadingTimes times;
+    sf::Clock clock;
+
     std::stringstream levelFile;
     if(!Helper::readFileWithoutComments(fileName, levelFile))
         return false;
@@ -195,6 +258,8 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
             gameMap.addGoalForAllSeats(std::move(tempGoal));
     }
 
+    times.mReadFile = getElapsedMs(clock);
+
     levelFile >> nextParam;
     if (nextParam != "[Tiles]")
     {
@@ -214,6 +279,7 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
     // Read in the map tiles from disk
     gameMap.disableFloodFill();
 
+    std::vector<std::string> tileLines;
     while (true)
     {
         if(!levelFile.good())
@@ -230,16 +296,29 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
         std::string entire_line = nextParam;
         std::getline(levelFile, nextParam);
         entire_line += nextParam;
+        tileLines.push_back(entire_line);
+    }
 
-        Tile* tile = new Tile(&gameMap, true);
+    std::vector<TileLevelData> tilesData;
+    parseTileLinesParallel(tileLines, tilesData);
+    times.mParseTiles = getElapsedMs(clock);
 
-        Tile::loadFromLine(entire_line, tile);
-        tile->computeTileVisual();
+    // The tiles created by createNewMap are updated instead of being replaced
+    for(const TileLevelData& tileData : tilesData)
+    {
+        Tile* tile = gameMap.getTile(tileData.mX, tileData.mY);
+        if(tile == nullptr)
+        {
+            OD_LOG_WRN("Invalid tile position x=" + Helper::toString(tileData.mX) + ", y=" + Helper::toString(tileData.mY));
+            continue;
+        }
 
-        gameMap.addTile(tile);
+        Tile::loadFromData(tileData, tile);
+        tile->computeTileVisual();
     }
 
     gameMap.setAllFullnessAndNeighbors();
+    times.mBuildTiles = getElapsedMs(clock);
 
     // Read in the rooms
     levelFile >> nextParam;
@@ -510,6 +589,15 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
         return false;
     }
 
+    times.mEntities = getElapsedMs(clock);
+    OD_LOG_INF("Loaded level " + fileName + " readFile=" + Helper::toString(times.mReadFile)
+        + " ms, parseTiles=" + Helper::toString(times.mParseTiles)
+        + " ms, buildTiles=" + Helper::toString(times.mBuildTiles)
+        + " ms, entities=" + Helper::toString(times.mEntities) + " ms");
+
+    if(loadingTimes != nullptr)
+        *loadingTimes = times;
+
     return true;
 }
 
@@ -560,6 +648,29 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
         return false;
     }
 
+    writeGameMapToStream(levelFile, gameMap);
+
+    if (!levelFile.good()) {
+        OD_LOG_WRN("Unexpected failure on file: " + fileName);
+        return false;
+    }
+
+    levelFile.close();
+    return true;
+}
+
+void writeGameMapToStream(std::ostream& levelFile, GameMap& gameMap)
+{
+    LevelSave levelSave;
+    captureLevelSave(gameMap, levelSave);
+    writeLevelSaveToStream(levelFile, levelSave);
+}
+
+void captureLevelSave(GameMap& gameMap, LevelSave& levelSave)
+{
+    // The small sections are written directly. The others are copied in records (see LevelSave)
+    std::ostringstream levelFile;
+
     // Write the identifier string and the version number
     levelFile << ODApplication::VERSIONSTRING
             << "  # The version of OpenDungeons which created this file (for compatibility reasons).\n";
@@ -578,20 +689,21 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
 
     levelFile << "[/Info]" << std::endl;
 
-    // Write out the seats to the file
-    levelFile << "\n[Seats]\n";
+    levelSave.mHeader = levelFile.str();
+
     const std::vector<Seat*> seats = gameMap.getSeats();
+    levelSave.mSeats.clear();
     for (Seat* seat : seats)
     {
         // We don't save rogue seat
         if(seat->isRogueSeat())
             continue;
 
-        levelFile << "[Seat]" << std::endl;
-        seat->exportSeatToStream(levelFile);
-        levelFile << "[/Seat]" << std::endl;
+        levelSave.mSeats.push_back(SeatSaveRecord());
+        seat->fillSaveRecord(levelSave.mSeats.back());
     }
-    levelFile << "[/Seats]" << std::endl;
+
+    levelFile.str(std::string());
 
     // Write out the goals shared by all players to the file.
     levelFile << "\n[Goals]\n";
@@ -602,40 +714,18 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
     }
     levelFile << "[/Goals]" << std::endl;
 
-    levelFile << "\n[Tiles]\n";
-    int mapSizeX = gameMap.getMapSizeX();
-    int mapSizeY = gameMap.getMapSizeY();
-    levelFile << "# Map Size" << std::endl;
-    levelFile << mapSizeX << " # MapSizeX" << std::endl;
-    levelFile << mapSizeY << " # MapSizeY" << std::endl;
-
-    // Write out the tiles to the file
-    levelFile << "# " << Tile::getFormat() << "\n";
-
-    for(int ii = 0; ii < mapSizeX; ++ii)
-    {
-        for(int jj = 0; jj < mapSizeY; ++jj)
-        {
-            Tile* tile = gameMap.getTile(ii, jj);
-            if (tile == nullptr)
-                continue;
-
-            // Don't save standard tiles as they're auto filled in at load time.
-            if (!tile->isClaimed() && tile->getType() == TileType::dirt && tile->getFullness() >= 100.0)
-                continue;
+    levelSave.mGoals = levelFile.str();
 
-            Tile::exportToStream(tile, levelFile);
-            levelFile << std::endl;
-        }
-    }
-    levelFile << "[/Tiles]" << std::endl;
+    // The tiles are taken from the game map snapshot. It is published again to include the changes
+    // done since the end of the last turn (and in the editor, where there are no turns). Only the changed
+    // tiles are copied
+    gameMap.publishSnapshot();
+    levelSave.mTiles = gameMap.getSnapshot();
 
     std::vector<Room*> rooms = gameMap.getRooms();
     std::sort(rooms.begin(), rooms.end(), Room::sortForMapSave);
-
-    // Write out the rooms to the file
-    levelFile << "\n[Rooms]\n";
-    levelFile << "# " << Room::getRoomStreamFormat() << "\n";
+    levelSave.mRooms.clear();
+    levelSave.mRooms.reserve(rooms.size());
     for (Room* room : rooms)
     {
         // Rooms with 0 tiles are removed during upkeep. In editor mode, we don't use upkeep so there might be some rooms with
@@ -643,18 +733,14 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
         if((gameMap.isInEditorMode()) && (room->numCoveredTiles() <= 0))
             continue;
 
-        levelFile << "[Room]" << std::endl;
-        GameEntity::exportToStream(room, levelFile);
-        levelFile << "[/Room]" << std::endl;
+        levelSave.mRooms.push_back(BuildingSaveRecord());
+        room->fillSaveRecord(levelSave.mRooms.back());
     }
-    levelFile << "[/Rooms]" << std::endl;
 
     std::vector<Trap*> traps = gameMap.getTraps();
     std::sort(traps.begin(), traps.end(), Trap::sortForMapSave);
-
-    // Write out the traps to the file
-    levelFile << "\n[Traps]\n";
-    levelFile << "# " << Trap::getTrapStreamFormat() << "\n";
+    levelSave.mTraps.clear();
+    levelSave.mTraps.reserve(traps.size());
     for (Trap* trap : traps)
     {
         // In editor mode, we don't use upkeep so there might be some traps with
@@ -662,39 +748,24 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
         if(gameMap.isInEditorMode() && trap->numCoveredTiles() <= 0)
             continue;
 
-        levelFile << "[Trap]" << std::endl;
-        GameEntity::exportToStream(trap, levelFile);
-        levelFile << "[/Trap]" << std::endl;
+        levelSave.mTraps.push_back(BuildingSaveRecord());
+        trap->fillSaveRecord(levelSave.mTraps.back());
     }
-    levelFile << "[/Traps]" << std::endl;
 
-    // Write out the lights to the file.
-    levelFile << "\n[Lights]\n";
-    levelFile << "# " << MapLight::getMapLightStreamFormat() << "\n";
-    for (MapLight* mapLight : gameMap.getMapLights())
-    {
-        GameEntity::exportToStream(mapLight, levelFile);
-        levelFile << std::endl;
-    }
-    levelFile << "[/Lights]" << std::endl;
+    const std::vector<MapLight*>& mapLights = gameMap.getMapLights();
+    levelSave.mMapLights.assign(mapLights.size(), MapLightSaveRecord());
+    for (uint32_t i = 0; i < mapLights.size(); ++i)
+        mapLights[i]->fillSaveRecord(levelSave.mMapLights[i]);
 
-    levelFile << std::endl << "[CreatureDefinitions]" << std::endl;
-    gameMap.saveLevelClassDescriptions(levelFile);
-    levelFile << "[/CreatureDefinitions]" << std::endl;
+    gameMap.getLevelClassDescriptions(levelSave.mCreatureDefinitions);
+    gameMap.getLevelEquipments(levelSave.mWeapons);
 
-    levelFile << std::endl << "[EquipmentDefinitions]" << std::endl;
-    gameMap.saveLevelEquipments(levelFile);
-    levelFile << "[/EquipmentDefinitions]" << std::endl;
+    const std::vector<Creature*>& creatures = gameMap.getCreatures();
+    levelSave.mCreatures.assign(creatures.size(), CreatureSaveRecord());
+    for (uint32_t i = 0; i < creatures.size(); ++i)
+        creatures[i]->fillSaveRecord(levelSave.mCreatures[i]);
 
-    // Write out the individual creatures to the file
-    levelFile << "\n[Creatures]\n";
-    levelFile << "# " << Creature::getCreatureStreamFormat() << "\n";
-    for (Creature* creature : gameMap.getCreatures())
-    {
-        GameEntity::exportToStream(creature, levelFile);
-        levelFile << std::endl;
-    }
-    levelFile << "[/Creatures]" << std::endl;
+    levelFile.str(std::string());
 
     // Write out the RenderedMovableEntities that need to
     const std::vector<RenderedMovableEntity*>& rendereds = gameMap.getRenderedMovableEntities();
@@ -778,14 +849,112 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
         levelFile << std::endl;
     }
     levelFile << "[/Chickens]" << std::endl;
+    levelSave.mEntities = levelFile.str();
+}
 
-    if (!levelFile.good()) {
-        OD_LOG_WRN("Unexpected failure on file: " + fileName);
-        return false;
+void writeLevelSaveToStream(std::ostream& levelFile, const LevelSave& levelSave)
+{
+    levelFile << levelSave.mHeader;
+
+    // Write out the seats to the file
+    levelFile << "\n[Seats]\n";
+    for (const SeatSaveRecord& seat : levelSave.mSeats)
+    {
+        levelFile << "[Seat]" << std::endl;
+        seat.exportToStream(levelFile);
+        levelFile << "[/Seat]" << std::endl;
     }
+    levelFile << "[/Seats]" << std::endl;
 
-    levelFile.close();
-    return true;
+    levelFile << levelSave.mGoals;
+
+    levelFile << "\n[Tiles]\n";
+    const GameMapSnapshot& tiles = *levelSave.mTiles;
+    int mapSizeX = tiles.getMapSizeX();
+    int mapSizeY = tiles.getMapSizeY();
+    levelFile << "# Map Size" << std::endl;
+    levelFile << mapSizeX << " # MapSizeX" << std::endl;
+    levelFile << mapSizeY << " # MapSizeY" << std::endl;
+
+    // Write out the tiles to the file
+    levelFile << "# " << Tile::getFormat() << "\n";
+
+    for(int ii = 0; ii < mapSizeX; ++ii)
+    {
+        for(int jj = 0; jj < mapSizeY; ++jj)
+        {
+            const TileSnapshot* tile = tiles.getTile(ii, jj);
+            if (tile == nullptr)
+                continue;
+
+            // Don't save standard tiles as they're auto filled in at load time.
+            if (!tile->mIsClaimed && tile->mType == TileType::dirt && tile->mFullness >= 100.0)
+                continue;
+
+            Tile::exportToStream(ii, jj, tile->mType, tile->mFullness, tile->mSeatId, levelFile);
+            levelFile << std::endl;
+        }
+    }
+    levelFile << "[/Tiles]" << std::endl;
+
+    // Write out the rooms to the file
+    levelFile << "\n[Rooms]\n";
+    levelFile << "# " << Room::getRoomStreamFormat() << "\n";
+    for (const BuildingSaveRecord& room : levelSave.mRooms)
+    {
+        levelFile << "[Room]" << std::endl;
+        room.exportHeadersToStream(levelFile);
+        room.exportToStream(levelFile);
+        levelFile << "[/Room]" << std::endl;
+    }
+    levelFile << "[/Rooms]" << std::endl;
+
+    // Write out the traps to the file
+    levelFile << "\n[Traps]\n";
+    levelFile << "# " << Trap::getTrapStreamFormat() << "\n";
+    for (const BuildingSaveRecord& trap : levelSave.mTraps)
+    {
+        levelFile << "[Trap]" << std::endl;
+        trap.exportHeadersToStream(levelFile);
+        trap.exportToStream(levelFile);
+        levelFile << "[/Trap]" << std::endl;
+    }
+    levelFile << "[/Traps]" << std::endl;
+
+    // Write out the lights to the file.
+    levelFile << "\n[Lights]\n";
+    levelFile << "# " << MapLight::getMapLightStreamFormat() << "\n";
+    for (const MapLightSaveRecord& mapLight : levelSave.mMapLights)
+    {
+        mapLight.exportToStream(levelFile);
+        levelFile << std::endl;
+    }
+    levelFile << "[/Lights]" << std::endl;
+
+    levelFile << std::endl << "[CreatureDefinitions]" << std::endl;
+    for (const std::pair<const CreatureDefinition*, const CreatureDefinition*>& def : levelSave.mCreatureDefinitions)
+    {
+        CreatureDefinition::writeCreatureDefinitionDiff(def.first, def.second, levelFile,
+            ConfigManager::getSingleton().getCreatureDefinitions());
+    }
+    levelFile << "[/CreatureDefinitions]" << std::endl;
+
+    levelFile << std::endl << "[EquipmentDefinitions]" << std::endl;
+    for (const std::pair<const Weapon*, const Weapon*>& def : levelSave.mWeapons)
+        Weapon::writeWeaponDiff(def.first, def.second, levelFile);
+    levelFile << "[/EquipmentDefinitions]" << std::endl;
+
+    // Write out the individual creatures to the file
+    levelFile << "\n[Creatures]\n";
+    levelFile << "# " << Creature::getCreatureStreamFormat() << "\n";
+    for (const CreatureSaveRecord& creature : levelSave.mCreatures)
+    {
+        creature.exportToStream(levelFile);
+        levelFile << std::endl;
+    }
+    levelFile << "[/Creatures]" << std::endl;
+
+    levelFile << levelSave.mEntities;
 }
 
 bool getMapInfo(const std::string& fileName, LevelInfo& levelInfo)
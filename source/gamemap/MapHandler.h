@@ -19,9 +19,11 @@
 #ifndef MAPHANDLER_H
 #define MAPHANDLER_H
 
+#include <iosfwd>
 #include <string>
 
 class GameMap;
+class LevelSave;
 
 enum class GameEntityType;
 
@@ -38,12 +40,44 @@ struct LevelInfo
     std::string mLevelDescription;
 };
 
+//! \brief Time spent in each stage of MapHandler::readGameMapFromFile, in milliseconds
+struct LevelLoadingTimes
+{
+    LevelLoadingTimes() :
+        mReadFile(0.0),
+        mParseTiles(0.0),
+        mBuildTiles(0.0),
+        mEntities(0.0)
+    {}
+
+    //! \brief Reading the file and the level header (info, seats, goals)
+    double mReadFile;
+    //! \brief Allocating the map and parsing the tile lines
+    double mParseTiles;
+    //! \brief Updating the tiles, their neighbors and fullness
+    double mBuildTiles;
+    //! \brief Creating the rooms, traps, creatures and other entities
+    double mEntities;
+};
+
 namespace MapHandler
 {
-    bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap);
+    //! \brief Loads the given level in the game map. If loadingTimes is not nullptr, it is filled with the
+    //! time spent in each loading stage
+    bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap, LevelLoadingTimes* loadingTimes = nullptr);
 
     bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap);
 
+    //! \brief Writes the level file content to the given stream. Used by writeGameMapToFile
+    void writeGameMapToStream(std::ostream& levelFile, GameMap& gameMap);
+
+    //! \brief Copies the game map data needed to write the level file in levelSave. Should be called by the
+    //! thread owning the game map
+    void captureLevelSave(GameMap& gameMap, LevelSave& levelSave);
+
+    //! \brief Writes the level file content from the captured data. Can be called from any thread (see MapFileWriter)
+    void writeLevelSaveToStream(std::ostream& levelFile, const LevelSave& levelSave);
+
     bool readGameEntity(GameMap& gameMap, const std::string& item, GameEntityType type, std::stringstream& levelFile);
 
     bool loadEquipments(const std::string& fileName, GameMap& gameMap);
@@ -20,9 +20,12 @@
 #include "gamemap/MiniMapCamera.h"
 #include "gamemap/MiniMapDrawn.h"
 #include "gamemap/MiniMapDrawnFull.h"
+#include "gamemap/MiniMapImage.h"
 #include "utils/ConfigManager.h"
 #include "utils/LogManager.h"
 
+#include <OgreHardwarePixelBuffer.h>
+
 namespace MiniMapTypes
 {
 static const std::string MINIMAP_CAMERA = "MiniMapCamera";
@@ -63,3 +66,15 @@ const std::vector<std::string>& MiniMap::getMiniMapTypes()
     static std::vector<std::string> minimapTypes = MiniMapTypes::buildMiniMapTypes();
     return minimapTypes;
 }
+
+void MiniMap::uploadDirtyRect(MiniMapImage& image, Ogre::HardwarePixelBufferSharedPtr& pixelBuffer)
+{
+    if(!image.hasDirtyRect())
+        return;
+
+    Ogre::PixelBox imageBox(image.getWidth(), image.getHeight(), 1, Ogre::PF_BYTE_BGRA,
+        const_cast<uint32_t*>(image.getPixels()));
+    Ogre::Box dirtyBox(image.getDirtyXMin(), image.getDirtyYMin(), image.getDirtyXMax(), image.getDirtyYMax());
+    pixelBuffer->blitFromMemory(imageBox.getSubVolume(dirtyBox), dirtyBox);
+    image.clearDirtyRect();
+}
@@ -25,6 +25,8 @@ namespace CEGUI
 class Window;
 }
 
+class MiniMapImage;
+
 class MiniMap
 {
 public:
@@ -44,6 +46,10 @@ public:
 
     // Returns the list of all possible minimap types
     static const std::vector<std::string>& getMiniMapTypes();
+
+protected:
+    //! \brief Uploads the dirty rectangle of the given image (if any) to the pixel buffer and clears it
+    static void uploadDirtyRect(MiniMapImage& image, Ogre::HardwarePixelBufferSharedPtr& pixelBuffer);
 };
 
 #endif // MINIMAP_H
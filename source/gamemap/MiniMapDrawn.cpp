@@ -44,6 +44,53 @@
 #include <CEGUI/Window.h>
 #include <CEGUI/WindowManager.h>
 
+#include <cmath>
+
+namespace
+{
+//! \brief Palette indexes used by the minimap. After the fixed colours, each seat has 2
+//! colours (claimed ground, claimed wall) in the game map seats order
+enum MiniMapDrawnPalette
+{
+    paletteBlack,
+    paletteMarkedForDigging,
+    paletteClaimedGround,
+    paletteClaimedFull,
+    paletteWater,
+    paletteLava,
+    paletteDirtGround,
+    paletteDirtFull,
+    paletteRockGround,
+    paletteRockFull,
+    paletteGoldGround,
+    paletteGoldFull,
+    paletteUnknown,
+    paletteFirstSeat
+};
+
+//! \brief Max number of seats that can have their own colour in the palette
+const uint32_t MAX_SEATS_PALETTE = (MiniMapRaster::PALETTE_SIZE - paletteFirstSeat) / 2;
+}
+
+class MiniMapDrawnTileStateListener : public TileStateListener
+{
+public:
+    MiniMapDrawnTileStateListener(MiniMapDrawn& minimap) :
+        mMinimap(minimap)
+    {}
+
+    virtual ~MiniMapDrawnTileStateListener()
+    {}
+
+    void tileStateChanged(Tile& tile) override
+    {
+        mMinimap.updateTile(tile);
+    }
+
+private:
+    MiniMapDrawn& mMinimap;
+};
+
 MiniMapDrawn::MiniMapDrawn(CEGUI::Window* miniMapWindow) :
     mMiniMapWindow(miniMapWindow),
     mTopLeftCornerX(0),
@@ -53,8 +100,8 @@ MiniMapDrawn::MiniMapDrawn(CEGUI::Window* miniMapWindow) :
            + mGrainSize - (static_cast<unsigned int>(mMiniMapWindow->getPixelSize().d_width) % mGrainSize)),
     mHeight(static_cast<unsigned int>(mMiniMapWindow->getPixelSize().d_height)
             + mGrainSize - (static_cast<unsigned int>(mMiniMapWindow->getPixelSize().d_height) % mGrainSize)),
-    mTiles(mWidth * mHeight, Color(0,0,0)),
-    mPixelBox(mWidth, mHeight, 1, Ogre::PF_R8G8B8),
+    mCosRotation(1.0),
+    mSinRotation(0.0),
     mMiniMapOgreTexture(Ogre::TextureManager::getSingletonPtr()->createManual(
             "miniMapOgreTexture",
             Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
@@ -63,8 +110,48 @@ MiniMapDrawn::MiniMapDrawn(CEGUI::Window* miniMapWindow) :
             Ogre::TU_DYNAMIC_WRITE_ONLY)),
     mPixelBuffer(mMiniMapOgreTexture->getBuffer()),
     mGameMap(*ODFrameListener::getSingleton().getClientGameMap()),
-    mCameraManager(*ODFrameListener::getSingleton().getCameraManager())
+    mCameraManager(*ODFrameListener::getSingleton().getCameraManager()),
+    mRaster(mGameMap.getMapSizeX(), mGameMap.getMapSizeY()),
+    mImage(mWidth, mHeight),
+    mTileStateListener(new MiniMapDrawnTileStateListener(*this))
 {
+    mRaster.setOutsideValue(paletteBlack);
+    mRaster.setPaletteColor(paletteBlack, 0x00, 0x00, 0x00);
+    mRaster.setPaletteColor(paletteMarkedForDigging, 0xFF, 0xA8, 0x00);
+    mRaster.setPaletteColor(paletteClaimedGround, 0x5C, 0x37, 0x1B);
+    mRaster.setPaletteColor(paletteClaimedFull, 0x86, 0x50, 0x28);
+    mRaster.setPaletteColor(paletteWater, 0x21, 0x36, 0x7A);
+    mRaster.setPaletteColor(paletteLava, 0xB2, 0x22, 0x22);
+    mRaster.setPaletteColor(paletteDirtGround, 0x3B, 0x1D, 0x08);
+    mRaster.setPaletteColor(paletteDirtFull, 0x5B, 0x2D, 0x0C);
+    mRaster.setPaletteColor(paletteRockGround, 0x30, 0x30, 0x30);
+    mRaster.setPaletteColor(paletteRockFull, 0x41, 0x41, 0x41);
+    mRaster.setPaletteColor(paletteGoldGround, 0x3B, 0x1D, 0x08);
+    mRaster.setPaletteColor(paletteGoldFull, 0xB5, 0xB3, 0x2F);
+    mRaster.setPaletteColor(paletteUnknown, 0x00, 0xFF, 0x7F);
+    const std::vector<Seat*>& seats = mGameMap.getSeats();
+    for(uint32_t i = 0; (i < seats.size()) && (i < MAX_SEATS_PALETTE); ++i)
+    {
+        const Ogre::ColourValue& color = seats[i]->getColorValue();
+        uint8_t index = static_cast<uint8_t>(paletteFirstSeat + 2 * i);
+        mRaster.setPaletteColor(index, color.r * 200.0, color.g * 200.0, color.b * 200.0);
+        mRaster.setPaletteColor(index + 1, color.r * 255.0, color.g * 255.0, color.b * 255.0);
+    }
+
+    // We set the initial tiles state and register to be notified when they change
+    for(int xxx = 0; xxx < mGameMap.getMapSizeX(); ++xxx)
+    {
+        for(int yyy = 0; yyy < mGameMap.getMapSizeY(); ++yyy)
+        {
+            Tile* tile = mGameMap.getTile(xxx, yyy);
+            if(tile == nullptr)
+                continue;
+
+            updateTile(*tile);
+            tile->addTileStateListener(*mTileStateListener);
+        }
+    }
+
     CEGUI::Texture& miniMapTextureGui = static_cast<CEGUI::OgreRenderer*>(CEGUI::System::getSingletonPtr()
                                             ->getRenderer())->createTexture("miniMapTextureGui", mMiniMapOgreTexture);
 
@@ -87,6 +174,19 @@ MiniMapDrawn::MiniMapDrawn(CEGUI::Window* miniMapWindow) :
 
 MiniMapDrawn::~MiniMapDrawn()
 {
+    for(int xxx = 0; xxx < mGameMap.getMapSizeX(); ++xxx)
+    {
+        for(int yyy = 0; yyy < mGameMap.getMapSizeY(); ++yyy)
+        {
+            Tile* tile = mGameMap.getTile(xxx, yyy);
+            if(tile == nullptr)
+                continue;
+
+            tile->removeTileStateListener(*mTileStateListener);
+        }
+    }
+    delete mTileStateListener;
+
     mMiniMapWindow->setProperty("Image", "");
     Ogre::TextureManager::getSingletonPtr()->remove("miniMapOgreTexture");
     CEGUI::ImageManager::getSingletonPtr()->destroy("MiniMapImageset");
@@ -109,139 +209,81 @@ Ogre::Vector2 MiniMapDrawn::camera_2dPositionFromClick(int xx, int yy)
     return mCamera_2dPosition;
 }
 
-void MiniMapDrawn::update(Ogre::Real timeSinceLastFrame, const std::vector<Ogre::Vector3>& cornerTiles)
+void MiniMapDrawn::updateTile(Tile& tile)
 {
-    Ogre::Vector3 vv = mCameraManager.getCameraViewTarget();
-    double rotation = mCameraManager.getActiveCameraNode()->getOrientation().getRoll().valueRadians();
-    mCamera_2dPosition = Ogre::Vector2(vv.x, vv.y);
-    mCosRotation = cos(rotation);
-    mSinRotation = sin(rotation);
-
-    for (int ii = 0, mm = mCamera_2dPosition.x - mWidth / (2 * mGrainSize); ii < static_cast<int>(mWidth); ++mm, ii += mGrainSize)
+    uint8_t value = paletteUnknown;
+    if (tile.getMarkedForDigging(mGameMap.getLocalPlayer()))
     {
-        //NOTE: (0,0) is in the bottom left in the game map, top left in textures, so we are reversing y order here.
-        for (int jj = static_cast<int>(mHeight) - static_cast<int>(mGrainSize), nn = mCamera_2dPosition.y - mHeight / (2 * mGrainSize);
-             jj >= 0; ++nn, jj -= mGrainSize)
+        value = paletteMarkedForDigging;
+    }
+    else
+    {
+        switch (tile.getTileVisual())
         {
-            // Applying rotation
-            int oo = mCamera_2dPosition.x + static_cast<int>((mm - mCamera_2dPosition.x) * mCosRotation - (nn - mCamera_2dPosition.y) * mSinRotation);
-            int pp = mCamera_2dPosition.y + static_cast<int>((mm - mCamera_2dPosition.x) * mSinRotation + (nn - mCamera_2dPosition.y) * mCosRotation);
-
-            /*FIXME: even if we use a THREE byte pixel format (PF_R8G8B8),
-             * for some reason it only works if we have FOUR increments
-             * (the empty one is the unused alpha channel)
-             * this is not how it is intended/expected
-             */
-            Tile* tile = mGameMap.getTile(oo, pp);
-            if(tile == nullptr)
+            case TileVisual::claimedGround:
+            case TileVisual::claimedFull:
             {
-                drawPixel(ii, jj, 0x00, 0x00, 0x00);
-                continue;
-            }
-
-            if (tile->getMarkedForDigging(mGameMap.getLocalPlayer()))
-            {
-                drawPixel(ii, jj, 0xFF, 0xA8, 0x00);
-                continue;
-            }
-
-            switch (tile->getTileVisual())
-            {
-                case TileVisual::claimedGround:
-                {
-                    Seat* tempSeat = tile->getSeat();
-                    if (tempSeat != nullptr)
-                    {
-                        Ogre::ColourValue color = tempSeat->getColorValue();
-                        drawPixel(ii, jj, color.r*200.0, color.g*200.0, color.b*200.0);
-                    }
-                    else
-                    {
-                        drawPixel(ii, jj, 0x5C, 0x37, 0x1B);
-                    }
+                bool isFull = (tile.getTileVisual() == TileVisual::claimedFull);
+                value = isFull ? paletteClaimedFull : paletteClaimedGround;
+                Seat* tempSeat = tile.getSeat();
+                if (tempSeat == nullptr)
                     break;
-                }
 
-                case TileVisual::claimedFull:
+                const std::vector<Seat*>& seats = mGameMap.getSeats();
+                for(uint32_t i = 0; (i < seats.size()) && (i < MAX_SEATS_PALETTE); ++i)
                 {
-                    Seat* tempSeat = tile->getSeat();
-                    if (tempSeat != nullptr)
-                    {
-                        Ogre::ColourValue color = tempSeat->getColorValue();
-                        drawPixel(ii, jj, color.r*255.0, color.g*255.0, color.b*255.0);
-                    }
-                    else
-                    {
-                        drawPixel(ii, jj, 0x86, 0x50, 0x28);
-                    }
-                    break;
-                }
-
-                case TileVisual::waterGround:
-                    drawPixel(ii, jj, 0x21, 0x36, 0x7A);
-                    break;
-
-                case TileVisual::lavaGround:
-                    drawPixel(ii, jj, 0xB2, 0x22, 0x22);
-                    break;
-
-                case TileVisual::dirtGround:
-                    drawPixel(ii, jj, 0x3B, 0x1D, 0x08);
-                    break;
-
-                case TileVisual::dirtFull:
-                    drawPixel(ii, jj, 0x5B, 0x2D, 0x0C);
-                    break;
-
-                case TileVisual::rockGround:
-                    drawPixel(ii, jj, 0x30, 0x30, 0x30);
-                    break;
-
-                case TileVisual::rockFull:
-                    drawPixel(ii, jj, 0x41, 0x41, 0x41);
-                    break;
-
-                case TileVisual::goldGround:
-                    drawPixel(ii, jj, 0x3B, 0x1D, 0x08);
-                    break;
+                    if(seats[i] != tempSeat)
+                        continue;
 
-                case TileVisual::goldFull:
-                    drawPixel(ii, jj, 0xB5, 0xB3, 0x2F);
-                    break;
-
-                case TileVisual::nullTileVisual:
-                    drawPixel(ii, jj, 0x00, 0x00, 0x00);
-                    break;
-
-                default:
-                    drawPixel(ii,jj,0x00,0xFF,0x7F);
+                    value = static_cast<uint8_t>(paletteFirstSeat + 2 * i + (isFull ? 1 : 0));
                     break;
+                }
+                break;
             }
+            case TileVisual::waterGround:
+                value = paletteWater;
+                break;
+            case TileVisual::lavaGround:
+                value = paletteLava;
+                break;
+            case TileVisual::dirtGround:
+                value = paletteDirtGround;
+                break;
+            case TileVisual::dirtFull:
+                value = paletteDirtFull;
+                break;
+            case TileVisual::rockGround:
+                value = paletteRockGround;
+                break;
+            case TileVisual::rockFull:
+                value = paletteRockFull;
+                break;
+            case TileVisual::goldGround:
+                value = paletteGoldGround;
+                break;
+            case TileVisual::goldFull:
+                value = paletteGoldFull;
+                break;
+            case TileVisual::nullTileVisual:
+                value = paletteBlack;
+                break;
+            default:
+                break;
         }
     }
 
-    // Draw creatures on map.
-    // std::vector<Creature*>::iterator updatedCreatureIndex = mGameMap->creatures.begin();
-    // for(; updatedCreatureIndex < mGameMap->creatures.end(); ++updatedCreatureIndex)
-    // {
-    //     if((*updatedCreatureIndex)->getIsOnMap())
-    //     {
-    //         double  ii = (*updatedCreatureIndex)->getPosition().x;
-    //         double  jj = (*updatedCreatureIndex)->getPosition().y;
-
-    //         drawPixel(ii, jj, 0x94, 0x0, 0x94);
-    //     }
-    // }
-
-    mPixelBuffer->lock(mPixelBox, Ogre::HardwareBuffer::HBL_NORMAL);
-
-    Ogre::uint8* pDest;
-    pDest = static_cast<Ogre::uint8*>(mPixelBuffer->getCurrentLock().data) - 1;
+    mRaster.setTileValue(tile.getX(), tile.getY(), value);
+}
 
-    for(const Color& color : mTiles)
-    {
-        drawPixelToMemory(pDest, color.RR, color.GG, color.BB);
-    }
+void MiniMapDrawn::update(Ogre::Real timeSinceLastFrame, const std::vector<Ogre::Vector3>& cornerTiles)
+{
+    Ogre::Vector3 vv = mCameraManager.getCameraViewTarget();
+    double rotation = mCameraManager.getActiveCameraNode()->getOrientation().getRoll().valueRadians();
+    mCamera_2dPosition = Ogre::Vector2(vv.x, vv.y);
+    mCosRotation = cos(rotation);
+    mSinRotation = sin(rotation);
 
-    mPixelBuffer->unlock();
+    // Only the pixels that changed since the last frame are redrawn and uploaded
+    mRaster.draw(mImage, mCamera_2dPosition.x, mCamera_2dPosition.y, mCosRotation, mSinRotation, mGrainSize);
+    uploadDirtyRect(mImage, mPixelBuffer);
 }
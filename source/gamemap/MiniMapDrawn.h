@@ -24,6 +24,8 @@
 #define MINIMAPDRAWN_H_
 
 #include "gamemap/MiniMap.h"
+#include "gamemap/MiniMapImage.h"
+#include "gamemap/MiniMapRaster.h"
 
 #include <OgreHardwarePixelBuffer.h>
 #include <OgrePixelFormat.h>
@@ -40,29 +42,12 @@ namespace CEGUI
 
 class CameraManager;
 class GameMap;
+class MiniMapDrawnTileStateListener;
+class Tile;
 
-struct Color
-{
-public:
-    Ogre::uint8 RR;
-    Ogre::uint8 GG;
-    Ogre::uint8 BB;
-
-    Color():
-        RR(0),
-        GG(0),
-        BB(0)
-    {}
-
-    Color(Ogre::uint8 rr, Ogre::uint8 gg, Ogre::uint8 bb):
-        RR(rr),
-        GG(gg),
-        BB(bb)
-    {}
-};
-
-//! \brief The class handling the minimap seen top-right of the in-game screen
-//! FIXME: The pixel are displayed without taking in account the camera current roll value.
+//! \brief The class handling the minimap seen top-right of the in-game screen. The tiles colours are
+//! kept in a MiniMapRaster updated when a tile changes. Each frame, the view is drawn in a MiniMapImage
+//! and only the pixels that changed are uploaded to the texture.
 class MiniMapDrawn : public MiniMap
 {
 public:
@@ -79,6 +64,9 @@ public:
 
     Ogre::Vector2 camera_2dPositionFromClick(int xx, int yy) override;
 
+    //! \brief Refreshes the palette index of the given tile. Called when the tile state changes
+    void updateTile(Tile& tile);
+
 private:
     CEGUI::Window* mMiniMapWindow;
 
@@ -92,37 +80,17 @@ private:
     Ogre::Vector2 mCamera_2dPosition;
     double mCosRotation, mSinRotation;
 
-    //!brief Vector containing colours to be drawn.
-    //NOTE: The tiles are laid out Y,X in the vector to iterate in the right order when drawing.
-    std::vector<Color> mTiles;
-
-    Ogre::PixelBox mPixelBox;
     Ogre::TexturePtr mMiniMapOgreTexture;
     Ogre::HardwarePixelBufferSharedPtr mPixelBuffer;
 
-    inline void drawPixel(int xx, int yy, Ogre::uint8 RR, Ogre::uint8 GG, Ogre::uint8 BB)
-    {
-        for(int gg = 0; gg < mGrainSize; ++gg)
-        {
-            for(int hh = 0; hh < mGrainSize; ++hh)
-            {
-                mTiles[xx + gg + ((yy + hh) * mWidth)] = Color(RR, GG, BB);
-            }
-        }
-
-    }
-
-    inline void drawPixelToMemory(Ogre::uint8*& pDest, unsigned char RR, unsigned char GG, unsigned char BB)
-    {
-        pDest++; //A, unused, shouldn't be here
-        // this is the order of colors I empirically found outto be working :)
-        *pDest++ = BB;  //B
-        *pDest++ = GG;  //G
-        *pDest++ = RR;  //R
-    }
-
     GameMap& mGameMap;
     CameraManager& mCameraManager;
+
+    MiniMapRaster mRaster;
+    MiniMapImage mImage;
+
+    //! \brief Listener registered on every tile to update mRaster
+    MiniMapDrawnTileStateListener* mTileStateListener;
 };
 
 #endif // MINIMAPDRAWN_H_
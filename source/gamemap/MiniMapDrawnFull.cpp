@@ -39,6 +39,8 @@
 #include <CEGUI/Window.h>
 #include <CEGUI/WindowManager.h>
 
+#include <algorithm>
+
 class MiniMapDrawnFullTileStateListener : public TileStateListener
 {
 public:
@@ -185,9 +187,8 @@ MiniMapDrawnFullPixel getPixelValueFromTile(Seat& playerSeat, Tile& tile)
 }
 
 void colourFromPixelValue(MiniMapDrawnFullPixel pixelValue, Seat* seatIfClaimed,
-        Ogre::HardwarePixelBufferSharedPtr pixelBuffer, Ogre::PixelBox pixelBox,
-        uint32_t minimapWidth, uint32_t minimapHeight, uint32_t minimapXMin,
-        uint32_t minimapXMax, uint32_t minimapYMin, uint32_t minimapYMax)
+        MiniMapImage& image, uint32_t minimapXMin, uint32_t minimapXMax,
+        uint32_t minimapYMin, uint32_t minimapYMax)
 {
     Ogre::uint8 RR = 0x00;
     Ogre::uint8 GG = 0x00;
@@ -307,23 +308,9 @@ void colourFromPixelValue(MiniMapDrawnFullPixel pixelValue, Seat* seatIfClaimed,
         }
     }
 
-    pixelBuffer->lock(pixelBox, Ogre::HardwareBuffer::HBL_NORMAL);
-    for(uint32_t x = minimapXMin; x < minimapXMax; ++x)
-    {
-        for(uint32_t y = minimapYMin; y < minimapYMax; ++y)
-        {
-            Ogre::uint8* pDest = static_cast<Ogre::uint8*>(pixelBuffer->getCurrentLock().data) - 1;
-            pDest += (minimapWidth * (minimapHeight - y - 1) * 4);
-            pDest += (x * 4);
-
-            pDest++; //A, unused, shouldn't be here
-            // this is the order of colors I empirically found out to be working :)
-            *pDest++ = BB;  //B
-            *pDest++ = GG;  //G
-            *pDest++ = RR;  //R
-        }
-    }
-    pixelBuffer->unlock();
+    // The minimap y axis goes up while the image one goes down
+    image.fillRect(minimapXMin, image.getHeight() - minimapYMax, minimapXMax,
+        image.getHeight() - minimapYMin, MiniMapImage::packColor(RR, GG, BB));
 }
 }
 
@@ -335,14 +322,14 @@ MiniMapDrawnFull::MiniMapDrawnFull(CEGUI::Window* miniMapWindow) :
     mTopLeftCornerY(0),
     mWidth(static_cast<unsigned int>(mMiniMapWindow->getPixelSize().d_width)),
     mHeight(static_cast<unsigned int>(mMiniMapWindow->getPixelSize().d_height)),
-    mPixelBox(mWidth, mHeight, 1, Ogre::PF_R8G8B8),
     mMiniMapOgreTexture(Ogre::TextureManager::getSingletonPtr()->createManual(
             "miniMapOgreTexture",
             Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME,
             Ogre::TEX_TYPE_2D,
             mWidth, mHeight, 0, Ogre::PF_R8G8B8,
             Ogre::TU_DYNAMIC_WRITE_ONLY)),
-    mPixelBuffer(mMiniMapOgreTexture->getBuffer())
+    mPixelBuffer(mMiniMapOgreTexture->getBuffer()),
+    mImage(mWidth, mHeight)
 {
     uint32_t tileXMax = mGameMap.getMapSizeX();
     uint32_t tileYMax = mGameMap.getMapSizeY();
@@ -499,8 +486,8 @@ void MiniMapDrawnFull::updateTileState(uint32_t minimapXMin, uint32_t minimapXMa
     }
 
     // We paint corresponding pixels
-    colourFromPixelValue(curValue, seatIfClaimed, mPixelBuffer, mPixelBox,
-        mWidth, mHeight, minimapXMin, minimapXMax, minimapYMin, minimapYMax);
+    colourFromPixelValue(curValue, seatIfClaimed, mImage, minimapXMin, minimapXMax,
+        minimapYMin, minimapYMax);
 }
 
 bool MiniMapDrawnFull::crossSegment(const Ogre::Vector3& p1, const Ogre::Vector3& p2,
@@ -556,11 +543,6 @@ bool MiniMapDrawnFull::crossSegment(const Ogre::Vector3& p1, const Ogre::Vector3
 
 void MiniMapDrawnFull::update(Ogre::Real timeSinceLastFrame, const std::vector<Ogre::Vector3>& cornerTiles)
 {
-    const Ogre::Vector3& topRight = cornerTiles[0];
-    const Ogre::Vector3& topLeft = cornerTiles[1];
-    const Ogre::Vector3& bottomLeft = cornerTiles[2];
-    const Ogre::Vector3& bottomRight = cornerTiles[3];
-
     bool isSame = (mLastCornerTiles.size() == cornerTiles.size());
     static const Ogre::Real squareDiffMin = 0.5;
     for(uint32_t iii = 0; isSame && iii < mLastCornerTiles.size(); ++iii)
@@ -569,8 +551,19 @@ void MiniMapDrawnFull::update(Ogre::Real timeSinceLastFrame, const std::vector<O
         isSame &= (val <= squareDiffMin);
     }
 
-    if(isSame)
-        return;
+    if(!isSame)
+        updateVisibleRectangle(cornerTiles);
+
+    // The pixels changed by the tiles events and the visible rectangle are uploaded once per frame
+    uploadDirtyRect(mImage, mPixelBuffer);
+}
+
+void MiniMapDrawnFull::updateVisibleRectangle(const std::vector<Ogre::Vector3>& cornerTiles)
+{
+    const Ogre::Vector3& topRight = cornerTiles[0];
+    const Ogre::Vector3& topLeft = cornerTiles[1];
+    const Ogre::Vector3& bottomLeft = cornerTiles[2];
+    const Ogre::Vector3& bottomRight = cornerTiles[3];
 
     // We save corner tiles
     mLastCornerTiles = cornerTiles;
@@ -582,12 +575,24 @@ void MiniMapDrawnFull::update(Ogre::Real timeSinceLastFrame, const std::vector<O
     }
     mVisibleRectangle.clear();
 
-    // And we paint the new visible rectangle
-    mPixelBuffer->lock(mPixelBox, Ogre::HardwareBuffer::HBL_NORMAL);
+    // A listener outside of the bounding box of the corners cannot cross any of the segments (see
+    // crossSegment) so we only test the ones within
+    Ogre::Real cornersXMin = std::min(std::min(topRight.x, topLeft.x), std::min(bottomLeft.x, bottomRight.x));
+    Ogre::Real cornersXMax = std::max(std::max(topRight.x, topLeft.x), std::max(bottomLeft.x, bottomRight.x));
+    Ogre::Real cornersYMin = std::min(std::min(topRight.y, topLeft.y), std::min(bottomLeft.y, bottomRight.y));
+    Ogre::Real cornersYMax = std::max(std::max(topRight.y, topLeft.y), std::max(bottomLeft.y, bottomRight.y));
 
     // we look for the tiles at the border of vision to paint them black
     for(MiniMapDrawnFullTileStateListener* listener : mTileStateListeners)
     {
+        if((cornersXMax < static_cast<Ogre::Real>(listener->mTileXMin)) ||
+           (cornersXMin > static_cast<Ogre::Real>(listener->mTileXMax)) ||
+           (cornersYMax < static_cast<Ogre::Real>(listener->mTileYMin)) ||
+           (cornersYMin > static_cast<Ogre::Real>(listener->mTileYMax)))
+        {
+            continue;
+        }
+
         bool isInBorder = false;
 
         // We check if the listener tiles are on the top line
@@ -623,21 +628,7 @@ void MiniMapDrawnFull::update(Ogre::Real timeSinceLastFrame, const std::vector<O
             continue;
 
         mVisibleRectangle.push_back(listener);
-        for(uint32_t xxx = listener->mMinimapXMin; xxx < listener->mMinimapXMax; ++xxx)
-        {
-            for(uint32_t yyy = listener->mMinimapYMin; yyy < listener->mMinimapYMax; ++yyy)
-            {
-                Ogre::uint8* pDest = static_cast<Ogre::uint8*>(mPixelBuffer->getCurrentLock().data) - 1;
-                pDest += (mWidth * (mHeight - yyy - 1) * 4);
-                pDest += (xxx * 4);
-
-                pDest++; //A, unused, shouldn't be here
-                // this is the order of colors I empirically found out to be working :)
-                *pDest++ = 0x00;  //B
-                *pDest++ = 0x00;  //G
-                *pDest++ = 0x00;  //R
-            }
-        }
+        mImage.fillRect(listener->mMinimapXMin, mHeight - listener->mMinimapYMax, listener->mMinimapXMax,
+            mHeight - listener->mMinimapYMin, MiniMapImage::packColor(0x00, 0x00, 0x00));
     }
-    mPixelBuffer->unlock();
 }
@@ -19,6 +19,7 @@
 #define MINIMAPDRAWNFULL_H_
 
 #include "gamemap/MiniMap.h"
+#include "gamemap/MiniMapImage.h"
 
 #include <OgreHardwarePixelBuffer.h>
 #include <OgrePixelFormat.h>
@@ -65,6 +66,10 @@ private:
     bool crossSegment(const Ogre::Vector3& p1, const Ogre::Vector3& p2,
         uint32_t xMin, uint32_t xMax, uint32_t yMin, uint32_t yMax);
 
+    //! \brief Repaints the tiles of the previous visible rectangle and paints in black the border of
+    //! the new one
+    void updateVisibleRectangle(const std::vector<Ogre::Vector3>& cornerTiles);
+
     CEGUI::Window* mMiniMapWindow;
 
     GameMap& mGameMap;
@@ -83,9 +88,12 @@ private:
 
     Ogre::Vector2 mCamera_2dPosition;
 
-    Ogre::PixelBox mPixelBox;
     Ogre::TexturePtr mMiniMapOgreTexture;
     Ogre::HardwarePixelBufferSharedPtr mPixelBuffer;
+
+    //! \brief The pixels are drawn in this image when tiles change and the changed rectangle
+    //! is uploaded to the texture once per frame
+    MiniMapImage mImage;
 };
 
 #endif // MINIMAPDRAWNFULL_H_
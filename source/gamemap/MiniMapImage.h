@@ -0,0 +1,139 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MINIMAPIMAGE_H
+#define MINIMAPIMAGE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+//! \brief CPU side image of the minimap. Pixels are stored as 32 bits values with the bytes in
+//! the B, G, R, A order (Ogre::PF_BYTE_BGRA) so that the image can be uploaded as is to the minimap
+//! texture. The image keeps track of the rectangle that changed since the last upload so that only
+//! this rectangle is uploaded. It does not depend on Ogre so that it can be used in unit tests.
+class MiniMapImage
+{
+public:
+    MiniMapImage(uint32_t width, uint32_t height) :
+        mWidth(width),
+        mHeight(height),
+        mPixels(width * height, packColor(0x00, 0x00, 0x00)),
+        mDirtyXMin(0),
+        mDirtyYMin(0),
+        mDirtyXMax(0),
+        mDirtyYMax(0)
+    {
+        // At start, the full image has to be uploaded
+        markDirty(0, 0, width, height);
+    }
+
+    //! \brief Returns the value to store in the image for the given colour
+    static inline uint32_t packColor(uint8_t r, uint8_t g, uint8_t b)
+    {
+        uint32_t color = 0;
+        uint8_t* bytes = reinterpret_cast<uint8_t*>(&color);
+        bytes[0] = b;
+        bytes[1] = g;
+        bytes[2] = r;
+        bytes[3] = 0xFF;
+        return color;
+    }
+
+    inline uint32_t getWidth() const
+    { return mWidth; }
+
+    inline uint32_t getHeight() const
+    { return mHeight; }
+
+    inline const uint32_t* getPixels() const
+    { return mPixels.data(); }
+
+    inline uint32_t getPixel(uint32_t x, uint32_t y) const
+    { return mPixels[x + y * mWidth]; }
+
+    //! \brief Fills the rectangle [xMin, xMax[ x [yMin, yMax[ with the given colour. Only the
+    //! pixels that change are marked dirty. The caller is responsible for the bounds
+    inline void fillRect(uint32_t xMin, uint32_t yMin, uint32_t xMax, uint32_t yMax, uint32_t color)
+    {
+        bool isChanged = false;
+        for(uint32_t y = yMin; y < yMax; ++y)
+        {
+            uint32_t* row = mPixels.data() + y * mWidth;
+            for(uint32_t x = xMin; x < xMax; ++x)
+            {
+                isChanged |= (row[x] != color);
+                row[x] = color;
+            }
+        }
+
+        if(isChanged)
+            markDirty(xMin, yMin, xMax, yMax);
+    }
+
+    //! \brief Adds the given rectangle to the rectangle to upload
+    inline void markDirty(uint32_t xMin, uint32_t yMin, uint32_t xMax, uint32_t yMax)
+    {
+        if(!hasDirtyRect())
+        {
+            mDirtyXMin = xMin;
+            mDirtyYMin = yMin;
+            mDirtyXMax = xMax;
+            mDirtyYMax = yMax;
+            return;
+        }
+
+        mDirtyXMin = std::min(mDirtyXMin, xMin);
+        mDirtyYMin = std::min(mDirtyYMin, yMin);
+        mDirtyXMax = std::max(mDirtyXMax, xMax);
+        mDirtyYMax = std::max(mDirtyYMax, yMax);
+    }
+
+    inline bool hasDirtyRect() const
+    { return (mDirtyXMin < mDirtyXMax) && (mDirtyYMin < mDirtyYMax); }
+
+    //! \brief Dirty rectangle. The max values are excluded
+    inline uint32_t getDirtyXMin() const
+    { return mDirtyXMin; }
+    inline uint32_t getDirtyYMin() const
+    { return mDirtyYMin; }
+    inline uint32_t getDirtyXMax() const
+    { return mDirtyXMax; }
+    inline uint32_t getDirtyYMax() const
+    { return mDirtyYMax; }
+
+    //! \brief Should be called once the dirty rectangle has been uploaded
+    inline void clearDirtyRect()
+    {
+        mDirtyXMin = 0;
+        mDirtyYMin = 0;
+        mDirtyXMax = 0;
+        mDirtyYMax = 0;
+    }
+
+private:
+    uint32_t mWidth;
+    uint32_t mHeight;
+    std::vector<uint32_t> mPixels;
+
+    uint32_t mDirtyXMin;
+    uint32_t mDirtyYMin;
+    uint32_t mDirtyXMax;
+    uint32_t mDirtyYMax;
+};
+
+#endif // MINIMAPIMAGE_H
@@ -0,0 +1,136 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/MiniMapRaster.h"
+
+#include "gamemap/MiniMapImage.h"
+
+MiniMapRaster::MiniMapRaster(uint32_t mapSizeX, uint32_t mapSizeY) :
+    mMapSizeX(mapSizeX),
+    mMapSizeY(mapSizeY),
+    mTiles(mapSizeX * mapSizeY, 0),
+    mPalette(PALETTE_SIZE, MiniMapImage::packColor(0x00, 0x00, 0x00)),
+    mOutsideValue(0),
+    mIsViewDirty(true),
+    mLastImage(nullptr),
+    mLastCameraX(0.0f),
+    mLastCameraY(0.0f),
+    mLastCosRotation(1.0),
+    mLastSinRotation(0.0),
+    mLastGrainSize(0)
+{
+}
+
+void MiniMapRaster::setPaletteColor(uint8_t index, uint8_t r, uint8_t g, uint8_t b)
+{
+    uint32_t color = MiniMapImage::packColor(r, g, b);
+    if(mPalette[index] == color)
+        return;
+
+    mPalette[index] = color;
+    mIsViewDirty = true;
+}
+
+void MiniMapRaster::setTileValue(int x, int y, uint8_t index)
+{
+    if((x < 0) || (y < 0) || (x >= static_cast<int>(mMapSizeX)) || (y >= static_cast<int>(mMapSizeY)))
+        return;
+
+    uint8_t& value = mTiles[x + y * mMapSizeX];
+    if(value == index)
+        return;
+
+    value = index;
+    // Note that we could only redraw the pixels of this tile. But as the view is rotated, it
+    // is simpler to redraw and only the changed pixels will be uploaded anyway
+    mIsViewDirty = true;
+}
+
+void MiniMapRaster::draw(MiniMapImage& image, float cameraX, float cameraY, double cosRotation, double sinRotation,
+    uint32_t grainSize)
+{
+    if(grainSize == 0)
+        return;
+
+    if(!mIsViewDirty &&
+       (mLastImage == &image) &&
+       (mLastCameraX == cameraX) &&
+       (mLastCameraY == cameraY) &&
+       (mLastCosRotation == cosRotation) &&
+       (mLastSinRotation == sinRotation) &&
+       (mLastGrainSize == grainSize))
+    {
+        return;
+    }
+
+    mIsViewDirty = false;
+    mLastImage = &image;
+    mLastCameraX = cameraX;
+    mLastCameraY = cameraY;
+    mLastCosRotation = cosRotation;
+    mLastSinRotation = sinRotation;
+    mLastGrainSize = grainSize;
+
+    uint32_t width = image.getWidth();
+    uint32_t height = image.getHeight();
+    uint32_t nbColumns = width / grainSize;
+    uint32_t nbRows = height / grainSize;
+
+    // The rotation is linear in the tile coordinates so we compute the terms once per column and per row
+    // instead of once per pixel
+    int firstColumnX = static_cast<int>(cameraX - width / (2 * grainSize));
+    int firstRowY = static_cast<int>(cameraY - height / (2 * grainSize));
+    mColumnCos.resize(nbColumns);
+    mColumnSin.resize(nbColumns);
+    for(uint32_t column = 0; column < nbColumns; ++column)
+    {
+        float diffX = static_cast<int>(firstColumnX + column) - cameraX;
+        mColumnCos[column] = diffX * cosRotation;
+        mColumnSin[column] = diffX * sinRotation;
+    }
+    mRowCos.resize(nbRows);
+    mRowSin.resize(nbRows);
+    for(uint32_t row = 0; row < nbRows; ++row)
+    {
+        float diffY = static_cast<int>(firstRowY + row) - cameraY;
+        mRowCos[row] = diffY * cosRotation;
+        mRowSin[row] = diffY * sinRotation;
+    }
+
+    uint32_t outsideColor = mPalette[mOutsideValue];
+    for(uint32_t row = 0; row < nbRows; ++row)
+    {
+        // (0,0) is in the bottom left in the game map, top left in the image, so we are reversing y order here
+        uint32_t pixelY = height - (row + 1) * grainSize;
+        for(uint32_t column = 0; column < nbColumns; ++column)
+        {
+            int tileX = static_cast<int>(cameraX + static_cast<int>(mColumnCos[column] - mRowSin[row]));
+            int tileY = static_cast<int>(cameraY + static_cast<int>(mColumnSin[column] + mRowCos[row]));
+
+            uint32_t color = outsideColor;
+            if((tileX >= 0) && (tileY >= 0) && (tileX < static_cast<int>(mMapSizeX)) && (tileY < static_cast<int>(mMapSizeY)))
+                color = mPalette[mTiles[tileX + tileY * mMapSizeX]];
+
+            uint32_t pixelX = column * grainSize;
+            // Every pixel of a tile square have the same colour so checking the first one is enough
+            if(image.getPixel(pixelX, pixelY) == color)
+                continue;
+
+            image.fillRect(pixelX, pixelY, pixelX + grainSize, pixelY + grainSize, color);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MINIMAPRASTER_H
+#define MINIMAPRASTER_H
+
+#include <cstdint>
+#include <vector>
+
+class MiniMapImage;
+
+//! \brief Keeps one palette index per game map tile and draws the rotated and scaled minimap
+//! view into a MiniMapImage. The tile values are expected to be updated only when a tile
+//! changes (see TileStateListener). If neither the tiles nor the view changed, drawing
+//! does nothing. It does not depend on Ogre so that it can be used in unit tests.
+class MiniMapRaster
+{
+public:
+    //! \brief Number of colours in the palette
+    static const uint32_t PALETTE_SIZE = 256;
+
+    MiniMapRaster(uint32_t mapSizeX, uint32_t mapSizeY);
+
+    //! \brief Sets the colour used for the tiles with the given palette index
+    void setPaletteColor(uint8_t index, uint8_t r, uint8_t g, uint8_t b);
+
+    //! \brief Sets the palette index of the tile at (x, y). Positions outside the map are ignored
+    void setTileValue(int x, int y, uint8_t index);
+
+    inline uint8_t getTileValue(int x, int y) const
+    { return mTiles[x + y * mMapSizeX]; }
+
+    //! \brief Sets the palette index used outside the map
+    inline void setOutsideValue(uint8_t index)
+    {
+        mOutsideValue = index;
+        mIsViewDirty = true;
+    }
+
+    //! \brief Draws the map centered on (cameraX, cameraY) and rotated by the given angle in the image. Each
+    //! tile is drawn as a grainSize x grainSize square. The image width and height should be multiples of
+    //! grainSize. The game map y axis goes up while the image one goes down. Only the changed pixels are
+    //! written (and marked dirty in the image).
+    void draw(MiniMapImage& image, float cameraX, float cameraY, double cosRotation, double sinRotation,
+        uint32_t grainSize);
+
+private:
+    uint32_t mMapSizeX;
+    uint32_t mMapSizeY;
+
+    //! \brief Palette index for each tile. Indexed by x + y * mMapSizeX
+    std::vector<uint8_t> mTiles;
+
+    //! \brief Colours (in MiniMapImage format) for each palette index
+    std::vector<uint32_t> mPalette;
+
+    uint8_t mOutsideValue;
+
+    //! \brief Set when a tile or the palette changed since the last draw
+    bool mIsViewDirty;
+
+    //! \brief Parameters of the last draw
+    const MiniMapImage* mLastImage;
+    float mLastCameraX;
+    float mLastCameraY;
+    double mLastCosRotation;
+    double mLastSinRotation;
+    uint32_t mLastGrainSize;
+
+    //! \brief Rotation terms for each drawn column and row. Kept as members to avoid allocating each draw
+    std::vector<double> mColumnCos;
+    std::vector<double> mColumnSin;
+    std::vector<double> mRowCos;
+    std::vector<double> mRowSin;
+};
+
+#endif // MINIMAPRASTER_H
@@ -0,0 +1,170 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/PathCache.h"
+
+#include "creatureaction/CreatureAction.h"
+#include "entities/Creature.h"
+#include "entities/CreatureDefinition.h"
+#include "utils/Helper.h"
+
+#include <iterator>
+#include <tuple>
+
+PathCache::Key::Key(Tile* start, Tile* dest, const Creature& creature) :
+    mStart(start),
+    mDest(dest),
+    mSeat(creature.getSeat()),
+    mGroundSpeed(creature.getMoveSpeedGround()),
+    mWaterSpeed(creature.getMoveSpeedWater()),
+    mLavaSpeed(creature.getMoveSpeedLava()),
+    mIsWorker(creature.getDefinition()->isWorker()),
+    mIsFighting(creature.isActionInList(CreatureActionType::fight) ||
+        creature.isActionInList(CreatureActionType::flee))
+{
+}
+
+bool PathCache::Key::operator<(const Key& other) const
+{
+    return std::tie(mStart, mDest, mSeat, mGroundSpeed, mWaterSpeed, mLavaSpeed, mIsWorker, mIsFighting) <
+        std::tie(other.mStart, other.mDest, other.mSeat, other.mGroundSpeed, other.mWaterSpeed, other.mLavaSpeed,
+            other.mIsWorker, other.mIsFighting);
+}
+
+PathCache::PathCache(uint32_t capacity) :
+    mCapacity(capacity),
+    mEpoch(0),
+    mEntriesEpoch(0),
+    mNbHits(0),
+    mNbMisses(0),
+    mNbEvictions(0),
+    mNbInvalidations(0)
+{
+}
+
+void PathCache::checkEpoch()
+{
+    if(mEntriesEpoch == mEpoch)
+        return;
+
+    mEntriesEpoch = mEpoch;
+    if(mEntries.empty())
+        return;
+
+    ++mNbInvalidations;
+    mIndex.clear();
+    mEntries.clear();
+    mComponents.clear();
+}
+
+void PathCache::invalidateComponent(uint32_t component)
+{
+    // If no path is cached for this component, there is nothing to invalidate
+    auto it = mComponents.find(component);
+    if(it == mComponents.end())
+        return;
+
+    ++it->second.mEpoch;
+}
+
+void PathCache::erase(std::list<Entry>::iterator it)
+{
+    auto itComponent = mComponents.find(it->mComponent);
+    if(itComponent != mComponents.end())
+    {
+        --itComponent->second.mNbEntries;
+        if(itComponent->second.mNbEntries == 0)
+            mComponents.erase(itComponent);
+    }
+
+    mIndex.erase(it->mKey);
+    mEntries.erase(it);
+}
+
+const TilePath* PathCache::find(const Key& key)
+{
+    checkEpoch();
+    auto it = mIndex.find(key);
+    if(it == mIndex.end())
+    {
+        ++mNbMisses;
+        return nullptr;
+    }
+
+    std::list<Entry>::iterator itEntry = it->second;
+    auto itComponent = mComponents.find(itEntry->mComponent);
+    if((itComponent == mComponents.end()) || (itComponent->second.mEpoch != itEntry->mComponentEpoch))
+    {
+        // The component of the start tile changed since the path was computed
+        ++mNbMisses;
+        ++mNbInvalidations;
+        erase(itEntry);
+        return nullptr;
+    }
+
+    ++mNbHits;
+    // We move the entry to the front as it is the most recently used
+    mEntries.splice(mEntries.begin(), mEntries, itEntry);
+    return &itEntry->mPath;
+}
+
+void PathCache::insert(const Key& key, uint32_t component, const TilePath& path)
+{
+    if(mCapacity == 0)
+        return;
+
+    checkEpoch();
+    auto it = mIndex.find(key);
+    if(it != mIndex.end())
+        erase(it->second);
+
+    if(mEntries.size() >= mCapacity)
+    {
+        erase(std::prev(mEntries.end()));
+        ++mNbEvictions;
+    }
+
+    ComponentState& componentState = mComponents[component];
+    ++componentState.mNbEntries;
+    mEntries.emplace_front(key, component, componentState.mEpoch, path);
+    mIndex.emplace(key, mEntries.begin());
+}
+
+void PathCache::clear()
+{
+    mIndex.clear();
+    mEntries.clear();
+    mComponents.clear();
+    mEntriesEpoch = mEpoch;
+    mNbHits = 0;
+    mNbMisses = 0;
+    mNbEvictions = 0;
+    mNbInvalidations = 0;
+}
+
+std::string PathCache::getStatsString() const
+{
+    uint64_t nbRequests = mNbHits + mNbMisses;
+    uint64_t hitRate = (nbRequests == 0) ? 0 : (mNbHits * 100) / nbRequests;
+    return "hits=" + Helper::toString(mNbHits)
+        + ", misses=" + Helper::toString(mNbMisses)
+        + ", hitRate=" + Helper::toString(hitRate) + "%"
+        + ", evictions=" + Helper::toString(mNbEvictions)
+        + ", invalidations=" + Helper::toString(mNbInvalidations)
+        + ", cachedPaths=" + Helper::toString(static_cast<uint32_t>(mEntries.size()))
+        + "/" + Helper::toString(mCapacity);
+}
@@ -0,0 +1,149 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PATHCACHE_H
+#define PATHCACHE_H
+
+#include "gamemap/TilePath.h"
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <string>
+
+class Creature;
+class Seat;
+class Tile;
+
+//! \brief LRU cache of the paths computed by GameMap::path. Many creatures ask for the same path
+//! during a turn (workers heading to the same dig site, fighters going to the same room, ...). The
+//! key is the start/destination tiles and the mobility class of the asking creature (move speeds, seat
+//! and the states that can change door passability). The cache has to be invalidated each time something
+//! that can change a path happens (floodfill changes, buildings added/removed, doors locked/unlocked, ...).
+//! Each path is stored with the floodfill component of its start tile. When the floodfill of a tile
+//! changes, only the paths starting in the components it left or joined are invalidated (see
+//! invalidateComponent). A path cannot change when tiles are dug or bridges built in other components.
+//! Invalidating only increments an epoch. The entries are dropped on the next access.
+class PathCache
+{
+public:
+    //! \brief Identifies a path request
+    struct Key
+    {
+        Key(Tile* start, Tile* dest, const Creature& creature);
+
+        bool operator<(const Key& other) const;
+
+        Tile* mStart;
+        Tile* mDest;
+        const Seat* mSeat;
+        double mGroundSpeed;
+        double mWaterSpeed;
+        double mLavaSpeed;
+        bool mIsWorker;
+        //! \brief Enemy doors are only impassable for fighting/fleeing creatures
+        bool mIsFighting;
+    };
+
+    PathCache(uint32_t capacity);
+
+    //! \brief Returns the cached path for the given key or nullptr if there is none.
+    //! Note that an empty path is a valid result (the destination cannot be reached).
+    //! The returned path shares its tiles with the cached one (see TilePath::share) so that
+    //! they are not copied
+    const TilePath* find(const Key& key);
+
+    //! \brief Stores the given path. component is the floodfill value of the start tile for the asking
+    //! creature. If the cache is full, the least recently used path is dropped
+    void insert(const Key& key, uint32_t component, const TilePath& path);
+
+    //! \brief Invalidates every cached path. Should be called each time something that can change
+    //! every path happens
+    inline void invalidate()
+    { ++mEpoch; }
+
+    //! \brief Invalidates the cached paths starting in the given floodfill component. Should be
+    //! called when a tile enters or leaves this component
+    void invalidateComponent(uint32_t component);
+
+    //! \brief Drops every cached path and resets the stats
+    void clear();
+
+    inline uint64_t getNbHits() const
+    { return mNbHits; }
+
+    inline uint64_t getNbMisses() const
+    { return mNbMisses; }
+
+    //! \brief Returns a human readable string with the cache stats
+    std::string getStatsString() const;
+
+private:
+    struct Entry
+    {
+        Entry(const Key& key, uint32_t component, uint64_t componentEpoch, const TilePath& path) :
+            mKey(key),
+            mComponent(component),
+            mComponentEpoch(componentEpoch),
+            mPath(path.share())
+        {}
+
+        Key mKey;
+        uint32_t mComponent;
+        //! \brief Epoch of mComponent when the path was computed
+        uint64_t mComponentEpoch;
+        TilePath mPath;
+    };
+
+    //! \brief Epoch and number of cached paths of a floodfill component. Components are only
+    //! tracked while they have cached paths
+    struct ComponentState
+    {
+        ComponentState() :
+            mEpoch(0),
+            mNbEntries(0)
+        {}
+
+        uint64_t mEpoch;
+        uint32_t mNbEntries;
+    };
+
+    //! \brief Drops the cached paths if the epoch changed since they were computed
+    void checkEpoch();
+
+    //! \brief Drops the given entry
+    void erase(std::list<Entry>::iterator it);
+
+    uint32_t mCapacity;
+
+    //! \brief Cached paths. The most recently used is at the front
+    std::list<Entry> mEntries;
+    std::map<Key, std::list<Entry>::iterator> mIndex;
+    std::map<uint32_t, ComponentState> mComponents;
+
+    //! \brief Incremented by invalidate
+    uint64_t mEpoch;
+    //! \brief Epoch when the cached paths have been computed
+    uint64_t mEntriesEpoch;
+
+    uint64_t mNbHits;
+    uint64_t mNbMisses;
+    uint64_t mNbEvictions;
+    uint64_t mNbInvalidations;
+};
+
+#endif // PATHCACHE_H
@@ -19,248 +19,15 @@
 
 #include "entities/Tile.h"
 
+#include "gamemap/TileDistanceTable.h"
+
 #include "network/ODPacket.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
-const std::vector<Tile*> EMPTY_TILES;
-
-class TileDistance
-{
-public:
-    enum TileDistanceType
-    {
-        Horizontal,
-        Diagonal,
-        Other
-    };
-
-    TileDistance(int diffX, int diffY, TileDistanceType type, int distSquared):
-        mDiffX(diffX),
-        mDiffY(diffY),
-        mType(type),
-        mDistSquared(distSquared)
-    {
-    }
-
-    inline int getDiffX() const
-    { return mDiffX; }
-
-    inline int getDiffY() const
-    { return mDiffY; }
-
-    inline TileDistanceType getType() const
-    { return mType; }
+#include <algorithm>
 
-    inline int getDistSquared() const
-    { return mDistSquared; }
-
-    void computeTileDistances(double coefNorth, double coefSouth, const TileDistance& tileDistance,
-        uint32_t indexTileDistance)
-    {
-        // A tile can only hide tiles behind (x > tile.x and y > tile.y)
-        if(tileDistance.getDiffX() < getDiffX())
-            return;
-        if(tileDistance.getDiffY() < getDiffY())
-            return;
-
-        // We don't want a tile to hide itself
-        if((tileDistance.getDiffX() == getDiffX()) &&
-           (tileDistance.getDiffY() == getDiffY()))
-        {
-            return;
-        }
-
-        if(getType() == TileDistance::TileDistanceType::Horizontal)
-        {
-            // For horizontal tiles, we hide following tiles (x > tile.x). But we process
-            // north tiles normally
-            if(tileDistance.getType() == TileDistance::TileDistanceType::Horizontal)
-            {
-                addHiddenTileSouth(indexTileDistance, 1.0);
-                return;
-            }
-
-            double xTileDeb = static_cast<double>(tileDistance.getDiffX()) - 0.5;
-            double xTileEnd = xTileDeb + 1.0;
-            double yTileDeb = static_cast<double>(tileDistance.getDiffY()) - 0.5;
-            double yTileEnd = yTileDeb + 1.0;
-            double yHideDebNorth = coefNorth * xTileDeb;
-            double yHideEndNorth = coefNorth * xTileEnd;
-
-            // If the tile is over the North ray, it is not hidden
-            if(yHideEndNorth <= yTileDeb)
-                return;
-
-            // We check which part of the tile is hidden
-            if((yHideDebNorth >= yTileDeb) &&
-               (yHideEndNorth <= yTileEnd))
-            {
-                // The ray hits the left side of the tile and the right side.
-                // The south part is partially hidden
-                double hiddenArea = (yHideEndNorth - yHideDebNorth) / 2.0;
-                hiddenArea += yHideDebNorth - yTileDeb;
-                addHiddenTileSouth(indexTileDistance, hiddenArea);
-            }
-            else if((yHideDebNorth < yTileDeb) &&
-                    (yHideEndNorth > yTileDeb))
-            {
-                // The ray hits the bottom side of the tile but hits the right side. We compute
-                // the south visible part
-                double xHit = yTileDeb / coefNorth;
-                double hiddenArea = (yHideEndNorth - yTileDeb) * (xTileEnd - xHit) / 2.0;
-                addHiddenTileSouth(indexTileDistance, hiddenArea);
-            }
-            else if((yHideDebNorth < yTileEnd) &&
-                    (yHideEndNorth > yTileEnd))
-            {
-                // The ray hits the left side of the tile but is over the right side. We compute
-                // the hidden part on north.
-                double xHit = yTileEnd / coefNorth;
-                double visibleArea = (yTileEnd - yHideDebNorth) * (xHit - xTileDeb) / 2.0;
-                addHiddenTileSouth(indexTileDistance, 1.0 - visibleArea);
-            }
-            else
-            {
-                // The entire tile is hidden
-                addHiddenTileSouth(indexTileDistance, 1.0);
-            }
-
-            return;
-        }
-
-        double xTileDeb = static_cast<double>(tileDistance.getDiffX()) - 0.5;
-        double xTileEnd = xTileDeb + 1.0;
-        double yTileDeb = static_cast<double>(tileDistance.getDiffY()) - 0.5;
-        double yTileEnd = yTileDeb + 1.0;
-
-        // We check if the current tile is hidden by the tile. To consider that the
-        // tile is hidden by the south, as we know the angle will be between 0 and 45 degrees,
-        // we consider that the tile has to be hit by the ray passing through the hiding tile
-        // on the left side of the tile (otherwise, the hidden part will be too small).
-        double yHideDebSouth = coefSouth * xTileDeb;
-        double yHideEndSouth = coefSouth * xTileEnd;
-        double yHideDebNorth = coefNorth * xTileDeb;
-        double yHideEndNorth = coefNorth * xTileEnd;
-        // We check if at least a part of the tile is hidden
-        if((yHideDebSouth < yTileEnd) &&
-           (yHideEndNorth > yTileDeb))
-        {
-            // At least a part of this tile is hidden
-            if((yHideDebSouth >= yTileDeb) &&
-               (yHideEndSouth <= yTileEnd))
-            {
-                // The ray hits the left side of the tile and the right side.
-                // The south part is partially hidden
-                // The visible part is composed from a square between the tile inferior part and
-                // the triangle made by the ray
-                double visibleArea = (yHideEndSouth - yHideDebSouth) / 2.0;
-                visibleArea += yHideDebSouth - yTileDeb;
-                addHiddenTileNorth(indexTileDistance, 1.0 - visibleArea);
-            }
-            else if((yHideDebSouth < yTileDeb) &&
-                    (yHideEndSouth > yTileDeb))
-            {
-                // The ray hits the bottom side of the tile but hits the right side. We compute
-                // the south visible part
-                double xHit = yTileDeb / coefSouth;
-                double visibleArea = (yHideEndSouth - yTileDeb) * (xTileEnd - xHit) / 2.0;
-                addHiddenTileNorth(indexTileDistance, 1.0 - visibleArea);
-            }
-            else if((yHideDebSouth < yTileEnd) &&
-                    (yHideEndSouth > yTileEnd))
-            {
-                // The ray hits the left side of the tile but is over the right side. We compute
-                // the hidden part on north.
-                double xHit = yTileEnd / coefSouth;
-                double hiddenArea = (yTileEnd - yHideDebSouth) * (xHit - xTileDeb) / 2.0;
-                addHiddenTileNorth(indexTileDistance, hiddenArea);
-
-            }
-            else if((yHideDebNorth >= yTileDeb) &&
-               (yHideEndNorth <= yTileEnd))
-            {
-                double hiddenArea = (yHideEndNorth - yHideDebNorth) / 2.0;
-                hiddenArea += yHideDebNorth - yTileDeb;
-                addHiddenTileSouth(indexTileDistance, hiddenArea);
-            }
-            else if((yHideDebNorth < yTileDeb) &&
-                    (yHideEndNorth > yTileDeb))
-            {
-                // The ray hits the bottom side of the tile but hits the right side. We compute
-                // the south visible part
-                double xHit = yTileDeb / coefNorth;
-                double hiddenArea = (yHideEndNorth - yTileDeb) * (xTileEnd - xHit) / 2.0;
-                addHiddenTileSouth(indexTileDistance, hiddenArea);
-            }
-            else if((yHideDebNorth < yTileEnd) &&
-                    (yHideEndNorth > yTileEnd))
-            {
-                // The ray hits the left side of the tile but is over the right side. We compute
-                // the hidden part on north.
-                double xHit = yTileEnd / coefNorth;
-                double visibleArea = (yTileEnd - yHideDebNorth) * (xHit - xTileDeb) / 2.0;
-                addHiddenTileSouth(indexTileDistance, 1.0 - visibleArea);
-            }
-            else
-            {
-                // The entire tile is hidden
-                addHiddenTileSouth(indexTileDistance, 1.0);
-            }
-        }
-    }
-
-    void print(const std::vector<TileDistance>& tileDistance)
-    {
-        std::string log = "TileDistance x=" + Helper::toString(getDiffX())
-            + ", y=" + Helper::toString(getDiffY())
-            + ", squared=" + Helper::toString(getDistSquared());
-        for(const std::pair<uint32_t, double>& p : mHiddenTilesNorth)
-        {
-            const TileDistance& tile = tileDistance[p.first];
-            log += ", TileDistanceNorth x=" + Helper::toString(tile.getDiffX())
-                + ", y=" + Helper::toString(tile.getDiffY())
-                + ", val=" + Helper::toString(p.second);
-        }
-        for(const std::pair<uint32_t, double>& p : mHiddenTilesSouth)
-        {
-            const TileDistance& tile = tileDistance[p.first];
-            log += ", TileDistanceSouth x=" + Helper::toString(tile.getDiffX())
-                + ", y=" + Helper::toString(tile.getDiffY())
-                + ", val=" + Helper::toString(p.second);
-        }
-
-        OD_LOG_INF(log);
-    }
-
-    const std::vector<std::pair<uint32_t, double>>& getHiddenTilesNorth() const
-    {
-        return mHiddenTilesNorth;
-    }
-
-    const std::vector<std::pair<uint32_t, double>>& getHiddenTilesSouth() const
-    {
-        return mHiddenTilesSouth;
-    }
-
-private:
-    void addHiddenTileNorth(uint32_t indexTile, double hiddenPercent)
-    {
-        mHiddenTilesNorth.push_back(std::pair<uint32_t, double>(indexTile, hiddenPercent));
-    }
-
-    void addHiddenTileSouth(uint32_t indexTile, double hiddenPercent)
-    {
-        mHiddenTilesSouth.push_back(std::pair<uint32_t, double>(indexTile, hiddenPercent));
-    }
-
-    int mDiffX;
-    int mDiffY;
-    TileDistanceType mType;
-    int mDistSquared;
-    std::vector<std::pair<uint32_t, double>> mHiddenTilesNorth;
-    std::vector<std::pair<uint32_t, double>> mHiddenTilesSouth;
-};
+const std::vector<Tile*> EMPTY_TILES;
 
 class TileDistanceProcess
 {
@@ -323,19 +90,25 @@ private:
     double mHiddenValueSouth;
 };
 
-bool sortByDistSquared(const TileDistance& tileDist1, const TileDistance& tileDist2)
+struct TileContainer::VisibleTilesScratch
 {
-    return tileDist1.getDistSquared() < tileDist2.getDistSquared();
-}
+    //! \brief The tiles processed for each of the 8 symmetric parts (see TileContainer::visibleTiles)
+    std::vector<TileDistanceProcess> mTilesProcess[8];
+
+    //! \brief Bitsets of the tiles hidden by more than half for each of the 8 symmetric parts. Indexed like mTilesProcess
+    std::vector<uint64_t> mHiddenTiles[8];
+};
 
 TileContainer::TileContainer(int initTileDistance):
     mMapSizeX(0),
     mMapSizeY(0),
     mRr(0),
     mTiles(nullptr),
-    mTileDistanceComputed(0)
+    mTileMarkGeneration(0),
+    mVisionGeneration(0),
+    mVisibleTilesScratch(new VisibleTilesScratch),
+    mTileDistanceTable(TileDistanceTable::getTable(initTileDistance))
 {
-    buildTileDistance(initTileDistance);
 }
 
 TileContainer::~TileContainer()
@@ -473,12 +246,46 @@ bool TileContainer::allocateMapMemory(int xSize, int ySize)
         }
     }
 
+    mTileMarks.assign(mMapSizeX * mMapSizeY, 0);
+    mTileMarkGeneration = 0;
+
+    mTileVisionChanges.assign(mMapSizeX * mMapSizeY, 0);
+    mVisionGeneration = 0;
+
+    return true;
+}
+
+void TileContainer::clearTileMarks()
+{
+    ++mTileMarkGeneration;
+    if(mTileMarkGeneration != 0)
+        return;
+
+    // The generation wrapped. We have to reset the marks to be sure no tile is marked
+    std::fill(mTileMarks.begin(), mTileMarks.end(), 0);
+    mTileMarkGeneration = 1;
+}
+
+bool TileContainer::markTile(const Tile* tile)
+{
+    uint32_t& mark = mTileMarks[tile->getX() * mMapSizeY + tile->getY()];
+    if(mark == mTileMarkGeneration)
+        return false;
+
+    mark = mTileMarkGeneration;
     return true;
 }
 
 std::vector<Tile*> TileContainer::rectangularRegion(int x1, int y1, int x2, int y2)
 {
     std::vector<Tile*> returnList;
+    rectangularRegion(x1, y1, x2, y2, returnList);
+    return returnList;
+}
+
+void TileContainer::rectangularRegion(int x1, int y1, int x2, int y2, std::vector<Tile*>& tiles) const
+{
+    tiles.clear();
     Tile *tempTile;
 
     if (x1 > x2)
@@ -493,24 +300,27 @@ std::vector<Tile*> TileContainer::rectangularRegion(int x1, int y1, int x2, int
             tempTile = getTile(ii, jj);
 
             if (tempTile != nullptr)
-                returnList.push_back(tempTile);
+                tiles.push_back(tempTile);
         }
     }
-
-    return returnList;
 }
 
 std::vector<Tile*> TileContainer::circularRegion(int x, int y, int radius)
 {
-    // To compute the tiles within this region, we use the symmetry of the square. That's why we mix tile x/y coordinate
-    // with tileDist diffX/diffY. More explanation can be found in the buildTileDistance function
     std::vector<Tile*> returnList;
+    circularRegion(x, y, radius, returnList);
+    return returnList;
+}
 
-    if(radius > mTileDistanceComputed)
-        buildTileDistance(radius);
+void TileContainer::circularRegion(int x, int y, int radius, std::vector<Tile*>& tiles)
+{
+    // To compute the tiles within this region, we use the symmetry of the square. That's why we mix tile x/y coordinate
+    // with tileDist diffX/diffY. More explanation can be found in TileDistanceTable::build
+    tiles.clear();
 
+    const TileDistanceTable& tileDistanceTable = getTileDistanceTable(radius);
     int radiusSquared = radius * radius;
-    for(const TileDistance& tileDist : mTileDistance)
+    for(const TileDistance& tileDist : tileDistanceTable.getTileDistances())
     {
         if(tileDist.getDistSquared() > radiusSquared)
             break;
@@ -525,7 +335,7 @@ std::vector<Tile*> TileContainer::circularRegion(int x, int y, int radius)
                     // We only add the current tile
                     Tile* tile = getTile(x, y);
                     if(tile != nullptr)
-                        returnList.push_back(tile);
+                        tiles.push_back(tile);
 
                     continue;
                 }
@@ -534,16 +344,16 @@ std::vector<Tile*> TileContainer::circularRegion(int x, int y, int radius)
                 Tile* tile;
                 tile = getTile(x + tileDist.getDiffX(), y);
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x - tileDist.getDiffX(), y);
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x, y + tileDist.getDiffX());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x, y - tileDist.getDiffX());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
 
                 break;
             }
@@ -554,16 +364,16 @@ std::vector<Tile*> TileContainer::circularRegion(int x, int y, int radius)
                 Tile* tile;
                 tile = getTile(x + tileDist.getDiffX(), y + tileDist.getDiffY());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x + tileDist.getDiffX(), y - tileDist.getDiffY());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x - tileDist.getDiffX(), y + tileDist.getDiffY());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x - tileDist.getDiffX(), y - tileDist.getDiffY());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
 
                 break;
             }
@@ -575,62 +385,60 @@ std::vector<Tile*> TileContainer::circularRegion(int x, int y, int radius)
                 Tile* tile;
                 tile = getTile(x + tileDist.getDiffX(), y + tileDist.getDiffY());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x + tileDist.getDiffX(), y - tileDist.getDiffY());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x - tileDist.getDiffX(), y + tileDist.getDiffY());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x - tileDist.getDiffX(), y - tileDist.getDiffY());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x + tileDist.getDiffY(), y + tileDist.getDiffX());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x + tileDist.getDiffY(), y - tileDist.getDiffX());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x - tileDist.getDiffY(), y + tileDist.getDiffX());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
                 tile = getTile(x - tileDist.getDiffY(), y - tileDist.getDiffX());
                 if(tile != nullptr)
-                    returnList.push_back(tile);
+                    tiles.push_back(tile);
 
                 break;
             }
         }
     }
-
-    return returnList;
 }
 
 std::vector<Tile*> TileContainer::tilesBorderedByRegion(const std::vector<Tile*> &region)
 {
     std::vector<Tile*> returnList;
+    tilesBorderedByRegion(region, returnList);
+    return returnList;
+}
 
-    std::vector<std::vector<bool>> tilesToRefresh(getMapSizeX(), std::vector<bool>(getMapSizeY(), false));
+void TileContainer::tilesBorderedByRegion(const std::vector<Tile*> &region, std::vector<Tile*>& tiles)
+{
+    tiles.clear();
+    clearTileMarks();
     for (Tile* t1 : region)
     {
-        if(!tilesToRefresh[t1->getX()][t1->getY()])
-        {
-            tilesToRefresh[t1->getX()][t1->getY()] = true;
-            returnList.push_back(t1);
-        }
+        if(markTile(t1))
+            tiles.push_back(t1);
 
         // Get the tiles bordering the current tile and loop over them.
         for (Tile* t2 : t1->getAllNeighbors())
         {
-            if(tilesToRefresh[t2->getX()][t2->getY()])
+            if(!markTile(t2))
                 continue;
 
-            tilesToRefresh[t2->getX()][t2->getY()] = true;
-            returnList.push_back(t2);
+            tiles.push_back(t2);
         }
     }
-
-    return returnList;
 }
 
 const std::vector<Tile*>& TileContainer::neighborTiles(int x, int y) const
@@ -642,85 +450,17 @@ const std::vector<Tile*>& TileContainer::neighborTiles(int x, int y) const
     return tempTile->getAllNeighbors();
 }
 
-void TileContainer::buildTileDistance(int distance)
+const TileDistanceTable& TileContainer::getTileDistanceTable(int radius)
 {
-    if(mTileDistanceComputed >= distance)
-        return;
-
-    // We want to be able to fill a vector of tiles sorted beginning with the closest tile. If we look a grid (each letter
-    // represents a tile at the same distance from the center: a):
-    // jihghij
-    // ifedefi
-    // hecbceh
-    // gdbabdg
-    // hecbceh
-    // ifedefi
-    // jihghij
-    // We can see that there are 3 kind of tiles:
-    // - Vertical/Horizontal tiles (abdg): at each distance, there are 4 of them
-    // - Diagonal tiles (acfj): at each distance, there are 4 of them
-    // - Other tiles (ehi...): at each distance, there are 8 of them
-    // Moreover, we can see a symmetry. We can compute all tiles by computing only 1/8 tiles:
-    //    j
-    //   fi
-    //  ceh
-    // abdg
-
-    // If we compute only the minimum tiles needed, we have no vertical tiles (since each of them can be deduced from the horizontal)
-    // To compute tiles easily, we will compute the 1/8 tiles until distance. Then, we will sort the tiles to begin with
-    // closest distance until farthest
-    mTileDistance.clear();
-    for(int y = 0; y <= distance; ++y)
-    {
-        for(int x = y; x <= distance; ++x)
-        {
-            TileDistance::TileDistanceType type;
-            if(y == 0)
-            {
-                type = TileDistance::TileDistanceType::Horizontal;
-            }
-            else if(x == y)
-            {
-                type = TileDistance::TileDistanceType::Diagonal;
-            }
-            else
-            {
-                type = TileDistance::TileDistanceType::Other;
-            }
-            int distSquared = x * x + y * y;
-            mTileDistance.push_back(TileDistance(x, y, type, distSquared));
-        }
-    }
-
-    std::sort(mTileDistance.begin(), mTileDistance.end(), sortByDistSquared);
-
-    // We have filled the tile distance vector. Now, we fill how each tile hides the
-    // other ones when they mask vision to help calculate visible tiles
-    for(TileDistance& tileDistance : mTileDistance)
-    {
-        // We don't process the first tile
-        if(tileDistance.getDiffX() == 0 && tileDistance.getDiffY() == 0)
-            continue;
-
-        // Other tiles can hide with their down side and their up side other tiles
-        // or diagonal tiles (but not Horizontal tiles)
-        // We compute the tiles hidden from the south. In this case, only tiles with
-        // x > tile.x can be hidden
-        double coefNorth = (static_cast<double>(tileDistance.getDiffY()) + 0.5) / (static_cast<double>(tileDistance.getDiffX()) - 0.5);
-        double coefSouth = (static_cast<double>(tileDistance.getDiffY()) - 0.5) / (static_cast<double>(tileDistance.getDiffX()) + 0.5);
-        for(uint32_t index = 0; index < mTileDistance.size(); ++index)
-        {
-            const TileDistance& tileDistance2 = mTileDistance[index];
-            tileDistance.computeTileDistances(coefNorth, coefSouth, tileDistance2, index);
-        }
-    }
+    if(radius > mTileDistanceTable->getRadius())
+        mTileDistanceTable = TileDistanceTable::getTable(radius);
 
-    mTileDistanceComputed = distance;
+    return *mTileDistanceTable;
 }
 
-std::list<Tile*> TileContainer::tilesBetween(int x1, int y1, int x2, int y2) const
+void TileContainer::tilesBetween(int x1, int y1, int x2, int y2, std::vector<Tile*>& path) const
 {
-    std::list<Tile*> path;
+    path.clear();
 
     double deltax = x2 - x1;
     double deltay = y2 - y1;
@@ -804,32 +544,37 @@ std::list<Tile*> TileContainer::tilesBetween(int x1, int y1, int x2, int y2) con
     Tile* tile = getTile(x2, y2);
     if(tile != nullptr)
         path.push_back(tile);
-
-    return path;
 }
 
 std::vector<Tile*> TileContainer::visibleTiles(int x, int y, int radius)
 {
-    // To compute the tiles within this region, we use the symmetry of the square. That's why we mix tile x/y coordinate
-    // with tileDist diffX/diffY. More explanation can be found in the buildTileDistance function
     std::vector<Tile*> returnList;
+    visibleTiles(x, y, radius, returnList);
+    return returnList;
+}
 
-    if(radius > mTileDistanceComputed)
-        buildTileDistance(radius);
+void TileContainer::visibleTiles(int x, int y, int radius, std::vector<Tile*>& tiles)
+{
+    // To compute the tiles within this region, we use the symmetry of the square. That's why we mix tile x/y coordinate
+    // with tileDist diffX/diffY. More explanation can be found in TileDistanceTable::build
+    tiles.clear();
 
+    const TileDistanceTable& tileDistanceTable = getTileDistanceTable(radius);
     int radiusSquared = radius * radius;
 
-    // To have all the tiles around, we process mTileDistance 8 times.
+    // To have all the tiles around, we process the tile distance table 8 times.
     // We will process in, this order (c being the starting tile):
     // 514
     // 2c0
     // 637
     // Then, we will have to merge diagonal/horizontal tiles
-    // Because we want the index to be correct, we will add tiles even when null in tilesProcess
-    std::vector<TileDistanceProcess> tilesProcess[8];
+    // Because we want the index to be correct, we will add tiles even when null in tilesProcess.
+    // The vectors are kept between calls to avoid allocating
+    std::vector<TileDistanceProcess>* tilesProcess = mVisibleTilesScratch->mTilesProcess;
     for(uint32_t k = 0; k < 8; ++k)
     {
-        for(const TileDistance& tileDist : mTileDistance)
+        tilesProcess[k].clear();
+        for(const TileDistance& tileDist : tileDistanceTable.getTileDistances())
         {
             if(tileDist.getDistSquared() > radiusSquared)
                 break;
@@ -891,8 +636,14 @@ std::vector<Tile*> TileContainer::visibleTiles(int x, int y, int radius)
     }
 
     // The array of tiles is filled. Now, we apply the visibility.
+    // The 8 vectors have the same size. The table might have been computed for a bigger radius so
+    // the tiles it hides have to be clamped to the ones we are processing
+    uint32_t nbTiles = static_cast<uint32_t>(tilesProcess[0].size());
+    uint32_t nbWords = (nbTiles + 63) / 64;
+    std::vector<uint64_t>* hiddenTiles = mVisibleTilesScratch->mHiddenTiles;
     for(uint32_t k = 0; k < 8; ++k)
     {
+        hiddenTiles[k].assign(nbWords, 0);
         for(TileDistanceProcess& tileDistanceProcess : tilesProcess[k])
         {
             if(tileDistanceProcess.getTile() == nullptr)
@@ -901,10 +652,18 @@ std::vector<Tile*> TileContainer::visibleTiles(int x, int y, int radius)
             if(tileDistanceProcess.getTile()->permitsVision())
                 continue;
 
-            // The tile hides vision. We process tiles it hides
+            // The tile hides vision. We process tiles it hides. Tiles hidden by more than half cannot be seen
+            // whatever the other tiles are so they are merged as a bitset
+            const TileDistance& tileDistance = tileDistanceProcess.getTileDistance();
+            const std::vector<uint64_t>& hiddenWords = tileDistance.getHiddenWords();
+            uint32_t firstWord = tileDistance.getHiddenFirstWord();
+            uint32_t endWord = std::min(nbWords, firstWord + static_cast<uint32_t>(hiddenWords.size()));
+            for(uint32_t word = firstWord; word < endWord; ++word)
+                hiddenTiles[k][word] |= hiddenWords[word - firstWord];
+
             for(const std::pair<uint32_t, double>& p : tileDistanceProcess.getTileDistance().getHiddenTilesNorth())
             {
-                // mTileDistance might be bigger than the actual vector because it can include tiles
+                // The table might be bigger than the actual vector because it can include tiles
                 // farther than the ones currently computed (for example if sight < computedSight)
                 if(p.first >= tilesProcess[k].size())
                     continue;
@@ -913,7 +672,7 @@ std::vector<Tile*> TileContainer::visibleTiles(int x, int y, int radius)
             }
             for(const std::pair<uint32_t, double>& p : tileDistanceProcess.getTileDistance().getHiddenTilesSouth())
             {
-                // mTileDistance might be bigger than the actual vector because it can include tiles
+                // The table might be bigger than the actual vector because it can include tiles
                 // farther than the ones currently computed (for example if sight < computedSight)
                 if(p.first >= tilesProcess[k].size())
                     continue;
@@ -925,9 +684,10 @@ std::vector<Tile*> TileContainer::visibleTiles(int x, int y, int radius)
 
     // Now, we process all the tiles. Note that horizontal tiles are common for 2 consecutive
     // vectors in tilesProcess and that diagonal tiles should be merged.
-    // The 8 vectors have the same size
-    for(uint32_t i = 0; i < tilesProcess[0].size(); ++i)
+    for(uint32_t i = 0; i < nbTiles; ++i)
     {
+        uint32_t word = i / 64;
+        uint64_t bit = static_cast<uint64_t>(1) << (i % 64);
         for(uint32_t k = 0; k < 8; ++k)
         {
             TileDistanceProcess& tileDistanceProcess = tilesProcess[k][i];
@@ -959,13 +719,45 @@ std::vector<Tile*> TileContainer::visibleTiles(int x, int y, int radius)
                 TileDistanceProcess& tileDistanceProcess2 = tilesProcess[k + 4][i];
                 tileDistanceProcess.addHiddenValueNorth(tileDistanceProcess2.getHiddenValueSouth());
                 tileDistanceProcess.addHiddenValueSouth(tileDistanceProcess2.getHiddenValueNorth());
+                if((hiddenTiles[k + 4][word] & bit) != 0)
+                    continue;
             }
 
+            if((hiddenTiles[k][word] & bit) != 0)
+                continue;
+
             if(!tileDistanceProcess.isTileVisible())
                 continue;
 
-            returnList.push_back(tileDistanceProcess.getTile());
+            tiles.push_back(tileDistanceProcess.getTile());
         }
     }
-    return returnList;
+}
+
+void TileContainer::notifyTileVisionChanged(const Tile* tile)
+{
+    ++mVisionGeneration;
+    mTileVisionChanges[tile->getX() * mMapSizeY + tile->getY()] = mVisionGeneration;
+}
+
+bool TileContainer::hasVisionChangedInRange(int x, int y, int radius, uint32_t sinceGeneration) const
+{
+    // Nothing changed anywhere on the map. That's the usual case
+    if(sinceGeneration == mVisionGeneration)
+        return false;
+
+    int xMin = std::max(0, x - radius);
+    int xMax = std::min(mMapSizeX - 1, x + radius);
+    int yMin = std::max(0, y - radius);
+    int yMax = std::min(mMapSizeY - 1, y + radius);
+    for(int xx = xMin; xx <= xMax; ++xx)
+    {
+        for(int yy = yMin; yy <= yMax; ++yy)
+        {
+            if(mTileVisionChanges[xx * mMapSizeY + yy] > sinceGeneration)
+                return true;
+        }
+    }
+
+    return false;
 }
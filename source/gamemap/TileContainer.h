@@ -19,11 +19,12 @@
 #define TILECONTAINER_H
 
 #include <cassert>
-#include <list>
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 class ODPacket;
-class TileDistance;
+class TileDistanceTable;
 class Tile;
 
 enum class TileType;
@@ -65,14 +66,23 @@ public:
     //! \brief Returns all the valid tiles in the rectangular region specified by the two corner points given.
     std::vector<Tile*> rectangularRegion(int x1, int y1, int x2, int y2);
 
+    //! \brief Same as rectangularRegion but fills the given vector instead of returning a new one. tiles
+    //! is cleared first. Callers doing the query often should keep the vector to avoid allocating.
+    //! The same applies to the other tile queries taking an output vector
+    void rectangularRegion(int x1, int y1, int x2, int y2, std::vector<Tile*>& tiles) const;
+
     //! \brief Returns all the valid tiles in the curcular region
     //! surrounding the given point and extending outward to the specified radius.
     std::vector<Tile*> circularRegion(int x, int y, int radius);
+    void circularRegion(int x, int y, int radius, std::vector<Tile*>& tiles);
 
     //! \brief Returns a vector of all the valid tiles which are a neighbor
     //! to one or more tiles in the specified region,
     //! i.e. the "perimeter" of the region extended out one tile.
+    //! Note that it uses the tile marks of this container (see mTileMarks) so it is not reentrant: it must
+    //! not be called from another thread or while another call on the same container is running
     std::vector<Tile*> tilesBorderedByRegion(const std::vector<Tile*> &region);
+    void tilesBorderedByRegion(const std::vector<Tile*> &region, std::vector<Tile*>& tiles);
 
     //! \brief Returns the (up to) 4 nearest neighbor tiles of the tile located at (x, y).
     const std::vector<Tile*>& neighborTiles(int x, int y) const;
@@ -91,11 +101,24 @@ public:
      * http://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm
      * A more detailed description of how it works can be found there.
      */
-    std::list<Tile*> tilesBetween(int x1, int y1, int x2, int y2) const;
+    void tilesBetween(int x1, int y1, int x2, int y2, std::vector<Tile*>& tiles) const;
 
     //! \brief Returns the tiles visible from the given start tile within radius. The tiles are ordered from the closest to
-    //! the furthest
+    //! the furthest. Note that it uses buffers owned by this container (see mVisibleTilesScratch) so it is not
+    //! reentrant: it must not be called from another thread or while another call on the same container is running
     std::vector<Tile*> visibleTiles(int x, int y, int radius);
+    void visibleTiles(int x, int y, int radius, std::vector<Tile*>& tiles);
+
+    //! \brief Should be called when the given tile may have started or stopped blocking vision (dug, door
+    //! locked, ...). It allows callers caching the result of visibleTiles to know if they have to recompute it
+    void notifyTileVisionChanged(const Tile* tile);
+
+    //! \brief Returns the current vision generation. It is incremented each time notifyTileVisionChanged is called
+    inline uint32_t getVisionGeneration() const
+    { return mVisionGeneration; }
+
+    //! \brief Returns true if a tile within radius of (x, y) changed its vision after the given generation
+    bool hasVisionChangedInRange(int x, int y, int radius, uint32_t sinceGeneration) const;
 
 protected:
     //! \brief The map size
@@ -107,17 +130,37 @@ protected:
     //! \brief Set the map size and memory
     bool allocateMapMemory(int xSize, int ySize);
 private:
+    struct VisibleTilesScratch;
+
     Tile*** mTiles;
 
-    //! \brief Fills mTileDistance that will help to compute a vector with sorted Tiles more efficiently
-    void buildTileDistance(int distance);
+    //! \brief Marks used by queries that need to know if a tile has already been processed. A tile is marked
+    //! if its value is mTileMarkGeneration. Incrementing mTileMarkGeneration unmarks every tile without
+    //! going through the whole map
+    std::vector<uint32_t> mTileMarks;
+    uint32_t mTileMarkGeneration;
 
-    //! \brief Helper to compute tile distances more efficiently
-    std::vector<TileDistance> mTileDistance;
+    //! \brief Vision generation at which each tile last changed its vision (see notifyTileVisionChanged).
+    //! Indexed like mTileMarks
+    std::vector<uint32_t> mTileVisionChanges;
+    uint32_t mVisionGeneration;
 
-    //! \brief Stores the highest distance computed. If a bigger distance is asked, mTileDistance will have to be updated by
-    //! calling buildTileDistance with the higher distance
-    int mTileDistanceComputed;
+    //! \brief Buffers reused by visibleTiles. They are overwritten by each call. As a game map is only used by
+    //! one thread (the server or the client one), there is no need to lock them
+    std::unique_ptr<VisibleTilesScratch> mVisibleTilesScratch;
+
+    //! \brief Unmarks every tile (see mTileMarks)
+    void clearTileMarks();
+
+    //! \brief Marks the given tile. Returns false if it was already marked
+    bool markTile(const Tile* tile);
+
+    //! \brief Returns the tile distance table computed at least up to the given radius. The table is shared
+    //! between every TileContainer (see TileDistanceTable)
+    const TileDistanceTable& getTileDistanceTable(int radius);
+
+    //! \brief Helper to compute tile distances more efficiently
+    std::shared_ptr<const TileDistanceTable> mTileDistanceTable;
 };
 
 #endif //TILECONTAINER_H
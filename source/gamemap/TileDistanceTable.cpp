@@ -0,0 +1,386 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/TileDistanceTable.h"
+
+#include "utils/Helper.h"
+#include "utils/LogManager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+void TileDistance::computeTileDistances(double coefNorth, double coefSouth, const TileDistance& tileDistance,
+    uint32_t indexTileDistance)
+{
+    // A tile can only hide tiles behind (x > tile.x and y > tile.y)
+    if(tileDistance.getDiffX() < getDiffX())
+        return;
+    if(tileDistance.getDiffY() < getDiffY())
+        return;
+
+    // We don't want a tile to hide itself
+    if((tileDistance.getDiffX() == getDiffX()) &&
+       (tileDistance.getDiffY() == getDiffY()))
+    {
+        return;
+    }
+
+    if(getType() == TileDistance::TileDistanceType::Horizontal)
+    {
+        // For horizontal tiles, we hide following tiles (x > tile.x). But we process
+        // north tiles normally
+        if(tileDistance.getType() == TileDistance::TileDistanceType::Horizontal)
+        {
+            addHiddenTileSouth(indexTileDistance, 1.0);
+            return;
+        }
+
+        double xTileDeb = static_cast<double>(tileDistance.getDiffX()) - 0.5;
+        double xTileEnd = xTileDeb + 1.0;
+        double yTileDeb = static_cast<double>(tileDistance.getDiffY()) - 0.5;
+        double yTileEnd = yTileDeb + 1.0;
+        double yHideDebNorth = coefNorth * xTileDeb;
+        double yHideEndNorth = coefNorth * xTileEnd;
+
+        // If the tile is over the North ray, it is not hidden
+        if(yHideEndNorth <= yTileDeb)
+            return;
+
+        // We check which part of the tile is hidden
+        if((yHideDebNorth >= yTileDeb) &&
+           (yHideEndNorth <= yTileEnd))
+        {
+            // The ray hits the left side of the tile and the right side.
+            // The south part is partially hidden
+            double hiddenArea = (yHideEndNorth - yHideDebNorth) / 2.0;
+            hiddenArea += yHideDebNorth - yTileDeb;
+            addHiddenTileSouth(indexTileDistance, hiddenArea);
+        }
+        else if((yHideDebNorth < yTileDeb) &&
+                (yHideEndNorth > yTileDeb))
+        {
+            // The ray hits the bottom side of the tile but hits the right side. We compute
+            // the south visible part
+            double xHit = yTileDeb / coefNorth;
+            double hiddenArea = (yHideEndNorth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+            addHiddenTileSouth(indexTileDistance, hiddenArea);
+        }
+        else if((yHideDebNorth < yTileEnd) &&
+                (yHideEndNorth > yTileEnd))
+        {
+            // The ray hits the left side of the tile but is over the right side. We compute
+            // the hidden part on north.
+            double xHit = yTileEnd / coefNorth;
+            double visibleArea = (yTileEnd - yHideDebNorth) * (xHit - xTileDeb) / 2.0;
+            addHiddenTileSouth(indexTileDistance, 1.0 - visibleArea);
+        }
+        else
+        {
+            // The entire tile is hidden
+            addHiddenTileSouth(indexTileDistance, 1.0);
+        }
+
+        return;
+    }
+
+    double xTileDeb = static_cast<double>(tileDistance.getDiffX()) - 0.5;
+    double xTileEnd = xTileDeb + 1.0;
+    double yTileDeb = static_cast<double>(tileDistance.getDiffY()) - 0.5;
+    double yTileEnd = yTileDeb + 1.0;
+
+    // We check if the current tile is hidden by the tile. To consider that the
+    // tile is hidden by the south, as we know the angle will be between 0 and 45 degrees,
+    // we consider that the tile has to be hit by the ray passing through the hiding tile
+    // on the left side of the tile (otherwise, the hidden part will be too small).
+    double yHideDebSouth = coefSouth * xTileDeb;
+    double yHideEndSouth = coefSouth * xTileEnd;
+    double yHideDebNorth = coefNorth * xTileDeb;
+    double yHideEndNorth = coefNorth * xTileEnd;
+    // We check if at least a part of the tile is hidden
+    if((yHideDebSouth < yTileEnd) &&
+       (yHideEndNorth > yTileDeb))
+    {
+        // At least a part of this tile is hidden
+        if((yHideDebSouth >= yTileDeb) &&
+           (yHideEndSouth <= yTileEnd))
+        {
+            // The ray hits the left side of the tile and the right side.
+            // The south part is partially hidden
+            // The visible part is composed from a square between the tile inferior part and
+            // the triangle made by the ray
+            double visibleArea = (yHideEndSouth - yHideDebSouth) / 2.0;
+            visibleArea += yHideDebSouth - yTileDeb;
+            addHiddenTileNorth(indexTileDistance, 1.0 - visibleArea);
+        }
+        else if((yHideDebSouth < yTileDeb) &&
+                (yHideEndSouth > yTileDeb))
+        {
+            // The ray hits the bottom side of the tile but hits the right side. We compute
+            // the south visible part
+            double xHit = yTileDeb / coefSouth;
+            double visibleArea = (yHideEndSouth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+            addHiddenTileNorth(indexTileDistance, 1.0 - visibleArea);
+        }
+        else if((yHideDebSouth < yTileEnd) &&
+                (yHideEndSouth > yTileEnd))
+        {
+            // The ray hits the left side of the tile but is over the right side. We compute
+            // the hidden part on north.
+            double xHit = yTileEnd / coefSouth;
+            double hiddenArea = (yTileEnd - yHideDebSouth) * (xHit - xTileDeb) / 2.0;
+            addHiddenTileNorth(indexTileDistance, hiddenArea);
+
+        }
+        else if((yHideDebNorth >= yTileDeb) &&
+           (yHideEndNorth <= yTileEnd))
+        {
+            double hiddenArea = (yHideEndNorth - yHideDebNorth) / 2.0;
+            hiddenArea += yHideDebNorth - yTileDeb;
+            addHiddenTileSouth(indexTileDistance, hiddenArea);
+        }
+        else if((yHideDebNorth < yTileDeb) &&
+                (yHideEndNorth > yTileDeb))
+        {
+            // The ray hits the bottom side of the tile but hits the right side. We compute
+            // the south visible part
+            double xHit = yTileDeb / coefNorth;
+            double hiddenArea = (yHideEndNorth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+            addHiddenTileSouth(indexTileDistance, hiddenArea);
+        }
+        else if((yHideDebNorth < yTileEnd) &&
+                (yHideEndNorth > yTileEnd))
+        {
+            // The ray hits the left side of the tile but is over the right side. We compute
+            // the hidden part on north.
+            double xHit = yTileEnd / coefNorth;
+            double visibleArea = (yTileEnd - yHideDebNorth) * (xHit - xTileDeb) / 2.0;
+            addHiddenTileSouth(indexTileDistance, 1.0 - visibleArea);
+        }
+        else
+        {
+            // The entire tile is hidden
+            addHiddenTileSouth(indexTileDistance, 1.0);
+        }
+    }
+}
+
+void TileDistance::print(const std::vector<TileDistance>& tileDistance) const
+{
+    std::string log = "TileDistance x=" + Helper::toString(getDiffX())
+        + ", y=" + Helper::toString(getDiffY())
+        + ", squared=" + Helper::toString(getDistSquared());
+    for(const std::pair<uint32_t, double>& p : mHiddenTilesNorth)
+    {
+        const TileDistance& tile = tileDistance[p.first];
+        log += ", TileDistanceNorth x=" + Helper::toString(tile.getDiffX())
+            + ", y=" + Helper::toString(tile.getDiffY())
+            + ", val=" + Helper::toString(p.second);
+    }
+    for(const std::pair<uint32_t, double>& p : mHiddenTilesSouth)
+    {
+        const TileDistance& tile = tileDistance[p.first];
+        log += ", TileDistanceSouth x=" + Helper::toString(tile.getDiffX())
+            + ", y=" + Helper::toString(tile.getDiffY())
+            + ", val=" + Helper::toString(p.second);
+    }
+    for(uint32_t index = 0; index < mHiddenWords.size() * 64; ++index)
+    {
+        if((mHiddenWords[index / 64] & (static_cast<uint64_t>(1) << (index % 64))) == 0)
+            continue;
+
+        const TileDistance& tile = tileDistance[mHiddenFirstWord * 64 + index];
+        log += ", TileDistanceHidden x=" + Helper::toString(tile.getDiffX())
+            + ", y=" + Helper::toString(tile.getDiffY());
+    }
+
+    OD_LOG_INF(log);
+}
+
+void TileDistance::addHiddenTileNorth(uint32_t indexTile, double hiddenPercent)
+{
+    // If more than half of the tile is hidden from one side, it is hidden whatever the other side is
+    if(hiddenPercent > 0.5)
+    {
+        addHiddenTile(indexTile);
+        return;
+    }
+
+    mHiddenTilesNorth.push_back(std::pair<uint32_t, double>(indexTile, hiddenPercent));
+}
+
+void TileDistance::addHiddenTileSouth(uint32_t indexTile, double hiddenPercent)
+{
+    if(hiddenPercent > 0.5)
+    {
+        addHiddenTile(indexTile);
+        return;
+    }
+
+    mHiddenTilesSouth.push_back(std::pair<uint32_t, double>(indexTile, hiddenPercent));
+}
+
+void TileDistance::addHiddenTile(uint32_t indexTile)
+{
+    // While building, mHiddenWords covers every offset. It is trimmed once the table is built
+    mHiddenWords[indexTile / 64] |= static_cast<uint64_t>(1) << (indexTile % 64);
+}
+
+std::shared_ptr<const TileDistanceTable> TileDistanceTable::getTable(int radius)
+{
+    static std::mutex tableMutex;
+    static std::shared_ptr<const TileDistanceTable> table;
+
+    std::lock_guard<std::mutex> lock(tableMutex);
+    if((table != nullptr) && (table->getRadius() >= radius))
+        return table;
+
+    // The previous table is kept alive by the containers still using it
+    int newRadius = radius;
+    if((table != nullptr) && (table->getRadius() > newRadius))
+        newRadius = table->getRadius();
+
+    TileDistanceTable* newTable = new TileDistanceTable(newRadius);
+    newTable->build();
+    table = std::shared_ptr<const TileDistanceTable>(newTable);
+    return table;
+}
+
+TileDistanceTable::TileDistanceTable(int radius) :
+    mRadius(std::max(radius, 0))
+{
+}
+
+void TileDistanceTable::build()
+{
+    int distance = mRadius;
+    // We want to be able to fill a vector of tiles sorted beginning with the closest tile. If we look a grid (each letter
+    // represents a tile at the same distance from the center: a):
+    // jihghij
+    // ifedefi
+    // hecbceh
+    // gdbabdg
+    // hecbceh
+    // ifedefi
+    // jihghij
+    // We can see that there are 3 kind of tiles:
+    // - Vertical/Horizontal tiles (abdg): at each distance, there are 4 of them
+    // - Diagonal tiles (acfj): at each distance, there are 4 of them
+    // - Other tiles (ehi...): at each distance, there are 8 of them
+    // Moreover, we can see a symmetry. We can compute all tiles by computing only 1/8 tiles:
+    //    j
+    //   fi
+    //  ceh
+    // abdg
+
+    // If we compute only the minimum tiles needed, we have no vertical tiles (since each of them can be deduced from the horizontal)
+    // To compute tiles easily, we will compute the 1/8 tiles until distance. Then, we will sort the tiles to begin with
+    // closest distance until farthest
+    mTileDistances.clear();
+    for(int y = 0; y <= distance; ++y)
+    {
+        for(int x = y; x <= distance; ++x)
+        {
+            TileDistance::TileDistanceType type;
+            if(y == 0)
+            {
+                type = TileDistance::TileDistanceType::Horizontal;
+            }
+            else if(x == y)
+            {
+                type = TileDistance::TileDistanceType::Diagonal;
+            }
+            else
+            {
+                type = TileDistance::TileDistanceType::Other;
+            }
+            int distSquared = x * x + y * y;
+            mTileDistances.push_back(TileDistance(x, y, type, distSquared));
+        }
+    }
+
+    std::sort(mTileDistances.begin(), mTileDistances.end(),
+        [](const TileDistance& tileDist1, const TileDistance& tileDist2)
+        {
+            return tileDist1.getDistSquared() < tileDist2.getDistSquared();
+        });
+
+    // Index of each offset in the sorted vector
+    uint32_t gridSize = static_cast<uint32_t>(distance + 1);
+    std::vector<uint32_t> indexes(gridSize * gridSize, 0);
+    for(uint32_t index = 0; index < mTileDistances.size(); ++index)
+    {
+        const TileDistance& tileDistance = mTileDistances[index];
+        indexes[tileDistance.getDiffX() + tileDistance.getDiffY() * gridSize] = index;
+    }
+
+    // We have filled the tile distance vector. Now, we fill how each tile hides the
+    // other ones when they mask vision to help calculate visible tiles
+    uint32_t nbWords = getNbWords();
+    for(TileDistance& tileDistance : mTileDistances)
+    {
+        // We don't process the first tile
+        if(tileDistance.getDiffX() == 0 && tileDistance.getDiffY() == 0)
+            continue;
+
+        // Other tiles can hide with their down side and their up side other tiles
+        // or diagonal tiles (but not Horizontal tiles)
+        // We compute the tiles hidden from the south. In this case, only tiles with
+        // x > tile.x can be hidden
+        double coefNorth = (static_cast<double>(tileDistance.getDiffY()) + 0.5) / (static_cast<double>(tileDistance.getDiffX()) - 0.5);
+        double coefSouth = (static_cast<double>(tileDistance.getDiffY()) - 0.5) / (static_cast<double>(tileDistance.getDiffX()) + 0.5);
+        tileDistance.mHiddenWords.assign(nbWords, 0);
+
+        // A tile can only hide tiles within the shadow between its north and south rays. We only check the tiles
+        // in this shadow (with a margin of 1 tile) instead of every tile. computeTileDistances checks
+        // precisely if they are hidden
+        for(int x = tileDistance.getDiffX(); x <= distance; ++x)
+        {
+            int yMin = tileDistance.getDiffY();
+            if(tileDistance.getType() != TileDistance::TileDistanceType::Horizontal)
+            {
+                double yShadowMin = std::floor(coefSouth * (static_cast<double>(x) - 0.5) - 0.5) - 1.0;
+                yMin = std::max(yMin, static_cast<int>(std::max(yShadowMin, 0.0)));
+            }
+            double yShadowMax = std::ceil(coefNorth * (static_cast<double>(x) + 0.5) + 0.5) + 1.0;
+            int yMax = static_cast<int>(std::min(yShadowMax, static_cast<double>(x)));
+            for(int y = yMin; y <= yMax; ++y)
+            {
+                uint32_t index = indexes[x + y * gridSize];
+                tileDistance.computeTileDistances(coefNorth, coefSouth, mTileDistances[index], index);
+            }
+        }
+
+        // Partially hidden tiles are processed in the same order as the table
+        std::sort(tileDistance.mHiddenTilesNorth.begin(), tileDistance.mHiddenTilesNorth.end());
+        std::sort(tileDistance.mHiddenTilesSouth.begin(), tileDistance.mHiddenTilesSouth.end());
+
+        // We only keep the words between the first and the last hidden tiles
+        std::vector<uint64_t>& words = tileDistance.mHiddenWords;
+        uint32_t firstWord = 0;
+        while((firstWord < words.size()) && (words[firstWord] == 0))
+            ++firstWord;
+        uint32_t endWord = static_cast<uint32_t>(words.size());
+        while((endWord > firstWord) && (words[endWord - 1] == 0))
+            --endWord;
+
+        tileDistance.mHiddenFirstWord = firstWord;
+        words.erase(words.begin() + endWord, words.end());
+        words.erase(words.begin(), words.begin() + firstWord);
+        words.shrink_to_fit();
+    }
+}
@@ -0,0 +1,129 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEDISTANCETABLE_H
+#define TILEDISTANCETABLE_H
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+//! \brief Offset from a center tile used to compute the tiles within a radius. Only 1/8 of the offsets
+//! around a tile are stored (0 <= diffY <= diffX), the other ones are deduced by symmetry (see
+//! TileDistanceTable::build). Each offset also knows which other offsets it hides when it blocks vision.
+class TileDistance
+{
+    friend class TileDistanceTable;
+public:
+    enum TileDistanceType
+    {
+        Horizontal,
+        Diagonal,
+        Other
+    };
+
+    TileDistance(int diffX, int diffY, TileDistanceType type, int distSquared):
+        mDiffX(diffX),
+        mDiffY(diffY),
+        mType(type),
+        mDistSquared(distSquared),
+        mHiddenFirstWord(0)
+    {
+    }
+
+    inline int getDiffX() const
+    { return mDiffX; }
+
+    inline int getDiffY() const
+    { return mDiffY; }
+
+    inline TileDistanceType getType() const
+    { return mType; }
+
+    inline int getDistSquared() const
+    { return mDistSquared; }
+
+    //! \brief Offsets hidden by this one by more than half of their surface. Such offsets cannot be
+    //! visible whatever the other blocking tiles are. The bitset is indexed like the table offsets and
+    //! only stores the words from getHiddenFirstWord() (the words before are always empty)
+    inline uint32_t getHiddenFirstWord() const
+    { return mHiddenFirstWord; }
+
+    inline const std::vector<uint64_t>& getHiddenWords() const
+    { return mHiddenWords; }
+
+    //! \brief Offsets partially hidden by this one (by at most half of their surface). The visibility of those
+    //! depends on the other tiles hiding them from the other side
+    inline const std::vector<std::pair<uint32_t, double>>& getHiddenTilesNorth() const
+    { return mHiddenTilesNorth; }
+
+    inline const std::vector<std::pair<uint32_t, double>>& getHiddenTilesSouth() const
+    { return mHiddenTilesSouth; }
+
+    void print(const std::vector<TileDistance>& tileDistance) const;
+
+private:
+    //! \brief Computes how this tile hides the given one when it blocks vision
+    void computeTileDistances(double coefNorth, double coefSouth, const TileDistance& tileDistance,
+        uint32_t indexTileDistance);
+
+    void addHiddenTileNorth(uint32_t indexTile, double hiddenPercent);
+    void addHiddenTileSouth(uint32_t indexTile, double hiddenPercent);
+    void addHiddenTile(uint32_t indexTile);
+
+    int mDiffX;
+    int mDiffY;
+    TileDistanceType mType;
+    int mDistSquared;
+    uint32_t mHiddenFirstWord;
+    std::vector<uint64_t> mHiddenWords;
+    std::vector<std::pair<uint32_t, double>> mHiddenTilesNorth;
+    std::vector<std::pair<uint32_t, double>> mHiddenTilesSouth;
+};
+
+//! \brief Immutable table of the TileDistance offsets sorted from the closest to the farthest up to a given radius.
+//! Computing a table is expensive so they are shared between every TileContainer and every thread: getTable returns
+//! the biggest table built so far if it is big enough. ConfigManager builds the table for the biggest radius used in
+//! the config at startup so that it does not have to be done while a game is running.
+class TileDistanceTable
+{
+public:
+    //! \brief Returns a table computed at least up to the given radius. A bigger table is built if needed.
+    //! Thread safe
+    static std::shared_ptr<const TileDistanceTable> getTable(int radius);
+
+    inline int getRadius() const
+    { return mRadius; }
+
+    //! \brief Number of 64 bits words needed to store a bitset of the offsets
+    inline uint32_t getNbWords() const
+    { return static_cast<uint32_t>((mTileDistances.size() + 63) / 64); }
+
+    inline const std::vector<TileDistance>& getTileDistances() const
+    { return mTileDistances; }
+
+private:
+    TileDistanceTable(int radius);
+
+    void build();
+
+    int mRadius;
+    std::vector<TileDistance> mTileDistances;
+};
+
+#endif // TILEDISTANCETABLE_H
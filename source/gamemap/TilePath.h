@@ -0,0 +1,133 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEPATH_H
+#define TILEPATH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Tile;
+
+//! \brief Path of tiles computed by the pathfinding, from the start tile to the destination.
+//! The tiles are stored contiguously (one allocation per path instead of one per tile) and
+//! the path is meant to be moved to where it is used, not copied. Use MovableGameEntity::setWalkPath
+//! to make an entity walk along a TilePath.
+//! The tiles can be shared between several paths (see share). In this case, they are copied
+//! before being modified
+class TilePath
+{
+public:
+    typedef std::vector<Tile*>::const_iterator const_iterator;
+
+    TilePath()
+    {}
+
+    TilePath(TilePath&& path) :
+        mTiles(std::move(path.mTiles))
+    {}
+
+    TilePath& operator=(TilePath&& path)
+    {
+        mTiles = std::move(path.mTiles);
+        return *this;
+    }
+
+    TilePath(const TilePath&) = delete;
+    TilePath& operator=(const TilePath&) = delete;
+
+    //! \brief Returns a path sharing the tiles of this one. The tiles are not copied. Used by the path
+    //! cache to give the cached paths without copying them
+    inline TilePath share() const
+    {
+        TilePath path;
+        path.mTiles = mTiles;
+        return path;
+    }
+
+    inline bool empty() const
+    { return getTiles().empty(); }
+
+    inline uint32_t size() const
+    { return static_cast<uint32_t>(getTiles().size()); }
+
+    inline Tile* front() const
+    { return getTiles().front(); }
+
+    inline Tile* back() const
+    { return getTiles().back(); }
+
+    inline Tile* at(uint32_t index) const
+    { return getTiles().at(index); }
+
+    inline const_iterator begin() const
+    { return getTiles().begin(); }
+
+    inline const_iterator end() const
+    { return getTiles().end(); }
+
+    inline void pushBack(Tile* tile)
+    { getTilesToModify().push_back(tile); }
+
+    //! \brief Reverses the path. Used to build paths from the destination to the start
+    inline void reverse()
+    {
+        if(empty())
+            return;
+
+        std::vector<Tile*>& tiles = getTilesToModify();
+        std::reverse(tiles.begin(), tiles.end());
+    }
+
+    //! \brief Keeps only the first nbTiles tiles of the path. Does nothing if the path is shorter
+    inline void truncate(uint32_t nbTiles)
+    {
+        if(nbTiles < size())
+            getTilesToModify().resize(nbTiles);
+    }
+
+    inline void clear()
+    { mTiles.reset(); }
+
+    inline const std::vector<Tile*>& getTiles() const
+    {
+        static const std::vector<Tile*> noTiles;
+        if(mTiles == nullptr)
+            return noTiles;
+
+        return *mTiles;
+    }
+
+private:
+    //! \brief The tiles. nullptr if the path is empty
+    std::shared_ptr<std::vector<Tile*>> mTiles;
+
+    //! \brief Returns the tiles to be modified. If they are shared with other paths, they are copied first
+    inline std::vector<Tile*>& getTilesToModify()
+    {
+        if(mTiles == nullptr)
+            mTiles = std::make_shared<std::vector<Tile*>>();
+        else if(mTiles.use_count() > 1)
+            mTiles = std::make_shared<std::vector<Tile*>>(*mTiles);
+
+        return *mTiles;
+    }
+};
+
+#endif // TILEPATH_H
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VISIONPLANE_H
+#define VISIONPLANE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//! \brief Packed bitset telling which tiles of the gamemap a seat has vision on. The tiles are stored
+//! X first (bit index = x * mapSizeY + y) in 64 bits words so that clearing, sharing vision between
+//! allied seats and computing the changes with the previous turn are done word by word. Iterating
+//! over the tiles goes through them in the same order as a loop over x then y would
+class VisionPlane
+{
+public:
+    VisionPlane() :
+        mMapSizeX(0),
+        mMapSizeY(0)
+    {}
+
+    inline int getMapSizeX() const
+    { return mMapSizeX; }
+
+    inline int getMapSizeY() const
+    { return mMapSizeY; }
+
+    //! \brief Sets the plane size. Every tile is cleared
+    void resize(int mapSizeX, int mapSizeY)
+    {
+        mMapSizeX = mapSizeX;
+        mMapSizeY = mapSizeY;
+        uint32_t nbBits = static_cast<uint32_t>(mapSizeX * mapSizeY);
+        mWords.assign((nbBits + 63) / 64, 0);
+    }
+
+    inline bool isInside(int x, int y) const
+    { return (x >= 0) && (y >= 0) && (x < mMapSizeX) && (y < mMapSizeY); }
+
+    inline void clear()
+    { std::fill(mWords.begin(), mWords.end(), 0); }
+
+    //! \brief The tile must be inside the plane (see isInside)
+    inline void set(int x, int y)
+    {
+        uint32_t index = getIndex(x, y);
+        mWords[index / 64] |= (static_cast<uint64_t>(1) << (index % 64));
+    }
+
+    //! \brief Returns false if the tile is not inside the plane
+    inline bool test(int x, int y) const
+    {
+        if(!isInside(x, y))
+            return false;
+
+        uint32_t index = getIndex(x, y);
+        return (mWords[index / 64] & (static_cast<uint64_t>(1) << (index % 64))) != 0;
+    }
+
+    inline void swap(VisionPlane& other)
+    {
+        std::swap(mMapSizeX, other.mMapSizeX);
+        std::swap(mMapSizeY, other.mMapSizeY);
+        mWords.swap(other.mWords);
+    }
+
+    //! \brief Calls func(x, y) for every tile set
+    template<typename Func>
+    void forEachTile(Func func) const
+    {
+        for(uint32_t i = 0; i < mWords.size(); ++i)
+            forEachBit(i, mWords[i], func);
+    }
+
+    //! \brief Calls func(x, y) for every tile that is set in only one of this plane and the given one.
+    //! Both planes must have the same size. The caller can use test to know in which one it is
+    template<typename Func>
+    void forEachDifference(const VisionPlane& other, Func func) const
+    {
+        if(other.mWords.size() != mWords.size())
+            return;
+
+        for(uint32_t i = 0; i < mWords.size(); ++i)
+            forEachBit(i, mWords[i] ^ other.mWords[i], func);
+    }
+
+private:
+    int mMapSizeX;
+    int mMapSizeY;
+    std::vector<uint64_t> mWords;
+
+    inline uint32_t getIndex(int x, int y) const
+    { return static_cast<uint32_t>(x * mMapSizeY + y); }
+
+    //! \brief Returns the index of the lowest bit set. word must not be 0
+    static inline uint32_t countTrailingZeros(uint64_t word)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(word));
+#endif
+    }
+
+    template<typename Func>
+    inline void forEachBit(uint32_t wordIndex, uint64_t word, Func& func) const
+    {
+        while(word != 0)
+        {
+            uint32_t index = wordIndex * 64 + countTrailingZeros(word);
+            func(static_cast<int>(index) / mMapSizeY, static_cast<int>(index) % mMapSizeY);
+            // Clears the lowest bit set
+            word &= word - 1;
+        }
+    }
+};
+
+#endif // VISIONPLANE_H
@@ -19,6 +19,13 @@
 
 #include "utils/LogManager.h"
 
+const uint32_t Goal::DEPENDENCY_CLAIMED_TILES = 0x01;
+const uint32_t Goal::DEPENDENCY_GOLD_MINED = 0x02;
+const uint32_t Goal::DEPENDENCY_CREATURES = 0x04;
+const uint32_t Goal::DEPENDENCY_ROOMS = 0x08;
+const uint32_t Goal::DEPENDENCY_TURN = 0x10;
+const uint32_t Goal::DEPENDENCY_ALL = 0xFFFFFFFF;
+
 Goal::Goal(const std::string& nName, const std::string& nArguments) :
     mName(nName),
     mArguments(nArguments)
@@ -26,6 +33,11 @@ Goal::Goal(const std::string& nName, const std::string& nArguments) :
     OD_LOG_INF("Adding goal " + mName);
 }
 
+uint32_t Goal::getDependencies() const
+{
+    return DEPENDENCY_TURN;
+}
+
 void Goal::doSuccessAction()
 {
 }
@@ -18,6 +18,7 @@
 #ifndef GOAL_H
 #define GOAL_H
 
+#include <cstdint>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -40,6 +41,9 @@ public:
     virtual std::string getFailedMessage(const Seat&) = 0;
 
     // Functions which can be overridden (but do not have to be) by child classes
+    //! \brief Returns the DEPENDENCY_* flags of the game states this goal depends on. The seats only check
+    //! a goal when one of them has changed. By default, goals are checked every turn
+    virtual uint32_t getDependencies() const;
     virtual void doSuccessAction();
     virtual bool isVisible();
     virtual bool isUnmet(const Seat& s, const GameMap& gameMap);
@@ -58,6 +62,16 @@ public:
     Goal* getFailureSubGoal(int index);
 
     static std::string getFormat();
+
+    //! \brief Game states the goals can depend on (see getDependencies). They are notified to the
+    //! seats when they change (see Seat::notifyGoalDependencyChanged)
+    static const uint32_t DEPENDENCY_CLAIMED_TILES;
+    static const uint32_t DEPENDENCY_GOLD_MINED;
+    static const uint32_t DEPENDENCY_CREATURES;
+    static const uint32_t DEPENDENCY_ROOMS;
+    //! \brief Notified every turn. Used by the goals depending on states that are not notified
+    static const uint32_t DEPENDENCY_TURN;
+    static const uint32_t DEPENDENCY_ALL;
     friend std::ostream& operator<<(std::ostream& os, Goal& g);
 
 protected:
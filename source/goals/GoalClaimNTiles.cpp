@@ -35,6 +35,11 @@ bool GoalClaimNTiles::isMet(const Seat &s, const GameMap&)
     return (s.getNumClaimedTiles() >= mNumberOfTiles);
 }
 
+uint32_t GoalClaimNTiles::getDependencies() const
+{
+    return DEPENDENCY_CLAIMED_TILES;
+}
+
 std::string GoalClaimNTiles::getSuccessMessage(const Seat&)
 {
     std::stringstream tempSS;
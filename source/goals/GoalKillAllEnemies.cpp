@@ -59,6 +59,11 @@ bool GoalKillAllEnemies::isMet(const Seat &s, const GameMap& gameMap)
     return true;
 }
 
+uint32_t GoalKillAllEnemies::getDependencies() const
+{
+    return DEPENDENCY_CREATURES | DEPENDENCY_ROOMS;
+}
+
 std::string GoalKillAllEnemies::getSuccessMessage(const Seat&)
 {
     return "You have killed all the enemy creatures,\ntemples and portals.";
@@ -34,6 +34,11 @@ bool GoalMineNGold::isMet(const Seat &s, const GameMap&)
     return (s.getGoldMined() >= mGoldToMine);
 }
 
+uint32_t GoalMineNGold::getDependencies() const
+{
+    return DEPENDENCY_GOLD_MINED;
+}
+
 std::string GoalMineNGold::getDescription(const Seat &s)
 {
     std::stringstream tempSS;
@@ -38,6 +38,11 @@ bool GoalProtectCreature::isMet(const Seat&, const GameMap& gameMap)
     return false;
 }
 
+uint32_t GoalProtectCreature::getDependencies() const
+{
+    return DEPENDENCY_CREATURES;
+}
+
 std::string GoalProtectCreature::getSuccessMessage(const Seat&)
 {
     return mCreatureName + " is still alive";
@@ -29,6 +29,7 @@ public:
 
     // Inherited functions
     bool isMet(const Seat&, const GameMap&);
+    uint32_t getDependencies() const;
     std::string getDescription(const Seat&);
     std::string getSuccessMessage(const Seat&);
     std::string getFailedMessage(const Seat&);
@@ -34,6 +34,11 @@ bool GoalProtectDungeonTemple::isMet(const Seat& s, const GameMap& gameMap)
     return (gameMap.numRoomsByTypeAndSeat(RoomType::dungeonTemple, &s) > 0);
 }
 
+uint32_t GoalProtectDungeonTemple::getDependencies() const
+{
+    return DEPENDENCY_ROOMS;
+}
+
 bool GoalProtectDungeonTemple::isUnmet(const Seat&, const GameMap&)
 {
     return false;
@@ -30,6 +30,7 @@ public:
 
     // Inherited functions
     bool isMet(const Seat& s, const GameMap& gameMap);
+    uint32_t getDependencies() const;
     bool isUnmet(const Seat&, const GameMap& gameMap);
     bool isFailed(const Seat&, const GameMap& gameMap);
     std::string getDescription(const Seat&);
@@ -56,7 +56,9 @@ const std::string HELPMESSAGE =
         "\n\tcatmullspline - Triggers the catmullspline camera movement type."
         "\n\tcirclearound - Triggers the circle camera movement type."
         "\n\tsetcamerafovy - Sets the camera vertical field of view aspect ratio value."
-        "\n\tlogfloodfill - Displays the FloodFillValues of all the Tiles in the GameMap.";
+        "\n\tlogfloodfill - Displays the FloodFillValues of all the Tiles in the GameMap."
+        "\n\tlogpathcache - Logs the path cache stats of the server GameMap."
+        "\n\tlogmapstats - Logs the claimed tiles and creatures of each seat.";
 
 //! \brief Template function to get/set a variable from the ODFrameListener object
 template<typename ValType, typename Getter, typename Setter>
@@ -418,6 +420,18 @@ Command::Result cSrvLogFloodFill(const Command::ArgumentList_t&, ConsoleInterfac
     return Command::Result::SUCCESS;
 }
 
+Command::Result cSrvLogPathCache(const Command::ArgumentList_t&, ConsoleInterface& c, GameMap& gameMap)
+{
+    gameMap.logPathCacheStats();
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cSrvLogMapStats(const Command::ArgumentList_t&, ConsoleInterface& c, GameMap& gameMap)
+{
+    gameMap.logMapStats();
+    return Command::Result::SUCCESS;
+}
+
 Command::Result cSetCameraFOVy(const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager&)
 {
     Ogre::Camera* cam = ODFrameListener::getSingleton().getCameraManager()->getActiveCamera();
@@ -637,6 +651,18 @@ void addConsoleCommands(ConsoleInterface& cl)
                    cSrvLogFloodFill,
                    {AbstractModeManager::ModeType::GAME},
                    {});
+    cl.addCommand("logpathcache",
+                   "'logpathcache' logs the path cache stats (hits, misses, evictions, ...) and the batched path request stats of the server GameMap.",
+                   cSendCmdToServer,
+                   cSrvLogPathCache,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
+    cl.addCommand("logmapstats",
+                   "'logmapstats' logs the claimed tiles and creatures of each seat and the remaining gold tiles. They are read from the last map snapshot published by the server.",
+                   cSendCmdToServer,
+                   cSrvLogMapStats,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
     cl.addCommand("listmeshanims",
                    "'listmeshanims' lists all the animations for the given mesh.",
                    cListMeshAnims,
@@ -62,7 +62,10 @@ enum class ClientNotificationType
     editorAskDestroyTrapTiles,
     editorCreateWorker,
     editorCreateFighter,
-    editorAskCreateMapLight
+    editorAskCreateMapLight,
+
+    // Added after the other types to keep their values
+    cameraViewChanged
 };
 
 ODPacket& operator<<(ODPacket& os, const ClientNotificationType& nt);
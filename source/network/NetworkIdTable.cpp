@@ -0,0 +1,151 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/NetworkIdTable.h"
+
+#include "network/ODPacket.h"
+
+#include <initializer_list>
+
+const uint32_t NetworkIdTable::NoName = 0xFFFFFFFF;
+const uint32_t NetworkIdTable::NotInTable = 0xFFFFFFFE;
+const uint32_t NetworkIdTable::DefaultWorkerClassId = 0xFFFFFFFD;
+
+void NetworkIdTable::clear()
+{
+    for(Names& names : mCategories)
+    {
+        names.mNames.clear();
+        names.mIds.clear();
+    }
+}
+
+void NetworkIdTable::clear(NetworkIdCategory category)
+{
+    Names& names = getNames(category);
+    names.mNames.clear();
+    names.mIds.clear();
+}
+
+uint32_t NetworkIdTable::addName(NetworkIdCategory category, const std::string& name)
+{
+    Names& names = getNames(category);
+    uint32_t id = static_cast<uint32_t>(names.mNames.size());
+    names.mNames.push_back(name);
+    names.mIds.emplace(name, id);
+    return id;
+}
+
+uint32_t NetworkIdTable::addNameIfMissing(NetworkIdCategory category, const std::string& name)
+{
+    uint32_t id = getId(category, name);
+    if(id != NotInTable)
+        return id;
+
+    return addName(category, name);
+}
+
+uint32_t NetworkIdTable::getId(NetworkIdCategory category, const std::string& name) const
+{
+    if(name.empty())
+        return NoName;
+
+    const Names& names = getNames(category);
+    auto it = names.mIds.find(name);
+    if(it == names.mIds.end())
+        return NotInTable;
+
+    return it->second;
+}
+
+const std::string* NetworkIdTable::getName(NetworkIdCategory category, uint32_t id) const
+{
+    const Names& names = getNames(category);
+    if(id >= names.mNames.size())
+        return nullptr;
+
+    return &names.mNames[id];
+}
+
+void NetworkIdTable::writeName(ODPacket& os, NetworkIdCategory category, const std::string& name) const
+{
+    writeId(os, getId(category, name), name);
+}
+
+void NetworkIdTable::writeId(ODPacket& os, uint32_t id, const std::string& name)
+{
+    os << id;
+    if(id == NotInTable)
+        os << name;
+}
+
+bool NetworkIdTable::readName(ODPacket& is, NetworkIdCategory category, std::string& name) const
+{
+    uint32_t id;
+    if(!(is >> id))
+        return false;
+
+    if(id == NoName)
+    {
+        name.clear();
+        return true;
+    }
+
+    if(id == NotInTable)
+        return static_cast<bool>(is >> name);
+
+    const std::string* tableName = getName(category, id);
+    if(tableName == nullptr)
+        return false;
+
+    name = *tableName;
+    return true;
+}
+
+void NetworkIdTable::exportToPacket(ODPacket& os) const
+{
+    for(NetworkIdCategory category : {NetworkIdCategory::mesh, NetworkIdCategory::animation})
+    {
+        const Names& names = getNames(category);
+        uint32_t nb = names.mNames.size();
+        os << nb;
+        for(const std::string& name : names.mNames)
+            os << name;
+    }
+}
+
+bool NetworkIdTable::importFromPacket(ODPacket& is)
+{
+    for(NetworkIdCategory category : {NetworkIdCategory::mesh, NetworkIdCategory::animation})
+    {
+        clear(category);
+        uint32_t nb;
+        if(!(is >> nb))
+            return false;
+
+        std::string name;
+        while(nb > 0)
+        {
+            --nb;
+            if(!(is >> name))
+                return false;
+
+            addName(category, name);
+        }
+    }
+    return true;
+}
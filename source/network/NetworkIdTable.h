@@ -0,0 +1,105 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NETWORKIDTABLE_H
+#define NETWORKIDTABLE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ODPacket;
+
+enum class NetworkIdCategory
+{
+    creatureClass,
+    weapon,
+    mesh,
+    animation,
+    nbCategories
+};
+
+//! \brief Ids of the names sent in network packets (creature classes, weapons, meshes and animations) so that
+//! packets carry a 32 bits id instead of the name and the client finds the name (or the definition) by index.
+//! Creature class and weapon ids are the indexes of the definitions in the game map. They are added by
+//! GameMap::addClassDescription and GameMap::addWeapon on both server and client, as the definitions are sent
+//! in this order when the client connects. Mesh and animation names are registered by the server when the
+//! level is loaded and sent to the clients with the loadLevel packet (see exportToPacket).
+//! Meshes and animations are open sets (rooms, traps and scripts can use any name). A name that is not in
+//! the table is sent as NotInTable followed by the name.
+class NetworkIdTable
+{
+public:
+    //! \brief Reserved ids. Valid ids are lower than the smallest of them
+    static const uint32_t NoName;
+    static const uint32_t NotInTable;
+    //! \brief Id of the default worker creature class (ConfigManager::DefaultWorkerCreatureDefinition). This
+    //! definition is not in the game map definitions and each side picks the worker of the creature seat
+    static const uint32_t DefaultWorkerClassId;
+
+    NetworkIdTable()
+    {}
+
+    void clear();
+    void clear(NetworkIdCategory category);
+
+    //! \brief Appends the name to the given category and returns its id (the number of names already in
+    //! the category). If the name is already in the table, looking it up keeps returning the first id.
+    uint32_t addName(NetworkIdCategory category, const std::string& name);
+
+    //! \brief Adds the name if it is not in the category yet. Returns its id (NoName if the name is empty)
+    uint32_t addNameIfMissing(NetworkIdCategory category, const std::string& name);
+
+    //! \brief Returns the id of the given name, NoName if empty or NotInTable if unknown
+    uint32_t getId(NetworkIdCategory category, const std::string& name) const;
+
+    //! \brief Returns the name with the given id or nullptr if the id is not valid
+    const std::string* getName(NetworkIdCategory category, uint32_t id) const;
+
+    //! \brief Writes the id of the given name, followed by the name if it is not in the table
+    void writeName(ODPacket& os, NetworkIdCategory category, const std::string& name) const;
+
+    //! \brief Same as writeName with an id already got from getId. Used when the same name is sent
+    //! to several players
+    static void writeId(ODPacket& os, uint32_t id, const std::string& name);
+
+    //! \brief Reads a name written by writeName. Returns false if the packet is not valid
+    bool readName(ODPacket& is, NetworkIdCategory category, std::string& name) const;
+
+    //! \brief Mesh and animation names. Creature class and weapon ids come from the definitions sent
+    //! with the level
+    void exportToPacket(ODPacket& os) const;
+    bool importFromPacket(ODPacket& is);
+
+private:
+    struct Names
+    {
+        std::vector<std::string> mNames;
+        std::unordered_map<std::string, uint32_t> mIds;
+    };
+
+    Names mCategories[static_cast<uint32_t>(NetworkIdCategory::nbCategories)];
+
+    inline Names& getNames(NetworkIdCategory category)
+    { return mCategories[static_cast<uint32_t>(category)]; }
+
+    inline const Names& getNames(NetworkIdCategory category) const
+    { return mCategories[static_cast<uint32_t>(category)]; }
+};
+
+#endif // NETWORKIDTABLE_H
@@ -49,13 +49,27 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <string>
 
 template<> ODClient* Ogre::Singleton<ODClient>::msSingleton = nullptr;
 
+//! \brief Smallest half size (in tiles) of the camera view sent to the server
+const int32_t CAMERA_VIEW_MIN_RADIUS = 5;
+//! \brief Biggest half size (in tiles) of the camera view sent to the server. When the camera looks at the
+//! horizon, the seen floor is not bounded and we use this one
+const int32_t CAMERA_VIEW_MAX_RADIUS = 40;
+//! \brief The camera view is sent again when it moved or changed size by this number of tiles
+const int32_t CAMERA_VIEW_MIN_CHANGE = 2;
+
 ODClient::ODClient() :
     ODSocketClient(),
-    mIsPlayerConfig(false)
+    mIsPlayerConfig(false),
+    mCameraViewX(0),
+    mCameraViewY(0),
+    mCameraViewRadius(-1)
 {
 }
 
@@ -112,6 +126,8 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
             gameMap->setTileSetName(str);
 
+            OD_ASSERT_TRUE(gameMap->getNetworkIdTable().importFromPacket(packetReceived));
+
             int32_t nb;
             // Seats
             OD_ASSERT_TRUE(packetReceived >> nb);
@@ -479,8 +495,12 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
             bool loopEndAnim;
             bool playIdleWhenAnimationEnds;
             uint32_t nbDest;
-            OD_ASSERT_TRUE(packetReceived >> objName >> walkAnim >> endAnim);
-            OD_ASSERT_TRUE(packetReceived >> loopEndAnim >> playIdleWhenAnimationEnds >> nbDest);
+            const NetworkIdTable& networkIdTable = gameMap->getNetworkIdTable();
+            OD_ASSERT_TRUE(packetReceived >> objName);
+            OD_ASSERT_TRUE(networkIdTable.readName(packetReceived, NetworkIdCategory::animation, walkAnim));
+            OD_ASSERT_TRUE(networkIdTable.readName(packetReceived, NetworkIdCategory::animation, endAnim));
+            OD_ASSERT_TRUE(packetReceived >> loopEndAnim >> playIdleWhenAnimationEnds);
+            OD_ASSERT_TRUE(packetReceived >> nbDest);
 
             MovableGameEntity *tempAnimatedObject = gameMap->getAnimatedObject(objName);
             if(tempAnimatedObject == nullptr)
@@ -498,7 +518,7 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
                 tempAnimatedObject->correctEntityMovePosition(dest);
                 path.push_back(dest);
             }
-            tempAnimatedObject->setWalkPath(walkAnim, endAnim, loopEndAnim, playIdleWhenAnimationEnds, path);
+            tempAnimatedObject->setWalkPathFromServer(walkAnim, endAnim, loopEndAnim, playIdleWhenAnimationEnds, path);
             break;
         }
 
@@ -557,8 +577,10 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
             bool loop;
             bool playIdleWhenAnimationEnds;
             bool shouldSetWalkDirection;
-            OD_ASSERT_TRUE(packetReceived >> objName >> animState
-                >> loop >> playIdleWhenAnimationEnds >> shouldSetWalkDirection);
+            const NetworkIdTable& networkIdTable = gameMap->getNetworkIdTable();
+            OD_ASSERT_TRUE(packetReceived >> objName);
+            OD_ASSERT_TRUE(networkIdTable.readName(packetReceived, NetworkIdCategory::animation, animState));
+            OD_ASSERT_TRUE(packetReceived >> loop >> playIdleWhenAnimationEnds >> shouldSetWalkDirection);
             MovableGameEntity *obj = gameMap->getAnimatedObject(objName);
             if (obj == nullptr)
             {
@@ -579,11 +601,17 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
         case ServerNotificationType::refreshPlayerSeat:
         {
+            bool goalsChanged;
             std::string goalsString;
             OD_ASSERT_TRUE(getPlayer()->getSeat()->importFromPacketForUpdate(packetReceived));
-            OD_ASSERT_TRUE(packetReceived >> goalsString);
+            OD_ASSERT_TRUE(packetReceived >> goalsChanged);
+            // The goals string is only sent when it changes
+            if(goalsChanged)
+            {
+                OD_ASSERT_TRUE(packetReceived >> goalsString);
+            }
 
-            refreshMainUI(goalsString);
+            refreshMainUI(goalsChanged, goalsString);
             break;
         }
 
@@ -1004,13 +1032,14 @@ void ODClient::addEventMessage(EventMessage* event)
     }
 }
 
-void ODClient::refreshMainUI(const std::string& goalsString)
+void ODClient::refreshMainUI(bool refreshGoals, const std::string& goalsString)
 {
     ODFrameListener* frameListener = ODFrameListener::getSingletonPtr();
     if (frameListener->getModeManager()->getCurrentModeType() == AbstractModeManager::GAME)
     {
         GameMode* gm = static_cast<GameMode*>(frameListener->getModeManager()->getCurrentMode());
-        gm->refreshPlayerGoals(goalsString);
+        if(refreshGoals)
+            gm->refreshPlayerGoals(goalsString);
         gm->refreshMainUI();
     }
     // Note: Later, we can handle other modes here if necessary.
@@ -1069,6 +1098,32 @@ void ODClient::disconnect(bool keepReplay)
     }
 
     mIsPlayerConfig = false;
+    mCameraViewRadius = -1;
+}
+
+void ODClient::notifyCameraView(const Ogre::Vector3& viewTarget, Ogre::Real viewRadius)
+{
+    if(!isConnected())
+        return;
+
+    int32_t x = Helper::round(viewTarget.x);
+    int32_t y = Helper::round(viewTarget.y);
+    viewRadius = std::min(viewRadius, static_cast<Ogre::Real>(CAMERA_VIEW_MAX_RADIUS));
+    int32_t radius = std::max(CAMERA_VIEW_MIN_RADIUS, static_cast<int32_t>(std::ceil(viewRadius)));
+
+    // We don't want to flood the server while the camera is moving. It adds a margin around the view anyway
+    if((mCameraViewRadius >= 0) &&
+       (std::abs(x - mCameraViewX) < CAMERA_VIEW_MIN_CHANGE) &&
+       (std::abs(y - mCameraViewY) < CAMERA_VIEW_MIN_CHANGE) &&
+       (std::abs(radius - mCameraViewRadius) < CAMERA_VIEW_MIN_CHANGE))
+    {
+        return;
+    }
+
+    mCameraViewX = x;
+    mCameraViewY = y;
+    mCameraViewRadius = radius;
+    queueClientNotification(ClientNotificationType::cameraViewChanged, x, y, radius);
 }
 
 void ODClient::notifyExit()
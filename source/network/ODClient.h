@@ -22,6 +22,7 @@
 #include "network/ClientNotification.h"
 
 #include <OgreSingleton.h>
+#include <OgreVector3.h>
 
 #include <deque>
 
@@ -85,6 +86,12 @@ class ODClient: public Ogre::Singleton<ODClient>,
     inline bool getIsPlayerConfig() const
     { return mIsPlayerConfig; }
 
+    //! \brief Tells the server which region the player is looking at so that it can send the changes far
+    //! from it less often. viewTarget is the point the camera looks at and viewRadius the half size of the
+    //! floor square it sees (see CameraManager::getCameraViewRadius). The server is only notified when the
+    //! view changed enough
+    void notifyCameraView(const Ogre::Vector3& viewTarget, Ogre::Real viewRadius);
+
  protected:
     bool processMessage(ServerNotificationType cmd, ODPacket& packetReceived) override;
     void playerDisconnected() override;
@@ -93,8 +100,8 @@ class ODClient: public Ogre::Singleton<ODClient>,
     //! \brief Convenience function to send a game event.
     void addEventMessage(EventMessage* event);
 
-    //! \brief Refreshes the player's goals + main data
-    void refreshMainUI(const std::string& goalsString);
+    //! \brief Refreshes the player's main data and, if refreshGoals is true, the player's goals
+    void refreshMainUI(bool refreshGoals, const std::string& goalsString);
 
     std::string mTmpReceivedString;
     std::string mLevelFilename;
@@ -104,6 +111,12 @@ class ODClient: public Ogre::Singleton<ODClient>,
     // true if the server told us we are allowed to configure the game. False otherwise
     bool mIsPlayerConfig;
 
+    //! \brief Last camera view sent to the server (see notifyCameraView). mCameraViewRadius is negative
+    //! if none has been sent since the connection
+    int32_t mCameraViewX;
+    int32_t mCameraViewY;
+    int32_t mCameraViewRadius;
+
 };
 
 template<typename ...Args>
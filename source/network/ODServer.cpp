@@ -334,10 +334,23 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
         // so that they can see how far from the goals the other players are
         ServerNotification *serverNotification = new ServerNotification(
             ServerNotificationType::refreshPlayerSeat, player);
-        std::string goals = gameMap->getGoalsStringForPlayer(player);
         Seat* seat = player->getSeat();
+        // The goals string is only rebuilt if the goals may have changed and only sent if it is different
+        // from the one the player already has
+        bool goalsChanged = false;
+        if(seat->getHasGoalsChanged())
+        {
+            std::string goals = gameMap->getGoalsStringForPlayer(player);
+            if(goals != seat->getGoalsStringSent())
+            {
+                seat->setGoalsStringSent(goals);
+                goalsChanged = true;
+            }
+        }
         seat->exportToPacketForUpdate(serverNotification->mPacket);
-        serverNotification->mPacket << goals;
+        serverNotification->mPacket << goalsChanged;
+        if(goalsChanged)
+            serverNotification->mPacket << seat->getGoalsStringSent();
         ODServer::getSingleton().queueServerNotification(serverNotification);
 
         // Here, the creature list is pulled. It could be possible that the creature dies before the stat window is
@@ -401,6 +414,8 @@ void ODServer::serverThread()
         // doTask should return after the length of 1 turn even if their are communications. When
         // it returns, we can launch next turn.
         doTask(static_cast<int32_t>(turnLengthMs));
+        processWrittenMapFiles();
+
         // If all the clients are disconnected during a game, we close the server
         if((mServerState == ServerState::StateGame) &&
            (mSockClients.empty()))
@@ -482,8 +497,7 @@ void ODServer::serverThread()
                     if(seat->getPlayer() == nullptr)
                         continue;
 
-                    if(seat->getGold() > 0)
-                        gameMap->addGoldToSeat(seat->getGold(), seat->getId());
+                    seat->fillStartingGold();
                 }
             }
             else
@@ -685,6 +699,9 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
 
             packet << gameMap->getTileSetName();
 
+            // Ids of the mesh and animation names used in the following packets
+            gameMap->getNetworkIdTable().exportToPacket(packet);
+
             int32_t nb;
             // Seats
             const std::vector<Seat*>& seats = gameMap->getSeats();
@@ -1332,8 +1349,7 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
             if(player->getHasLost())
                 break;
 
-            std::vector<Room*> rooms = gameMap->getRoomsByTypeAndSeat(RoomType::workshop, player->getSeat());
-            if(!rooms.empty())
+            if(gameMap->numRoomsByTypeAndSeat(RoomType::workshop, player->getSeat()) > 0)
                 break;
 
             ServerNotification *serverNotification = new ServerNotification(
@@ -1418,6 +1434,20 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
             break;
         }
 
+        case ClientNotificationType::cameraViewChanged:
+        {
+            int32_t x;
+            int32_t y;
+            int32_t radius;
+            OD_ASSERT_TRUE(packetReceived >> x >> y >> radius);
+            Player* player = clientSocket->getPlayer();
+            if((player == nullptr) || (player->getSeat() == nullptr))
+                break;
+
+            player->getSeat()->setCameraView(x, y, radius);
+            break;
+        }
+
         case ClientNotificationType::askCreatureInfos:
         {
             std::string name;
@@ -1552,19 +1582,16 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
                 levelSave = boost::filesystem::path(savePath);
             }
 
-            // If the file exists, we make a backup
-            if (boost::filesystem::exists(levelSave))
-                boost::filesystem::rename(levelSave, levelSave.string() + ".bak");
-
-            std::string msg = "Map saved successfully as: " + levelSave.string();
-            if (!MapHandler::writeGameMapToFile(levelSave.string(), *gameMap))
+            // The map is captured now but written in the background. If the file exists, a backup
+            // will be made. The players are notified once the file is written (see processWrittenMapFiles)
+            if(!mMapFileWriter.writeGameMapToFile(levelSave.string(), *gameMap))
             {
-                msg = "Couldn't not save map file as: " + levelSave.string() + "\nPlease check logs.";
+                // A previous save is still written
+                std::string msg = "Map could not be saved because a previous save is still in progress";
+                ServerNotification notif(ServerNotificationType::chatServer, player);
+                notif.mPacket << msg << EventShortNoticeType::genericGameInfo;
+                sendAsyncMsg(notif);
             }
-            // We notify all the players that the game was saved successfully
-            ServerNotification notif(ServerNotificationType::chatServer, nullptr);
-            notif.mPacket << msg << EventShortNoticeType::genericGameInfo;
-            sendAsyncMsg(notif);
             break;
         }
 
@@ -1906,6 +1933,11 @@ void ODServer::stopServer()
     // We start by stopping server to make sure no new message comes
     ODSocketServer::stopServer();
 
+    // We make sure the last saved game is written. No turn is computed anymore so waiting
+    // is fine here. There is nobody to notify anymore
+    mMapFileWriter.waitForWrite();
+    mMapFileWriter.clearWrittenFiles();
+
     mServerState = ServerState::StateNone;
     mSeatsConfigured = false;
     mDisconnectedPlayers.clear();
@@ -1920,6 +1952,23 @@ void ODServer::stopServer()
     mGameMap->clearAll();
 }
 
+void ODServer::processWrittenMapFiles()
+{
+    std::string fileName;
+    bool isSuccess;
+    while(mMapFileWriter.popWrittenFile(fileName, isSuccess))
+    {
+        std::string msg = "Map saved successfully as: " + fileName;
+        if(!isSuccess)
+            msg = "Couldn't not save map file as: " + fileName + "\nPlease check logs.";
+
+        // We notify all the players that the game was saved successfully
+        ServerNotification notif(ServerNotificationType::chatServer, nullptr);
+        notif.mPacket << msg << EventShortNoticeType::genericGameInfo;
+        sendAsyncMsg(notif);
+    }
+}
+
 void ODServer::notifyExit()
 {
     while(!mServerNotificationQueue.empty())
@@ -19,6 +19,7 @@
 #define ODSERVER_H
 
 #include "ODSocketServer.h"
+#include "gamemap/MapFileWriter.h"
 #include "modes/ConsoleInterface.h"
 
 #include <OgreSingleton.h>
@@ -119,6 +120,9 @@ private:
     std::string mMasterServerGameId;
     double mMasterServerGameStatusUpdateTime;
 
+    //! \brief Writes the saved games without stalling the server
+    MapFileWriter mMapFileWriter;
+
     void printConsoleMsg(const std::string& text);
 
     ODSocketClient* getClientFromPlayer(Player* player);
@@ -150,6 +154,9 @@ private:
 
     void fireSeatConfigurationRefresh();
 
+    //! \brief Notifies the players about the saved games written by mMapFileWriter
+    void processWrittenMapFiles();
+
     //! \brief Handles console command. player is the player that launched the command
     void handleConsoleCommand(Player* player, GameMap* gameMap, const std::vector<std::string>& args);
 };
@@ -19,6 +19,7 @@
 #define SERVERNOTIFICATION_H
 
 #include "network/ODPacket.h"
+#include "utils/ObjectPool.h"
 
 #include <string>
 #include <OgreVector3.h>
@@ -93,7 +94,7 @@ ODPacket& operator<<(ODPacket& os, const ServerNotificationType& nt);
 ODPacket& operator>>(ODPacket& is, ServerNotificationType& nt);
 
 //! \brief A data structure used to send messages to the clients
-class ServerNotification
+class ServerNotification : public PooledObject<ServerNotification>
 {
     friend class ODServer;
 
@@ -208,6 +208,11 @@ bool ODFrameListener::frameRenderingQueued(const Ogre::FrameEvent& evt)
     printDebugInfo();
 
     mGameMap.get()->processDeletionQueues();
+    if(currentTurn >= 0)
+    {
+        Ogre::Vector3 viewTarget = mCameraManager.getCameraViewTarget();
+        ODClient::getSingleton().notifyCameraView(viewTarget, mCameraManager.getCameraViewRadius(viewTarget));
+    }
     ODClient::getSingleton().processClientSocketMessages();
     ODClient::getSingleton().processClientNotifications();
 
@@ -37,12 +37,22 @@
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
 
+#include <algorithm>
 #include <istream>
 #include <ostream>
 
+//! \brief Values used in the occupancy bitmap of Room::updateActiveSpots
+const uint8_t SPOT_BITMAP_EMPTY = 0;
+const uint8_t SPOT_BITMAP_COVERED = 1;
+const uint8_t SPOT_BITMAP_CENTER = 2;
+
 Room::Room(GameMap* gameMap):
     Building(gameMap),
-    mNumActiveSpots(0)
+    mNumActiveSpots(0),
+    mSeatCounted(nullptr),
+    mIsRoomCounted(false),
+    mGoldCounted(0),
+    mGoldMaxCounted(0)
 {
 }
 
@@ -66,12 +76,19 @@ void Room::addToGameMap()
 {
     getGameMap()->addRoom(this);
     getGameMap()->addActiveObject(this);
+
+    if(!getIsOnServerMap())
+        return;
+
+    mSeatCounted = getSeat();
+    refreshSeatCounters();
 }
 
 void Room::removeFromGameMap()
 {
     fireEntityRemoveFromGameMap();
     getGameMap()->removeRoom(this);
+    releaseSeatCounters();
     setIsOnMap(false);
     for(Seat* seat : getGameMap()->getSeats())
     {
@@ -131,11 +148,70 @@ void Room::absorbRoom(Room *r)
     r->mCoveredTilesDestroyed.insert(r->mCoveredTilesDestroyed.end(), r->mCoveredTiles.begin(), r->mCoveredTiles.end());
     r->mCoveredTiles.clear();
 
+    r->refreshSeatCounters();
+    refreshSeatCounters();
+    getGameMap()->notifyBuildingsChanged();
+
     // We fire the dead event so that if there are creatures heading for this room or
     // whatever, we release them before the remove from gamemap event
     r->fireEntityDead();
 }
 
+bool Room::removeCoveredTile(Tile* t)
+{
+    if(!Building::removeCoveredTile(t))
+        return false;
+
+    refreshSeatCounters();
+    return true;
+}
+
+double Room::takeDamage(GameEntity* attacker, double absoluteDamage, double physicalDamage, double magicalDamage, double elementDamage,
+        Tile *tileTakingDamage, bool ko)
+{
+    double damageDone = Building::takeDamage(attacker, absoluteDamage, physicalDamage, magicalDamage, elementDamage, tileTakingDamage, ko);
+    refreshSeatCounters();
+    return damageDone;
+}
+
+void Room::refreshSeatCounters()
+{
+    if(mSeatCounted == nullptr)
+        return;
+
+    bool isRoomCounted = (getHP(nullptr) > 0.0);
+    if(isRoomCounted != mIsRoomCounted)
+    {
+        mSeatCounted->notifyRoomCounted(getType(), isRoomCounted);
+        mIsRoomCounted = isRoomCounted;
+        getGameMap()->notifyBuildingsChanged();
+    }
+
+    int gold = getTotalGoldStored();
+    int goldMax = getTotalGoldStorage();
+    if((gold == mGoldCounted) && (goldMax == mGoldMaxCounted))
+        return;
+
+    mSeatCounted->notifyGoldChanged(gold - mGoldCounted, goldMax - mGoldMaxCounted);
+    mGoldCounted = gold;
+    mGoldMaxCounted = goldMax;
+}
+
+void Room::releaseSeatCounters()
+{
+    if(mSeatCounted == nullptr)
+        return;
+
+    if(mIsRoomCounted)
+        mSeatCounted->notifyRoomCounted(getType(), false);
+
+    mSeatCounted->notifyGoldChanged(-mGoldCounted, -mGoldMaxCounted);
+    mSeatCounted = nullptr;
+    mIsRoomCounted = false;
+    mGoldCounted = 0;
+    mGoldMaxCounted = 0;
+}
+
 void Room::handleCreatureUsingAbsorbedRoom(Creature& creature)
 {
     // If the job room is absorbed, we force the creatures working in the old rooms to search
@@ -236,67 +312,54 @@ void Room::updateActiveSpots()
     std::vector<Tile*> topWallsActiveSpotTiles;
     std::vector<Tile*> bottomWallsActiveSpotTiles;
 
-    // Detect the centers of 3x3 squares tiles
-    for(unsigned int i = 0, size = mCoveredTiles.size(); i < size; ++i)
+    // Detect the centers of 3x3 squares tiles. We use an occupancy bitmap of the room bounding box (with a
+    // 1 tile border to avoid checking the limits) where each covered tile is set to SPOT_BITMAP_COVERED.
+    // Once a tile is chosen as a center, it is set to SPOT_BITMAP_CENTER as we can't have two center spots
+    // next to one another. Note that the tiles are processed in the covered tiles order so that
+    // the spots are always placed the same way
+    if(!mCoveredTiles.empty())
     {
-        bool foundTop = false;
-        bool foundTopLeft = false;
-        bool foundTopRight = false;
-        bool foundLeft = false;
-        bool foundRight = false;
-        bool foundBottomLeft = false;
-        bool foundBottomRight = false;
-        bool foundBottom = false;
-        Tile* tile = mCoveredTiles[i];
-        int tileX = tile->getX();
-        int tileY = tile->getY();
-
-        // Check all other tiles to know whether we have one center tile.
-        for(unsigned int j = 0; j < size; ++j)
+        int minX = mCoveredTiles[0]->getX();
+        int maxX = minX;
+        int minY = mCoveredTiles[0]->getY();
+        int maxY = minY;
+        for(Tile* tile : mCoveredTiles)
         {
-            // Don't check the tile itself
-            if (tile == mCoveredTiles[j])
-                continue;
-
-            // Check whether the tile around the tile checked is already a center spot
-            // as we can't have two center spots next to one another.
-            if (std::find(centralActiveSpotTiles.begin(), centralActiveSpotTiles.end(), mCoveredTiles[j]) != centralActiveSpotTiles.end())
-                continue;
+            minX = std::min(minX, tile->getX());
+            maxX = std::max(maxX, tile->getX());
+            minY = std::min(minY, tile->getY());
+            maxY = std::max(maxY, tile->getY());
+        }
 
-            int tile2X = mCoveredTiles[j]->getX();
-            int tile2Y = mCoveredTiles[j]->getY();
+        // The bitmap is indexed by (x - minX + 1) + (y - minY + 1) * width
+        int width = maxX - minX + 3;
+        int height = maxY - minY + 3;
+        mActiveSpotsBitmap.assign(width * height, SPOT_BITMAP_EMPTY);
+        for(Tile* tile : mCoveredTiles)
+            mActiveSpotsBitmap[(tile->getX() - minX + 1) + (tile->getY() - minY + 1) * width] = SPOT_BITMAP_COVERED;
 
-            if(tile2X == tileX - 1)
-            {
-                if (tile2Y == tileY + 1)
-                    foundTopLeft = true;
-                else if (tile2Y == tileY)
-                    foundLeft = true;
-                else if (tile2Y == tileY - 1)
-                    foundBottomLeft = true;
-            }
-            else if(tile2X == tileX)
-            {
-                if (tile2Y == tileY + 1)
-                    foundTop = true;
-                else if (tile2Y == tileY - 1)
-                    foundBottom = true;
-            }
-            else if(tile2X == tileX + 1)
+        const int neighbors[8] = {
+            -width - 1, -width, -width + 1,
+            -1, 1,
+            width - 1, width, width + 1
+        };
+        for(Tile* tile : mCoveredTiles)
+        {
+            int index = (tile->getX() - minX + 1) + (tile->getY() - minY + 1) * width;
+            bool isCenter = true;
+            for(int neighbor : neighbors)
             {
-                if (tile2Y == tileY + 1)
-                    foundTopRight = true;
-                else if (tile2Y == tileY)
-                    foundRight = true;
-                else if (tile2Y == tileY - 1)
-                    foundBottomRight = true;
+                if(mActiveSpotsBitmap[index + neighbor] != SPOT_BITMAP_COVERED)
+                {
+                    isCenter = false;
+                    break;
+                }
             }
-        }
 
-        // Check whether we found a tile at the center of others
-        if (foundTop && foundTopLeft && foundTopRight && foundLeft && foundRight
-                && foundBottomLeft && foundBottomRight && foundBottom)
-        {
+            if(!isCenter)
+                continue;
+
+            mActiveSpotsBitmap[index] = SPOT_BITMAP_CENTER;
             centralActiveSpotTiles.push_back(tile);
         }
     }
@@ -452,11 +515,18 @@ void Room::updateActiveSpots()
 void Room::activeSpotCheckChange(ActiveSpotPlace place, const std::vector<Tile*>& originalSpotTiles,
     const std::vector<Tile*>& newSpotTiles)
 {
+    // We search in sorted copies to avoid being quadratic with big rooms. The notifications are still
+    // sent in the spot tiles order
+    std::vector<Tile*> originalSorted(originalSpotTiles);
+    std::sort(originalSorted.begin(), originalSorted.end());
+    std::vector<Tile*> newSorted(newSpotTiles);
+    std::sort(newSorted.begin(), newSorted.end());
+
     // We create the non existing tiles
     for(std::vector<Tile*>::const_iterator it = newSpotTiles.begin(); it != newSpotTiles.end(); ++it)
     {
         Tile* tile = *it;
-        if(std::find(originalSpotTiles.begin(), originalSpotTiles.end(), tile) == originalSpotTiles.end())
+        if(!std::binary_search(originalSorted.begin(), originalSorted.end(), tile))
         {
             // The tile do not exist
             BuildingObject* ro = notifyActiveSpotCreated(place, tile);
@@ -472,7 +542,7 @@ void Room::activeSpotCheckChange(ActiveSpotPlace place, const std::vector<Tile*>
     for(std::vector<Tile*>::const_iterator it = originalSpotTiles.begin(); it != originalSpotTiles.end(); ++it)
     {
         Tile* tile = *it;
-        if(std::find(newSpotTiles.begin(), newSpotTiles.end(), tile) == newSpotTiles.end())
+        if(!std::binary_search(newSorted.begin(), newSorted.end(), tile))
         {
             // The tile has been removed
             notifyActiveSpotRemoved(place, tile);
@@ -495,26 +565,38 @@ void Room::exportHeadersToStream(std::ostream& os) const
     os << getType() << "\t";
 }
 
-void Room::exportTileDataToStream(std::ostream& os, Tile* tile, TileData* tileData) const
+void Room::fillSaveRecord(BuildingSaveRecord& record) const
 {
-    if(getGameMap()->isInEditorMode())
-        return;
+    Building::fillSaveRecord(record);
+    record.mRoomType = getType();
+}
 
-    os << "\t" << tileData->mHP;
+void Room::fillTileSaveRecord(Tile* tile, TileData* tileData, BuildingTileSaveRecord& record) const
+{
+    record.mHP = tileData->mHP;
 
     // We only save enemy seats that have vision on the building
-    std::vector<Seat*> seatsToSave;
+    record.mSeatsVision.clear();
     for(Seat* seat : tileData->mSeatsVision)
     {
         if(getSeat()->isAlliedSeat(seat))
             continue;
 
-        seatsToSave.push_back(seat);
+        record.mSeatsVision.push_back(seat->getId());
     }
-    uint32_t nbSeatsVision = seatsToSave.size();
+}
+
+void Room::exportTileSaveRecordToStream(std::ostream& os, const BuildingTileSaveRecord& tile, bool isEditorMode)
+{
+    if(isEditorMode)
+        return;
+
+    os << "\t" << tile.mHP;
+
+    uint32_t nbSeatsVision = tile.mSeatsVision.size();
     os << "\t" << nbSeatsVision;
-    for(Seat* seat : seatsToSave)
-        os << "\t" << seat->getId();
+    for(int seatId : tile.mSeatsVision)
+        os << "\t" << seatId;
 }
 
 bool Room::importTileDataFromStream(std::istream& is, Tile* tile, TileData* tileData)
@@ -679,6 +761,7 @@ void Room::repairRoom()
         tile->setCoveringBuilding(this);
     }
 
+    refreshSeatCounters();
     updateActiveSpots();
 }
 
@@ -50,6 +50,11 @@ public:
     virtual void addToGameMap();
     virtual void removeFromGameMap() override;
 
+    virtual bool removeCoveredTile(Tile* t) override;
+
+    double takeDamage(GameEntity* attacker, double absoluteDamage, double physicalDamage, double magicalDamage, double elementDamage,
+        Tile *tileTakingDamage, bool ko) override;
+
     virtual void absorbRoom(Room* r);
 
     //! \brief By default, we consider that creatures using the room are working and
@@ -108,6 +113,11 @@ public:
 
     static bool sortForMapSave(Room* r1, Room* r2);
 
+    virtual void fillSaveRecord(BuildingSaveRecord& record) const override;
+
+    //! \brief Writes the data of a room tile after its coordinates (see BuildingSaveRecord::exportToStream)
+    static void exportTileSaveRecordToStream(std::ostream& os, const BuildingTileSaveRecord& tile, bool isEditorMode);
+
     //! \brief Returns the total gold that can be stored in the room
     virtual int getTotalGoldStorage() const
     { return 0; }
@@ -140,7 +150,7 @@ protected:
      * The content of the Room will be exported by exportToPacket.
      */
     virtual void exportHeadersToStream(std::ostream& os) const override;
-    void exportTileDataToStream(std::ostream& os, Tile* tile, TileData* tileData) const;
+    virtual void fillTileSaveRecord(Tile* tile, TileData* tileData, BuildingTileSaveRecord& record) const override;
     bool importTileDataFromStream(std::istream& is, Tile* tile, TileData* tileData);
 
     enum ActiveSpotPlace
@@ -168,10 +178,27 @@ protected:
 
     //! \brief This function will be called when reordering room is needed (for example if another room has been absorbed)
     static void reorderRoomTiles(std::vector<Tile*>& tiles);
+
+    //! \brief Updates the seat running counters (rooms, gold, gold max) with the current room state. Should be
+    //! called each time the room tiles, HP or stored gold change. Used on server side only
+    void refreshSeatCounters();
 private :
     void activeSpotCheckChange(ActiveSpotPlace place, const std::vector<Tile*>& originalSpotTiles,
         const std::vector<Tile*>& newSpotTiles);
 
+    //! \brief Removes everything this room accounts for from its seat counters
+    void releaseSeatCounters();
+
+    //! \brief Seat whose counters currently account for this room. nullptr if the room is not
+    //! in the gamemap. The counted values are saved to only apply the difference when refreshing
+    Seat* mSeatCounted;
+    bool mIsRoomCounted;
+    int mGoldCounted;
+    int mGoldMaxCounted;
+
+    //! \brief Occupancy bitmap of the room bounding box used by updateActiveSpots. Kept as a member
+    //! to avoid allocating each time the active spots are updated
+    std::vector<uint8_t> mActiveSpotsBitmap;
 };
 
 #endif // ROOM_H
@@ -49,7 +49,7 @@ class RoomArenaFactory : public RoomFactory
     { return RoomArenaNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("ArenaCostPerTile"); }
+    { return ConfigManager::getSingleton().getRoomConfigInt32(RoomConfig::ArenaCostPerTile); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -137,7 +137,7 @@ bool RoomArena::hasOpenCreatureSpot(Creature* c)
         return false;
 
     // We allow using arena only if level is not too high
-    if (c->getLevel() >= ConfigManager::getSingleton().getRoomConfigUInt32("ArenaMaxTrainingLevel"))
+    if (c->getLevel() >= ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfig::ArenaMaxTrainingLevel))
         return false;
 
     return true;
@@ -316,9 +316,8 @@ bool RoomArena::shouldStopUseIfHungrySleepy(Creature& creature, bool forced)
     return false;
 }
 
-void RoomArena::exportToStream(std::ostream& os) const
+void RoomArena::exportSpecificDataToStream(std::ostream& os) const
 {
-    Room::exportToStream(os);
     // TODO: save fighting creatures
 }
 
@@ -52,7 +52,7 @@ public:
 
 protected:
     virtual BuildingObject* notifyActiveSpotCreated(ActiveSpotPlace place, Tile* tile);
-    virtual void exportToStream(std::ostream& os) const override;
+    virtual void exportSpecificDataToStream(std::ostream& os) const override;
     virtual bool importFromStream(std::istream& is) override;
 
 private:
@@ -291,10 +291,8 @@ void RoomBridge::restoreInitialEntityState()
         updateFloodFillPathCreated(s, getCoveredTiles());
 }
 
-void RoomBridge::exportToStream(std::ostream& os) const
+void RoomBridge::exportSpecificDataToStream(std::ostream& os) const
 {
-    Room::exportToStream(os);
-
     os << mClaimedValue << "\n";
 }
 
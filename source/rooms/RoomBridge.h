@@ -66,7 +66,7 @@ public:
     virtual bool removeCoveredTile(Tile* t) override;
 
 protected:
-    virtual void exportToStream(std::ostream& os) const override;
+    virtual void exportSpecificDataToStream(std::ostream& os) const override;
     virtual bool importFromStream(std::istream& is) override;
 
     virtual void updateFloodFillPathCreated(Seat* seat, const std::vector<Tile*>& tiles);
@@ -54,7 +54,7 @@ class RoomCasinoFactory : public RoomFactory
     { return RoomCasinoNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("CasinoCostPerTile"); }
+    { return ConfigManager::getSingleton().getRoomConfigInt32(RoomConfig::CasinoCostPerTile); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -375,11 +375,11 @@ void RoomCasino::doUpkeep()
         // TODO: we could use the wall active spots to change feePercent/bets
 
         // We set anim for both creatures
-        uint32_t cooldown = Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("CasinoCooldownWorkMin"),
-            ConfigManager::getSingleton().getRoomConfigUInt32("CasinoCooldownWorkMax"));
-        double feePercent = std::min(ConfigManager::getSingleton().getRoomConfigDouble("CasinoFee"), 1.0);
-        double wakefullness = ConfigManager::getSingleton().getRoomConfigDouble("CasinoWakefulnessPerWork");
-        int32_t creatureBet = ConfigManager::getSingleton().getRoomConfigInt32("CasinoBet");
+        uint32_t cooldown = Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfig::CasinoCooldownWorkMin),
+            ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfig::CasinoCooldownWorkMax));
+        double feePercent = std::min(ConfigManager::getSingleton().getRoomConfigDouble(RoomConfig::CasinoFee), 1.0);
+        double wakefullness = ConfigManager::getSingleton().getRoomConfigDouble(RoomConfig::CasinoWakefulnessPerWork);
+        int32_t creatureBet = ConfigManager::getSingleton().getRoomConfigInt32(RoomConfig::CasinoBet);
         creatureBet = std::min(creatureBet, p.second.mCreature1.mCreature->getGoldCarried());
         creatureBet = std::min(creatureBet, p.second.mCreature2.mCreature->getGoldCarried());
         int32_t totalBet = 0;
@@ -509,7 +509,7 @@ bool RoomCasino::useRoom(Creature& creature, bool forced)
     if(Pathfinding::squaredDistance(creature.getPosition().x, wantedX, creature.getPosition().y, wantedY) > 0.4)
     {
         // We go there
-        std::list<Tile*> pathToSpot = getGameMap()->path(&creature, tileSpot);
+        TilePath pathToSpot = getGameMap()->path(&creature, tileSpot);
         std::vector<Ogre::Vector3> path;
         Creature::tileToVector3(pathToSpot, path, true, 0.0);
         // We add the last step to take account of the offset
@@ -43,7 +43,7 @@ public:
     static const RoomType mRoomType;
 
 protected:
-    virtual void exportToStream(std::ostream& os) const override;
+    virtual void exportSpecificDataToStream(std::ostream& os) const override;
     virtual bool importFromStream(std::istream& is) override;
 
     virtual BuildingObject* notifyActiveSpotCreated(ActiveSpotPlace place, Tile* tile) override;
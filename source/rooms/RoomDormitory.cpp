@@ -50,7 +50,7 @@ class RoomDormitoryFactory : public RoomFactory
     { return RoomDormitoryNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("DormitoryCostPerTile"); }
+    { return ConfigManager::getSingleton().getRoomConfigInt32(RoomConfig::DormitoryCostPerTile); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -400,9 +400,8 @@ bool RoomDormitory::tileCanAcceptBed(Tile *tile, int xDim, int yDim, const std::
     return true;
 }
 
-void RoomDormitory::exportToStream(std::ostream& os) const
+void RoomDormitory::exportSpecificDataToStream(std::ostream& os) const
 {
-    Room::exportToStream(os);
     uint32_t nbBeds = mBedRoomObjectsInfo.size();
     os << nbBeds << "\n";
     for(const BedRoomObjectInfo& bed : mBedRoomObjectsInfo)
@@ -23,9 +23,12 @@
 
 #include <OgreVector3.h>
 
-class RoomDormitoryTileData : public TileData
+class RoomDormitoryTileData : public TileData, public PooledObject<RoomDormitoryTileData>
 {
 public:
+    using PooledObject<RoomDormitoryTileData>::operator new;
+    using PooledObject<RoomDormitoryTileData>::operator delete;
+
     RoomDormitoryTileData() :
         TileData(),
         mCreature(nullptr)
@@ -168,7 +171,7 @@ public:
     static const RoomType mRoomType;
 
 protected:
-    void exportToStream(std::ostream& os) const override;
+    void exportSpecificDataToStream(std::ostream& os) const override;
     bool importFromStream(std::istream& is) override;
 
     RoomDormitoryTileData* createTileData(Tile* tile);
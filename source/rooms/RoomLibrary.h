@@ -25,9 +25,12 @@ class Tile;
 
 enum class SkillType;
 
-class RoomLibraryTileData : public TileData
+class RoomLibraryTileData : public TileData, public PooledObject<RoomLibraryTileData>
 {
 public:
+    using PooledObject<RoomLibraryTileData>::operator new;
+    using PooledObject<RoomLibraryTileData>::operator delete;
+
     RoomLibraryTileData() :
         TileData(),
         mCanHaveSkillEntity(true)
@@ -65,7 +68,7 @@ public:
     static const RoomType mRoomType;
 
 protected:
-    void exportToStream(std::ostream& os) const override;
+    void exportSpecificDataToStream(std::ostream& os) const override;
     bool importFromStream(std::istream& is) override;
 
     RoomLibraryTileData* createTileData(Tile* tile) override;
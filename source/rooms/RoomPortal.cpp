@@ -216,8 +216,8 @@ void RoomPortal::doUpkeep()
         --mSpawnCreatureCountdown;
         return;
     }
-    mSpawnCreatureCountdown = Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("PortalCooldownSpawnMin"),
-        ConfigManager::getSingleton().getRoomConfigUInt32("PortalCooldownSpawnMax"));
+    mSpawnCreatureCountdown = Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfig::PortalCooldownSpawnMin),
+        ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfig::PortalCooldownSpawnMax));
 
     if (mCoveredTiles.empty())
         return;
@@ -281,10 +281,8 @@ void RoomPortal::setupRoom(const std::string& name, Seat* seat, const std::vecto
     mNbCreatureMaxIncrease = 5;
 }
 
-void RoomPortal::exportToStream(std::ostream& os) const
+void RoomPortal::exportSpecificDataToStream(std::ostream& os) const
 {
-    Room::exportToStream(os);
-
     os << mClaimedValue << "\t" << mNbCreatureMaxIncrease << "\n";
 }
 
@@ -199,6 +199,8 @@ void RoomPortalWave::claimForSeat(Seat* seat, Tile* tile, double danceRate)
     // In the case of RoomPortalWave, when it is claimed, it is destroyed
     for(std::pair<Tile* const, TileData*>& p : mTileData)
         p.second->mHP = 0.0;
+
+    getGameMap()->notifyBuildingsChanged();
 }
 
 void RoomPortalWave::updateActiveSpots()
@@ -487,10 +489,8 @@ void RoomPortalWave::setupRoom(const std::string& name, Seat* seat, const std::v
     mClaimedValue = static_cast<double>(numCoveredTiles());
 }
 
-void RoomPortalWave::exportToStream(std::ostream& os) const
+void RoomPortalWave::exportSpecificDataToStream(std::ostream& os) const
 {
-    Room::exportToStream(os);
-
     std::string teams;
     if(mTargetTeams.empty())
     {
@@ -109,7 +109,7 @@ public:
     static const RoomType mRoomType;
 
 protected:
-    virtual void exportToStream(std::ostream& os) const override;
+    virtual void exportSpecificDataToStream(std::ostream& os) const override;
     virtual bool importFromStream(std::istream& is) override;
 
     void destroyMeshLocal() override;
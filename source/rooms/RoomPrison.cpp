@@ -53,7 +53,7 @@ class RoomPrisonFactory : public RoomFactory
     { return RoomPrisonNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("PrisonCostPerTile"); }
+    { return ConfigManager::getSingleton().getRoomConfigInt32(RoomConfig::PrisonCostPerTile); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -210,7 +210,7 @@ void RoomPrison::doUpkeep()
 
             ++nbCreatures;
             // We slightly damage the prisoner
-            double damage = ConfigManager::getSingleton().getRoomConfigDouble("PrisonDamagePerTurn");
+            double damage = ConfigManager::getSingleton().getRoomConfigDouble(RoomConfig::PrisonDamagePerTurn);
             creature->takeDamage(this, damage, 0.0, 0.0, 0.0, creatureTile, false);
             creature->increaseTurnsPrison();
 
@@ -235,7 +235,7 @@ void RoomPrison::doUpkeep()
             creature->removeFromGameMap();
             creature->deleteYourself();
 
-            const std::string& className = ConfigManager::getSingleton().getRoomConfigString("PrisonSpawnClass");
+            const std::string& className = ConfigManager::getSingleton().getRoomConfigString(RoomConfig::PrisonSpawnClass);
             const CreatureDefinition* classToSpawn = getGameMap()->getClassDescription(className);
             if(classToSpawn == nullptr)
             {
@@ -253,10 +253,8 @@ void RoomPrison::doUpkeep()
     }
 }
 
-void RoomPrison::exportToStream(std::ostream& os) const
+void RoomPrison::exportSpecificDataToStream(std::ostream& os) const
 {
-    Room::exportToStream(os);
-
     std::vector<Creature*> creatures;
     for(Tile* tile : mCoveredTiles)
     {
@@ -58,7 +58,7 @@ public:
 
 protected:
     virtual BuildingObject* notifyActiveSpotCreated(ActiveSpotPlace place, Tile* tile) override;
-    void exportToStream(std::ostream& os) const override;
+    void exportSpecificDataToStream(std::ostream& os) const override;
     bool importFromStream(std::istream& is) override;
 
 private:
@@ -52,7 +52,7 @@ class RoomTortureFactory : public RoomFactory
     { return RoomTortureNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("TortureCostPerTile"); }
+    { return ConfigManager::getSingleton().getRoomConfigInt32(RoomConfig::TortureCostPerTile); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -297,7 +297,7 @@ void RoomTorture::doUpkeep()
             break;
         }
         creature->increaseTurnsTorture();
-        double damage = config.getRoomConfigDouble("TortureDamagePerTurn");
+        double damage = config.getRoomConfigDouble(RoomConfig::TortureDamagePerTurn);
         creature->takeDamage(this, damage, 0.0, 0.0, 0.0, tileCreature, false);
         break;
     }
@@ -328,7 +328,7 @@ bool RoomTorture::useRoom(Creature& creature, bool forced)
         p.second.mIsReady = true;
 
         if((getSeat() != creature.getSeat()) &&
-           (Random::Double(0.0, 1.0) <= config.getRoomConfigDouble("TortureRallyPercent")))
+           (Random::Double(0.0, 1.0) <= config.getRoomConfigDouble(RoomConfig::TortureRallyPercent)))
         {
             // The creature changes side
             creature.changeSeat(getSeat());
@@ -349,8 +349,8 @@ bool RoomTorture::useRoom(Creature& creature, bool forced)
         }
 
         // We start the fire effect and we set job cooldown
-        uint32_t nbTurns = Random::Uint(config.getRoomConfigUInt32("TortureSessionLengthMin"),
-            config.getRoomConfigUInt32("TortureSessionLengthMax"));
+        uint32_t nbTurns = Random::Uint(config.getRoomConfigUInt32(RoomConfig::TortureSessionLengthMin),
+            config.getRoomConfigUInt32(RoomConfig::TortureSessionLengthMax));
         creature.setJobCooldown(nbTurns);
 
         BuildingObject* obj = getBuildingObjectFromTile(tileCreature);
@@ -367,7 +367,7 @@ bool RoomTorture::useRoom(Creature& creature, bool forced)
             case 1:
             {
                 obj->addParticleEffect("Flame", nbTurns / 2);
-                obj->fireRefresh();
+                obj->setNeedFireRefresh();
                 creature.setAnimationState(EntityAnimation::flee_anim);
                 break;
             }
@@ -413,10 +413,8 @@ void RoomTorture::creatureDropped(Creature& creature)
     creature.clearActionQueue();
     creature.pushAction(Utils::make_unique<CreatureActionUseRoom>(creature, *this, true));
 }
-void RoomTorture::exportToStream(std::ostream& os) const
+void RoomTorture::exportSpecificDataToStream(std::ostream& os) const
 {
-    Room::exportToStream(os);
-
     std::vector<Creature*> creatures;
     for(Tile* tile : mCoveredTiles)
     {
@@ -69,7 +69,7 @@ public:
 protected:
     BuildingObject* notifyActiveSpotCreated(ActiveSpotPlace place, Tile* tile) override;
     void notifyActiveSpotRemoved(ActiveSpotPlace place, Tile* tile) override;
-    void exportToStream(std::ostream& os) const override;
+    void exportSpecificDataToStream(std::ostream& os) const override;
     bool importFromStream(std::istream& is) override;
 
 private:
@@ -47,7 +47,7 @@ class RoomTrainingHallFactory : public RoomFactory
     { return RoomTrainingHallNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("TrainHallCostPerTile"); }
+    { return ConfigManager::getSingleton().getRoomConfigInt32(RoomConfig::TrainHallCostPerTile); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -247,7 +247,7 @@ void RoomTrainingHall::refreshCreaturesDummies()
            creaturePosition.y != wantedY)
         {
             // We move to the good tile
-            std::list<Tile*> pathToDummy = getGameMap()->path(creature, tileDummy);
+            TilePath pathToDummy = getGameMap()->path(creature, tileDummy);
             if(pathToDummy.empty())
             {
                 OD_LOG_ERR("unexpected empty pathToDummy");
@@ -266,7 +266,7 @@ void RoomTrainingHall::refreshCreaturesDummies()
 
 bool RoomTrainingHall::hasOpenCreatureSpot(Creature* c)
 {
-    if (c->getLevel() >= ConfigManager::getSingleton().getRoomConfigUInt32("TrainHallMaxTrainingLevel"))
+    if (c->getLevel() >= ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfig::TrainHallMaxTrainingLevel))
         return false;
 
     // We accept all creatures as soon as there are free dummies
@@ -290,7 +290,7 @@ bool RoomTrainingHall::addCreatureUsingRoom(Creature* creature)
        creaturePosition.y != wantedY)
     {
         // We move to the good tile
-        std::list<Tile*> pathToDummy = getGameMap()->path(creature, tileDummy);
+        TilePath pathToDummy = getGameMap()->path(creature, tileDummy);
         if(pathToDummy.empty())
         {
             OD_LOG_ERR("unexpected empty pathToDummy");
@@ -389,14 +389,14 @@ bool RoomTrainingHall::useRoom(Creature& creature, bool forced)
         + ", creatureRoomAffinityType=" + Helper::toString(static_cast<int>(creatureRoomAffinity.getRoomType())));
 
     // We add a bonus per wall active spots
-    double coef = 1.0 + static_cast<double>(mNumActiveSpots - mCentralActiveSpotTiles.size()) * ConfigManager::getSingleton().getRoomConfigDouble("TrainHallBonusWallActiveSpot");
-    double expReceived = creatureRoomAffinity.getEfficiency() * ConfigManager::getSingleton().getRoomConfigDouble("TrainHallXpPerAttack");
+    double coef = 1.0 + static_cast<double>(mNumActiveSpots - mCentralActiveSpotTiles.size()) * ConfigManager::getSingleton().getRoomConfigDouble(RoomConfig::TrainHallBonusWallActiveSpot);
+    double expReceived = creatureRoomAffinity.getEfficiency() * ConfigManager::getSingleton().getRoomConfigDouble(RoomConfig::TrainHallXpPerAttack);
     expReceived *= coef;
 
     creature.receiveExp(expReceived);
-    creature.jobDone(ConfigManager::getSingleton().getRoomConfigDouble("TrainHallWakefulnessPerAttack"));
-    creature.setJobCooldown(Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("TrainHallCooldownHitMin"),
-        ConfigManager::getSingleton().getRoomConfigUInt32("TrainHallCooldownHitMax")));
+    creature.jobDone(ConfigManager::getSingleton().getRoomConfigDouble(RoomConfig::TrainHallWakefulnessPerAttack));
+    creature.setJobCooldown(Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfig::TrainHallCooldownHitMin),
+        ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfig::TrainHallCooldownHitMax)));
 
     return false;
 }
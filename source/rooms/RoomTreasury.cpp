@@ -56,7 +56,7 @@ class RoomTreasuryFactory : public RoomFactory
     { return RoomTreasuryNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("TreasuryCostPerTile"); }
+    { return ConfigManager::getSingleton().getRoomConfigInt32(RoomConfig::TreasuryCostPerTile); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -221,8 +221,7 @@ class RoomTreasuryFactory : public RoomFactory
         int32_t pricePerTarget = RoomManager::costPerTile(RoomTreasury::mRoomType);
         int32_t price = static_cast<int32_t>(tiles.size()) * pricePerTarget;
         // First treasury tile is free
-        std::vector<Room*> treasuriesOwned = gameMap->getRoomsByTypeAndSeat(RoomTreasury::mRoomType, player->getSeat());
-        if(treasuriesOwned.empty())
+        if(gameMap->numRoomsByTypeAndSeat(RoomTreasury::mRoomType, player->getSeat()) == 0)
             price -= pricePerTarget;
 
         return price;
@@ -344,6 +343,7 @@ int RoomTreasury::depositGold(int gold, Tile *tile)
         return wasDeposited;
 
     mGoldChanged = true;
+    refreshSeatCounters();
 
     // Tells the client to play a deposit gold sound. For now, we only send it to the players
     // with vision on tile
@@ -377,6 +377,7 @@ int RoomTreasury::withdrawGold(int gold)
         }
     }
 
+    refreshSeatCounters();
     return withdrawlAmount;
 }
 
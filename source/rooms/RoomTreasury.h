@@ -21,9 +21,12 @@
 #include "rooms/Room.h"
 #include "rooms/RoomType.h"
 
-class RoomTreasuryTileData : public TileData
+class RoomTreasuryTileData : public TileData, public PooledObject<RoomTreasuryTileData>
 {
 public:
+    using PooledObject<RoomTreasuryTileData>::operator new;
+    using PooledObject<RoomTreasuryTileData>::operator delete;
+
     RoomTreasuryTileData() :
         TileData(),
         mGoldInTile(0)
@@ -53,7 +53,7 @@ class RoomWorkshopFactory : public RoomFactory
     { return RoomWorkshopNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("WorkshopCostPerTile"); }
+    { return ConfigManager::getSingleton().getRoomConfigInt32(RoomConfig::WorkshopCostPerTile); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -248,7 +248,7 @@ bool RoomWorkshop::addCreatureUsingRoom(Creature* creature)
        creaturePosition.y != wantedY)
     {
         // We move to the good tile
-        std::list<Tile*> pathToSpot = getGameMap()->path(creature, tileSpot);
+        TilePath pathToSpot = getGameMap()->path(creature, tileSpot);
         if(pathToSpot.empty())
         {
             OD_LOG_ERR("unexpected empty pathToSpot");
@@ -301,7 +301,7 @@ void RoomWorkshop::doUpkeep()
         Creature* worker = getGameMap()->getWorkerForPathFinding(getSeat());
         if (worker != nullptr)
         {
-            std::vector<Building*> reachableBuildings = getGameMap()->getReachableBuildingsPerSeat(getSeat(),
+            const std::vector<Building*>& reachableBuildings = getGameMap()->getReachableBuildingsPerSeat(getSeat(),
                 mCoveredTiles[0], worker);
             for(Building* building : reachableBuildings)
             {
@@ -471,10 +471,10 @@ bool RoomWorkshop::useRoom(Creature& creature, bool forced)
     OD_ASSERT_TRUE_MSG(creatureRoomAffinity.getRoomType() == getType(), "name=" + getName() + ", creature=" + creature.getName()
         + ", creatureRoomAffinityType=" + Helper::toString(static_cast<int>(creatureRoomAffinity.getRoomType())));
 
-    mPoints += static_cast<int32_t>(creatureRoomAffinity.getEfficiency() * ConfigManager::getSingleton().getRoomConfigDouble("WorkshopPointsPerWork"));
-    creature.jobDone(ConfigManager::getSingleton().getRoomConfigDouble("WorkshopWakefulnessPerWork"));
-    creature.setJobCooldown(Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("WorkshopCooldownWorkMin"),
-        ConfigManager::getSingleton().getRoomConfigUInt32("WorkshopCooldownWorkMax")));
+    mPoints += static_cast<int32_t>(creatureRoomAffinity.getEfficiency() * ConfigManager::getSingleton().getRoomConfigDouble(RoomConfig::WorkshopPointsPerWork));
+    creature.jobDone(ConfigManager::getSingleton().getRoomConfigDouble(RoomConfig::WorkshopWakefulnessPerWork));
+    creature.setJobCooldown(Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfig::WorkshopCooldownWorkMin),
+        ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfig::WorkshopCooldownWorkMax)));
 
     return false;
 }
@@ -518,9 +518,8 @@ void RoomWorkshop::getCreatureWantedPos(Creature* creature, Tile* tileSpot,
     wantedY += Y_OFFSET_CREATURE;
 }
 
-void RoomWorkshop::exportToStream(std::ostream& os) const
+void RoomWorkshop::exportSpecificDataToStream(std::ostream& os) const
 {
-    Room::exportToStream(os);
     os << mPoints << "\t";
     os << mTrapType << "\n";
 }
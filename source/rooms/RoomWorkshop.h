@@ -23,9 +23,12 @@
 
 enum class TrapType;
 
-class RoomWorkshopTileData : public TileData
+class RoomWorkshopTileData : public TileData, public PooledObject<RoomWorkshopTileData>
 {
 public:
+    using PooledObject<RoomWorkshopTileData>::operator new;
+    using PooledObject<RoomWorkshopTileData>::operator delete;
+
     RoomWorkshopTileData() :
         TileData(),
         mCanHaveCraftedTrap(true)
@@ -62,7 +65,7 @@ public:
     static const RoomType mRoomType;
 
 protected:
-    void exportToStream(std::ostream& os) const override;
+    void exportSpecificDataToStream(std::ostream& os) const override;
     bool importFromStream(std::istream& is) override;
 
     RoomWorkshopTileData* createTileData(Tile* tile) override;
@@ -24,7 +24,7 @@
 bool SpawnConditionRoom::computePointsForSeat(const GameMap& gameMap, const Seat& seat, int32_t& computedPoints) const
 {
     int32_t nbActiveSpots = 0;
-    std::vector<const Room*> rooms = gameMap.getRoomsByTypeAndSeat(mRoomType, &seat);
+    const std::vector<Room*>& rooms = gameMap.getRoomsByTypeAndSeat(mRoomType, &seat);
     for(const Room* room : rooms)
     {
         nbActiveSpots += room->getNumActiveSpots();
@@ -35,7 +35,6 @@
 
 const std::string SpellCreatureExplosionName = "creatureExplosion";
 const std::string SpellCreatureExplosionNameDisplay = "Creature explosion";
-const std::string SpellCreatureExplosionCooldownKey = "CreatureExplosionCooldown";
 const SpellType SpellCreatureExplosion::mSpellType = SpellType::creatureExplosion;
 
 namespace
@@ -48,8 +47,8 @@ class SpellCreatureExplosionFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureExplosionName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureExplosionCooldownKey; }
+    SpellConfig getCooldownKey() const override
+    { return SpellConfig::CreatureExplosionCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureExplosionNameDisplay; }
@@ -75,7 +74,7 @@ void SpellCreatureExplosion::checkSpellCast(GameMap* gameMap, const InputManager
 {
     Player* player = gameMap->getLocalPlayer();
     int32_t priceTotal = 0;
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureExplosionPrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfig::CreatureExplosionPrice);
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -205,7 +204,7 @@ bool SpellCreatureExplosion::castSpell(GameMap* gameMap, Player* player, ODPacke
     if(creatures.empty())
         return false;
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureExplosionPrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfig::CreatureExplosionPrice);
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     uint32_t nbTargets = std::min(static_cast<uint32_t>(playerMana / pricePerTarget), static_cast<uint32_t>(creatures.size()));
     int32_t priceTotal = nbTargets * pricePerTarget;
@@ -216,8 +215,8 @@ bool SpellCreatureExplosion::castSpell(GameMap* gameMap, Player* player, ODPacke
     if(!player->getSeat()->takeMana(priceTotal))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureExplosionDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureExplosionValue");
+    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32(SpellConfig::CreatureExplosionDuration);
+    double value = ConfigManager::getSingleton().getSpellConfigDouble(SpellConfig::CreatureExplosionValue);
     for(Creature* creature : creatures)
     {
         CreatureEffectExplosion* effect = new CreatureEffectExplosion(duration, value, "SpellCreatureExplosion");
@@ -36,7 +36,6 @@
 
 const std::string SpellCreatureHasteName = "creatureHaste";
 const std::string SpellCreatureHasteNameDisplay = "Creature haste";
-const std::string SpellCreatureHasteCooldownKey = "CreatureHasteCooldown";
 const SpellType SpellCreatureHaste::mSpellType = SpellType::creatureHaste;
 
 namespace
@@ -49,8 +48,8 @@ class SpellCreatureHasteFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureHasteName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureHasteCooldownKey; }
+    SpellConfig getCooldownKey() const override
+    { return SpellConfig::CreatureHasteCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureHasteNameDisplay; }
@@ -75,7 +74,7 @@ static SpellRegister reg(new SpellCreatureHasteFactory);
 void SpellCreatureHaste::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
 {
     Player* player = gameMap->getLocalPlayer();
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureHastePrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfig::CreatureHastePrice);
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -193,13 +192,13 @@ bool SpellCreatureHaste::castSpell(GameMap* gameMap, Player* player, ODPacket& p
         return false;
     }
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureHastePrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfig::CreatureHastePrice);
 
     if(!player->getSeat()->takeMana(pricePerTarget))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureHasteDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureHasteValue");
+    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32(SpellConfig::CreatureHasteDuration);
+    double value = ConfigManager::getSingleton().getSpellConfigDouble(SpellConfig::CreatureHasteValue);
     CreatureEffectSpeedChange* effect = new CreatureEffectSpeedChange(duration, value, "SpellCreatureHaste");
     creature->addCreatureEffect(effect);
 
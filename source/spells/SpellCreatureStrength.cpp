@@ -36,7 +36,6 @@
 
 const std::string SpellCreatureStrengthName = "creatureStrength";
 const std::string SpellCreatureStrengthNameDisplay = "Creature Strength";
-const std::string SpellCreatureStrengthCooldownKey = "CreatureStrengthCooldown";
 const SpellType SpellCreatureStrength::mSpellType = SpellType::creatureStrength;
 
 namespace
@@ -49,8 +48,8 @@ class SpellCreatureStrengthFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureStrengthName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureStrengthCooldownKey; }
+    SpellConfig getCooldownKey() const override
+    { return SpellConfig::CreatureStrengthCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureStrengthNameDisplay; }
@@ -75,7 +74,7 @@ static SpellRegister reg(new SpellCreatureStrengthFactory);
 void SpellCreatureStrength::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
 {
     Player* player = gameMap->getLocalPlayer();
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureStrengthPrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfig::CreatureStrengthPrice);
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -193,13 +192,13 @@ bool SpellCreatureStrength::castSpell(GameMap* gameMap, Player* player, ODPacket
         return false;
     }
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureStrengthPrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfig::CreatureStrengthPrice);
 
     if(!player->getSeat()->takeMana(pricePerTarget))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureStrengthDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureStrengthValue");
+    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32(SpellConfig::CreatureStrengthDuration);
+    double value = ConfigManager::getSingleton().getSpellConfigDouble(SpellConfig::CreatureStrengthValue);
     CreatureEffectStrengthChange* effect = new CreatureEffectStrengthChange(duration, value, "SpellCreatureStrength");
     creature->addCreatureEffect(effect);
 
@@ -32,7 +32,6 @@
 
 const std::string SpellEyeEvilName = "eyeEvil";
 const std::string SpellEyeEvilNameDisplay = "Eye of Evil";
-const std::string SpellEyeEvilCooldownKey = "EyeEvilCooldown";
 const SpellType SpellEyeEvil::mSpellType = SpellType::eyeEvil;
 
 namespace
@@ -45,8 +44,8 @@ class SpellEyeEvilFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellEyeEvilName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellEyeEvilCooldownKey; }
+    SpellConfig getCooldownKey() const override
+    { return SpellConfig::EyeEvilCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellEyeEvilNameDisplay; }
@@ -70,7 +69,7 @@ static SpellRegister reg(new SpellEyeEvilFactory);
 
 SpellEyeEvil::SpellEyeEvil(GameMap* gameMap) :
     Spell(gameMap, SpellManager::getSpellNameFromSpellType(getSpellType()), "FlyingSkull", 0.0,
-        ConfigManager::getSingleton().getSpellConfigInt32("EyeEvilNbTurns"))
+        ConfigManager::getSingleton().getSpellConfigInt32(SpellConfig::EyeEvilNbTurns))
 {
     mPrevAnimationState = "Triggered";
     mPrevAnimationStateLoop = true;
@@ -82,7 +81,7 @@ SpellEyeEvil::~SpellEyeEvil()
 
 void SpellEyeEvil::computeVisibleTiles()
 {
-    uint32_t radius = ConfigManager::getSingleton().getSpellConfigUInt32("EyeEvilRadiusTiles");
+    uint32_t radius = ConfigManager::getSingleton().getSpellConfigUInt32(SpellConfig::EyeEvilRadiusTiles);
     Tile* posTile = getPositionTile();
     if(posTile == nullptr)
     {
@@ -90,8 +89,8 @@ void SpellEyeEvil::computeVisibleTiles()
         return;
     }
 
-    std::vector<Tile*> tiles = getGameMap()->circularRegion(posTile->getX(), posTile->getY(), radius);
-    for(Tile* tile : tiles)
+    getGameMap()->circularRegion(posTile->getX(), posTile->getY(), radius, mTilesInRadius);
+    for(Tile* tile : mTilesInRadius)
         tile->notifyVision(getSeat());
 }
 
@@ -104,7 +103,7 @@ void SpellEyeEvil::checkSpellCast(GameMap* gameMap, const InputManager& inputMan
         return;
 
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
-    int32_t price = ConfigManager::getSingleton().getSpellConfigInt32("EyeEvilPrice");
+    int32_t price = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfig::EyeEvilPrice);
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
         if(playerMana < price)
@@ -147,7 +146,7 @@ bool SpellEyeEvil::castSpell(GameMap* gameMap, Player* player, ODPacket& packet)
         return false;
 
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
-    int32_t manaCost = ConfigManager::getSingleton().getSpellConfigInt32("EyeEvilPrice");
+    int32_t manaCost = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfig::EyeEvilPrice);
     if(playerMana < manaCost)
         return false;
 
@@ -43,6 +43,10 @@ public:
     static Spell* getSpellFromPacket(GameMap* gameMap, ODPacket &is);
 
     static const SpellType mSpellType;
+
+private:
+    //! \brief Reused when computing vision to avoid allocating each turn
+    std::vector<Tile*> mTilesInRadius;
 };
 
 #endif // SPELLEYEEVIL_H
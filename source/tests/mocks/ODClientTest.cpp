@@ -117,6 +117,8 @@ bool ODClientTest::processMessage(ServerNotificationType cmd, ODPacket& packetRe
             BOOST_CHECK(packetReceived >> str);
             OD_LOG_INF("level tileset=" + (str.empty() ? "default" : str));
 
+            BOOST_CHECK(mNetworkIdTable.importFromPacket(packetReceived));
+
             uint32_t nb;
             // We read the seats
             BOOST_CHECK(mSeats.empty());
@@ -390,8 +392,11 @@ bool ODClientTest::processMessage(ServerNotificationType cmd, ODPacket& packetRe
         }
         case ServerNotificationType::refreshPlayerSeat:
         {
+            bool goalsChanged;
             BOOST_CHECK(mPlayers[mLocalPlayerIndex].mSeat->importFromPacketForUpdate(packetReceived));
-            BOOST_CHECK(packetReceived >> mPlayers[mLocalPlayerIndex].mGoals);
+            BOOST_CHECK(packetReceived >> goalsChanged);
+            if(goalsChanged)
+                BOOST_CHECK(packetReceived >> mPlayers[mLocalPlayerIndex].mGoals);
             break;
         }
         case ServerNotificationType::setObjectAnimationState:
@@ -402,8 +407,9 @@ bool ODClientTest::processMessage(ServerNotificationType cmd, ODPacket& packetRe
             bool playIdleWhenAnimationEnds;
             bool shouldSetWalkDirection;
             Ogre::Vector3 walkDirection(0, 0, 0);
-            BOOST_CHECK(packetReceived >> entityName >> animState
-                >> loop >> playIdleWhenAnimationEnds >> shouldSetWalkDirection);
+            BOOST_CHECK(packetReceived >> entityName);
+            BOOST_CHECK(mNetworkIdTable.readName(packetReceived, NetworkIdCategory::animation, animState));
+            BOOST_CHECK(packetReceived >> loop >> playIdleWhenAnimationEnds >> shouldSetWalkDirection);
 
             if(shouldSetWalkDirection)
             {
@@ -421,8 +427,11 @@ bool ODClientTest::processMessage(ServerNotificationType cmd, ODPacket& packetRe
             bool loopEndAnim;
             bool playIdleWhenAnimationEnds;
             uint32_t nbDest;
-            BOOST_CHECK(packetReceived >> entityName >> walkAnim >> endAnim);
-            BOOST_CHECK(packetReceived >> loopEndAnim >> playIdleWhenAnimationEnds >> nbDest);
+            BOOST_CHECK(packetReceived >> entityName);
+            BOOST_CHECK(mNetworkIdTable.readName(packetReceived, NetworkIdCategory::animation, walkAnim));
+            BOOST_CHECK(mNetworkIdTable.readName(packetReceived, NetworkIdCategory::animation, endAnim));
+            BOOST_CHECK(packetReceived >> loopEndAnim >> playIdleWhenAnimationEnds);
+            BOOST_CHECK(packetReceived >> nbDest);
             std::vector<Ogre::Vector3> path;
             while(nbDest)
             {
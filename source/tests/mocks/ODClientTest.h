@@ -19,6 +19,7 @@
 #ifndef ODCLIENTTEST_H
 #define ODCLIENTTEST_H
 
+#include "network/NetworkIdTable.h"
 #include "network/ODSocketClient.h"
 
 #include <string>
@@ -90,6 +91,8 @@ private:
     std::vector<PlayerInfo> mPlayers;
     std::vector<SeatData*> mSeats;
     uint32_t mLocalPlayerIndex;
+    //! \brief Used to read the animation names sent by id
+    NetworkIdTable mNetworkIdTable;
 };
 
 #endif // ODCLIENTTEST_H
@@ -0,0 +1,139 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/GameMapSnapshot.h"
+
+#include <atomic>
+#include <thread>
+
+#define BOOST_TEST_MODULE GameMapSnapshot
+#include "BoostTestTargetConfig.h"
+
+namespace
+{
+const int MAP_SIZE_X = 40;
+const int MAP_SIZE_Y = 35;
+
+void fillTiles(GameMapSnapshotBuilder& builder, double fullness)
+{
+    for(int x = 0; x < MAP_SIZE_X; ++x)
+    {
+        for(int y = 0; y < MAP_SIZE_Y; ++y)
+        {
+            TileSnapshot tile;
+            tile.mFullness = fullness;
+            tile.mSeatId = x % 4;
+            builder.setTile(x, y, tile);
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_GameMapSnapshotCopyOnWrite)
+{
+    GameMapSnapshotBuilder builder;
+    BOOST_CHECK(builder.getSnapshot() == nullptr);
+
+    builder.resize(MAP_SIZE_X, MAP_SIZE_Y);
+    fillTiles(builder, 100.0);
+    CreatureSnapshot creature;
+    creature.mName = "Kobold1";
+    builder.addCreature(creature);
+    builder.publish(1);
+    std::shared_ptr<const GameMapSnapshot> snapshot1 = builder.getSnapshot();
+    BOOST_REQUIRE(snapshot1 != nullptr);
+    BOOST_CHECK(snapshot1->getTurnNumber() == 1);
+    BOOST_CHECK(snapshot1->getTile(MAP_SIZE_X, 0) == nullptr);
+    BOOST_CHECK(snapshot1->getTile(0, -1) == nullptr);
+    BOOST_CHECK(snapshot1->getTile(39, 34)->mFullness == 100.0);
+    BOOST_CHECK(snapshot1->getCreatures().size() == 1);
+
+    // Setting the same values does not copy anything
+    fillTiles(builder, 100.0);
+    BOOST_CHECK(builder.getNbPagesCopied() == 0);
+
+    // Changing tiles only copies the pages containing them
+    TileSnapshot tile;
+    tile.mFullness = 0.0;
+    builder.setTile(3, 4, tile);
+    builder.setTile(5, 6, tile);
+    BOOST_CHECK(builder.getNbPagesCopied() == 1);
+    builder.clearCreatures();
+    builder.publish(2);
+    std::shared_ptr<const GameMapSnapshot> snapshot2 = builder.getSnapshot();
+    BOOST_CHECK(snapshot2->getTurnNumber() == 2);
+    BOOST_CHECK(snapshot2->getTile(3, 4)->mFullness == 0.0);
+    BOOST_CHECK(snapshot2->getTile(3, 5)->mFullness == 100.0);
+    BOOST_CHECK(snapshot2->getCreatures().empty());
+
+    // The previous snapshot is unchanged
+    BOOST_CHECK(snapshot1->getTile(3, 4)->mFullness == 100.0);
+    BOOST_CHECK(snapshot1->getCreatures().size() == 1);
+    // 3x3 pages, only one of them was copied
+    BOOST_CHECK(snapshot2->getNbSharedPages(*snapshot1) == 8);
+
+    builder.resize(0, 0);
+    BOOST_CHECK(builder.getSnapshot() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_GameMapSnapshotReaderThread)
+{
+    GameMapSnapshotBuilder builder;
+    builder.resize(MAP_SIZE_X, MAP_SIZE_Y);
+    fillTiles(builder, 0.0);
+    builder.publish(0);
+
+    // The reader checks that every snapshot it gets is consistent: every tile has the fullness
+    // set during the turn the snapshot was published, even if the map is modified meanwhile
+    std::atomic<bool> isDone(false);
+    std::atomic<uint32_t> nbErrors(0);
+    std::atomic<uint32_t> nbSnapshotsRead(0);
+    std::thread reader([&]()
+    {
+        while(!isDone)
+        {
+            std::shared_ptr<const GameMapSnapshot> snapshot = builder.getSnapshot();
+            double fullness = static_cast<double>(snapshot->getTurnNumber());
+            for(int x = 0; x < snapshot->getMapSizeX(); ++x)
+            {
+                for(int y = 0; y < snapshot->getMapSizeY(); ++y)
+                {
+                    if(snapshot->getTile(x, y)->mFullness != fullness)
+                        ++nbErrors;
+                }
+            }
+            ++nbSnapshotsRead;
+        }
+    });
+
+    for(int64_t turn = 1; turn <= 500; ++turn)
+    {
+        // We modify the tiles one by one while the reader might be reading the previous snapshot
+        fillTiles(builder, static_cast<double>(turn));
+        builder.publish(turn);
+    }
+
+    // We make sure the reader has read at least one snapshot
+    while(nbSnapshotsRead == 0)
+        std::this_thread::yield();
+
+    isDone = true;
+    reader.join();
+
+    BOOST_CHECK(nbErrors == 0);
+    BOOST_CHECK(builder.getSnapshot()->getTurnNumber() == 500);
+}
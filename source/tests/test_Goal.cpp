@@ -63,4 +63,6 @@ BOOST_AUTO_TEST_CASE(test_Goal)
     logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkConsole()));
     TestGoal g("name", "arguments");
     BOOST_CHECK(g.isMet(Seat(), GameMap()));
+    // Goals not telling what they depend on are checked every turn
+    BOOST_CHECK(g.getDependencies() == Goal::DEPENDENCY_TURN);
 }
@@ -0,0 +1,133 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/MiniMapImage.h"
+#include "gamemap/MiniMapRaster.h"
+
+#define BOOST_TEST_MODULE MiniMapRaster
+#include "BoostTestTargetConfig.h"
+
+namespace
+{
+const uint32_t MAP_SIZE = 4;
+const uint32_t GRAIN_SIZE = 4;
+const uint8_t OUTSIDE_VALUE = 0;
+
+//! \brief Returns a palette index different for each tile
+uint8_t tileValue(uint32_t x, uint32_t y)
+{
+    return static_cast<uint8_t>(1 + x + y * MAP_SIZE);
+}
+
+uint32_t paletteColor(uint8_t index)
+{
+    return MiniMapImage::packColor(index, 0x80, 0xFF - index);
+}
+
+void initRaster(MiniMapRaster& raster)
+{
+    raster.setOutsideValue(OUTSIDE_VALUE);
+    raster.setPaletteColor(OUTSIDE_VALUE, 0x00, 0x00, 0x00);
+    for(uint32_t x = 0; x < MAP_SIZE; ++x)
+    {
+        for(uint32_t y = 0; y < MAP_SIZE; ++y)
+        {
+            uint8_t index = tileValue(x, y);
+            raster.setPaletteColor(index, index, 0x80, 0xFF - index);
+            raster.setTileValue(x, y, index);
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_MiniMapRasterDraw)
+{
+    MiniMapRaster raster(MAP_SIZE, MAP_SIZE);
+    initRaster(raster);
+    MiniMapImage image(MAP_SIZE * GRAIN_SIZE, MAP_SIZE * GRAIN_SIZE);
+    image.clearDirtyRect();
+
+    // Camera at the center of the map without rotation: each tile is drawn as a square. The map
+    // y axis goes up while the image one goes down
+    raster.draw(image, 2.0f, 2.0f, 1.0, 0.0, GRAIN_SIZE);
+    for(uint32_t x = 0; x < MAP_SIZE; ++x)
+    {
+        for(uint32_t y = 0; y < MAP_SIZE; ++y)
+        {
+            uint32_t expected = paletteColor(tileValue(x, y));
+            uint32_t pixelX = x * GRAIN_SIZE;
+            uint32_t pixelY = (MAP_SIZE - 1 - y) * GRAIN_SIZE;
+            BOOST_CHECK(image.getPixel(pixelX, pixelY) == expected);
+            BOOST_CHECK(image.getPixel(pixelX + GRAIN_SIZE - 1, pixelY + GRAIN_SIZE - 1) == expected);
+        }
+    }
+    BOOST_CHECK(image.hasDirtyRect());
+    BOOST_CHECK(image.getDirtyXMin() == 0);
+    BOOST_CHECK(image.getDirtyYMin() == 0);
+    BOOST_CHECK(image.getDirtyXMax() == MAP_SIZE * GRAIN_SIZE);
+    BOOST_CHECK(image.getDirtyYMax() == MAP_SIZE * GRAIN_SIZE);
+    image.clearDirtyRect();
+
+    // Nothing changed
+    raster.draw(image, 2.0f, 2.0f, 1.0, 0.0, GRAIN_SIZE);
+    BOOST_CHECK(!image.hasDirtyRect());
+
+    // Setting the same value does not change anything
+    raster.setTileValue(1, 2, tileValue(1, 2));
+    raster.draw(image, 2.0f, 2.0f, 1.0, 0.0, GRAIN_SIZE);
+    BOOST_CHECK(!image.hasDirtyRect());
+
+    // Only the changed tile is dirty
+    raster.setTileValue(1, 2, tileValue(3, 3));
+    raster.draw(image, 2.0f, 2.0f, 1.0, 0.0, GRAIN_SIZE);
+    BOOST_CHECK(image.hasDirtyRect());
+    BOOST_CHECK(image.getDirtyXMin() == GRAIN_SIZE);
+    BOOST_CHECK(image.getDirtyYMin() == GRAIN_SIZE);
+    BOOST_CHECK(image.getDirtyXMax() == 2 * GRAIN_SIZE);
+    BOOST_CHECK(image.getDirtyYMax() == 2 * GRAIN_SIZE);
+    BOOST_CHECK(image.getPixel(GRAIN_SIZE, GRAIN_SIZE) == paletteColor(tileValue(3, 3)));
+
+    // Out of range tiles are ignored
+    raster.setTileValue(-1, 0, tileValue(3, 3));
+    raster.setTileValue(0, MAP_SIZE, tileValue(3, 3));
+}
+
+BOOST_AUTO_TEST_CASE(test_MiniMapRasterRotation)
+{
+    MiniMapRaster raster(MAP_SIZE, MAP_SIZE);
+    initRaster(raster);
+    MiniMapImage image(MAP_SIZE * GRAIN_SIZE, MAP_SIZE * GRAIN_SIZE);
+
+    // With a half turn, the map is mirrored around the camera. The first column and the
+    // last row are then outside of the map
+    raster.draw(image, 2.0f, 2.0f, -1.0, 0.0, GRAIN_SIZE);
+    for(uint32_t column = 0; column < MAP_SIZE; ++column)
+    {
+        for(uint32_t row = 0; row < MAP_SIZE; ++row)
+        {
+            uint32_t pixelX = column * GRAIN_SIZE;
+            uint32_t pixelY = (MAP_SIZE - 1 - row) * GRAIN_SIZE;
+            uint32_t tileX = MAP_SIZE - column;
+            uint32_t tileY = MAP_SIZE - row;
+            uint32_t expected = MiniMapImage::packColor(0x00, 0x00, 0x00);
+            if((tileX < MAP_SIZE) && (tileY < MAP_SIZE))
+                expected = paletteColor(tileValue(tileX, tileY));
+
+            BOOST_CHECK(image.getPixel(pixelX, pixelY) == expected);
+        }
+    }
+}
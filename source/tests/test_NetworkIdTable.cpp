@@ -0,0 +1,68 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE NetworkIdTable
+#include "BoostTestTargetConfig.h"
+
+#include "network/NetworkIdTable.h"
+#include "network/ODPacket.h"
+
+BOOST_AUTO_TEST_CASE(test_NetworkIdTable)
+{
+    NetworkIdTable serverTable;
+    // Class ids are the definition indexes, even if a name is used twice
+    BOOST_CHECK(serverTable.addName(NetworkIdCategory::creatureClass, "Kobold") == 0);
+    BOOST_CHECK(serverTable.addName(NetworkIdCategory::creatureClass, "Wizard") == 1);
+    BOOST_CHECK(serverTable.addName(NetworkIdCategory::creatureClass, "Kobold") == 2);
+    BOOST_CHECK(serverTable.getId(NetworkIdCategory::creatureClass, "Kobold") == 0);
+    BOOST_CHECK(serverTable.getId(NetworkIdCategory::creatureClass, "Wizard") == 1);
+    BOOST_CHECK(serverTable.getId(NetworkIdCategory::creatureClass, "Troll") == NetworkIdTable::NotInTable);
+    BOOST_CHECK(serverTable.getId(NetworkIdCategory::weapon, "Kobold") == NetworkIdTable::NotInTable);
+    BOOST_CHECK(serverTable.getId(NetworkIdCategory::weapon, "") == NetworkIdTable::NoName);
+
+    BOOST_CHECK(serverTable.addNameIfMissing(NetworkIdCategory::animation, "Idle") == 0);
+    BOOST_CHECK(serverTable.addNameIfMissing(NetworkIdCategory::animation, "Walk") == 1);
+    BOOST_CHECK(serverTable.addNameIfMissing(NetworkIdCategory::animation, "Idle") == 0);
+    BOOST_CHECK(serverTable.addNameIfMissing(NetworkIdCategory::animation, "") == NetworkIdTable::NoName);
+    BOOST_CHECK(serverTable.addNameIfMissing(NetworkIdCategory::mesh, "Kobold.mesh") == 0);
+
+    // The client gets the mesh and animation names from the table sent with the level
+    ODPacket packet;
+    serverTable.exportToPacket(packet);
+    NetworkIdTable clientTable;
+    BOOST_CHECK(clientTable.importFromPacket(packet));
+    BOOST_CHECK(clientTable.getId(NetworkIdCategory::animation, "Walk") == 1);
+    BOOST_CHECK(clientTable.getId(NetworkIdCategory::mesh, "Kobold.mesh") == 0);
+    BOOST_CHECK(clientTable.getName(NetworkIdCategory::animation, 2) == nullptr);
+
+    // Names in the table are sent by id, the others by name
+    serverTable.writeName(packet, NetworkIdCategory::animation, "Walk");
+    serverTable.writeName(packet, NetworkIdCategory::animation, "Dance");
+    serverTable.writeName(packet, NetworkIdCategory::animation, "");
+    std::string name = "Unchanged";
+    BOOST_CHECK(clientTable.readName(packet, NetworkIdCategory::animation, name));
+    BOOST_CHECK(name == "Walk");
+    BOOST_CHECK(clientTable.readName(packet, NetworkIdCategory::animation, name));
+    BOOST_CHECK(name == "Dance");
+    BOOST_CHECK(clientTable.readName(packet, NetworkIdCategory::animation, name));
+    BOOST_CHECK(name.empty());
+
+    // An id the client does not know is an error
+    uint32_t unknownId = 5;
+    packet << unknownId;
+    BOOST_CHECK(!clientTable.readName(packet, NetworkIdCategory::animation, name));
+}
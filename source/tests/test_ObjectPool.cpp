@@ -0,0 +1,184 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/ObjectPool.h"
+#include "utils/Random.h"
+
+#define BOOST_TEST_MODULE ObjectPool
+#include "BoostTestTargetConfig.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+const uint32_t NB_BLOCKS_PER_CHUNK = 64;
+
+class TestEntityBase
+{
+public:
+    virtual ~TestEntityBase()
+    {}
+};
+
+class TestEntity : public TestEntityBase, public PooledObject<TestEntity>
+{
+public:
+    TestEntity(int value) :
+        mValue(value)
+    {}
+
+    int mValue;
+    std::string mName;
+};
+
+struct LiveObject
+{
+    void* mPtr;
+    uint32_t mTurnRelease;
+};
+
+//! \brief Simulates a fight: each turn, some objects are created with a short random life time and the expired
+//! ones are released. Returns the highest number of objects alive at the same time
+uint32_t runTurns(uint32_t nbTurns, std::size_t size, ObjectPool& pool)
+{
+    // Seeded so that the test always does the same thing
+    Random::initialize(42);
+    uint32_t peak = 0;
+    std::vector<LiveObject> live;
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        uint32_t nbNew = Random::Uint(0, 39);
+        for(uint32_t i = 0; i < nbNew; ++i)
+        {
+            LiveObject obj;
+            obj.mPtr = pool.allocate(size);
+            obj.mTurnRelease = turn + 1 + Random::Uint(0, 19);
+            live.push_back(obj);
+        }
+        peak = std::max(peak, static_cast<uint32_t>(live.size()));
+
+        for(uint32_t i = 0; i < live.size();)
+        {
+            if(live[i].mTurnRelease > turn)
+            {
+                ++i;
+                continue;
+            }
+            pool.release(live[i].mPtr, size);
+            live[i] = live.back();
+            live.pop_back();
+        }
+    }
+
+    for(LiveObject& obj : live)
+        pool.release(obj.mPtr, size);
+
+    return peak;
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_ReuseBlocks)
+{
+    ObjectPool pool(40, NB_BLOCKS_PER_CHUNK);
+    BOOST_CHECK(pool.getBlockSize() >= 40);
+    BOOST_CHECK_EQUAL(pool.getBlockSize() % 16, 0u);
+
+    void* ptr1 = pool.allocate(40);
+    void* ptr2 = pool.allocate(40);
+    BOOST_CHECK(ptr1 != ptr2);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(ptr1) % 16, 0u);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(ptr2) % 16, 0u);
+    BOOST_CHECK_EQUAL(pool.getNbUsedBlocks(), 2u);
+    BOOST_CHECK_EQUAL(pool.getNbChunks(), 1u);
+
+    // The last released block is the next one given
+    pool.release(ptr1, 40);
+    BOOST_CHECK_EQUAL(pool.getNbUsedBlocks(), 1u);
+    void* ptr3 = pool.allocate(40);
+    BOOST_CHECK(ptr3 == ptr1);
+
+    pool.release(ptr2, 40);
+    pool.release(ptr3, 40);
+    BOOST_CHECK_EQUAL(pool.getNbUsedBlocks(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_ChunkGrowth)
+{
+    ObjectPool pool(24, NB_BLOCKS_PER_CHUNK);
+    std::vector<void*> blocks;
+    for(uint32_t i = 0; i < NB_BLOCKS_PER_CHUNK + 1; ++i)
+        blocks.push_back(pool.allocate(24));
+
+    BOOST_CHECK_EQUAL(pool.getNbChunks(), 2u);
+    for(void* ptr : blocks)
+        pool.release(ptr, 24);
+
+    // Released blocks are reused: no new chunk
+    for(uint32_t i = 0; i < NB_BLOCKS_PER_CHUNK + 1; ++i)
+        blocks[i] = pool.allocate(24);
+    BOOST_CHECK_EQUAL(pool.getNbChunks(), 2u);
+
+    for(void* ptr : blocks)
+        pool.release(ptr, 24);
+}
+
+BOOST_AUTO_TEST_CASE(test_BiggerSizeUsesHeap)
+{
+    ObjectPool pool(16, NB_BLOCKS_PER_CHUNK);
+    void* ptr = pool.allocate(1000);
+    BOOST_CHECK(ptr != nullptr);
+    BOOST_CHECK_EQUAL(pool.getNbChunks(), 0u);
+    BOOST_CHECK_EQUAL(pool.getNbUsedBlocks(), 0u);
+    pool.release(ptr, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(test_PooledObject)
+{
+    ObjectPool& pool = PooledObject<TestEntity>::getPool();
+    uint32_t nbUsed = pool.getNbUsedBlocks();
+
+    TestEntityBase* entity = new TestEntity(12);
+    BOOST_CHECK_EQUAL(pool.getNbUsedBlocks(), nbUsed + 1);
+    BOOST_CHECK_EQUAL(static_cast<TestEntity*>(entity)->mValue, 12);
+
+    // Deleting from the base class gives the block back to the pool
+    delete entity;
+    BOOST_CHECK_EQUAL(pool.getNbUsedBlocks(), nbUsed);
+}
+
+BOOST_AUTO_TEST_CASE(test_StressTurns)
+{
+    const uint32_t NB_TURNS = 10000;
+    const std::size_t SIZE = 200;
+
+    ObjectPool pool(SIZE, NB_BLOCKS_PER_CHUNK);
+    uint32_t peak = runTurns(NB_TURNS, SIZE, pool);
+    BOOST_CHECK(peak > 0);
+
+    // The memory held by the pool never exceeds what was needed at the peak
+    BOOST_CHECK_EQUAL(pool.getNbUsedBlocks(), 0u);
+    BOOST_CHECK(pool.getNbChunks() <= (peak + NB_BLOCKS_PER_CHUNK - 1) / NB_BLOCKS_PER_CHUNK);
+
+    // Running the same fight again reuses the released blocks
+    uint32_t nbChunks = pool.getNbChunks();
+    BOOST_CHECK_EQUAL(runTurns(NB_TURNS, SIZE, pool), peak);
+    BOOST_CHECK_EQUAL(pool.getNbChunks(), nbChunks);
+    BOOST_CHECK_EQUAL(pool.getNbUsedBlocks(), 0u);
+}
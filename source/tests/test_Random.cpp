@@ -25,3 +25,15 @@ BOOST_AUTO_TEST_CASE(test_Random)
     Random::initialize();
     BOOST_CHECK (Random::Int(1, 2 ) <= 2);
 }
+
+BOOST_AUTO_TEST_CASE(test_RandomSeed)
+{
+    Random::initialize(42);
+    int first1 = Random::Int(0, 1000);
+    int first2 = Random::Int(0, 1000);
+
+    // The same seed gives the same sequence
+    Random::initialize(42);
+    BOOST_CHECK_EQUAL(Random::Int(0, 1000), first1);
+    BOOST_CHECK_EQUAL(Random::Int(0, 1000), first2);
+}
@@ -0,0 +1,169 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "entities/TileDataMap.h"
+#include "utils/ObjectPool.h"
+#include "utils/Random.h"
+
+#define BOOST_TEST_MODULE TileDataMap
+#include "BoostTestTargetConfig.h"
+
+#include <cstdint>
+#include <map>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+//! \brief Tile and TileData are only used as keys/values by TileDataMap. We use the addresses of the elements
+//! of these arrays so that the test does not depend on the game classes
+const uint32_t NB_TILES = 200;
+char gTiles[NB_TILES];
+char gTileDatas[NB_TILES];
+
+Tile* getTile(uint32_t index)
+{
+    return reinterpret_cast<Tile*>(&gTiles[index]);
+}
+
+TileData* getTileData(uint32_t index)
+{
+    return reinterpret_cast<TileData*>(&gTileDatas[index]);
+}
+
+//! \brief Same pattern as TileData and its subclasses
+class TestTileData : public PooledObject<TestTileData>
+{
+public:
+    virtual ~TestTileData()
+    {}
+
+    double mHP;
+};
+
+class TestTrapTileData : public TestTileData, public PooledObject<TestTrapTileData>
+{
+public:
+    using PooledObject<TestTrapTileData>::operator new;
+    using PooledObject<TestTrapTileData>::operator delete;
+
+    uint32_t mReloadTime;
+    double mClaimedValue;
+};
+}
+
+BOOST_AUTO_TEST_CASE(test_SameAsMap)
+{
+    TileDataMap tileDataMap;
+    std::map<Tile*, TileData*> reference;
+    std::vector<Tile*> insertionOrder;
+    // Seeded so that the test always does the same thing
+    Random::initialize(42);
+    for(uint32_t i = 0; i < 500; ++i)
+    {
+        uint32_t index = Random::Uint(0, NB_TILES - 1);
+        if(reference.find(getTile(index)) == reference.end())
+            insertionOrder.push_back(getTile(index));
+
+        tileDataMap[getTile(index)] = getTileData(index);
+        reference[getTile(index)] = getTileData(index);
+    }
+
+    // The slots are walked in the order the tiles were added
+    BOOST_CHECK_EQUAL(tileDataMap.size(), reference.size());
+    BOOST_REQUIRE_EQUAL(tileDataMap.size(), insertionOrder.size());
+    uint32_t slot = 0;
+    for(const std::pair<Tile* const, TileData*>& p : tileDataMap)
+    {
+        BOOST_CHECK(p.first == insertionOrder[slot]);
+        BOOST_CHECK(p.second == reference[p.first]);
+        ++slot;
+    }
+
+    for(uint32_t index = 0; index < NB_TILES; ++index)
+    {
+        bool inReference = (reference.find(getTile(index)) != reference.end());
+        TileDataMap::const_iterator it = tileDataMap.find(getTile(index));
+        BOOST_CHECK_EQUAL(it != tileDataMap.end(), inReference);
+        if(inReference)
+            BOOST_CHECK(tileDataMap.at(getTile(index)) == getTileData(index));
+        else
+            BOOST_CHECK_THROW(tileDataMap.at(getTile(index)), std::out_of_range);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_OperatorBracketAddsEmptySlot)
+{
+    TileDataMap tileDataMap;
+    BOOST_CHECK(tileDataMap.empty());
+    BOOST_CHECK(tileDataMap[getTile(3)] == nullptr);
+    BOOST_CHECK_EQUAL(tileDataMap.size(), 1u);
+    tileDataMap[getTile(3)] = getTileData(3);
+    BOOST_CHECK(tileDataMap.at(getTile(3)) == getTileData(3));
+    BOOST_CHECK_EQUAL(tileDataMap.size(), 1u);
+    tileDataMap.clear();
+    BOOST_CHECK(tileDataMap.find(getTile(3)) == tileDataMap.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_PooledSubclass)
+{
+    ObjectPool& basePool = PooledObject<TestTileData>::getPool();
+    ObjectPool& trapPool = PooledObject<TestTrapTileData>::getPool();
+    uint32_t nbBase = basePool.getNbUsedBlocks();
+    uint32_t nbTrap = trapPool.getNbUsedBlocks();
+
+    TestTileData* tileData = new TestTileData;
+    TestTileData* trapTileData = new TestTrapTileData;
+    BOOST_CHECK_EQUAL(basePool.getNbUsedBlocks(), nbBase + 1);
+    BOOST_CHECK_EQUAL(trapPool.getNbUsedBlocks(), nbTrap + 1);
+
+    // Deleting from the base class gives the block back to the pool of the subclass
+    delete trapTileData;
+    delete tileData;
+    BOOST_CHECK_EQUAL(basePool.getNbUsedBlocks(), nbBase);
+    BOOST_CHECK_EQUAL(trapPool.getNbUsedBlocks(), nbTrap);
+}
+
+//! \brief Covers tiles like a building growing: the slots of the tiles already covered do not move and their
+//! data can be changed through the iterators
+BOOST_AUTO_TEST_CASE(test_SlotsAreStable)
+{
+    static_assert(std::is_const<TileDataMap::value_type::first_type>::value, "The tile of a slot cannot be changed");
+
+    TileDataMap tileDataMap;
+    // Tiles are added in decreasing address order so that the sorted index and the slots differ
+    for(uint32_t i = NB_TILES; i > 0; --i)
+    {
+        tileDataMap[getTile(i - 1)] = nullptr;
+        BOOST_CHECK(tileDataMap.begin()->first == getTile(NB_TILES - 1));
+        BOOST_CHECK((tileDataMap.end() - 1)->first == getTile(i - 1));
+        BOOST_CHECK(tileDataMap.find(getTile(i - 1)) == tileDataMap.end() - 1);
+    }
+
+    uint32_t index = NB_TILES;
+    for(TileDataMap::value_type& p : tileDataMap)
+    {
+        --index;
+        p.second = getTileData(index);
+    }
+
+    for(uint32_t i = 0; i < NB_TILES; ++i)
+    {
+        BOOST_CHECK(tileDataMap.at(getTile(i)) == getTileData(i));
+        BOOST_CHECK(tileDataMap.find(getTile(i)) == tileDataMap.begin() + (NB_TILES - 1 - i));
+    }
+}
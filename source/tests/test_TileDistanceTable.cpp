@@ -0,0 +1,305 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/TileDistanceTable.h"
+
+#define BOOST_TEST_MODULE TileDistanceTable
+#include "BoostTestTargetConfig.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace
+{
+//! \brief Biggest radius checked. The config uses up to 15 (creatures sight radius and cannon range)
+const int MAX_RADIUS = 31;
+
+typedef std::vector<std::pair<uint32_t, double>> HiddenTiles;
+
+//! \brief Offset as TileContainer::buildTileDistance used to compute it before TileDistanceTable: every
+//! offset is tested against every other one and the hidden part of each tile is kept as is
+struct ReferenceTileDistance
+{
+    ReferenceTileDistance(int diffX, int diffY, TileDistance::TileDistanceType type, int distSquared) :
+        mDiffX(diffX),
+        mDiffY(diffY),
+        mType(type),
+        mDistSquared(distSquared)
+    {}
+
+    void computeTileDistances(double coefNorth, double coefSouth, const ReferenceTileDistance& tileDistance,
+        uint32_t indexTileDistance)
+    {
+        if(tileDistance.mDiffX < mDiffX)
+            return;
+        if(tileDistance.mDiffY < mDiffY)
+            return;
+
+        if((tileDistance.mDiffX == mDiffX) &&
+           (tileDistance.mDiffY == mDiffY))
+        {
+            return;
+        }
+
+        if(mType == TileDistance::TileDistanceType::Horizontal)
+        {
+            if(tileDistance.mType == TileDistance::TileDistanceType::Horizontal)
+            {
+                addSouth(indexTileDistance, 1.0);
+                return;
+            }
+
+            double xTileDeb = static_cast<double>(tileDistance.mDiffX) - 0.5;
+            double xTileEnd = xTileDeb + 1.0;
+            double yTileDeb = static_cast<double>(tileDistance.mDiffY) - 0.5;
+            double yTileEnd = yTileDeb + 1.0;
+            double yHideDebNorth = coefNorth * xTileDeb;
+            double yHideEndNorth = coefNorth * xTileEnd;
+
+            if(yHideEndNorth <= yTileDeb)
+                return;
+
+            if((yHideDebNorth >= yTileDeb) &&
+               (yHideEndNorth <= yTileEnd))
+            {
+                double hiddenArea = (yHideEndNorth - yHideDebNorth) / 2.0;
+                hiddenArea += yHideDebNorth - yTileDeb;
+                addSouth(indexTileDistance, hiddenArea);
+            }
+            else if((yHideDebNorth < yTileDeb) &&
+                    (yHideEndNorth > yTileDeb))
+            {
+                double xHit = yTileDeb / coefNorth;
+                double hiddenArea = (yHideEndNorth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+                addSouth(indexTileDistance, hiddenArea);
+            }
+            else if((yHideDebNorth < yTileEnd) &&
+                    (yHideEndNorth > yTileEnd))
+            {
+                double xHit = yTileEnd / coefNorth;
+                double visibleArea = (yTileEnd - yHideDebNorth) * (xHit - xTileDeb) / 2.0;
+                addSouth(indexTileDistance, 1.0 - visibleArea);
+            }
+            else
+            {
+                addSouth(indexTileDistance, 1.0);
+            }
+
+            return;
+        }
+
+        double xTileDeb = static_cast<double>(tileDistance.mDiffX) - 0.5;
+        double xTileEnd = xTileDeb + 1.0;
+        double yTileDeb = static_cast<double>(tileDistance.mDiffY) - 0.5;
+        double yTileEnd = yTileDeb + 1.0;
+
+        double yHideDebSouth = coefSouth * xTileDeb;
+        double yHideEndSouth = coefSouth * xTileEnd;
+        double yHideDebNorth = coefNorth * xTileDeb;
+        double yHideEndNorth = coefNorth * xTileEnd;
+        if((yHideDebSouth < yTileEnd) &&
+           (yHideEndNorth > yTileDeb))
+        {
+            if((yHideDebSouth >= yTileDeb) &&
+               (yHideEndSouth <= yTileEnd))
+            {
+                double visibleArea = (yHideEndSouth - yHideDebSouth) / 2.0;
+                visibleArea += yHideDebSouth - yTileDeb;
+                addNorth(indexTileDistance, 1.0 - visibleArea);
+            }
+            else if((yHideDebSouth < yTileDeb) &&
+                    (yHideEndSouth > yTileDeb))
+            {
+                double xHit = yTileDeb / coefSouth;
+                double visibleArea = (yHideEndSouth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+                addNorth(indexTileDistance, 1.0 - visibleArea);
+            }
+            else if((yHideDebSouth < yTileEnd) &&
+                    (yHideEndSouth > yTileEnd))
+            {
+                double xHit = yTileEnd / coefSouth;
+                double hiddenArea = (yTileEnd - yHideDebSouth) * (xHit - xTileDeb) / 2.0;
+                addNorth(indexTileDistance, hiddenArea);
+            }
+            else if((yHideDebNorth >= yTileDeb) &&
+               (yHideEndNorth <= yTileEnd))
+            {
+                double hiddenArea = (yHideEndNorth - yHideDebNorth) / 2.0;
+                hiddenArea += yHideDebNorth - yTileDeb;
+                addSouth(indexTileDistance, hiddenArea);
+            }
+            else if((yHideDebNorth < yTileDeb) &&
+                    (yHideEndNorth > yTileDeb))
+            {
+                double xHit = yTileDeb / coefNorth;
+                double hiddenArea = (yHideEndNorth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+                addSouth(indexTileDistance, hiddenArea);
+            }
+            else if((yHideDebNorth < yTileEnd) &&
+                    (yHideEndNorth > yTileEnd))
+            {
+                double xHit = yTileEnd / coefNorth;
+                double visibleArea = (yTileEnd - yHideDebNorth) * (xHit - xTileDeb) / 2.0;
+                addSouth(indexTileDistance, 1.0 - visibleArea);
+            }
+            else
+            {
+                addSouth(indexTileDistance, 1.0);
+            }
+        }
+    }
+
+    void addNorth(uint32_t indexTile, double hiddenPercent)
+    { mHiddenTilesNorth.push_back(std::make_pair(indexTile, hiddenPercent)); }
+
+    void addSouth(uint32_t indexTile, double hiddenPercent)
+    { mHiddenTilesSouth.push_back(std::make_pair(indexTile, hiddenPercent)); }
+
+    int mDiffX;
+    int mDiffY;
+    TileDistance::TileDistanceType mType;
+    int mDistSquared;
+    HiddenTiles mHiddenTilesNorth;
+    HiddenTiles mHiddenTilesSouth;
+};
+
+//! \brief Same as TileContainer::buildTileDistance used to do
+std::vector<ReferenceTileDistance> referenceBuildTileDistance(int distance)
+{
+    std::vector<ReferenceTileDistance> tileDistances;
+    for(int y = 0; y <= distance; ++y)
+    {
+        for(int x = y; x <= distance; ++x)
+        {
+            TileDistance::TileDistanceType type;
+            if(y == 0)
+                type = TileDistance::TileDistanceType::Horizontal;
+            else if(x == y)
+                type = TileDistance::TileDistanceType::Diagonal;
+            else
+                type = TileDistance::TileDistanceType::Other;
+
+            tileDistances.push_back(ReferenceTileDistance(x, y, type, x * x + y * y));
+        }
+    }
+
+    std::sort(tileDistances.begin(), tileDistances.end(),
+        [](const ReferenceTileDistance& tileDist1, const ReferenceTileDistance& tileDist2)
+        {
+            return tileDist1.mDistSquared < tileDist2.mDistSquared;
+        });
+
+    for(ReferenceTileDistance& tileDistance : tileDistances)
+    {
+        if(tileDistance.mDiffX == 0 && tileDistance.mDiffY == 0)
+            continue;
+
+        double coefNorth = (static_cast<double>(tileDistance.mDiffY) + 0.5) / (static_cast<double>(tileDistance.mDiffX) - 0.5);
+        double coefSouth = (static_cast<double>(tileDistance.mDiffY) - 0.5) / (static_cast<double>(tileDistance.mDiffX) + 0.5);
+        for(uint32_t index = 0; index < tileDistances.size(); ++index)
+            tileDistance.computeTileDistances(coefNorth, coefSouth, tileDistances[index], index);
+    }
+
+    return tileDistances;
+}
+
+//! \brief Returns the offsets set in the hidden bitset of the given offset
+std::vector<uint32_t> getHiddenIndexes(const TileDistance& tileDistance)
+{
+    std::vector<uint32_t> indexes;
+    const std::vector<uint64_t>& words = tileDistance.getHiddenWords();
+    for(uint32_t index = 0; index < words.size() * 64; ++index)
+    {
+        if((words[index / 64] & (static_cast<uint64_t>(1) << (index % 64))) != 0)
+            indexes.push_back(tileDistance.getHiddenFirstWord() * 64 + index);
+    }
+
+    return indexes;
+}
+
+//! \brief The table keeps the tiles hidden by more than half of their surface in the bitset and the other
+//! ones in the partially hidden lists. Fills what the table should contain from the reference lists
+void splitReference(const HiddenTiles& reference, std::vector<uint32_t>& hidden, HiddenTiles& partial)
+{
+    for(const std::pair<uint32_t, double>& p : reference)
+    {
+        if(p.second > 0.5)
+            hidden.push_back(p.first);
+        else
+            partial.push_back(p);
+    }
+}
+
+void checkHiddenTiles(const HiddenTiles& expected, const HiddenTiles& hiddenTiles)
+{
+    BOOST_REQUIRE_EQUAL(expected.size(), hiddenTiles.size());
+    for(uint32_t i = 0; i < expected.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(expected[i].first, hiddenTiles[i].first);
+        BOOST_CHECK_SMALL(expected[i].second - hiddenTiles[i].second, 1e-9);
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_MatchesPreviousComputation)
+{
+    // Tables are shared: getTable only builds a new one for a bigger radius. Asking for increasing
+    // radiuses builds a table for each one
+    for(int radius = 0; radius <= MAX_RADIUS; ++radius)
+    {
+        std::shared_ptr<const TileDistanceTable> table = TileDistanceTable::getTable(radius);
+        BOOST_REQUIRE_EQUAL(table->getRadius(), radius);
+
+        std::vector<ReferenceTileDistance> reference = referenceBuildTileDistance(radius);
+        const std::vector<TileDistance>& tileDistances = table->getTileDistances();
+        BOOST_REQUIRE_EQUAL(reference.size(), tileDistances.size());
+        for(uint32_t index = 0; index < reference.size(); ++index)
+        {
+            const ReferenceTileDistance& expected = reference[index];
+            const TileDistance& tileDistance = tileDistances[index];
+            // The offsets are used by circularRegion and visibleTiles in this order
+            BOOST_REQUIRE_EQUAL(expected.mDiffX, tileDistance.getDiffX());
+            BOOST_REQUIRE_EQUAL(expected.mDiffY, tileDistance.getDiffY());
+            BOOST_REQUIRE_EQUAL(expected.mType, tileDistance.getType());
+            BOOST_REQUIRE_EQUAL(expected.mDistSquared, tileDistance.getDistSquared());
+
+            std::vector<uint32_t> expectedHidden;
+            HiddenTiles expectedNorth;
+            HiddenTiles expectedSouth;
+            splitReference(expected.mHiddenTilesNorth, expectedHidden, expectedNorth);
+            splitReference(expected.mHiddenTilesSouth, expectedHidden, expectedSouth);
+            std::sort(expectedHidden.begin(), expectedHidden.end());
+            expectedHidden.erase(std::unique(expectedHidden.begin(), expectedHidden.end()), expectedHidden.end());
+
+            std::vector<uint32_t> hidden = getHiddenIndexes(tileDistance);
+            BOOST_CHECK(expectedHidden == hidden);
+            checkHiddenTiles(expectedNorth, tileDistance.getHiddenTilesNorth());
+            checkHiddenTiles(expectedSouth, tileDistance.getHiddenTilesSouth());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_SmallerRadiusReusesTable)
+{
+    std::shared_ptr<const TileDistanceTable> table = TileDistanceTable::getTable(MAX_RADIUS);
+    BOOST_CHECK(TileDistanceTable::getTable(MAX_RADIUS / 2) == table);
+    BOOST_CHECK(TileDistanceTable::getTable(MAX_RADIUS + 1) != table);
+}
@@ -0,0 +1,225 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/VisionPlane.h"
+#include "utils/Random.h"
+
+#define BOOST_TEST_MODULE VisionPlane
+#include "BoostTestTargetConfig.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace
+{
+//! \brief Vision of a seat as it was stored before VisionPlane: a vision flag for the current and the
+//! last turn on each tile (see TileStateNotified)
+struct ReferenceSeat
+{
+    std::vector<std::vector<bool>> mVisionTurnLast;
+    std::vector<std::vector<bool>> mVisionTurnCurrent;
+    std::vector<uint32_t> mAlliedSeats;
+};
+
+//! \brief Same as Tile::notifyVision used to do: the vision is given to the seat and, recursively, to its allies
+void referenceNotifyVision(std::vector<ReferenceSeat>& seats, uint32_t seatIndex, int x, int y)
+{
+    ReferenceSeat& seat = seats[seatIndex];
+    if(seat.mVisionTurnCurrent[x][y])
+        return;
+
+    seat.mVisionTurnCurrent[x][y] = true;
+    for(uint32_t alliedSeat : seat.mAlliedSeats)
+        referenceNotifyVision(seats, alliedSeat, x, y);
+}
+
+typedef std::vector<std::pair<int, int>> Tiles;
+
+//! \brief Same loop as Seat::sendVisibleTiles used to do
+void referenceVisionChanges(const ReferenceSeat& seat, Tiles& gained, Tiles& lost)
+{
+    for(uint32_t x = 0; x < seat.mVisionTurnCurrent.size(); ++x)
+    {
+        for(uint32_t y = 0; y < seat.mVisionTurnCurrent[x].size(); ++y)
+        {
+            if(seat.mVisionTurnCurrent[x][y] == seat.mVisionTurnLast[x][y])
+                continue;
+
+            if(seat.mVisionTurnCurrent[x][y])
+                gained.push_back(std::make_pair(static_cast<int>(x), static_cast<int>(y)));
+            else
+                lost.push_back(std::make_pair(static_cast<int>(x), static_cast<int>(y)));
+        }
+    }
+}
+
+void checkSeats(const std::vector<ReferenceSeat>& refSeats, const std::vector<VisionPlane>& planesCurrent,
+    const std::vector<VisionPlane>& planesLast, int mapSizeX, int mapSizeY)
+{
+    for(uint32_t seatIndex = 0; seatIndex < refSeats.size(); ++seatIndex)
+    {
+        const ReferenceSeat& refSeat = refSeats[seatIndex];
+        const VisionPlane& current = planesCurrent[seatIndex];
+        Tiles tiles;
+        Tiles refTiles;
+        for(int x = 0; x < mapSizeX; ++x)
+        {
+            for(int y = 0; y < mapSizeY; ++y)
+            {
+                BOOST_CHECK(current.test(x, y) == refSeat.mVisionTurnCurrent[x][y]);
+                if(refSeat.mVisionTurnCurrent[x][y])
+                    refTiles.push_back(std::make_pair(x, y));
+            }
+        }
+        current.forEachTile([&tiles](int x, int y)
+            {
+                tiles.push_back(std::make_pair(x, y));
+            });
+        BOOST_CHECK(tiles == refTiles);
+
+        Tiles gained;
+        Tiles lost;
+        current.forEachDifference(planesLast[seatIndex], [&current, &gained, &lost](int x, int y)
+            {
+                if(current.test(x, y))
+                    gained.push_back(std::make_pair(x, y));
+                else
+                    lost.push_back(std::make_pair(x, y));
+            });
+        Tiles refGained;
+        Tiles refLost;
+        referenceVisionChanges(refSeat, refGained, refLost);
+        BOOST_CHECK(gained == refGained);
+        BOOST_CHECK(lost == refLost);
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(test_VisionPlaneBits)
+{
+    VisionPlane plane;
+    BOOST_CHECK(!plane.test(0, 0));
+
+    // 13 x 11 tiles do not fill the last word
+    plane.resize(13, 11);
+    BOOST_CHECK(plane.isInside(12, 10));
+    BOOST_CHECK(!plane.isInside(13, 0));
+    BOOST_CHECK(!plane.isInside(0, -1));
+    plane.set(0, 0);
+    plane.set(5, 9);
+    plane.set(12, 10);
+    BOOST_CHECK(plane.test(0, 0));
+    BOOST_CHECK(plane.test(5, 9));
+    BOOST_CHECK(plane.test(12, 10));
+    BOOST_CHECK(!plane.test(9, 5));
+    BOOST_CHECK(!plane.test(13, 10));
+
+    std::vector<std::pair<int, int>> tiles;
+    plane.forEachTile([&tiles](int x, int y)
+        {
+            tiles.push_back(std::make_pair(x, y));
+        });
+    BOOST_REQUIRE(tiles.size() == 3);
+    BOOST_CHECK(tiles[0] == std::make_pair(0, 0));
+    BOOST_CHECK(tiles[1] == std::make_pair(5, 9));
+    BOOST_CHECK(tiles[2] == std::make_pair(12, 10));
+
+    plane.clear();
+    tiles.clear();
+    plane.forEachTile([&tiles](int x, int y)
+        {
+            tiles.push_back(std::make_pair(x, y));
+        });
+    BOOST_CHECK(tiles.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_VisionPlaneRandomMaps)
+{
+    // Seeded so that the test always does the same thing
+    Random::initialize(42);
+    for(uint32_t nbMap = 0; nbMap < 20; ++nbMap)
+    {
+        int mapSizeX = Random::Int(1, 80);
+        int mapSizeY = Random::Int(1, 80);
+        uint32_t nbSeats = Random::Uint(1, 6);
+        uint32_t nbTeams = Random::Uint(1, nbSeats);
+        std::vector<uint32_t> teams;
+        for(uint32_t seatIndex = 0; seatIndex < nbSeats; ++seatIndex)
+            teams.push_back(Random::Uint(0, nbTeams - 1));
+
+        std::vector<ReferenceSeat> refSeats(nbSeats);
+        std::vector<VisionPlane> planesCurrent(nbSeats);
+        std::vector<VisionPlane> planesLast(nbSeats);
+        for(uint32_t seatIndex = 0; seatIndex < nbSeats; ++seatIndex)
+        {
+            ReferenceSeat& refSeat = refSeats[seatIndex];
+            refSeat.mVisionTurnCurrent.assign(mapSizeX, std::vector<bool>(mapSizeY, false));
+            refSeat.mVisionTurnLast.assign(mapSizeX, std::vector<bool>(mapSizeY, false));
+            for(uint32_t alliedIndex = 0; alliedIndex < nbSeats; ++alliedIndex)
+            {
+                if(alliedIndex == seatIndex)
+                    continue;
+                if(teams[alliedIndex] != teams[seatIndex])
+                    continue;
+
+                refSeat.mAlliedSeats.push_back(alliedIndex);
+            }
+            planesCurrent[seatIndex].resize(mapSizeX, mapSizeY);
+            planesLast[seatIndex].resize(mapSizeX, mapSizeY);
+        }
+
+        for(uint32_t turn = 0; turn < 5; ++turn)
+        {
+            // Same as Seat::clearTilesWithVision
+            for(uint32_t seatIndex = 0; seatIndex < nbSeats; ++seatIndex)
+            {
+                ReferenceSeat& refSeat = refSeats[seatIndex];
+                refSeat.mVisionTurnLast = refSeat.mVisionTurnCurrent;
+                refSeat.mVisionTurnCurrent.assign(mapSizeX, std::vector<bool>(mapSizeY, false));
+
+                planesLast[seatIndex].swap(planesCurrent[seatIndex]);
+                planesCurrent[seatIndex].clear();
+            }
+
+            // Each seat sees a few random areas
+            for(uint32_t seatIndex = 0; seatIndex < nbSeats; ++seatIndex)
+            {
+                uint32_t nbAreas = Random::Uint(0, 5);
+                for(uint32_t area = 0; area < nbAreas; ++area)
+                {
+                    int xStart = Random::Int(0, mapSizeX - 1);
+                    int yStart = Random::Int(0, mapSizeY - 1);
+                    int size = Random::Int(1, 10);
+                    for(int x = xStart; (x < xStart + size) && (x < mapSizeX); ++x)
+                    {
+                        for(int y = yStart; (y < yStart + size) && (y < mapSizeY); ++y)
+                        {
+                            // Same as Tile::notifyVision
+                            referenceNotifyVision(refSeats, seatIndex, x, y);
+                            planesCurrent[seatIndex].set(x, y);
+                            for(uint32_t alliedIndex : refSeats[seatIndex].mAlliedSeats)
+                                planesCurrent[alliedIndex].set(x, y);
+                        }
+                    }
+                }
+            }
+
+            checkSeats(refSeats, planesCurrent, planesLast, mapSizeX, mapSizeY);
+        }
+    }
+}
@@ -253,6 +253,9 @@ void Trap::activate(Tile* tile)
     trapTileData->setActivated(true);
     trapTileData->setNbShootsBeforeDeactivation(mNbShootsBeforeDeactivation);
     trapTileData->setReloadTime(0);
+    // Some traps (doors) can block creatures and vision only when activated
+    getGameMap()->notifyPathingChanged();
+    getGameMap()->notifyTileVisionChanged(tile);
 
     BuildingObject* entity = getBuildingObjectFromTile(tile);
     if (entity == nullptr)
@@ -268,6 +271,8 @@ void Trap::deactivate(Tile* tile)
 
     TrapTileData* trapTileData = static_cast<TrapTileData*>(mTileData[tile]);
     trapTileData->setActivated(false);
+    getGameMap()->notifyPathingChanged();
+    getGameMap()->notifyTileVisionChanged(tile);
 
     BuildingObject* entity = getBuildingObjectFromTile(tile);
     if (entity == nullptr)
@@ -276,9 +281,24 @@ void Trap::deactivate(Tile* tile)
     entity->setMeshOpacity(0.5f);
 }
 
+const std::vector<Tile*>& Trap::getVisibleTilesFromTile(Tile* tile, int radius)
+{
+    TrapTileData* trapTileData = static_cast<TrapTileData*>(mTileData[tile]);
+    GameMap* gameMap = getGameMap();
+    if((trapTileData->mVisibleTilesRadius != radius) ||
+       gameMap->hasVisionChangedInRange(tile->getX(), tile->getY(), radius, trapTileData->mVisibleTilesGeneration))
+    {
+        gameMap->visibleTiles(tile->getX(), tile->getY(), radius, trapTileData->mVisibleTiles);
+        trapTileData->mVisibleTilesRadius = radius;
+    }
+    trapTileData->mVisibleTilesGeneration = gameMap->getVisionGeneration();
+
+    return trapTileData->mVisibleTiles;
+}
+
 bool Trap::isActivated(Tile* tile) const
 {
-    std::map<Tile*, TileData*>::const_iterator it = mTileData.find(tile);
+    TileDataMap::const_iterator it = mTileData.find(tile);
     if (it == mTileData.end())
         return false;
 
@@ -463,31 +483,47 @@ void Trap::exportHeadersToStream(std::ostream& os) const
     os << getType() << "\t";
 }
 
-void Trap::exportTileDataToStream(std::ostream& os, Tile* tile, TileData* tileData) const
+void Trap::fillSaveRecord(BuildingSaveRecord& record) const
 {
-    TrapTileData* trapTileData = static_cast<TrapTileData*>(tileData);
-    os << "\t" << (trapTileData->isActivated() ? 1 : 0);
-    if(getGameMap()->isInEditorMode())
-        return;
+    Building::fillSaveRecord(record);
+    record.mTrapType = getType();
+}
 
-    os << "\t" << trapTileData->mHP;
-    os << "\t" << trapTileData->getReloadTime();
-    os << "\t" << trapTileData->getNbShootsBeforeDeactivation();
-    os << "\t" << trapTileData->mClaimedValue;
+void Trap::fillTileSaveRecord(Tile* tile, TileData* tileData, BuildingTileSaveRecord& record) const
+{
+    TrapTileData* trapTileData = static_cast<TrapTileData*>(tileData);
+    record.mIsActivated = trapTileData->isActivated();
+    record.mHP = trapTileData->mHP;
+    record.mReloadTime = trapTileData->getReloadTime();
+    record.mNbShootsBeforeDeactivation = trapTileData->getNbShootsBeforeDeactivation();
+    record.mClaimedValue = trapTileData->mClaimedValue;
 
     // We only save enemy seats that have vision on the building
-    std::vector<Seat*> seatsToSave;
+    record.mSeatsVision.clear();
     for(Seat* seat : trapTileData->mSeatsVision)
     {
         if(getSeat()->isAlliedSeat(seat))
             continue;
 
-        seatsToSave.push_back(seat);
+        record.mSeatsVision.push_back(seat->getId());
     }
-    uint32_t nbSeatsVision = seatsToSave.size();
+}
+
+void Trap::exportTileSaveRecordToStream(std::ostream& os, const BuildingTileSaveRecord& tile, bool isEditorMode)
+{
+    os << "\t" << (tile.mIsActivated ? 1 : 0);
+    if(isEditorMode)
+        return;
+
+    os << "\t" << tile.mHP;
+    os << "\t" << tile.mReloadTime;
+    os << "\t" << tile.mNbShootsBeforeDeactivation;
+    os << "\t" << tile.mClaimedValue;
+
+    uint32_t nbSeatsVision = tile.mSeatsVision.size();
     os << "\t" << nbSeatsVision;
-    for(Seat* seat : seatsToSave)
-        os << "\t" << seat->getId();
+    for(int seatId : tile.mSeatsVision)
+        os << "\t" << seatId;
 }
 
 bool Trap::importTileDataFromStream(std::istream& is, Tile* tile, TileData* tileData)
@@ -608,6 +644,7 @@ void Trap::claimForSeat(Seat* seat, Tile* tile, double danceRate)
     }
 
     trapTileData->mHP = 0.0;
+    getGameMap()->notifyBuildingsChanged();
     tile->claimTile(seat);
 }
 
@@ -40,12 +40,17 @@ enum class TrapType;
 
 
 //! \brief A small class telling whether a trap tile is activated.
-class TrapTileData : public TileData
+class TrapTileData : public TileData, public PooledObject<TrapTileData>
 {
 public:
+    using PooledObject<TrapTileData>::operator new;
+    using PooledObject<TrapTileData>::operator delete;
+
     TrapTileData() :
         TileData(),
         mClaimedValue(1.0),
+        mVisibleTilesRadius(-1),
+        mVisibleTilesGeneration(0),
         mIsActivated(false),
         mReloadTime(0),
         mCraftedTrap(nullptr),
@@ -57,6 +62,8 @@ public:
 
     TrapTileData(const TrapTileData* trapTileData) :
         TileData(trapTileData),
+        mVisibleTilesRadius(-1),
+        mVisibleTilesGeneration(0),
         mIsActivated(trapTileData->mIsActivated),
         mReloadTime(trapTileData->mReloadTime),
         mCraftedTrap(trapTileData->mCraftedTrap),
@@ -146,6 +153,12 @@ public:
 
     double mClaimedValue;
 
+    //! \brief Tiles visible from this trap tile (see Trap::getVisibleTilesFromTile). As traps never move,
+    //! they are only recomputed when the vision of a tile in range changes
+    std::vector<Tile*> mVisibleTiles;
+    int mVisibleTilesRadius;
+    uint32_t mVisibleTilesGeneration;
+
 private:
     bool mIsActivated;
     uint32_t mReloadTime;
@@ -212,13 +225,18 @@ public:
 
     static bool sortForMapSave(Trap* t1, Trap* t2);
 
+    virtual void fillSaveRecord(BuildingSaveRecord& record) const override;
+
+    //! \brief Writes the data of a trap tile after its coordinates (see BuildingSaveRecord::exportToStream)
+    static void exportTileSaveRecordToStream(std::ostream& os, const BuildingTileSaveRecord& tile, bool isEditorMode);
+
     static bool importTrapFromStream(Trap& trap, std::istream& is);
 
 protected:
     static void fireTrapSound(Tile& tile, const std::string& soundFamily);
 
     virtual void exportHeadersToStream(std::ostream& os) const override;
-    virtual void exportTileDataToStream(std::ostream& os, Tile* tile, TileData* tileData) const override;
+    virtual void fillTileSaveRecord(Tile* tile, TileData* tileData, BuildingTileSaveRecord& record) const override;
     virtual bool importTileDataFromStream(std::istream& is, Tile* tile, TileData* tileData) override;
 
     virtual TrapTileData* createTileData(Tile* tile) override;
@@ -227,6 +245,10 @@ protected:
     virtual TrapEntity* getTrapEntity(Tile* tile) = 0;
     virtual void notifyActiveSpotRemoved(Tile* tile);
 
+    //! \brief Returns the tiles visible from the given covered tile within radius. The result is cached
+    //! in the tile data and recomputed only if a tile in range changed its vision since the last call
+    const std::vector<Tile*>& getVisibleTilesFromTile(Tile* tile, int radius);
+
     //! \brief Triggered when the trap is activated
     void activate(Tile* tile);
 
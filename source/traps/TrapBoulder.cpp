@@ -46,7 +46,7 @@ class TrapBoulderFactory : public TrapFactory
     { return TrapBoulderNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getTrapConfigInt32("BoulderCostPerTile"); }
+    { return ConfigManager::getSingleton().getTrapConfigInt32(TrapConfig::BoulderCostPerTile); }
 
     const std::string& getMeshName() const override
     {
@@ -114,10 +114,10 @@ static TrapRegister reg(new TrapBoulderFactory);
 TrapBoulder::TrapBoulder(GameMap* gameMap) :
     Trap(gameMap)
 {
-    mReloadTime = ConfigManager::getSingleton().getTrapConfigUInt32("BoulderReloadTurns");
-    mMinDamage = ConfigManager::getSingleton().getTrapConfigDouble("BoulderDamagePerHitMin");
-    mMaxDamage = ConfigManager::getSingleton().getTrapConfigDouble("BoulderDamagePerHitMax");
-    mNbShootsBeforeDeactivation = ConfigManager::getSingleton().getTrapConfigUInt32("BoulderNbShootsBeforeDeactivation");
+    mReloadTime = ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfig::BoulderReloadTurns);
+    mMinDamage = ConfigManager::getSingleton().getTrapConfigDouble(TrapConfig::BoulderDamagePerHitMin);
+    mMaxDamage = ConfigManager::getSingleton().getTrapConfigDouble(TrapConfig::BoulderDamagePerHitMax);
+    mNbShootsBeforeDeactivation = ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfig::BoulderNbShootsBeforeDeactivation);
     setMeshName("");
 }
 
@@ -150,7 +150,7 @@ bool TrapBoulder::shoot(Tile* tile)
     position.z = 0;
     direction.normalise();
     MissileBoulder* missile = new MissileBoulder(getGameMap(), getSeat(), getName(), "Boulder",
-        direction, ConfigManager::getSingleton().getTrapConfigDouble("BoulderSpeed"),
+        direction, ConfigManager::getSingleton().getTrapConfigDouble(TrapConfig::BoulderSpeed),
         Random::Double(mMinDamage, mMaxDamage), nullptr, true);
     missile->addToGameMap();
     missile->createMesh();
@@ -47,7 +47,7 @@ class TrapCannonFactory : public TrapFactory
     { return TrapCannonNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getTrapConfigInt32("CannonCostPerTile"); }
+    { return ConfigManager::getSingleton().getTrapConfigInt32(TrapConfig::CannonCostPerTile); }
 
     const std::string& getMeshName() const override
     {
@@ -118,17 +118,17 @@ TrapCannon::TrapCannon(GameMap* gameMap) :
     Trap(gameMap),
     mRange(0)
 {
-    mReloadTime = ConfigManager::getSingleton().getTrapConfigUInt32("CannonReloadTurns");
-    mRange = ConfigManager::getSingleton().getTrapConfigUInt32("CannonRange");
-    mMinDamage = ConfigManager::getSingleton().getTrapConfigDouble("CannonDamagePerHitMin");
-    mMaxDamage = ConfigManager::getSingleton().getTrapConfigDouble("CannonDamagePerHitMax");
-    mNbShootsBeforeDeactivation = ConfigManager::getSingleton().getTrapConfigUInt32("CannonNbShootsBeforeDeactivation");
+    mReloadTime = ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfig::CannonReloadTurns);
+    mRange = ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfig::CannonRange);
+    mMinDamage = ConfigManager::getSingleton().getTrapConfigDouble(TrapConfig::CannonDamagePerHitMin);
+    mMaxDamage = ConfigManager::getSingleton().getTrapConfigDouble(TrapConfig::CannonDamagePerHitMax);
+    mNbShootsBeforeDeactivation = ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfig::CannonNbShootsBeforeDeactivation);
     setMeshName("");
 }
 
 bool TrapCannon::shoot(Tile* tile)
 {
-    std::vector<Tile*> visibleTiles = getGameMap()->visibleTiles(tile->getX(), tile->getY(), mRange);
+    const std::vector<Tile*>& visibleTiles = getVisibleTilesFromTile(tile, mRange);
     std::vector<GameEntity*> enemyObjects = getGameMap()->getVisibleCreatures(visibleTiles, getSeat(), true);
 
     if(enemyObjects.empty())
@@ -149,7 +149,7 @@ bool TrapCannon::shoot(Tile* tile)
     direction = direction - position;
     direction.normalise();
     MissileOneHit* missile = new MissileOneHit(getGameMap(), getSeat(), getName(), "Cannonball",
-        "", direction, ConfigManager::getSingleton().getTrapConfigDouble("CannonSpeed"),
+        "", direction, ConfigManager::getSingleton().getTrapConfigDouble(TrapConfig::CannonSpeed),
         Random::Double(mMinDamage, mMaxDamage), 0.0, 0.0, nullptr, false, false, true);
     missile->addToGameMap();
     missile->createMesh();
@@ -171,15 +171,15 @@ TrapEntity* TrapCannon::getTrapEntity(Tile* tile)
 
 double TrapCannon::getPhysicalDefense() const
 {
-    return ConfigManager::getSingleton().getTrapConfigUInt32("CannonPhyDef");
+    return ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfig::CannonPhyDef);
 }
 
 double TrapCannon::getMagicalDefense() const
 {
-    return ConfigManager::getSingleton().getTrapConfigUInt32("CannonMagDef");
+    return ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfig::CannonMagDef);
 }
 
 double TrapCannon::getElementDefense() const
 {
-    return ConfigManager::getSingleton().getTrapConfigUInt32("CannonEleDef");
+    return ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfig::CannonEleDef);
 }
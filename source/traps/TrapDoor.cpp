@@ -54,7 +54,7 @@ class TrapDoorFactory : public TrapFactory
     { return TrapDoorNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getTrapConfigInt32("WoodenDoorCostPerTile"); }
+    { return ConfigManager::getSingleton().getTrapConfigInt32(TrapConfig::WoodenDoorCostPerTile); }
 
     const std::string& getMeshName() const override
     {
@@ -324,6 +324,7 @@ void TrapDoor::doUpkeep()
 
             TrapTileData* trapTileData = static_cast<TrapTileData*>(it->second);
             trapTileData->mHP = 0.0;
+            getGameMap()->notifyBuildingsChanged();
         }
 
         // We need to look for destroyed door before calling Trap::doUpkeep otherwise, they will be removed
@@ -444,10 +445,8 @@ double TrapDoor::getCreatureSpeed(const Creature* creature, Tile* tile) const
     return tile->getCreatureSpeedDefault(creature);
 }
 
-void TrapDoor::exportToStream(std::ostream& os) const
+void TrapDoor::exportSpecificDataToStream(std::ostream& os) const
 {
-    Trap::exportToStream(os);
-
     os << mIsLocked << "\n";
 }
 
@@ -68,7 +68,7 @@ public:
     static const TrapType mTrapType;
 
 protected:
-    void exportToStream(std::ostream& os) const override;
+    void exportSpecificDataToStream(std::ostream& os) const override;
     bool importFromStream(std::istream& is) override;
 
 private:
@@ -0,0 +1,34 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALLOCATIONCOUNTER_H_
+#define ALLOCATIONCOUNTER_H_
+
+#include <cstdint>
+
+//! \brief The global operator new and delete are only replaced when the game is built with
+//! OD_COUNT_ALLOCATIONS (cmake option of the same name). Otherwise, nothing is counted
+namespace AllocationCounter
+{
+    //! \brief Returns true if the allocations are counted
+    bool isEnabled();
+
+    //! \brief Returns the number of calls to the global operator new since the start
+    uint64_t getNbAllocations();
+}
+
+#endif // ALLOCATIONCOUNTER_H_
@@ -0,0 +1,359 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/ConfigCache.h"
+
+#include "utils/LogManager.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    //! \brief Identifies the cache files. VERSION must be increased whenever the format changes
+    const std::string CACHE_MAGIC = "ODConfigCache";
+    const uint32_t CACHE_VERSION = 1;
+
+    template<typename T>
+    void writeValue(std::ostream& os, T value)
+    {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void writeString(std::ostream& os, const std::string& str)
+    {
+        writeValue<uint64_t>(os, str.size());
+        os.write(str.data(), str.size());
+    }
+
+    //! \brief Reads the values written by writeValue and writeString from the cache file content
+    class CacheReader
+    {
+    public:
+        CacheReader(const std::string& data) :
+            mData(data),
+            mPos(0)
+        {}
+
+        template<typename T>
+        bool readValue(T& value)
+        {
+            if(mData.size() - mPos < sizeof(value))
+                return false;
+
+            std::memcpy(&value, mData.data() + mPos, sizeof(value));
+            mPos += sizeof(value);
+            return true;
+        }
+
+        bool readString(std::string& str)
+        {
+            uint64_t size;
+            if(!readValue(size))
+                return false;
+
+            // We check the size against the remaining data to not allocate garbage from a corrupted cache
+            if(mData.size() - mPos < size)
+                return false;
+
+            str.assign(mData, mPos, size);
+            mPos += size;
+            return true;
+        }
+
+    private:
+        const std::string& mData;
+        std::size_t mPos;
+    };
+
+    //! \brief Removes the comments the same way Helper::readFileWithoutComments does
+    void stripComments(const std::string& rawContent, std::string& content)
+    {
+        std::istringstream is(rawContent);
+        std::ostringstream os;
+        std::string line;
+        while(is.good())
+        {
+            std::getline(is, line);
+            os << line.substr(0, line.find('#')) << "\n";
+        }
+        content = os.str();
+    }
+}
+
+ConfigCache::ConfigCache(const std::string& cacheFileName, bool rebuild) :
+    mCacheFileName(cacheFileName),
+    mRebuild(rebuild),
+    mModified(false),
+    mNbHits(0),
+    mNbMisses(0)
+{
+}
+
+bool ConfigCache::load()
+{
+    mEntries.clear();
+    if(mRebuild)
+    {
+        OD_LOG_INF("Rebuilding config cache " + mCacheFileName);
+        return false;
+    }
+
+    std::ifstream file(mCacheFileName.c_str(), std::ios::in | std::ios::binary);
+    if(!file.good())
+    {
+        OD_LOG_INF("No config cache found at " + mCacheFileName);
+        return false;
+    }
+
+    // The cache is read at once and parsed from memory
+    std::stringstream dataStream;
+    dataStream << file.rdbuf();
+    std::string data = dataStream.str();
+    CacheReader reader(data);
+
+    std::string magic;
+    uint32_t version = 0;
+    uint32_t nbEntries = 0;
+    if(!reader.readString(magic) || (magic != CACHE_MAGIC) ||
+       !reader.readValue(version) || (version != CACHE_VERSION) ||
+       !reader.readValue(nbEntries))
+    {
+        OD_LOG_INF("Ignoring config cache with unknown format " + mCacheFileName);
+        return false;
+    }
+
+    for(uint32_t i = 0; i < nbEntries; ++i)
+    {
+        std::string fileName;
+        Entry entry;
+        uint8_t hasKeyValues = 0;
+        uint32_t nbKeyValues = 0;
+        if(!reader.readString(fileName) ||
+           !reader.readValue(entry.mModificationTime) ||
+           !reader.readValue(entry.mFileSize) ||
+           !reader.readValue(entry.mHash) ||
+           !reader.readString(entry.mContent) ||
+           !reader.readValue(hasKeyValues) ||
+           !reader.readValue(nbKeyValues))
+        {
+            OD_LOG_WRN("Corrupted config cache " + mCacheFileName);
+            mEntries.clear();
+            return false;
+        }
+
+        entry.mHasKeyValues = (hasKeyValues != 0);
+        entry.mKeyValues.resize(nbKeyValues);
+        for(std::pair<std::string, std::string>& keyValue : entry.mKeyValues)
+        {
+            if(!reader.readString(keyValue.first) || !reader.readString(keyValue.second))
+            {
+                OD_LOG_WRN("Corrupted config cache " + mCacheFileName);
+                mEntries.clear();
+                return false;
+            }
+        }
+
+        mEntries[fileName] = std::move(entry);
+    }
+
+    return true;
+}
+
+bool ConfigCache::save()
+{
+    // Files not read anymore (removed, renamed or from another config path) are pruned
+    for(auto it = mEntries.begin(); it != mEntries.end();)
+    {
+        if(it->second.mIsUsed)
+        {
+            ++it;
+            continue;
+        }
+
+        OD_LOG_INF("Removing stale config cache entry " + it->first);
+        it = mEntries.erase(it);
+        mModified = true;
+    }
+
+    if(!mModified)
+        return true;
+
+    // We write in a temporary file and rename it so that a server starting at the same time never
+    // reads a partially written cache. The temporary name is unique so that processes saving at the
+    // same time do not write in the same file
+    std::string tmpFileName = mCacheFileName + boost::filesystem::unique_path(".%%%%-%%%%-%%%%.tmp").string();
+    {
+        std::ofstream os(tmpFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!os.good())
+        {
+            OD_LOG_WRN("Couldn't open config cache for writing: " + tmpFileName);
+            return false;
+        }
+
+        writeString(os, CACHE_MAGIC);
+        writeValue<uint32_t>(os, CACHE_VERSION);
+        writeValue<uint32_t>(os, mEntries.size());
+        for(const std::pair<const std::string, Entry>& p : mEntries)
+        {
+            const Entry& entry = p.second;
+            writeString(os, p.first);
+            writeValue(os, entry.mModificationTime);
+            writeValue(os, entry.mFileSize);
+            writeValue(os, entry.mHash);
+            writeString(os, entry.mContent);
+            writeValue<uint8_t>(os, entry.mHasKeyValues ? 1 : 0);
+            writeValue<uint32_t>(os, entry.mKeyValues.size());
+            for(const std::pair<std::string, std::string>& keyValue : entry.mKeyValues)
+            {
+                writeString(os, keyValue.first);
+                writeString(os, keyValue.second);
+            }
+        }
+
+        if(!os.good())
+        {
+            OD_LOG_WRN("Couldn't write config cache: " + tmpFileName);
+            return false;
+        }
+    }
+
+    try
+    {
+        boost::filesystem::rename(tmpFileName, mCacheFileName);
+    }
+    catch(const boost::filesystem::filesystem_error& e)
+    {
+        OD_LOG_WRN("Couldn't save config cache " + mCacheFileName + ": " + e.what());
+        boost::system::error_code ec;
+        boost::filesystem::remove(tmpFileName, ec);
+        return false;
+    }
+
+    mModified = false;
+    return true;
+}
+
+ConfigCache::Entry* ConfigCache::getEntry(const std::string& fileName)
+{
+    int64_t modificationTime;
+    uint64_t fileSize;
+    try
+    {
+        boost::filesystem::path path(fileName);
+        modificationTime = static_cast<int64_t>(boost::filesystem::last_write_time(path));
+        fileSize = static_cast<uint64_t>(boost::filesystem::file_size(path));
+    }
+    catch(const boost::filesystem::filesystem_error&)
+    {
+        OD_LOG_WRN("File not found=" + fileName);
+        return nullptr;
+    }
+
+    auto it = mEntries.find(fileName);
+    if((it != mEntries.end()) &&
+       (it->second.mModificationTime == modificationTime) &&
+       (it->second.mFileSize == fileSize))
+    {
+        if(!it->second.mIsUsed)
+        {
+            it->second.mIsUsed = true;
+            ++mNbHits;
+        }
+        return &it->second;
+    }
+
+    std::ifstream file(fileName.c_str(), std::ifstream::in);
+    if(!file.good())
+    {
+        OD_LOG_WRN("File not found=" + fileName);
+        return nullptr;
+    }
+    std::stringstream rawStream;
+    rawStream << file.rdbuf();
+    std::string rawContent = rawStream.str();
+    uint64_t hash = computeHash(rawContent);
+
+    mModified = true;
+    if((it != mEntries.end()) &&
+       (it->second.mFileSize == fileSize) &&
+       (it->second.mHash == hash))
+    {
+        // Only the modification time changed
+        it->second.mModificationTime = modificationTime;
+        if(!it->second.mIsUsed)
+        {
+            it->second.mIsUsed = true;
+            ++mNbHits;
+        }
+        return &it->second;
+    }
+
+    Entry& entry = mEntries[fileName];
+    entry = Entry();
+    entry.mModificationTime = modificationTime;
+    entry.mFileSize = fileSize;
+    entry.mHash = hash;
+    entry.mIsUsed = true;
+    stripComments(rawContent, entry.mContent);
+    ++mNbMisses;
+    return &entry;
+}
+
+bool ConfigCache::readFileWithoutComments(const std::string& fileName, std::stringstream& stream)
+{
+    const Entry* entry = getEntry(fileName);
+    if(entry == nullptr)
+        return false;
+
+    stream << entry->mContent;
+    return true;
+}
+
+bool ConfigCache::getKeyValues(const std::string& fileName, std::vector<std::pair<std::string, std::string>>& values)
+{
+    const Entry* entry = getEntry(fileName);
+    if((entry == nullptr) || !entry->mHasKeyValues)
+        return false;
+
+    values = entry->mKeyValues;
+    return true;
+}
+
+void ConfigCache::setKeyValues(const std::string& fileName, const std::vector<std::pair<std::string, std::string>>& values)
+{
+    Entry* entry = getEntry(fileName);
+    if(entry == nullptr)
+        return;
+
+    entry->mHasKeyValues = true;
+    entry->mKeyValues = values;
+    mModified = true;
+}
+
+uint64_t ConfigCache::computeHash(const std::string& data)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for(char c : data)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
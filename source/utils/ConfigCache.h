@@ -0,0 +1,104 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONFIGCACHE_H
+#define CONFIGCACHE_H
+
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//! \brief Binary cache of the configuration files read by ConfigManager. Each cached file is keyed by its
+//! modification time, its size and a hash of its content. As long as a file does not change, its comment
+//! stripped content is read back from the cache instead of the file. For the files made of key/value pairs
+//! (rooms, traps, spells and skills), the values themselves are restored without parsing the file.
+//! The definition objects (creatures, equipments, spawn conditions, factions, tilesets) are not cached: they are
+//! built from the cached content at each start because their skills, behaviours, moods and spawn conditions
+//! only have text loaders.
+//! Files whose content only changed in time (checkout, copy) are detected by comparing the hash and kept.
+//! Entries for files not read since the cache was loaded (removed or renamed files) are dropped when saving.
+class ConfigCache
+{
+public:
+    //! \brief Creates a cache stored in the given file. If rebuild is true, the existing cache is ignored
+    //! and fully rewritten by save()
+    ConfigCache(const std::string& cacheFileName, bool rebuild);
+
+    //! \brief Reads the cache file. Returns false if the cache cannot be used (missing, other version, corrupted
+    //! or rebuild requested). In this case, every file will be read from its source.
+    bool load();
+
+    //! \brief Drops the entries of the files not read since the cache was loaded, then writes the cache file
+    //! if any entry was added, refreshed or dropped.
+    bool save();
+
+    //! \brief Number of files read from the cache (hits) and from their source (misses) since the cache was loaded
+    inline uint32_t getNbHits() const
+    { return mNbHits; }
+
+    inline uint32_t getNbMisses() const
+    { return mNbMisses; }
+
+    //! \brief Same as Helper::readFileWithoutComments but reads the content from the cache when the file did
+    //! not change and stores it otherwise.
+    bool readFileWithoutComments(const std::string& fileName, std::stringstream& stream);
+
+    //! \brief Fills values with the key/value pairs cached for the given file. Returns false if the file
+    //! changed since they were stored or if they were never stored. In that case, the file should be parsed
+    //! (with readFileWithoutComments) and the values stored with setKeyValues
+    bool getKeyValues(const std::string& fileName, std::vector<std::pair<std::string, std::string>>& values);
+    void setKeyValues(const std::string& fileName, const std::vector<std::pair<std::string, std::string>>& values);
+
+    //! \brief Computes the hash used to identify a file content (64 bits FNV-1a)
+    static uint64_t computeHash(const std::string& data);
+
+private:
+    struct Entry
+    {
+        Entry() :
+            mModificationTime(0),
+            mFileSize(0),
+            mHash(0),
+            mHasKeyValues(false),
+            mIsUsed(false)
+        {}
+
+        int64_t mModificationTime;
+        uint64_t mFileSize;
+        uint64_t mHash;
+        std::string mContent;
+        bool mHasKeyValues;
+        std::vector<std::pair<std::string, std::string>> mKeyValues;
+        //! \brief True if the file was read since the cache was loaded. Not saved
+        bool mIsUsed;
+    };
+
+    //! \brief Returns the entry for the given file. If the file changed since it was cached, the entry is
+    //! refreshed from the file (and its key/values dropped). Returns nullptr if the file cannot be read
+    Entry* getEntry(const std::string& fileName);
+
+    std::string mCacheFileName;
+    bool mRebuild;
+    bool mModified;
+    uint32_t mNbHits;
+    uint32_t mNbMisses;
+    std::map<std::string, Entry> mEntries;
+};
+
+#endif // CONFIGCACHE_H
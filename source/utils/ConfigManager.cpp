@@ -21,13 +21,18 @@
 #include "entities/Tile.h"
 #include "entities/Weapon.h"
 #include "game/Skill.h"
+#include "gamemap/TileDistanceTable.h"
 #include "gamemap/TileSet.h"
 #include "spawnconditions/SpawnCondition.h"
+#include "utils/ConfigCache.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
 #include <boost/dynamic_bitset.hpp>
 #include <OgreRoot.h>
+#include <SFML/System/Clock.hpp>
+
+#include <algorithm>
 
 const std::vector<std::string> EMPTY_SPAWNPOOL;
 const std::string EMPTY_STRING;
@@ -41,7 +46,7 @@ const std::string ConfigManager::DefaultWorkerCreatureDefinition = "DefaultWorke
 template<> ConfigManager* Ogre::Singleton<ConfigManager>::msSingleton = nullptr;
 
 ConfigManager::ConfigManager(const std::string& configPath, const std::string& userConfigPath,
-        const std::string& soundPath) :
+        const std::string& soundPath, const std::string& configCacheFile, bool rebuildConfigCache) :
     mNetworkPort(0),
     mClientConnectionTimeout(5000),
     mBaseSpawnPoint(10),
@@ -70,65 +75,112 @@ ConfigManager::ConfigManager(const std::string& configPath, const std::string& u
     // TODO: it might be better to go through the creature definitions and try to pickup the first worker we can find
     mCreatureDefinitionDefaultWorker = new CreatureDefinition(DefaultWorkerCreatureDefinition,
         CreatureDefinition::CreatureJob::Worker, "Kobold.mesh");
+
+    // Time spent in each config file is logged to compare starts with and without the config cache
+    sf::Clock totalClock;
+    sf::Clock sectionClock;
+    std::string loadTimes;
+    auto addLoadTime = [&](const std::string& section)
+    {
+        loadTimes += " " + section + "=" + Helper::toString(sectionClock.restart().asMilliseconds()) + "ms";
+    };
+
+    if(!configCacheFile.empty())
+    {
+        mConfigCache.reset(new ConfigCache(configCacheFile, rebuildConfigCache));
+        mConfigCache->load();
+    }
+    addLoadTime("cacheLoad");
+
     if(!loadGlobalConfig(configPath))
     {
         OD_LOG_ERR("Couldn't read loadCreatureDefinitions");
         exit(1);
     }
+    addLoadTime("global");
     std::string fileName = configPath + mFilenameCreatureDefinition;
     if(!loadCreatureDefinitions(fileName))
     {
         OD_LOG_ERR("Couldn't read loadCreatureDefinitions");
         exit(1);
     }
+    addLoadTime("creatures");
     fileName = configPath + mFilenameEquipmentDefinition;
     if(!loadEquipements(fileName))
     {
         OD_LOG_ERR("Couldn't read loadEquipements");
         exit(1);
     }
+    addLoadTime("equipments");
     fileName = configPath + mFilenameSpawnConditions;
     if(!loadSpawnConditions(fileName))
     {
         OD_LOG_ERR("Couldn't read loadSpawnConditions");
         exit(1);
     }
+    addLoadTime("spawnConditions");
     fileName = configPath + mFilenameFactions;
     if(!loadFactions(fileName))
     {
         OD_LOG_ERR("Couldn't read loadFactions");
         exit(1);
     }
+    addLoadTime("factions");
     fileName = configPath + mFilenameRooms;
     if(!loadRooms(fileName))
     {
         OD_LOG_ERR("Couldn't read loadRooms");
         exit(1);
     }
+    addLoadTime("rooms");
     fileName = configPath + mFilenameTraps;
     if(!loadTraps(fileName))
     {
         OD_LOG_ERR("Couldn't read loadTraps");
         exit(1);
     }
+    addLoadTime("traps");
     fileName = configPath + mFilenameSpells;
     if(!loadSpellConfig(fileName))
     {
         OD_LOG_ERR("Couldn't read loadSpellConfig");
         exit(1);
     }
+    addLoadTime("spells");
     fileName = configPath + mFilenameSkills;
     if(!loadSkills(fileName))
     {
         OD_LOG_ERR("Couldn't read loadSkills");
         exit(1);
     }
+    addLoadTime("skills");
     fileName = configPath + mFilenameTilesets;
     if(!loadTilesets(fileName))
     {
         OD_LOG_ERR("Couldn't read loadTilesets");
         exit(1);
     }
+    addLoadTime("tilesets");
+
+    std::string cacheState = "no config cache";
+    if(mConfigCache != nullptr)
+    {
+        cacheState = Helper::toString(mConfigCache->getNbHits()) + " files from the config cache, "
+            + Helper::toString(mConfigCache->getNbMisses()) + " files parsed";
+        mConfigCache->save();
+        mConfigCache.reset();
+        addLoadTime("cacheSave");
+    }
+    OD_LOG_INF("Config loaded in " + Helper::toString(totalClock.getElapsedTime().asMilliseconds()) + "ms ("
+        + cacheState + "):" + loadTimes);
+
+    // Computing the tile distance table is expensive. We build it at startup for the biggest radius used
+    // by the config so that it does not have to be done while a game is running
+    int maxTileDistance = static_cast<int>(getTrapConfigUInt32(TrapConfig::CannonRange));
+    for(const std::pair<const std::string, CreatureDefinition*>& p : mCreatureDefs)
+        maxTileDistance = std::max(maxTileDistance, p.second->getSightRadius());
+
+    TileDistanceTable::getTable(maxTileDistance);
 
     // Reserve space in any case.
     mUserConfig.resize(Config::Ctg::TOTAL);
@@ -175,7 +227,7 @@ bool ConfigManager::loadGlobalConfig(const std::string& configPath)
 {
     std::stringstream configFile;
     std::string fileName = configPath + "global.cfg";
-    if(!Helper::readFileWithoutComments(fileName, configFile))
+    if(!readConfigFile(fileName, configFile))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -625,7 +677,7 @@ bool ConfigManager::loadCreatureDefinitions(const std::string& fileName)
 {
     OD_LOG_INF("Load creature definition file: " + fileName);
     std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    if(!readConfigFile(fileName, defFile))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -675,7 +727,7 @@ bool ConfigManager::loadEquipements(const std::string& fileName)
 {
     OD_LOG_INF("Load weapon definition file: " + fileName);
     std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    if(!readConfigFile(fileName, defFile))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -724,7 +776,7 @@ bool ConfigManager::loadSpawnConditions(const std::string& fileName)
 {
     OD_LOG_INF("Load creature spawn conditions file: " + fileName);
     std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    if(!readConfigFile(fileName, defFile))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -810,7 +862,7 @@ bool ConfigManager::loadFactions(const std::string& fileName)
 {
     OD_LOG_INF("Load factions file: " + fileName);
     std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    if(!readConfigFile(fileName, defFile))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -920,8 +972,13 @@ bool ConfigManager::loadFactions(const std::string& fileName)
 bool ConfigManager::loadRooms(const std::string& fileName)
 {
     OD_LOG_INF("Load Rooms file: " + fileName);
+    std::map<const std::string, std::string> values;
+    if(getCachedKeyValues(fileName, values))
+        return setConfigParams(fileName, values, ConfigParams::getRoomDefinitions(),
+            static_cast<uint32_t>(RoomConfig::nbParams), mRoomsConfig);
+
     std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    if(!readConfigFile(fileName, defFile))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -944,17 +1001,24 @@ bool ConfigManager::loadRooms(const std::string& fileName)
         if (nextParam == "[/Rooms]")
             break;
 
-        defFile >> mRoomsConfig[nextParam];
+        defFile >> values[nextParam];
     }
 
-    return true;
+    cacheKeyValues(fileName, values);
+    return setConfigParams(fileName, values, ConfigParams::getRoomDefinitions(),
+        static_cast<uint32_t>(RoomConfig::nbParams), mRoomsConfig);
 }
 
 bool ConfigManager::loadTraps(const std::string& fileName)
 {
     OD_LOG_INF("Load traps file: " + fileName);
+    std::map<const std::string, std::string> values;
+    if(getCachedKeyValues(fileName, values))
+        return setConfigParams(fileName, values, ConfigParams::getTrapDefinitions(),
+            static_cast<uint32_t>(TrapConfig::nbParams), mTrapsConfig);
+
     std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    if(!readConfigFile(fileName, defFile))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -977,17 +1041,24 @@ bool ConfigManager::loadTraps(const std::string& fileName)
         if (nextParam == "[/Traps]")
             break;
 
-        defFile >> mTrapsConfig[nextParam];
+        defFile >> values[nextParam];
     }
 
-    return true;
+    cacheKeyValues(fileName, values);
+    return setConfigParams(fileName, values, ConfigParams::getTrapDefinitions(),
+        static_cast<uint32_t>(TrapConfig::nbParams), mTrapsConfig);
 }
 
 bool ConfigManager::loadSpellConfig(const std::string& fileName)
 {
     OD_LOG_INF("Load Spell config file: " + fileName);
+    std::map<const std::string, std::string> values;
+    if(getCachedKeyValues(fileName, values))
+        return setConfigParams(fileName, values, ConfigParams::getSpellDefinitions(),
+            static_cast<uint32_t>(SpellConfig::nbParams), mSpellConfig);
+
     std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    if(!readConfigFile(fileName, defFile))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -1010,17 +1081,28 @@ bool ConfigManager::loadSpellConfig(const std::string& fileName)
         if (nextParam == "[/Spells]")
             break;
 
-        defFile >> mSpellConfig[nextParam];
+        defFile >> values[nextParam];
     }
 
-    return true;
+    cacheKeyValues(fileName, values);
+    return setConfigParams(fileName, values, ConfigParams::getSpellDefinitions(),
+        static_cast<uint32_t>(SpellConfig::nbParams), mSpellConfig);
 }
 
 bool ConfigManager::loadSkills(const std::string& fileName)
 {
     OD_LOG_INF("Load Skills file: " + fileName);
+    std::map<const std::string, std::string> cachedSkillPoints;
+    if(getCachedKeyValues(fileName, cachedSkillPoints))
+    {
+        for(const std::pair<const std::string, std::string>& p : cachedSkillPoints)
+            mSkillPoints[p.first] = Helper::toInt(p.second);
+
+        return true;
+    }
+
     std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    if(!readConfigFile(fileName, defFile))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -1045,14 +1127,114 @@ bool ConfigManager::loadSkills(const std::string& fileName)
 
         defFile >> mSkillPoints[nextParam];
     }
+
+    std::map<const std::string, std::string> skillPoints;
+    for(const std::pair<const std::string, int32_t>& p : mSkillPoints)
+        skillPoints[p.first] = Helper::toString(p.second);
+
+    cacheKeyValues(fileName, skillPoints);
+    return true;
+}
+
+bool ConfigManager::readConfigFile(const std::string& fileName, std::stringstream& stream)
+{
+    if(mConfigCache == nullptr)
+        return Helper::readFileWithoutComments(fileName, stream);
+
+    return mConfigCache->readFileWithoutComments(fileName, stream);
+}
+
+bool ConfigManager::getCachedKeyValues(const std::string& fileName, std::map<const std::string, std::string>& config)
+{
+    std::vector<std::pair<std::string, std::string>> values;
+    if((mConfigCache == nullptr) || !mConfigCache->getKeyValues(fileName, values))
+        return false;
+
+    OD_LOG_INF("Using cached values for " + fileName);
+    for(std::pair<std::string, std::string>& value : values)
+        config[value.first] = std::move(value.second);
+
     return true;
 }
 
+void ConfigManager::cacheKeyValues(const std::string& fileName, const std::map<const std::string, std::string>& config)
+{
+    if(mConfigCache == nullptr)
+        return;
+
+    std::vector<std::pair<std::string, std::string>> values(config.begin(), config.end());
+    mConfigCache->setKeyValues(fileName, values);
+}
+
+bool ConfigManager::setConfigParams(const std::string& fileName, const std::map<const std::string, std::string>& values,
+    const ConfigParamDefinition* definitions, uint32_t nbParams, std::vector<ConfigParamValue>& params)
+{
+    params.assign(nbParams, ConfigParamValue());
+
+    std::map<std::string, uint32_t> indexes;
+    for(uint32_t i = 0; i < nbParams; ++i)
+        indexes[definitions[i].mName] = i;
+
+    std::vector<bool> isSet(nbParams, false);
+    bool isOk = true;
+    for(const std::pair<const std::string, std::string>& value : values)
+    {
+        auto it = indexes.find(value.first);
+        if(it == indexes.end())
+        {
+            OD_LOG_ERR("Unknown parameter " + value.first + " in " + fileName);
+            continue;
+        }
+
+        const ConfigParamDefinition& def = definitions[it->second];
+        bool isValid = true;
+        switch(def.mType)
+        {
+            case ConfigParamType::UInt32:
+                isValid = Helper::checkIfT<uint32_t>(value.second);
+                break;
+            case ConfigParamType::Int32:
+                isValid = Helper::checkIfT<int32_t>(value.second);
+                break;
+            case ConfigParamType::Double:
+                isValid = Helper::checkIfT<double>(value.second);
+                break;
+            case ConfigParamType::String:
+            default:
+                break;
+        }
+        if(!isValid)
+        {
+            OD_LOG_ERR("Invalid value for parameter " + value.first + "=" + value.second + " in " + fileName);
+            isOk = false;
+            continue;
+        }
+
+        ConfigParamValue& param = params[it->second];
+        param.mString = value.second;
+        param.mUInt32 = Helper::toUInt32(value.second);
+        param.mInt32 = Helper::toInt(value.second);
+        param.mDouble = Helper::toDouble(value.second);
+        isSet[it->second] = true;
+    }
+
+    for(uint32_t i = 0; i < nbParams; ++i)
+    {
+        if(isSet[i])
+            continue;
+
+        OD_LOG_ERR("Missing parameter " + std::string(definitions[i].mName) + " in " + fileName);
+        isOk = false;
+    }
+
+    return isOk;
+}
+
 bool ConfigManager::loadTilesets(const std::string& fileName)
 {
     OD_LOG_INF("Load Tilesets file: " + fileName);
     std::stringstream defFile;
-    if(!Helper::readFileWithoutComments(fileName, defFile))
+    if(!readConfigFile(fileName, defFile))
     {
         OD_LOG_ERR("Couldn't read " + fileName);
         return false;
@@ -1372,150 +1554,6 @@ const std::string ConfigManager::getUserValue(Config::Ctg category,
     return it->second;
 }
 
-const std::string& ConfigManager::getRoomConfigString(const std::string& param) const
-{
-    auto it = mRoomsConfig.find(param);
-    if(it == mRoomsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return EMPTY_STRING;
-    }
-
-    return it->second;
-}
-
-uint32_t ConfigManager::getRoomConfigUInt32(const std::string& param) const
-{
-    auto it = mRoomsConfig.find(param);
-    if(it == mRoomsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toUInt32(it->second);
-}
-
-int32_t ConfigManager::getRoomConfigInt32(const std::string& param) const
-{
-    auto it = mRoomsConfig.find(param);
-    if(it == mRoomsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toInt(it->second);
-}
-
-double ConfigManager::getRoomConfigDouble(const std::string& param) const
-{
-    auto it = mRoomsConfig.find(param);
-    if(it == mRoomsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0.0;
-    }
-
-    return Helper::toDouble(it->second);
-}
-
-const std::string& ConfigManager::getTrapConfigString(const std::string& param) const
-{
-    auto it = mTrapsConfig.find(param);
-    if(it == mTrapsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return EMPTY_STRING;
-    }
-
-    return it->second;
-}
-
-uint32_t ConfigManager::getTrapConfigUInt32(const std::string& param) const
-{
-    auto it = mTrapsConfig.find(param);
-    if(it == mTrapsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toUInt32(it->second);
-}
-
-int32_t ConfigManager::getTrapConfigInt32(const std::string& param) const
-{
-    auto it = mTrapsConfig.find(param);
-    if(it == mTrapsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toInt(it->second);
-}
-
-double ConfigManager::getTrapConfigDouble(const std::string& param) const
-{
-    auto it = mTrapsConfig.find(param);
-    if(it == mTrapsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0.0;
-    }
-
-    return Helper::toDouble(it->second);
-}
-
-const std::string& ConfigManager::getSpellConfigString(const std::string& param) const
-{
-    auto it = mSpellConfig.find(param);
-    if(it == mSpellConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return EMPTY_STRING;
-    }
-
-    return it->second;
-}
-
-uint32_t ConfigManager::getSpellConfigUInt32(const std::string& param) const
-{
-    auto it = mSpellConfig.find(param);
-    if(it == mSpellConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toUInt32(it->second);
-}
-
-int32_t ConfigManager::getSpellConfigInt32(const std::string& param) const
-{
-    auto it = mSpellConfig.find(param);
-    if(it == mSpellConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toInt(it->second);
-}
-
-double ConfigManager::getSpellConfigDouble(const std::string& param) const
-{
-    auto it = mSpellConfig.find(param);
-    if(it == mSpellConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0.0;
-    }
-
-    return Helper::toDouble(it->second);
-}
-
 int32_t ConfigManager::getSkillPoints(const std::string& res) const
 {
     auto it = mSkillPoints.find(res);
@@ -18,11 +18,15 @@
 #ifndef CONFIGMANAGER_H
 #define CONFIGMANAGER_H
 
+#include "utils/ConfigParams.h"
+
 #include <OgreSingleton.h>
 #include <OgreColourValue.h>
 
 #include <cstdint>
+#include <memory>
 
+class ConfigCache;
 class CreatureDefinition;
 class Weapon;
 class SpawnCondition;
@@ -71,10 +75,12 @@ public:
     //! \brief Loads the game configuration files.
     //! \param configPath The system configuration path.
     //! \param userConfigPath The user profile config path or empty if not used.
+    //! \param configCacheFile The file where the configuration files content is cached or empty if not used (see ConfigCache).
+    //! \param rebuildConfigCache If true, the cache is ignored and rebuilt from the configuration files.
     //! \note In server mode, the configuration doesn't load the user config and thus,
     //! doesn't set the userConfigPath.
     ConfigManager(const std::string& configPath, const std::string& userConfigPath,
-        const std::string& soundPath);
+        const std::string& soundPath, const std::string& configCacheFile, bool rebuildConfigCache);
     ~ConfigManager();
 
     static const std::string DefaultWorkerCreatureDefinition;
@@ -174,22 +180,34 @@ public:
     { return mFactions; }
 
     //! Rooms configuration
-    const std::string& getRoomConfigString(const std::string& param) const;
-    uint32_t getRoomConfigUInt32(const std::string& param) const;
-    int32_t getRoomConfigInt32(const std::string& param) const;
-    double getRoomConfigDouble(const std::string& param) const;
+    inline const std::string& getRoomConfigString(RoomConfig param) const
+    { return mRoomsConfig[static_cast<uint32_t>(param)].mString; }
+    inline uint32_t getRoomConfigUInt32(RoomConfig param) const
+    { return mRoomsConfig[static_cast<uint32_t>(param)].mUInt32; }
+    inline int32_t getRoomConfigInt32(RoomConfig param) const
+    { return mRoomsConfig[static_cast<uint32_t>(param)].mInt32; }
+    inline double getRoomConfigDouble(RoomConfig param) const
+    { return mRoomsConfig[static_cast<uint32_t>(param)].mDouble; }
 
     //! Traps configuration
-    const std::string& getTrapConfigString(const std::string& param) const;
-    uint32_t getTrapConfigUInt32(const std::string& param) const;
-    int32_t getTrapConfigInt32(const std::string& param) const;
-    double getTrapConfigDouble(const std::string& param) const;
+    inline const std::string& getTrapConfigString(TrapConfig param) const
+    { return mTrapsConfig[static_cast<uint32_t>(param)].mString; }
+    inline uint32_t getTrapConfigUInt32(TrapConfig param) const
+    { return mTrapsConfig[static_cast<uint32_t>(param)].mUInt32; }
+    inline int32_t getTrapConfigInt32(TrapConfig param) const
+    { return mTrapsConfig[static_cast<uint32_t>(param)].mInt32; }
+    inline double getTrapConfigDouble(TrapConfig param) const
+    { return mTrapsConfig[static_cast<uint32_t>(param)].mDouble; }
 
     //! Spells configuration
-    const std::string& getSpellConfigString(const std::string& param) const;
-    uint32_t getSpellConfigUInt32(const std::string& param) const;
-    int32_t getSpellConfigInt32(const std::string& param) const;
-    double getSpellConfigDouble(const std::string& param) const;
+    inline const std::string& getSpellConfigString(SpellConfig param) const
+    { return mSpellConfig[static_cast<uint32_t>(param)].mString; }
+    inline uint32_t getSpellConfigUInt32(SpellConfig param) const
+    { return mSpellConfig[static_cast<uint32_t>(param)].mUInt32; }
+    inline int32_t getSpellConfigInt32(SpellConfig param) const
+    { return mSpellConfig[static_cast<uint32_t>(param)].mInt32; }
+    inline double getSpellConfigDouble(SpellConfig param) const
+    { return mSpellConfig[static_cast<uint32_t>(param)].mDouble; }
 
     int32_t getSkillPoints(const std::string& res) const;
 
@@ -261,6 +279,19 @@ private:
     bool loadTilesets(const std::string& fileName);
     bool loadTilesetValues(std::istream& defFile, TileVisual tileVisual, std::vector<TileSetValue>& tileValues);
 
+    //! \brief Reads the given config file through the config cache if it is used
+    bool readConfigFile(const std::string& fileName, std::stringstream& stream);
+
+    //! \brief Fills config with the values cached for the given key/value file. Returns false if
+    //! the file has to be parsed
+    bool getCachedKeyValues(const std::string& fileName, std::map<const std::string, std::string>& config);
+    void cacheKeyValues(const std::string& fileName, const std::map<const std::string, std::string>& config);
+
+    //! \brief Converts the values read from fileName to the given parameters. Unknown parameters are reported.
+    //! Returns false if a parameter is missing or has a value that does not match its type
+    bool setConfigParams(const std::string& fileName, const std::map<const std::string, std::string>& values,
+        const ConfigParamDefinition* definitions, uint32_t nbParams, std::vector<ConfigParamValue>& params);
+
     //! \brief Loads the user configuration values, and use default ones if it cannot do it.
     void loadUserConfig(const std::string& fileName);
 
@@ -316,9 +347,12 @@ private:
     std::map<const std::string, std::string> mFactionDefaultWorkerClass;
 
     std::vector<std::string> mFactions;
-    std::map<const std::string, std::string> mRoomsConfig;
-    std::map<const std::string, std::string> mTrapsConfig;
-    std::map<const std::string, std::string> mSpellConfig;
+
+    //! \brief Tuning parameters indexed by RoomConfig, TrapConfig and SpellConfig
+    std::vector<ConfigParamValue> mRoomsConfig;
+    std::vector<ConfigParamValue> mTrapsConfig;
+    std::vector<ConfigParamValue> mSpellConfig;
+
     std::map<const std::string, int32_t> mSkillPoints;
 
     //! \brief Default definition for the editor. At map loading, it will spawn a creature from
@@ -337,6 +371,9 @@ private:
 
     //! \brief List of the found keeper voices (in the relative sound folder)
     std::vector<std::string> mKeeperVoices;
+
+    //! \brief Cache used while loading the configuration files. Released once they are loaded
+    std::unique_ptr<ConfigCache> mConfigCache;
 };
 
 #endif //CONFIGMANAGER_H
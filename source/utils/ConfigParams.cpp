@@ -0,0 +1,175 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/ConfigParams.h"
+
+namespace
+{
+    //! \brief Must be in the same order as RoomConfig
+    const ConfigParamDefinition ROOM_DEFINITIONS[] =
+    {
+        {"HatcheryCostPerTile", ConfigParamType::Int32},
+        {"HatcheryHungerPerChicken", ConfigParamType::Double},
+        {"HatcheryHpRecoveredPerChicken", ConfigParamType::Double},
+        {"HatcheryChickenSpawnRate", ConfigParamType::UInt32},
+        {"HatcheryCooldownChickenMin", ConfigParamType::UInt32},
+        {"HatcheryCooldownChickenMax", ConfigParamType::UInt32},
+        {"TrainHallCostPerTile", ConfigParamType::Int32},
+        {"TrainHallXpPerAttack", ConfigParamType::Double},
+        {"TrainHallWakefulnessPerAttack", ConfigParamType::Double},
+        {"TrainHallCooldownHitMin", ConfigParamType::UInt32},
+        {"TrainHallCooldownHitMax", ConfigParamType::UInt32},
+        {"TrainHallBonusWallActiveSpot", ConfigParamType::Double},
+        {"TrainHallMaxTrainingLevel", ConfigParamType::UInt32},
+        {"CryptCostPerTile", ConfigParamType::Int32},
+        {"CryptRotNbTurns", ConfigParamType::Int32},
+        {"CryptBonusWallActiveSpot", ConfigParamType::Double},
+        {"CryptPointsForSpawn", ConfigParamType::Int32},
+        {"CryptSpawnClass", ConfigParamType::String},
+        {"WorkshopCostPerTile", ConfigParamType::Int32},
+        {"WorkshopPointsPerWork", ConfigParamType::Double},
+        {"WorkshopWakefulnessPerWork", ConfigParamType::Double},
+        {"WorkshopCooldownWorkMin", ConfigParamType::UInt32},
+        {"WorkshopCooldownWorkMax", ConfigParamType::UInt32},
+        {"TreasuryCostPerTile", ConfigParamType::Int32},
+        {"DormitoryCostPerTile", ConfigParamType::Int32},
+        {"LibraryCostPerTile", ConfigParamType::Int32},
+        {"LibraryPointsPerWork", ConfigParamType::Double},
+        {"LibraryWakefulnessPerWork", ConfigParamType::Double},
+        {"LibraryCooldownWorkMin", ConfigParamType::UInt32},
+        {"LibraryCooldownWorkMax", ConfigParamType::UInt32},
+        {"LibrarySkillPointsBook", ConfigParamType::Int32},
+        {"PortalCooldownSpawnMin", ConfigParamType::UInt32},
+        {"PortalCooldownSpawnMax", ConfigParamType::UInt32},
+        {"PrisonCostPerTile", ConfigParamType::Int32},
+        {"PrisonDamagePerTurn", ConfigParamType::Double},
+        {"PrisonSpawnClass", ConfigParamType::String},
+        {"WoodenBridgeCostPerTile", ConfigParamType::Int32},
+        {"StoneBridgeCostPerTile", ConfigParamType::Int32},
+        {"ArenaCostPerTile", ConfigParamType::Int32},
+        {"ArenaMaxTrainingLevel", ConfigParamType::UInt32},
+        {"CasinoCostPerTile", ConfigParamType::Int32},
+        {"CasinoWakefulnessPerWork", ConfigParamType::Double},
+        {"CasinoCooldownWorkMin", ConfigParamType::UInt32},
+        {"CasinoCooldownWorkMax", ConfigParamType::UInt32},
+        {"CasinoBet", ConfigParamType::Int32},
+        {"CasinoFee", ConfigParamType::Double},
+        {"TortureCostPerTile", ConfigParamType::Int32},
+        {"TortureRallyPercent", ConfigParamType::Double},
+        {"TortureSessionLengthMin", ConfigParamType::UInt32},
+        {"TortureSessionLengthMax", ConfigParamType::UInt32},
+        {"TortureDamagePerTurn", ConfigParamType::Double},
+    };
+    static_assert(sizeof(ROOM_DEFINITIONS) / sizeof(ROOM_DEFINITIONS[0]) == static_cast<uint32_t>(RoomConfig::nbParams),
+        "ROOM_DEFINITIONS does not match RoomConfig");
+
+    //! \brief Must be in the same order as TrapConfig
+    const ConfigParamDefinition TRAP_DEFINITIONS[] =
+    {
+        {"BoulderCostPerTile", ConfigParamType::Int32},
+        {"BoulderWorkshopPointsPerTile", ConfigParamType::Int32},
+        {"BoulderReloadTurns", ConfigParamType::UInt32},
+        {"BoulderSpeed", ConfigParamType::Double},
+        {"BoulderDamagePerHitMin", ConfigParamType::Double},
+        {"BoulderDamagePerHitMax", ConfigParamType::Double},
+        {"BoulderNbShootsBeforeDeactivation", ConfigParamType::UInt32},
+        {"CannonCostPerTile", ConfigParamType::Int32},
+        {"CannonPhyDef", ConfigParamType::UInt32},
+        {"CannonMagDef", ConfigParamType::UInt32},
+        {"CannonEleDef", ConfigParamType::UInt32},
+        {"CannonWorkshopPointsPerTile", ConfigParamType::Int32},
+        {"CannonRange", ConfigParamType::UInt32},
+        {"CannonSpeed", ConfigParamType::Double},
+        {"CannonReloadTurns", ConfigParamType::UInt32},
+        {"CannonDamagePerHitMin", ConfigParamType::Double},
+        {"CannonDamagePerHitMax", ConfigParamType::Double},
+        {"CannonNbShootsBeforeDeactivation", ConfigParamType::UInt32},
+        {"SpikeCostPerTile", ConfigParamType::Int32},
+        {"SpikeWorkshopPointsPerTile", ConfigParamType::Int32},
+        {"SpikeReloadTurns", ConfigParamType::UInt32},
+        {"SpikeDamagePerHitMin", ConfigParamType::Double},
+        {"SpikeDamagePerHitMax", ConfigParamType::Double},
+        {"SpikeNbShootsBeforeDeactivation", ConfigParamType::UInt32},
+        {"WoodenDoorCostPerTile", ConfigParamType::Int32},
+        {"WoodenDoorPointsPerTile", ConfigParamType::Int32},
+    };
+    static_assert(sizeof(TRAP_DEFINITIONS) / sizeof(TRAP_DEFINITIONS[0]) == static_cast<uint32_t>(TrapConfig::nbParams),
+        "TRAP_DEFINITIONS does not match TrapConfig");
+
+    //! \brief Must be in the same order as SpellConfig
+    const ConfigParamDefinition SPELL_DEFINITIONS[] =
+    {
+        {"SummonWorkerNbFree", ConfigParamType::Int32},
+        {"SummonWorkerBasePrice", ConfigParamType::Int32},
+        {"SummonWorkerCooldown", ConfigParamType::UInt32},
+        {"CallToWarPrice", ConfigParamType::Int32},
+        {"CallToWarNbTurnsMax", ConfigParamType::Int32},
+        {"CallToWarCooldown", ConfigParamType::UInt32},
+        {"CreatureExplosionPrice", ConfigParamType::Int32},
+        {"CreatureExplosionDuration", ConfigParamType::UInt32},
+        {"CreatureExplosionValue", ConfigParamType::Double},
+        {"CreatureExplosionCooldown", ConfigParamType::UInt32},
+        {"CreatureHastePrice", ConfigParamType::Int32},
+        {"CreatureHasteDuration", ConfigParamType::UInt32},
+        {"CreatureHasteValue", ConfigParamType::Double},
+        {"CreatureHasteCooldown", ConfigParamType::UInt32},
+        {"CreatureDefensePrice", ConfigParamType::Int32},
+        {"CreatureDefenseDuration", ConfigParamType::UInt32},
+        {"CreatureDefenseValue", ConfigParamType::Double},
+        {"CreatureDefenseCooldown", ConfigParamType::UInt32},
+        {"CreatureHealPrice", ConfigParamType::Int32},
+        {"CreatureHealDuration", ConfigParamType::UInt32},
+        {"CreatureHealValue", ConfigParamType::Double},
+        {"CreatureHealCooldown", ConfigParamType::UInt32},
+        {"CreatureSlowPrice", ConfigParamType::Int32},
+        {"CreatureSlowDuration", ConfigParamType::UInt32},
+        {"CreatureSlowValue", ConfigParamType::Double},
+        {"CreatureSlowCooldown", ConfigParamType::UInt32},
+        {"CreatureStrengthPrice", ConfigParamType::Int32},
+        {"CreatureStrengthDuration", ConfigParamType::UInt32},
+        {"CreatureStrengthValue", ConfigParamType::Double},
+        {"CreatureStrengthCooldown", ConfigParamType::UInt32},
+        {"CreatureWeakPrice", ConfigParamType::Int32},
+        {"CreatureWeakDuration", ConfigParamType::UInt32},
+        {"CreatureWeakValue", ConfigParamType::Double},
+        {"CreatureWeakCooldown", ConfigParamType::UInt32},
+        {"EyeEvilPrice", ConfigParamType::Int32},
+        {"EyeEvilRadiusTiles", ConfigParamType::UInt32},
+        {"EyeEvilNbTurns", ConfigParamType::Int32},
+        {"EyeEvilCooldown", ConfigParamType::UInt32},
+    };
+    static_assert(sizeof(SPELL_DEFINITIONS) / sizeof(SPELL_DEFINITIONS[0]) == static_cast<uint32_t>(SpellConfig::nbParams),
+        "SPELL_DEFINITIONS does not match SpellConfig");
+}
+
+namespace ConfigParams
+{
+    const ConfigParamDefinition* getRoomDefinitions()
+    {
+        return ROOM_DEFINITIONS;
+    }
+
+    const ConfigParamDefinition* getTrapDefinitions()
+    {
+        return TRAP_DEFINITIONS;
+    }
+
+    const ConfigParamDefinition* getSpellDefinitions()
+    {
+        return SPELL_DEFINITIONS;
+    }
+}
@@ -0,0 +1,197 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONFIGPARAMS_H
+#define CONFIGPARAMS_H
+
+#include <cstdint>
+#include <string>
+
+//! \brief Type of a tuning parameter. The values from the config files are checked against it when loaded
+enum class ConfigParamType
+{
+    String,
+    UInt32,
+    Int32,
+    Double
+};
+
+//! \brief Describes a tuning parameter: its name in the config file and its type
+struct ConfigParamDefinition
+{
+    const char* mName;
+    ConfigParamType mType;
+};
+
+//! \brief Value of a tuning parameter. It is converted to every type when the config file is loaded so that
+//! reading it does not need any parsing
+struct ConfigParamValue
+{
+    ConfigParamValue() :
+        mUInt32(0),
+        mInt32(0),
+        mDouble(0.0)
+    {}
+
+    std::string mString;
+    uint32_t mUInt32;
+    int32_t mInt32;
+    double mDouble;
+};
+
+//! \brief Parameters from rooms.cfg. Enum values are named like the parameters in the file
+enum class RoomConfig
+{
+    HatcheryCostPerTile,
+    HatcheryHungerPerChicken,
+    HatcheryHpRecoveredPerChicken,
+    HatcheryChickenSpawnRate,
+    HatcheryCooldownChickenMin,
+    HatcheryCooldownChickenMax,
+    TrainHallCostPerTile,
+    TrainHallXpPerAttack,
+    TrainHallWakefulnessPerAttack,
+    TrainHallCooldownHitMin,
+    TrainHallCooldownHitMax,
+    TrainHallBonusWallActiveSpot,
+    TrainHallMaxTrainingLevel,
+    CryptCostPerTile,
+    CryptRotNbTurns,
+    CryptBonusWallActiveSpot,
+    CryptPointsForSpawn,
+    CryptSpawnClass,
+    WorkshopCostPerTile,
+    WorkshopPointsPerWork,
+    WorkshopWakefulnessPerWork,
+    WorkshopCooldownWorkMin,
+    WorkshopCooldownWorkMax,
+    TreasuryCostPerTile,
+    DormitoryCostPerTile,
+    LibraryCostPerTile,
+    LibraryPointsPerWork,
+    LibraryWakefulnessPerWork,
+    LibraryCooldownWorkMin,
+    LibraryCooldownWorkMax,
+    LibrarySkillPointsBook,
+    PortalCooldownSpawnMin,
+    PortalCooldownSpawnMax,
+    PrisonCostPerTile,
+    PrisonDamagePerTurn,
+    PrisonSpawnClass,
+    WoodenBridgeCostPerTile,
+    StoneBridgeCostPerTile,
+    ArenaCostPerTile,
+    ArenaMaxTrainingLevel,
+    CasinoCostPerTile,
+    CasinoWakefulnessPerWork,
+    CasinoCooldownWorkMin,
+    CasinoCooldownWorkMax,
+    CasinoBet,
+    CasinoFee,
+    TortureCostPerTile,
+    TortureRallyPercent,
+    TortureSessionLengthMin,
+    TortureSessionLengthMax,
+    TortureDamagePerTurn,
+    nbParams    // Must be the last in this enum
+};
+
+//! \brief Parameters from traps.cfg. Enum values are named like the parameters in the file
+enum class TrapConfig
+{
+    BoulderCostPerTile,
+    BoulderWorkshopPointsPerTile,
+    BoulderReloadTurns,
+    BoulderSpeed,
+    BoulderDamagePerHitMin,
+    BoulderDamagePerHitMax,
+    BoulderNbShootsBeforeDeactivation,
+    CannonCostPerTile,
+    CannonPhyDef,
+    CannonMagDef,
+    CannonEleDef,
+    CannonWorkshopPointsPerTile,
+    CannonRange,
+    CannonSpeed,
+    CannonReloadTurns,
+    CannonDamagePerHitMin,
+    CannonDamagePerHitMax,
+    CannonNbShootsBeforeDeactivation,
+    SpikeCostPerTile,
+    SpikeWorkshopPointsPerTile,
+    SpikeReloadTurns,
+    SpikeDamagePerHitMin,
+    SpikeDamagePerHitMax,
+    SpikeNbShootsBeforeDeactivation,
+    WoodenDoorCostPerTile,
+    WoodenDoorPointsPerTile,
+    nbParams    // Must be the last in this enum
+};
+
+//! \brief Parameters from spells.cfg. Enum values are named like the parameters in the file
+enum class SpellConfig
+{
+    SummonWorkerNbFree,
+    SummonWorkerBasePrice,
+    SummonWorkerCooldown,
+    CallToWarPrice,
+    CallToWarNbTurnsMax,
+    CallToWarCooldown,
+    CreatureExplosionPrice,
+    CreatureExplosionDuration,
+    CreatureExplosionValue,
+    CreatureExplosionCooldown,
+    CreatureHastePrice,
+    CreatureHasteDuration,
+    CreatureHasteValue,
+    CreatureHasteCooldown,
+    CreatureDefensePrice,
+    CreatureDefenseDuration,
+    CreatureDefenseValue,
+    CreatureDefenseCooldown,
+    CreatureHealPrice,
+    CreatureHealDuration,
+    CreatureHealValue,
+    CreatureHealCooldown,
+    CreatureSlowPrice,
+    CreatureSlowDuration,
+    CreatureSlowValue,
+    CreatureSlowCooldown,
+    CreatureStrengthPrice,
+    CreatureStrengthDuration,
+    CreatureStrengthValue,
+    CreatureStrengthCooldown,
+    CreatureWeakPrice,
+    CreatureWeakDuration,
+    CreatureWeakValue,
+    CreatureWeakCooldown,
+    EyeEvilPrice,
+    EyeEvilRadiusTiles,
+    EyeEvilNbTurns,
+    EyeEvilCooldown,
+    nbParams    // Must be the last in this enum
+};
+
+namespace ConfigParams
+{
+    //! \brief Returns the definitions of the parameters, indexed by the matching enum value
+    const ConfigParamDefinition* getRoomDefinitions();
+    const ConfigParamDefinition* getTrapDefinitions();
+    const ConfigParamDefinition* getSpellDefinitions();
+}
+
+#endif // CONFIGPARAMS_H
@@ -25,6 +25,7 @@
 
 #include <string>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 #include <cstdint>
 
@@ -78,14 +79,26 @@ namespace Helper
     /*! \brief Checks if a string contains primitive type T
      *
      *  \param str The string to be checked
-     *  \return true if string contains type T, else false
+     *  \return true if the whole string (but surrounding spaces) is a value of type T, else false.
+     *  A numeric prefix ("8abc") or a negative value for an unsigned type is refused
      */
     template<typename T>
     bool checkIfT(const std::string& str)
     {
         std::istringstream stream(str);
         T t = 0;
-        return (stream >> t);
+        if(std::is_unsigned<T>::value)
+        {
+            // Streams accept "-1" for unsigned types and wrap it around
+            stream >> std::ws;
+            if(stream.peek() == '-')
+                return false;
+        }
+        if(!(stream >> t))
+            return false;
+
+        stream >> std::ws;
+        return stream.eof();
     }
 
     //! \brief Split a line based on a delimiter.
@@ -0,0 +1,135 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/ObjectPool.h"
+
+#include "utils/Helper.h"
+#include "utils/LogManager.h"
+
+#include <SFML/System/Lock.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+namespace
+{
+    //! \brief Blocks are aligned on this value, which is enough for any type used in the game
+    const std::size_t BLOCK_ALIGNMENT = 16;
+}
+
+ObjectPool::ObjectPool(std::size_t blockSize, uint32_t nbBlocksPerChunk) :
+    mBlockSize(((std::max(blockSize, sizeof(FreeBlock)) + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT) * BLOCK_ALIGNMENT),
+    mNbBlocksPerChunk(nbBlocksPerChunk),
+    mFreeBlocks(nullptr),
+    mNbUsedBlocks(0)
+{
+}
+
+ObjectPool::~ObjectPool()
+{
+    if(mNbUsedBlocks > 0)
+    {
+        OD_LOG_WRN("Destroying pool with blockSize=" + Helper::toString(static_cast<uint32_t>(mBlockSize))
+            + " while blocks are still used nb=" + Helper::toString(mNbUsedBlocks));
+    }
+
+    for(char* chunk : mChunks)
+        ::operator delete(chunk);
+}
+
+void* ObjectPool::allocate(std::size_t size)
+{
+    if(size > mBlockSize)
+        return ::operator new(size);
+
+    sf::Lock lock(mLock);
+    if(mFreeBlocks == nullptr)
+        allocateChunk();
+
+    FreeBlock* block = mFreeBlocks;
+    mFreeBlocks = block->mNext;
+    ++mNbUsedBlocks;
+
+#ifdef OD_DEBUG
+    // Everything after the free list pointer should still be poisoned
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(block);
+    for(std::size_t i = sizeof(FreeBlock); i < mBlockSize; ++i)
+    {
+        if(data[i] != POISON_BYTE)
+        {
+            OD_LOG_ERR("Block written after being released blockSize=" + Helper::toString(static_cast<uint32_t>(mBlockSize))
+                + ", offset=" + Helper::toString(static_cast<uint32_t>(i)));
+            break;
+        }
+    }
+#endif
+
+    return block;
+}
+
+void ObjectPool::release(void* ptr, std::size_t size)
+{
+    if(ptr == nullptr)
+        return;
+
+    if(size > mBlockSize)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+#ifdef OD_DEBUG
+    std::memset(ptr, POISON_BYTE, mBlockSize);
+#endif
+
+    sf::Lock lock(mLock);
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->mNext = mFreeBlocks;
+    mFreeBlocks = block;
+    --mNbUsedBlocks;
+}
+
+uint32_t ObjectPool::getNbChunks()
+{
+    sf::Lock lock(mLock);
+    return mChunks.size();
+}
+
+uint32_t ObjectPool::getNbUsedBlocks()
+{
+    sf::Lock lock(mLock);
+    return mNbUsedBlocks;
+}
+
+void ObjectPool::allocateChunk()
+{
+    char* chunk = static_cast<char*>(::operator new(mBlockSize * mNbBlocksPerChunk));
+    mChunks.push_back(chunk);
+
+#ifdef OD_DEBUG
+    std::memset(chunk, POISON_BYTE, mBlockSize * mNbBlocksPerChunk);
+#endif
+
+    // We chain the blocks in address order so that consecutive allocations are contiguous
+    for(uint32_t i = mNbBlocksPerChunk; i > 0; --i)
+    {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * mBlockSize);
+        block->mNext = mFreeBlocks;
+        mFreeBlocks = block;
+    }
+}
@@ -0,0 +1,98 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <SFML/System/Mutex.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//! \brief Allocator handing out fixed size blocks taken from chunks that are kept until the pool is destroyed.
+//! Released blocks are put in a free list and reused by the next allocations. It is meant for objects created
+//! and deleted at a high rate (missiles, temporary entities, server notifications...) so that they do not go
+//! through the heap each time and do not fragment it.
+//! When OD_DEBUG is defined, released blocks are filled with POISON_BYTE and checked when they are reused
+//! so that a write after delete is reported.
+//! The pool can be used from several threads (entities are created on both the server and the client game maps).
+class ObjectPool
+{
+public:
+    static const uint8_t POISON_BYTE = 0xDD;
+
+    ObjectPool(std::size_t blockSize, uint32_t nbBlocksPerChunk);
+    ~ObjectPool();
+
+    //! \brief Returns a block of at least size bytes. Sizes bigger than the block size (like for a derived
+    //! class) are allocated with the global operator new.
+    void* allocate(std::size_t size);
+
+    //! \brief Gives back a block returned by allocate. size should be the same as the one given to allocate
+    void release(void* ptr, std::size_t size);
+
+    inline std::size_t getBlockSize() const
+    { return mBlockSize; }
+
+    inline uint32_t getNbBlocksPerChunk() const
+    { return mNbBlocksPerChunk; }
+
+    //! \brief Number of chunks allocated. The memory held by the pool is getNbChunks() * nbBlocksPerChunk blocks
+    uint32_t getNbChunks();
+
+    //! \brief Number of blocks currently allocated from this pool
+    uint32_t getNbUsedBlocks();
+
+private:
+    //! \brief A free block stores a pointer to the next free one
+    struct FreeBlock
+    {
+        FreeBlock* mNext;
+    };
+
+    void allocateChunk();
+
+    std::size_t mBlockSize;
+    uint32_t mNbBlocksPerChunk;
+    std::vector<char*> mChunks;
+    FreeBlock* mFreeBlocks;
+    uint32_t mNbUsedBlocks;
+    sf::Mutex mLock;
+};
+
+//! \brief Classes deriving from PooledObject<T> are allocated with new/delete from an ObjectPool dedicated
+//! to T. Classes deriving from T that are bigger than T fall back to the global heap.
+template<typename T>
+class PooledObject
+{
+public:
+    static void* operator new(std::size_t size)
+    { return getPool().allocate(size); }
+
+    static void operator delete(void* ptr, std::size_t size)
+    { getPool().release(ptr, size); }
+
+    static ObjectPool& getPool()
+    {
+        // The pool is never destroyed so that objects deleted while the program exits can still be released
+        static ObjectPool* pool = new ObjectPool(sizeof(T), 64);
+        return *pool;
+    }
+};
+
+#endif // OBJECTPOOL_H
@@ -69,7 +69,12 @@ namespace Random
 
 void initialize()
 {
-    myRandomSeed = static_cast<unsigned long>(std::time(0));
+    initialize(static_cast<unsigned long>(std::time(0)));
+}
+
+void initialize(unsigned long seed)
+{
+    myRandomSeed = seed;
 }
 
 double Double(double min, double max)
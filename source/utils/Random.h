@@ -28,6 +28,10 @@ namespace Random
     //! \brief initializes the semaphore and seeds the generator
     void initialize();
 
+    //! \brief seeds the generator with the given value. The same seed always gives the same
+    //! sequence, which is used by the tests needing reproducible random data
+    void initialize(unsigned long seed);
+
     /*! \brief generate a random double
      *
      *  \param min, max One or both can be negative
@@ -54,6 +54,8 @@
 
 #include <boost/program_options.hpp>
 
+#include <algorithm>
+
 template<> ResourceManager* Ogre::Singleton<ResourceManager>::msSingleton = nullptr;
 #if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 && defined(OD_DEBUG)
 //On windows, if the application is compiled in debug mode, use the plugins with debug prefix.
@@ -71,6 +73,7 @@ const std::string ResourceManager::SHADERCACHESUBPATH = "shaderCache/";
 const std::string ResourceManager::LOGFILENAME = "opendungeons.log";
 const std::string ResourceManager::CEGUILOGFILENAME = "CEGUI.log";
 const std::string ResourceManager::USERCFGFILENAME = "config.cfg";
+const std::string ResourceManager::CONFIGCACHEFILENAME = "config.cache";
 
 const std::string ResourceManager::RESOURCEGROUPMUSIC = "Music";
 const std::string ResourceManager::RESOURCEGROUPSOUND = "Sound";
@@ -85,6 +88,8 @@ const std::string ResourceManager::RESOURCEGROUPSOUND = "Sound";
 ResourceManager::ResourceManager(boost::program_options::variables_map& options) :
         mServerMode(false),
         mForcedNetworkPort(-1),
+        mBenchmarkLevelsNbLoads(0),
+        mRebuildConfigCache(false),
         mLogLevel(LogMessageLevel::NORMAL),
         mGameDataPath("./"),
         mUserDataPath("./"),
@@ -433,7 +438,14 @@ void ResourceManager::setupUserDataFolders(boost::program_options::variables_map
     if(itOption != options.end())
         mLogLevel = static_cast<LogMessageLevel>(itOption->second.as<int32_t>());
 
+    itOption = options.find("benchmarklevels");
+    if(itOption != options.end())
+        mBenchmarkLevelsNbLoads = std::max(itOption->second.as<int32_t>(), 0);
+
+    mRebuildConfigCache = (options.find("rebuild-config-cache") != options.end());
+
     mUserConfigFile = mUserConfigPath + USERCFGFILENAME;
+    mConfigCacheFile = mUserDataPath + CONFIGCACHEFILENAME;
     mCeguiLogFile = mUserDataPath + CEGUILOGFILENAME;
     mShaderCachePath = mUserDataPath + SHADERCACHESUBPATH;
 
@@ -578,6 +590,8 @@ void ResourceManager::buildCommandOptions(boost::program_options::options_descri
         ("mscreator", boost::program_options::value<std::string>(), "Sets the creator for this map to connect to the master server. server/servercustom/serversave option needs to be on")
         ("port", boost::program_options::value<int32_t>(), "Sets the port used. Note that the port is used for both single and multi player")
         ("loglevel", boost::program_options::value<int32_t>(), "Sets the log level (between 0=Trivial and 3=Critical)")
+        ("benchmarklevels", boost::program_options::value<int32_t>(), "Loads every official level the given number of times, logs the time spent in each loading stage and in tile queries and exits")
+        ("rebuild-config-cache", "Ignores the config cache and rebuilds it from the config files")
     ;
 }
 
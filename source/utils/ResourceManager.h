@@ -123,6 +123,9 @@ public:
     inline const std::string& getUserCfgFile() const
     { return mUserConfigFile; }
 
+    inline const std::string& getConfigCacheFile() const
+    { return mConfigCacheFile; }
+
     inline const std::string& getLogFile() const
     { return mOgreLogFile; }
 
@@ -148,6 +151,14 @@ public:
     inline int32_t getForcedNetworkPort() const
     { return mForcedNetworkPort; }
 
+    //! \brief Number of times each level should be loaded when benchmarking level loading. 0 if not benchmarking
+    inline int32_t getBenchmarkLevelsNbLoads() const
+    { return mBenchmarkLevelsNbLoads; }
+
+    //! \brief True if the config cache should be rebuilt from the config files
+    inline bool getRebuildConfigCache() const
+    { return mRebuildConfigCache; }
+
     inline LogMessageLevel getLogLevel() const
     { return mLogLevel; }
 
@@ -160,6 +171,12 @@ private:
     //! \brief used when the network port is forced
     int32_t mForcedNetworkPort;
 
+    //! \brief used when the executable is launched to benchmark level loading
+    int32_t mBenchmarkLevelsNbLoads;
+
+    //! \brief used when the executable is launched to rebuild the config cache
+    bool mRebuildConfigCache;
+
     //! \brief The log level
     LogMessageLevel mLogLevel;
 
@@ -186,6 +203,7 @@ private:
     std::string mOgreLogFile;
     std::string mCeguiLogFile;
     std::string mShaderCachePath;
+    std::string mConfigCacheFile;
 
     //! \brief Specific data sub-paths.
     std::string mConfigPath;
@@ -210,6 +228,7 @@ private:
     static const std::string LOGFILENAME;
     static const std::string CEGUILOGFILENAME;
     static const std::string USERCFGFILENAME;
+    static const std::string CONFIGCACHEFILENAME;
 
     static const std::string RESOURCEGROUPMUSIC;
     static const std::string RESOURCEGROUPSOUND;